@@ -0,0 +1,128 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <hpp/constraints/convex-shape-contact.hh>
+#include <hpp/constraints/explicit/convex-shape-contact.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/liegroup-element.hh>
+#include <hpp/pinocchio/urdf/util.hh>
+#include <pinocchio/algorithm/joint-configuration.hpp>
+
+using hpp::pinocchio::Configuration_t;
+using hpp::pinocchio::Device;
+using hpp::pinocchio::DevicePtr_t;
+using hpp::pinocchio::JointPtr_t;
+using hpp::pinocchio::LiegroupElement;
+using hpp::pinocchio::urdf::loadModelFromString;
+using namespace hpp::constraints;
+
+namespace {
+// Two freeflying boxes of size (2,2,2); a contact constraint between
+// the upper and lower faces of both boxes, as in
+// tests/convex-shape-contact.cc.
+struct Fixture {
+  DevicePtr_t robot;
+  DifferentiableFunctionPtr_t function;
+  Configuration_t q;
+
+  Fixture() : robot(Device::create("two-boxes")) {
+    const std::string model(
+        "<robot name=\"box\">"
+        "  <link name=\"baselink\">"
+        "    <collision>"
+        "      <origin rpy=\"0 0 0\" xyz=\"0 0 0\"/>"
+        "      <geometry>"
+        "        <box size=\"2 2 2\"/>"
+        "      </geometry>"
+        "    </collision>"
+        "  </link>"
+        "</robot>");
+    loadModelFromString(robot, 0, "1/", "freeflyer", model, "");
+    loadModelFromString(robot, 0, "2/", "freeflyer", model, "");
+    JointAndShapes_t surfaces1(faces(robot->jointAt(0)));
+    JointAndShapes_t surfaces2(faces(robot->jointAt(1)));
+    ExplicitPtr_t contact(explicit_::ConvexShapeContact::create(
+        "box1/box2", robot, surfaces1, surfaces2, 0));
+    function = contact->functionPtr();
+    q = robot->neutralConfiguration();
+    q[2] = 2.;  // box2 on top of box1
+  }
+
+  // Upper and lower faces of the box attached to joint.
+  static JointAndShapes_t faces(const JointPtr_t& joint) {
+    JointAndShapes_t shapes;
+    JointAndShape_t surface;
+    surface.first = joint;
+    vector3_t v;
+    v << -1., -1., 1.;
+    surface.second.push_back(v);
+    v << 1., -1., 1.;
+    surface.second.push_back(v);
+    v << 1., 1., 1.;
+    surface.second.push_back(v);
+    v << -1., 1., 1.;
+    surface.second.push_back(v);
+    shapes.push_back(surface);
+    surface.second.clear();
+    v << -1., 1., -1.;
+    surface.second.push_back(v);
+    v << 1., 1., -1.;
+    surface.second.push_back(v);
+    v << 1., -1., -1.;
+    surface.second.push_back(v);
+    v << -1., -1., -1.;
+    surface.second.push_back(v);
+    shapes.push_back(surface);
+    return shapes;
+  }
+};
+}  // namespace
+
+static void BM_value(benchmark::State& state) {
+  Fixture f;
+  LiegroupElement value(f.function->outputSpace());
+  for (auto _ : state) {
+    f.function->value(value, f.q);
+    benchmark::DoNotOptimize(value.vector().data());
+  }
+}
+BENCHMARK(BM_value);
+
+static void BM_jacobian(benchmark::State& state) {
+  Fixture f;
+  matrix_t J(f.function->outputDerivativeSize(),
+             f.function->inputDerivativeSize());
+  for (auto _ : state) {
+    f.function->jacobian(J, f.q);
+    benchmark::DoNotOptimize(J.data());
+  }
+}
+BENCHMARK(BM_jacobian);
+
+BENCHMARK_MAIN();
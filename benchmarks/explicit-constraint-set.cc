@@ -0,0 +1,99 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <hpp/constraints/affine-function.hh>
+#include <hpp/constraints/explicit-constraint-set.hh>
+#include <hpp/constraints/explicit.hh>
+#include <hpp/pinocchio/liegroup-space.hh>
+
+using hpp::constraints::AffineFunction;
+using hpp::constraints::ComparisonTypes_t;
+using hpp::constraints::EqualToZero;
+using hpp::constraints::Explicit;
+using hpp::constraints::ExplicitConstraintSet;
+using hpp::constraints::ExplicitPtr_t;
+using hpp::constraints::matrix_t;
+using hpp::constraints::segment_t;
+using hpp::constraints::segments_t;
+using hpp::constraints::size_type;
+using hpp::constraints::vector_t;
+using hpp::pinocchio::LiegroupSpace;
+
+namespace {
+// Build a set of nFunctions chained explicit constraints on
+// R^((nFunctions + 1) * width): variables of block i+1 are an affine
+// function of the variables of block i.
+ExplicitConstraintSet makeSet(size_type nFunctions, size_type width) {
+  const size_type nDof = (nFunctions + 1) * width;
+  ExplicitConstraintSet set(LiegroupSpace::Rn(nDof));
+  for (size_type i = 0; i < nFunctions; ++i) {
+    segments_t in(1, segment_t(i * width, width));
+    segments_t out(1, segment_t((i + 1) * width, width));
+    ExplicitPtr_t constraint(Explicit::create(
+        LiegroupSpace::Rn(nDof),
+        AffineFunction::create(matrix_t::Random(width, width)), in, out, in,
+        out));
+    set.add(constraint);
+  }
+  return set;
+}
+}  // namespace
+
+// Resolution of the explicit part. range(0): number of chained
+// functions, range(1): size of each variable block.
+static void BM_solve(benchmark::State& state) {
+  srand(0);
+  ExplicitConstraintSet set(
+      makeSet(state.range(0), state.range(1)));
+  vector_t q(vector_t::Random(set.configSpace()->nq()));
+  for (auto _ : state) {
+    set.solve(q);
+    benchmark::DoNotOptimize(q.data());
+  }
+}
+BENCHMARK(BM_solve)->Args({2, 3})->Args({8, 3})->Args({8, 7})->Args({16, 7});
+
+// Jacobian of the explicit part, as used by
+// BySubstitution::updateJacobian.
+static void BM_jacobian(benchmark::State& state) {
+  srand(0);
+  ExplicitConstraintSet set(
+      makeSet(state.range(0), state.range(1)));
+  const size_type nv = set.configSpace()->nv();
+  vector_t q(vector_t::Random(set.configSpace()->nq()));
+  set.solve(q);
+  matrix_t J(nv, nv);
+  for (auto _ : state) {
+    set.jacobian(J, q);
+    benchmark::DoNotOptimize(J.data());
+  }
+}
+BENCHMARK(BM_jacobian)->Args({8, 3})->Args({16, 7});
+
+BENCHMARK_MAIN();
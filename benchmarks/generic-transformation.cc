@@ -0,0 +1,108 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <hpp/constraints/generic-transformation.hh>
+#include <hpp/pinocchio/configuration.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/liegroup-element.hh>
+#include <hpp/pinocchio/simple-device.hh>
+#include <pinocchio/algorithm/joint-configuration.hpp>
+
+using hpp::constraints::Configuration_t;
+using hpp::constraints::DevicePtr_t;
+using hpp::constraints::DifferentiableFunctionPtr_t;
+using hpp::constraints::JointPtr_t;
+using hpp::constraints::LiegroupElement;
+using hpp::constraints::matrix_t;
+using hpp::constraints::Orientation;
+using hpp::constraints::Position;
+using hpp::constraints::RelativeTransformation;
+using hpp::constraints::Transform3f;
+using hpp::constraints::Transformation;
+using hpp::pinocchio::unittest::HumanoidSimple;
+using hpp::pinocchio::unittest::makeDevice;
+
+namespace {
+struct Fixture {
+  DevicePtr_t device;
+  JointPtr_t ee1, ee2;
+  Configuration_t q;
+
+  Fixture() : device(makeDevice(HumanoidSimple)) {
+    ee1 = device->getJointByName("lleg5_joint");
+    ee2 = device->getJointByName("rleg5_joint");
+    q = ::pinocchio::randomConfiguration(device->model());
+  }
+
+  DifferentiableFunctionPtr_t function(int id) const {
+    Transform3f tf1(Transform3f::Identity()), tf2(Transform3f::Identity());
+    switch (id) {
+      case 0:
+        return Position::create("Position", device, ee2, tf2, tf1);
+      case 1:
+        return Orientation::create("Orientation", device, ee2, tf2);
+      case 2:
+        return Transformation::create("Transformation", device, ee1, tf1);
+      default:
+        return RelativeTransformation::create("RelativeTransformation", device,
+                                              ee1, ee2, tf1, tf2);
+    }
+  }
+};
+}  // namespace
+
+// Value evaluation. range(0) selects the constraint type: 0 Position,
+// 1 Orientation, 2 Transformation, 3 RelativeTransformation.
+static void BM_value(benchmark::State& state) {
+  srand(0);
+  Fixture f;
+  DifferentiableFunctionPtr_t function(f.function((int)state.range(0)));
+  LiegroupElement value(function->outputSpace());
+  for (auto _ : state) {
+    function->value(value, f.q);
+    benchmark::DoNotOptimize(value.vector().data());
+  }
+}
+BENCHMARK(BM_value)->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+
+// Jacobian evaluation for the same constraint types.
+static void BM_jacobian(benchmark::State& state) {
+  srand(0);
+  Fixture f;
+  DifferentiableFunctionPtr_t function(f.function((int)state.range(0)));
+  matrix_t J(function->outputDerivativeSize(), function->inputDerivativeSize());
+  for (auto _ : state) {
+    function->jacobian(J, f.q);
+    benchmark::DoNotOptimize(J.data());
+  }
+}
+BENCHMARK(BM_jacobian)->Arg(0)->Arg(1)->Arg(2)->Arg(3);
+
+BENCHMARK_MAIN();
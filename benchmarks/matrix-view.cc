@@ -0,0 +1,101 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <hpp/constraints/matrix-view.hh>
+
+using Eigen::ColBlockIndices;
+using Eigen::MatrixBlocks;
+using Eigen::RowBlockIndices;
+using hpp::constraints::matrix_t;
+using hpp::constraints::size_type;
+using hpp::constraints::vector_t;
+
+namespace {
+// Alternating kept/skipped index segments of the given width over
+// [0, size).
+RowBlockIndices alternatingRows(size_type size, size_type width) {
+  RowBlockIndices idx;
+  for (size_type i = 0; i < size; i += 2 * width)
+    idx.addRow(i, std::min(width, size - i));
+  idx.updateRows<true, true, true>();
+  return idx;
+}
+}  // namespace
+
+// Gathering copy `dst = blocks.rview(src)`, the kernel behind the
+// reduced Jacobian extraction of the solvers. range(0): matrix size,
+// range(1): segment width.
+static void BM_rviewCopy(benchmark::State& state) {
+  const size_type size = state.range(0), width = state.range(1);
+  RowBlockIndices rows(alternatingRows(size, width));
+  MatrixBlocks<false, false> blocks(rows.rows(), rows.rows());
+  matrix_t src(matrix_t::Random(size, size));
+  matrix_t dst(blocks.nbRows(), blocks.nbCols());
+  for (auto _ : state) {
+    dst = blocks.rview(src);
+    benchmark::DoNotOptimize(dst.data());
+  }
+}
+BENCHMARK(BM_rviewCopy)->Args({128, 4})->Args({128, 16})->Args({512, 16});
+
+// Scattering write `blocks.lview(dst) = src`, as used to expand the
+// reduced descent direction.
+static void BM_lviewWrite(benchmark::State& state) {
+  const size_type size = state.range(0), width = state.range(1);
+  RowBlockIndices rows(alternatingRows(size, width));
+  vector_t src(vector_t::Random(rows.nbRows()));
+  vector_t dst(vector_t::Zero(size));
+  for (auto _ : state) {
+    rows.lview(dst) = src;
+    benchmark::DoNotOptimize(dst.data());
+  }
+}
+BENCHMARK(BM_lviewWrite)->Args({128, 4})->Args({512, 16});
+
+// Product of a row-selected view with a dense vector, without
+// materializing the view: one GEMV per kept segment, writing the
+// matching segment of the result.
+static void BM_rviewProduct(benchmark::State& state) {
+  const size_type size = state.range(0), width = state.range(1);
+  RowBlockIndices rows(alternatingRows(size, width));
+  matrix_t src(matrix_t::Random(size, size));
+  vector_t x(vector_t::Random(size));
+  vector_t y(rows.nbRows());
+  for (auto _ : state) {
+    size_type r = 0;
+    for (const RowBlockIndices::segment_t& s : rows.rows()) {
+      y.segment(r, s.second).noalias() = src.middleRows(s.first, s.second) * x;
+      r += s.second;
+    }
+    benchmark::DoNotOptimize(y.data());
+  }
+}
+BENCHMARK(BM_rviewProduct)->Args({128, 4})->Args({512, 16});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,205 @@
+// Copyright (c) 2026 CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+// Synthetic scaling study of BySubstitution::solve. The problems are
+// generated, not recorded: a serial chain of n revolute joints, k
+// position constraints spread over p priority levels and m explicit
+// constraints chaining pairs of dofs. Sweeping one parameter at a time
+// exposes regressions in asymptotic behavior (decomposition shapes,
+// BlockIndex algebra, ...) that fixed-size benchmarks miss.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <hpp/constraints/affine-function.hh>
+#include <hpp/constraints/explicit.hh>
+#include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/implicit.hh>
+#include <hpp/constraints/solver/by-substitution.hh>
+#include <hpp/pinocchio/device.hh>
+#include <hpp/pinocchio/joint.hh>
+#include <hpp/pinocchio/urdf/util.hh>
+#include <new>
+#include <pinocchio/algorithm/joint-configuration.hpp>
+#include <sstream>
+
+using hpp::constraints::AffineFunction;
+using hpp::constraints::ComparisonTypes_t;
+using hpp::constraints::Configuration_t;
+using hpp::constraints::DevicePtr_t;
+using hpp::constraints::EqualToZero;
+using hpp::constraints::Explicit;
+using hpp::constraints::Implicit;
+using hpp::constraints::JointPtr_t;
+using hpp::constraints::matrix_t;
+using hpp::constraints::Position;
+using hpp::constraints::segment_t;
+using hpp::constraints::segments_t;
+using hpp::constraints::size_type;
+using hpp::constraints::Transform3f;
+using hpp::constraints::vector_t;
+using hpp::constraints::solver::BySubstitution;
+using hpp::constraints::solver::HierarchicalIterative;
+using hpp::pinocchio::Device;
+using hpp::pinocchio::urdf::loadModelFromString;
+
+// Process wide allocation counter, reported per solve. Replacing
+// operator new here covers the library as well since the benchmark and
+// the library live in the same process.
+namespace {
+std::atomic<std::size_t> allocationCount(0);
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocationCount;
+  if (void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+  ++allocationCount;
+  if (void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+// Serial chain of n bounded revolute joints with alternating axes, so
+// that the configuration space is R^n and every parameter set is legal.
+DevicePtr_t makeChain(size_type n) {
+  std::ostringstream urdf;
+  urdf << "<robot name='chain'><link name='link0'/>";
+  for (size_type i = 0; i < n; ++i) {
+    urdf << "<joint name='joint" << i << "' type='revolute'>"
+         << "<parent link='link" << i << "'/>"
+         << "<child link='link" << i + 1 << "'/>"
+         << "<origin xyz='0 0 0.1'/>"
+         << "<axis xyz='" << (i % 2 ? "0 1 0" : "1 0 0") << "'/>"
+         << "<limit effort='30' velocity='1.0' lower='-3' upper='3'/>"
+         << "</joint><link name='link" << i + 1 << "'/>";
+  }
+  urdf << "</robot>";
+  DevicePtr_t robot(Device::create("chain"));
+  loadModelFromString(robot, 0, "", "anchor", urdf.str(), "");
+  return robot;
+}
+
+// Parameterized problem: k position constraints on joints spread along
+// the chain, distributed over p priority levels, and m explicit
+// constraints making the last m dofs affine functions of the first m.
+// Every constraint is satisfied at qRef, so the problems are feasible.
+struct Problem {
+  DevicePtr_t robot;
+  BySubstitution solver;
+  Configuration_t qRef;
+
+  Problem(size_type n, size_type k, size_type p, size_type m)
+      : robot(makeChain(n)), solver(robot->configSpace()) {
+    solver.maxIterations(40);
+    solver.errorThreshold(1e-4);
+
+    qRef = ::pinocchio::randomConfiguration(robot->model());
+    robot->currentConfiguration(qRef);
+    robot->computeForwardKinematics();
+
+    for (size_type i = 0; i < k; ++i) {
+      JointPtr_t joint(robot->jointAt(((i + 1) * n) / k - 1));
+      std::ostringstream name;
+      name << "position-" << i;
+      solver.add(
+          Implicit::create(
+              Position::create(name.str(), robot, joint,
+                               Transform3f::Identity(),
+                               Transform3f(joint->currentTransformation())),
+              ComparisonTypes_t(3, EqualToZero)),
+          i % p);
+    }
+    for (size_type j = 0; j < m; ++j) {
+      segments_t in(1, segment_t(j, 1));
+      segments_t out(1, segment_t(n - m + j, 1));
+      matrix_t A(matrix_t::Random(1, 1));
+      vector_t b(qRef.segment(n - m + j, 1) - A * qRef.segment(j, 1));
+      solver.add(Explicit::create(robot->configSpace(),
+                                  AffineFunction::create(A, b), in, out, in,
+                                  out));
+    }
+  }
+};
+
+// Iteration count of the last solve, read from the telemetry ring.
+std::size_t lastIterationCount(const BySubstitution& solver) {
+  const HierarchicalIterative::SolveTelemetry& t = solver.telemetry();
+  if (t.size == 0) return 0;
+  return (std::size_t)t.ring[(t.head + t.ring.size() - 1) % t.ring.size()]
+             .iteration +
+         1;
+}
+}  // namespace
+
+// range(0): n joints, range(1): k position constraints, range(2): p
+// priority levels, range(3): m explicit constraints. Reports the Newton
+// iteration count and the heap allocations per solve next to the time.
+static void BM_solve(benchmark::State& state) {
+  srand(0);
+  Problem problem(state.range(0), state.range(1), state.range(2),
+                  state.range(3));
+  Configuration_t q(problem.qRef.size());
+  std::size_t iterations = 0, allocations = 0;
+  for (auto _ : state) {
+    q = problem.qRef + 0.1 * vector_t::Random(q.size());
+    const std::size_t before = allocationCount.load();
+    benchmark::DoNotOptimize(problem.solver.solve(q));
+    allocations += allocationCount.load() - before;
+    iterations += lastIterationCount(problem.solver);
+  }
+  state.counters["newton-iterations"] = benchmark::Counter(
+      (double)iterations, benchmark::Counter::kAvgIterations);
+  state.counters["allocations"] = benchmark::Counter(
+      (double)allocations, benchmark::Counter::kAvgIterations);
+}
+// Chain length sweep.
+BENCHMARK(BM_solve)
+    ->Args({8, 2, 1, 0})
+    ->Args({16, 2, 1, 0})
+    ->Args({32, 2, 1, 0})
+    ->Args({64, 2, 1, 0});
+// Constraint count and priority level sweep.
+BENCHMARK(BM_solve)
+    ->Args({32, 1, 1, 0})
+    ->Args({32, 2, 2, 0})
+    ->Args({32, 4, 2, 0})
+    ->Args({32, 8, 4, 0});
+// Explicit constraint sweep.
+BENCHMARK(BM_solve)
+    ->Args({32, 2, 1, 4})
+    ->Args({32, 2, 1, 8})
+    ->Args({32, 2, 1, 16});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,98 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <benchmark/benchmark.h>
+
+#include <hpp/constraints/affine-function.hh>
+#include <hpp/constraints/implicit.hh>
+#include <hpp/constraints/solver/hierarchical-iterative.hh>
+#include <hpp/pinocchio/liegroup-space.hh>
+
+using hpp::constraints::AffineFunction;
+using hpp::constraints::ComparisonTypes_t;
+using hpp::constraints::EqualToZero;
+using hpp::constraints::Implicit;
+using hpp::constraints::matrix_t;
+using hpp::constraints::size_type;
+using hpp::constraints::vector_t;
+using hpp::constraints::solver::HierarchicalIterative;
+using hpp::pinocchio::LiegroupSpace;
+namespace lineSearch = hpp::constraints::solver::lineSearch;
+
+namespace {
+// Build a solver on R^nDof with nLevels priority levels, each made of a
+// random affine constraint of output size rows.
+HierarchicalIterative makeSolver(size_type nDof, size_type nLevels,
+                                 size_type rows) {
+  HierarchicalIterative solver(LiegroupSpace::Rn(nDof));
+  solver.maxIterations(40);
+  solver.errorThreshold(1e-6);
+  for (size_type i = 0; i < nLevels; ++i) {
+    matrix_t A(matrix_t::Random(rows, nDof));
+    solver.add(Implicit::create(AffineFunction::create(A),
+                                ComparisonTypes_t(rows, EqualToZero)),
+               (std::size_t)i);
+  }
+  return solver;
+}
+}  // namespace
+
+// Newton resolution for various problem sizes and stack depths.
+// range(0): number of dofs, range(1): number of priority levels.
+static void BM_solve(benchmark::State& state) {
+  srand(0);
+  const size_type nDof = state.range(0), nLevels = state.range(1);
+  HierarchicalIterative solver(makeSolver(nDof, nLevels, 3));
+  vector_t q0(vector_t::Random(nDof)), q(nDof);
+  for (auto _ : state) {
+    q = q0;
+    benchmark::DoNotOptimize(solver.solve(q, lineSearch::Constant()));
+  }
+}
+BENCHMARK(BM_solve)
+    ->Args({10, 1})
+    ->Args({10, 2})
+    ->Args({36, 1})
+    ->Args({36, 3})
+    ->Args({64, 4});
+
+// One value and Jacobian evaluation plus one descent direction, i.e.
+// the cost of a single Newton iteration without the line search.
+static void BM_oneIteration(benchmark::State& state) {
+  srand(0);
+  const size_type nDof = state.range(0), nLevels = state.range(1);
+  HierarchicalIterative solver(makeSolver(nDof, nLevels, 3));
+  vector_t q(vector_t::Random(nDof));
+  for (auto _ : state) {
+    solver.computeValue<true>(q);
+    solver.computeError();
+    benchmark::DoNotOptimize(solver.lastStep());
+  }
+}
+BENCHMARK(BM_oneIteration)->Args({36, 1})->Args({36, 3})->Args({64, 4});
+
+BENCHMARK_MAIN();
@@ -82,6 +82,15 @@ class HPP_CONSTRAINTS_DLLAPI ActiveSetDifferentiableFunction
       jacobian.middleCols(_int->first, _int->second).setZero();
   }
 
+  virtual void impl_computeValueAndJacobian(LiegroupElementRef result,
+                                            matrixOut_t jacobian,
+                                            vectorIn_t arg) const {
+    function_->valueAndJacobian(result, jacobian, arg);
+    for (segments_t::const_iterator _int = intervals_.begin();
+         _int != intervals_.end(); ++_int)
+      jacobian.middleCols(_int->first, _int->second).setZero();
+  }
+
   bool isEqual(const DifferentiableFunction& other) const {
     const ActiveSetDifferentiableFunction& castother =
         dynamic_cast<const ActiveSetDifferentiableFunction&>(other);
@@ -29,6 +29,7 @@
 #ifndef HPP_CONSTRAINTS_AFFINE_FUNCTION_HH
 #define HPP_CONSTRAINTS_AFFINE_FUNCTION_HH
 
+#include <Eigen/SparseCore>
 #include <hpp/constraints/config.hh>
 #include <hpp/constraints/differentiable-function.hh>
 #include <hpp/constraints/fwd.hh>
@@ -53,7 +54,11 @@ class HPP_CONSTRAINTS_DLLAPI Identity
   }
 
   Identity(const LiegroupSpacePtr_t space, const std::string& name)
-      : DifferentiableFunction(space->nq(), space->nv(), space, name) {}
+      : DifferentiableFunction(space->nq(), space->nv(), space, name) {
+    kind_ = IdentityKind;
+  }
+
+  bool providesJacobianOnColumns() const { return true; }
 
  protected:
   void impl_compute(LiegroupElementRef y, vectorIn_t arg) const {
@@ -62,6 +67,14 @@ class HPP_CONSTRAINTS_DLLAPI Identity
 
   void impl_jacobian(matrixOut_t J, vectorIn_t) const { J.setIdentity(); }
 
+  void impl_jacobianOnColumns(matrixOut_t J, vectorIn_t,
+                              const segments_t& cols) const {
+    J.setZero();
+    size_type c = 0;
+    for (const segment_t& s : cols)
+      for (size_type j = 0; j < s.second; ++j, ++c) J(s.first + j, c) = 1;
+  }
+
   bool isEqual(const DifferentiableFunction& other) const {
     dynamic_cast<const Identity&>(other);
     if (!DifferentiableFunction::isEqual(other)) return false;
@@ -70,7 +83,8 @@ class HPP_CONSTRAINTS_DLLAPI Identity
   }
 
  private:
-  Identity() {}
+  friend class DifferentiableFunction;
+  Identity() { kind_ = IdentityKind; }
   HPP_SERIALIZABLE();
 };  // class Identity
 
@@ -90,6 +104,8 @@ class HPP_CONSTRAINTS_DLLAPI AffineFunction : public DifferentiableFunction {
     return AffineFunctionPtr_t(new AffineFunction(J, b, name));
   }
 
+  bool providesJacobianOnColumns() const { return true; }
+
  protected:
   AffineFunction(const matrixIn_t& J, const std::string name = "LinearFunction")
       : DifferentiableFunction(J.cols(), J.cols(), LiegroupSpace::Rn(J.rows()),
@@ -127,19 +143,129 @@ class HPP_CONSTRAINTS_DLLAPI AffineFunction : public DifferentiableFunction {
 
   void impl_jacobian(matrixOut_t jacobian, vectorIn_t) const { jacobian = J_; }
 
+  void impl_jacobianOnColumns(matrixOut_t jacobian, vectorIn_t,
+                              const segments_t& cols) const {
+    size_type c = 0;
+    for (const segment_t& s : cols) {
+      jacobian.middleCols(c, s.second) = J_.middleCols(s.first, s.second);
+      c += s.second;
+    }
+  }
+
   void init() {
     assert(J_.rows() == b_.rows());
     activeParameters_ = (J_.array() != 0).colwise().any();
     activeDerivativeParameters_ = activeParameters_;
+    kind_ = AffineKind;
   }
 
   const matrix_t J_;
   const vector_t b_;
 
-  AffineFunction() {}
+  friend class DifferentiableFunction;
+  AffineFunction() { kind_ = AffineKind; }
   HPP_SERIALIZABLE();
 };  // class AffineFunction
 
+/// Sparse affine function
+/// \f$ f(q) = J * q + b \f$
+///
+/// Variant of AffineFunction for large linear couplings with few
+/// nonzero coefficients: J is stored as an Eigen::SparseMatrix, the
+/// value runs a sparse product and the Jacobian writes the stored
+/// coefficients only.
+class HPP_CONSTRAINTS_DLLAPI SparseAffineFunction
+    : public DifferentiableFunction {
+ public:
+  typedef Eigen::SparseMatrix<value_type> SparseMatrix_t;
+
+  static SparseAffineFunctionPtr_t create(
+      const SparseMatrix_t& J, const std::string name = "SparseLinearFunction") {
+    return SparseAffineFunctionPtr_t(new SparseAffineFunction(J, name));
+  }
+
+  static SparseAffineFunctionPtr_t create(
+      const SparseMatrix_t& J, const vectorIn_t& b,
+      const std::string name = "SparseLinearFunction") {
+    return SparseAffineFunctionPtr_t(new SparseAffineFunction(J, b, name));
+  }
+
+  bool providesJacobianOnColumns() const { return true; }
+
+ protected:
+  SparseAffineFunction(const SparseMatrix_t& J,
+                       const std::string name = "SparseLinearFunction")
+      : DifferentiableFunction(J.cols(), J.cols(), LiegroupSpace::Rn(J.rows()),
+                               name),
+        J_(J),
+        b_(vector_t::Zero(J.rows())) {
+    init();
+  }
+
+  SparseAffineFunction(const SparseMatrix_t& J, const vectorIn_t& b,
+                       const std::string name = "SparseLinearFunction")
+      : DifferentiableFunction(J.cols(), J.cols(), LiegroupSpace::Rn(J.rows()),
+                               name),
+        J_(J),
+        b_(b) {
+    init();
+  }
+
+  bool isEqual(const DifferentiableFunction& other) const {
+    const SparseAffineFunction& castother =
+        dynamic_cast<const SparseAffineFunction&>(other);
+    if (!DifferentiableFunction::isEqual(other)) return false;
+
+    if (J_.rows() != castother.J_.rows()) return false;
+    if (J_.cols() != castother.J_.cols()) return false;
+    if ((J_ - castother.J_).norm() != 0) return false;
+    if (b_ != castother.b_) return false;
+
+    return true;
+  }
+
+ private:
+  /// User implementation of function evaluation
+  void impl_compute(LiegroupElementRef y, vectorIn_t x) const {
+    y.vector().noalias() = J_ * x;
+    y.vector() += b_;
+  }
+
+  void impl_jacobian(matrixOut_t jacobian, vectorIn_t) const {
+    jacobian.setZero();
+    for (size_type k = 0; k < J_.outerSize(); ++k)
+      for (SparseMatrix_t::InnerIterator it(J_, k); it; ++it)
+        jacobian(it.row(), it.col()) = it.value();
+  }
+
+  void impl_jacobianOnColumns(matrixOut_t jacobian, vectorIn_t,
+                              const segments_t& cols) const {
+    jacobian.setZero();
+    size_type c = 0;
+    for (const segment_t& s : cols)
+      for (size_type j = 0; j < s.second; ++j, ++c)
+        for (SparseMatrix_t::InnerIterator it(J_, s.first + j); it; ++it)
+          jacobian(it.row(), c) = it.value();
+  }
+
+  void init() {
+    assert(J_.rows() == b_.rows());
+    activeParameters_ = ArrayXb::Constant(J_.cols(), false);
+    for (size_type k = 0; k < J_.outerSize(); ++k)
+      for (SparseMatrix_t::InnerIterator it(J_, k); it; ++it)
+        if (it.value() != 0) activeParameters_[it.col()] = true;
+    activeDerivativeParameters_ = activeParameters_;
+    kind_ = SparseAffineKind;
+  }
+
+  const SparseMatrix_t J_;
+  const vector_t b_;
+
+  friend class DifferentiableFunction;
+  SparseAffineFunction() { kind_ = SparseAffineKind; }
+  HPP_SERIALIZABLE();
+};  // class SparseAffineFunction
+
 /// Constant function
 /// \f$ f(q) = C \f$
 ///
@@ -159,25 +285,36 @@ struct HPP_CONSTRAINTS_DLLAPI ConstantFunction : public DifferentiableFunction {
         new ConstantFunction(element, sizeIn, sizeInDer, name));
   }
 
+  bool providesJacobianOnColumns() const { return true; }
+
  protected:
   ConstantFunction(const vector_t& constant, const size_type& sizeIn,
                    const size_type& sizeInDer,
                    const std::string name = "ConstantFunction")
       : DifferentiableFunction(sizeIn, sizeInDer,
                                LiegroupSpace::Rn(constant.rows()), name),
-        c_(constant, outputSpace()) {}
+        c_(constant, outputSpace()) {
+    kind_ = ConstantKind;
+  }
 
   ConstantFunction(const LiegroupElement& element, const size_type& sizeIn,
                    const size_type& sizeInDer,
                    const std::string name = "ConstantFunction")
       : DifferentiableFunction(sizeIn, sizeInDer, element.space(), name),
-        c_(element) {}
+        c_(element) {
+    kind_ = ConstantKind;
+  }
 
   /// User implementation of function evaluation
   void impl_compute(LiegroupElementRef r, vectorIn_t) const { r = c_; }
 
   void impl_jacobian(matrixOut_t J, vectorIn_t) const { J.setZero(); }
 
+  void impl_jacobianOnColumns(matrixOut_t J, vectorIn_t,
+                              const segments_t&) const {
+    J.setZero();
+  }
+
   bool isEqual(const DifferentiableFunction& other) const {
     const ConstantFunction& castother =
         dynamic_cast<const ConstantFunction&>(other);
@@ -191,7 +328,8 @@ struct HPP_CONSTRAINTS_DLLAPI ConstantFunction : public DifferentiableFunction {
   const LiegroupElement c_;
 
  private:
-  ConstantFunction() {}
+  friend class DifferentiableFunction;
+  ConstantFunction() { kind_ = ConstantKind; }
   HPP_SERIALIZABLE();
 };  // class ConstantFunction
 
@@ -143,6 +143,11 @@ class HPP_CONSTRAINTS_DLLAPI ComBetweenFeet : public DifferentiableFunction {
   mutable Traits<ScalarProduct<DiffPCPiJ, DiffPiJPiJ> >::Ptr_t xmxlDotu_,
       xmxrDotu_;
   std::vector<bool> mask_;
+  // Flattened evaluation order of the masked expression trees, compiled
+  // at construction. Value and jacobian are one pass over the tape and
+  // the sub-expressions shared between the output rows (center of mass,
+  // foot points, u) are evaluated once.
+  mutable ExpressionTape tape_;
   mutable eigen::matrix3_t cross_;
 };  // class ComBetweenFeet
 }  // namespace constraints
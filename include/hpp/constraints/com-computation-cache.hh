@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2026 CNRS
+// Authors: Florent Lamiraux
+//
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_COM_COMPUTATION_CACHE_HH
+#define HPP_CONSTRAINTS_COM_COMPUTATION_CACHE_HH
+
+#include <hpp/constraints/config.hh>
+#include <hpp/constraints/fwd.hh>
+
+namespace hpp {
+namespace constraints {
+/// \addtogroup constraints
+/// \{
+
+/// Memoized access to a CenterOfMassComputation
+///
+/// A balance stack typically contains several center of mass
+/// constraints - RelativeCom, ComBetweenFeet - built over the same
+/// kinematic subtree, and the solver evaluates all of them at every
+/// iteration. Each evaluation used to run the full mass summation
+/// again although the configuration had not changed since the previous
+/// constraint ran it.
+///
+/// An instance of this class wraps a CenterOfMassComputation and
+/// remembers the configuration and the computation flags of the last
+/// call to \ref compute; a call with the same configuration and
+/// already computed flags returns without touching the wrapped
+/// computation. Caches are shared: wrapping the same computation twice
+/// yields the same instance, so the memoization works across
+/// constraints.
+///
+/// Like the constraints using it, the cache follows the device state
+/// and is not thread safe.
+class HPP_CONSTRAINTS_DLLAPI ComComputationCache {
+ public:
+  /// Return the cache wrapping comc, creating it on first request
+  static ComComputationCachePtr_t get(const CenterOfMassComputationPtr_t& comc);
+
+  /// Return the whole body computation shared by the constraints of
+  /// robot
+  ///
+  /// The computation sums over the subtree of the root joint. It is
+  /// created on first request and kept by weak reference, so center of
+  /// mass constraints created without an explicit computation share
+  /// one mass summation per device instead of each owning their own.
+  static CenterOfMassComputationPtr_t wholeBody(const DevicePtr_t& robot);
+
+  /// Run the wrapped computation unless it is already up to date
+  ///
+  /// \param argument configuration the device is currently set to,
+  /// \param flag subset of hpp::pinocchio::Computation_t to compute.
+  void compute(ConfigurationIn_t argument,
+               const pinocchio::Computation_t& flag);
+
+  /// Forget the memoized configuration
+  ///
+  /// Call this after running the wrapped computation directly, behind
+  /// the back of the cache.
+  void invalidate() { computed_ = 0; }
+
+  /// The wrapped computation
+  const CenterOfMassComputationPtr_t& computation() const { return comc_; }
+
+ private:
+  ComComputationCache(const CenterOfMassComputationPtr_t& comc)
+      : comc_(comc), computed_(0) {}
+
+  CenterOfMassComputationPtr_t comc_;
+  /// Configuration of the last call to compute
+  Configuration_t lastConfiguration_;
+  /// Computation flags already up to date at lastConfiguration_
+  int computed_;
+};  // class ComComputationCache
+/// \}
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // HPP_CONSTRAINTS_COM_COMPUTATION_CACHE_HH
@@ -35,6 +35,7 @@
 #include <hpp/constraints/config.hh>
 #include <hpp/constraints/differentiable-function.hh>
 #include <hpp/constraints/fwd.hh>
+#include <hpp/constraints/matrix-view.hh>
 
 namespace hpp {
 namespace constraints {
@@ -69,6 +70,25 @@ class HPP_CONSTRAINTS_DLLAPI ConfigurationConstraint
 
   const LiegroupElement& goal() const { return goal_; }
 
+  /// Restrict the evaluation to a subset of the degrees of freedom
+  ///
+  /// \param dofs intervals of velocity indices, typically the free
+  ///        variables of the solver owning the constraint.
+  ///
+  /// The value accumulates the weighted difference over these
+  /// intervals only and the Jacobian is filled on the matching columns
+  /// - the other columns are set to zero. The contribution of the
+  /// remaining degrees of freedom is constant as long as they do not
+  /// move, which the caller asserts by restricting the evaluation.
+  /// Passing an empty vector of intervals restores the evaluation on
+  /// the whole configuration (the default).
+  void restrictToDofs(const segments_t& dofs);
+
+  /// Intervals the evaluation is restricted to
+  ///
+  /// Empty when the function evaluates on the whole configuration.
+  const Eigen::RowBlockIndices& restrictedDofs() const { return activeDofs_; }
+
  protected:
   /// Compute value of error
   ///
@@ -89,6 +109,7 @@ class HPP_CONSTRAINTS_DLLAPI ConfigurationConstraint
     if (robot_ != castother.robot_) return false;
     if (goal_.vector() != castother.goal_.vector()) return false;
     if (weights_ != castother.weights_) return false;
+    if (activeDofs_.rows() != castother.activeDofs_.rows()) return false;
 
     return true;
   }
@@ -98,6 +119,13 @@ class HPP_CONSTRAINTS_DLLAPI ConfigurationConstraint
   DevicePtr_t robot_;
   LiegroupElement goal_;
   vector_t weights_;
+  /// Intervals of \ref restrictToDofs, empty by default
+  Eigen::RowBlockIndices activeDofs_;
+  bool restricted_;
+  /// Difference between the goal and the argument
+  mutable vector_t diff_;
+  /// Row workspace of the restricted Jacobian
+  mutable matrix_t diffJ_;
 };  // class ConfigurationConstraint
 }  // namespace constraints
 }  // namespace hpp
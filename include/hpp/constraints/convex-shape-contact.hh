@@ -149,6 +149,25 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShapeContact
   /// Default to 0
   void setNormalMargin(const value_type& margin);
 
+  /// Set the margin of the contact-pair cache.
+  ///
+  /// When positive, selectConvexShapes first checks the pair selected
+  /// by the previous evaluation: if the object center still projects
+  /// inside the cached floor shape by more than this margin, the pair
+  /// is kept and the scan of all pairs is skipped. Between iterations
+  /// of a solver the selected pair almost never changes, so this turns
+  /// the selection from O(floors x objects) into a single distance
+  /// evaluation. When the projection drifts within the margin of the
+  /// floor boundary - where a neighboring pair could take over - the
+  /// full scan is performed. Set to zero (the default) to disable the
+  /// cache. \warning the cache is not thread safe.
+  void pairCacheMargin(const value_type& margin) {
+    assert(margin >= 0);
+    pairCacheMargin_ = margin;
+  }
+  /// Get the margin of the contact-pair cache.
+  const value_type& pairCacheMargin() const { return pairCacheMargin_; }
+
   /// Compute the contact points
   std::vector<ForceData> computeContactPoints(
       ConfigurationIn_t q, const value_type& normalMargin) const;
@@ -234,6 +253,34 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShapeContact
                                bool& isInside, ContactType& type,
                                matrix_t& jacobian) const;
 
+  /// Fused evaluation: the forward kinematics, the shape-pair
+  /// selection and the intermediate error terms are computed only
+  /// once for the value and the Jacobian.
+  void impl_computeValueAndJacobian(LiegroupElementRef result,
+                                    matrixOut_t jacobian,
+                                    ConfigurationIn_t argument) const;
+  void computeInternalValueAndJacobian(const ConfigurationIn_t& argument,
+                                       bool& isInside, ContactType& type,
+                                       vector6_t& value, matrix_t& jacobian,
+                                       std::size_t& iobject,
+                                       std::size_t& ifloor) const;
+
+  /// Map the internal 6d error onto the output of the function.
+  void assembleValue(bool isInside, ContactType type, const vector6_t& value,
+                     LiegroupElementRef result) const;
+  /// Map the internal 6d Jacobian onto the output of the function.
+  void assembleJacobian(bool isInside, ContactType type, const matrix_t& tmpJac,
+                        matrixOut_t jacobian) const;
+
+  /// \ref selectConvexShapes with a configuration stamp: when called
+  /// again on the configuration of the previous evaluation - as by the
+  /// Jacobian pass following the value pass - the selection is reused
+  /// instead of scanning all pairs again.
+  bool selectConvexShapesStamped(const ConfigurationIn_t& argument,
+                                 const pinocchio::DeviceData& data,
+                                 std::size_t& iobject,
+                                 std::size_t& ifloor) const;
+
   /// Find floor and object surfaces that are the closest.
   /// \retval iobject, ifloor indices in internal vectors
   ///         objectConvexShapes_ and floorConvexShapes_
@@ -248,11 +295,29 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShapeContact
 
   ConvexShapes_t objectConvexShapes_;
   ConvexShapes_t floorConvexShapes_;
+  /// For each floor shape, an upper bound of the distance between its
+  /// center and its vertices, used to prune pairs in
+  /// selectConvexShapes before any narrow-phase computation.
+  std::vector<value_type> floorRadii_;
 
   value_type normalMargin_;
   // upper bound of distance between center of polygon and vectices for
   // all floor polygons.
   value_type M_;
+  value_type pairCacheMargin_;
+  /// Pair selected by the previous evaluation, checked first by
+  /// selectConvexShapes when the cache is enabled.
+  mutable std::size_t cachedObject_, cachedFloor_;
+  mutable bool cachedPairValid_;
+  /// Configuration-stamped result of the shape-pair selection: when
+  /// value and Jacobian are evaluated on the same configuration - as
+  /// in every solver iteration - the second pass reuses the selection
+  /// of the first instead of scanning all pairs again.
+  /// \warning like the pair cache above, not thread safe.
+  mutable vector_t selectionArg_;
+  mutable std::size_t selectedObject_, selectedFloor_;
+  mutable bool selectedIsInside_;
+  mutable bool selectionValid_;
 };
 
 /** Complement to full transformation constraint of ConvexShapeContact
@@ -333,6 +398,12 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShapeContactComplement
 
   void impl_jacobian(matrixOut_t jacobian, ConfigurationIn_t argument) const;
 
+  /// Fused evaluation through the fused internal computation of the
+  /// sibling.
+  void impl_computeValueAndJacobian(LiegroupElementRef result,
+                                    matrixOut_t jacobian,
+                                    ConfigurationIn_t argument) const;
+
   ConvexShapeContactPtr_t sibling_;
 };  // class ConvexShapeContactComplement
 
@@ -389,6 +460,9 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShapeContactHold
   virtual void impl_compute(LiegroupElementRef result,
                             vectorIn_t argument) const;
   virtual void impl_jacobian(matrixOut_t jacobian, vectorIn_t arg) const;
+  virtual void impl_computeValueAndJacobian(LiegroupElementRef result,
+                                            matrixOut_t jacobian,
+                                            vectorIn_t argument) const;
 
   bool isEqual(const DifferentiableFunction& other) const;
 
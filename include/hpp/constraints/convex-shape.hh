@@ -115,33 +115,42 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShape {
   }
 
   /// As isInside but consider A as expressed in joint frame.
+  ///
+  /// The test is evaluated over all edges at once on the
+  /// structure-of-arrays edge data built by \ref init.
   inline bool isInsideLocal(const vector3_t& Ap) const {
     assert(shapeDimension_ > 2);
-    for (std::size_t i = 0; i < shapeDimension_; ++i) {
-      if (Ns_[i].dot(Ap - Pts_[i]) > 0) return false;
-    }
-    return true;
+    // Edge i separates Ap when Ns_[i].dot(Ap - Pts_[i]) > 0.
+    return ((eNs_ * Ap).array() <= eNdotP_.array()).all();
   }
 
   /// Return the shortest distance from a point to the shape
   /// A negative value means the point is inside the shape
   /// \param a a point already in the plane containing the convex shape,
   ///        and expressed in the local frame.
+  ///
+  /// The per edge distances are computed over all edges at once on the
+  /// structure-of-arrays edge data built by \ref init. \ref dist
+  /// documents the scalar computation performed for one edge.
   inline value_type distanceLocal(const vector3_t& a) const {
     assert(shapeDimension_ > 1);
+    typedef Eigen::Array<value_type, Eigen::Dynamic, 1> array_t;
+    // With w_i = a - Pts_[i]:
+    // c1_i = Us_[i].dot(w_i), un_i = Ns_[i].dot(w_i), wsq_i = ||w_i||^2.
+    const array_t c1((eUs_ * a).array() - eUdotP_.array());
+    const array_t un((eNs_ * a).array() - eNdotP_.array());
+    const array_t wsq(a.squaredNorm() - 2 * (ePts_ * a).array() +
+                      ePsq_.array());
+    // Squared distance to the end point of edge i:
+    // ||w_i - Ls_[i] * Us_[i]||^2 = wsq_i - Ls_[i] * (2 c1_i - Ls_[i]).
+    const array_t endSq((wsq - eLs_.array() * (2 * c1 - eLs_.array())).max(0.));
+    array_t d((c1 <= 0)
+                  .select(wsq.max(0.).sqrt(),
+                          (eLs_.array() <= c1).select(endSq.sqrt(), un.abs())));
+    d = (un > 0).select(d, -d);
     const value_type inf = std::numeric_limits<value_type>::infinity();
-    value_type minPosDist = inf, maxNegDist = -inf;
-    bool outside = false;
-    for (std::size_t i = 0; i < shapeDimension_; ++i) {
-      value_type d = dist(a - Pts_[i], Ls_[i], Us_[i], Ns_[i]);
-      if (d > 0) {
-        outside = true;
-        if (d < minPosDist) minPosDist = d;
-      }
-      if (d <= 0 && d > maxNegDist) maxNegDist = d;
-    }
-    if (outside) return minPosDist;
-    return maxNegDist;
+    if ((d > 0).any()) return (d > 0).select(d, inf).minCoeff();
+    return d.maxCoeff();
   }
 
   /// Return the X axis of the plane in the joint frame
@@ -192,9 +201,24 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShape {
   JointPtr_t joint_;
 
  private:
+  typedef Eigen::Matrix<value_type, Eigen::Dynamic, 3> edgeMatrix_t;
+
+  /// Edge data in structure-of-arrays layout, derived from Pts_, Ns_,
+  /// Us_ and Ls_ by \ref buildEdgeData. Row i of ePts_ (resp. eNs_,
+  /// eUs_) is Pts_[i] (resp. Ns_[i], Us_[i]), so each coordinate is
+  /// stored in a contiguous column. eNdotP_, eUdotP_ and ePsq_ hold
+  /// Ns_[i].dot(Pts_[i]), Us_[i].dot(Pts_[i]) and Pts_[i].squaredNorm().
+  /// The arrays are padded with copies of edge 0 to a multiple of four
+  /// rows so that Eigen processes them with full SIMD packets;
+  /// duplicated edges do not change the result of the reductions.
+  edgeMatrix_t ePts_, eNs_, eUs_;
+  vector_t eNdotP_, eUdotP_, ePsq_, eLs_;
+
   /// Return the distance between the point A and the segment
   /// [P, c2*v] oriented by u.
   /// w = PA.
+  /// \note kept as the scalar reference of the vectorized computation
+  ///       performed by \ref distanceLocal.
   inline value_type dist(const vector3_t& w, const value_type& c2,
                          const vector3_t& v, const vector3_t& u) const {
     value_type c1;
@@ -287,6 +311,35 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShape {
     MinJoint_.rotation().col(0) = N_;
     MinJoint_.rotation().col(1) = Ns_[0];
     MinJoint_.rotation().col(2) = Us_[0];
+
+    buildEdgeData();
+  }
+
+  /// Build the structure-of-arrays edge data used by the vectorized
+  /// isInsideLocal and distanceLocal.
+  void buildEdgeData() {
+    const std::size_t n = Ns_.size();
+    const std::size_t m = ((n + 3) / 4) * 4;
+    ePts_.resize(m, 3);
+    eNs_.resize(m, 3);
+    eUs_.resize(m, 3);
+    eNdotP_.resize(m);
+    eUdotP_.resize(m);
+    ePsq_.resize(m);
+    eLs_.resize(m);
+    for (std::size_t i = 0; i < m; ++i) {
+      // Pad with copies of edge 0 beyond the real edges.
+      const std::size_t j = (i < n) ? i : 0;
+      ePts_.row(i) = Pts_[j].transpose();
+      eNs_.row(i) = Ns_[j].transpose();
+      eUs_.row(i) = Us_[j].transpose();
+      eNdotP_[i] = Ns_[j].dot(Pts_[j]);
+      eUdotP_[i] = Us_[j].dot(Pts_[j]);
+      ePsq_[i] = Pts_[j].squaredNorm();
+      // For a single point Ls_ is empty; the edge then degenerates to
+      // its origin.
+      eLs_[i] = (j < (std::size_t)Ls_.size()) ? Ls_[j] : 0;
+    }
   }
 };
 
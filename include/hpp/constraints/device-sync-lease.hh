@@ -0,0 +1,95 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_DEVICE_SYNC_LEASE_HH
+#define HPP_CONSTRAINTS_DEVICE_SYNC_LEASE_HH
+
+#include <hpp/constraints/config.hh>
+#include <hpp/constraints/fwd.hh>
+#include <hpp/pinocchio/device-sync.hh>
+
+namespace hpp {
+namespace constraints {
+/// \addtogroup constraints
+/// \{
+
+/// Thread-local lease on the internal data of a device.
+///
+/// Evaluating a constraint acquires a hpp::pinocchio::DeviceData from
+/// the pool of its device and releases it afterwards. When many
+/// constraints are evaluated from many threads - as in each iteration
+/// of solver::HierarchicalIterative::solve - the pool lock becomes a
+/// contention point.
+///
+/// While an instance of this class is alive, every constraint
+/// evaluation performed by the current thread on \c device reuses its
+/// single acquisition:
+/// \code
+/// DeviceSyncLease lease(robot);
+/// solver.solve(q); // All constraint evaluations share one DeviceData.
+/// \endcode
+/// Leases on different devices may be nested. A lease must be destroyed
+/// by the thread that created it, in reverse order of creation.
+class HPP_CONSTRAINTS_DLLAPI DeviceSyncLease {
+ public:
+  DeviceSyncLease(const DevicePtr_t& device);
+
+  ~DeviceSyncLease();
+
+  /// Lease held by the current thread on \c device.
+  /// \return NULL when the current thread holds no lease on \c device.
+  static DeviceSyncLease* get(const DevicePtr_t& device);
+
+  /// Synchronized device of this lease.
+  pinocchio::DeviceSync& sync() { return sync_; }
+
+  /// Set the current configuration of the leased data and recompute the
+  /// forward kinematics.
+  ///
+  /// The computation is skipped when the leased data is already at
+  /// \c config, so evaluating several constraints on the same device at
+  /// the same configuration - as each computeValue sweep of
+  /// solver::HierarchicalIterative does - runs it only once.
+  void computeForwardKinematics(vectorIn_t config);
+
+ private:
+  DeviceSyncLease(const DeviceSyncLease&);
+  DeviceSyncLease& operator=(const DeviceSyncLease&);
+
+  pinocchio::DeviceSync sync_;
+  DevicePtr_t device_;
+  DeviceSyncLease* previous_;
+  /// Configuration for which the forward kinematics of the leased data
+  /// were last computed.
+  vector_t lastConfig_;
+  bool lastConfigValid_;
+};  // class DeviceSyncLease
+/// \}
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // HPP_CONSTRAINTS_DEVICE_SYNC_LEASE_HH
@@ -41,6 +41,11 @@ namespace constraints {
 /// Set of differentiable functions
 ///
 /// This class also handles selection of cols of the output matrix.
+///
+/// The output value and Jacobian passed by the caller form the only
+/// storage: each member function evaluates directly into its row block
+/// of them, so stacking functions adds no intermediate buffer nor
+/// gather copy.
 class HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionSet
     : public DifferentiableFunction {
  public:
@@ -76,7 +81,6 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionSet
           activeDerivativeParameters_ || func->activeDerivativeParameters();
     }
     functions_.push_back(func);
-    result_.push_back(LiegroupElement(func->outputSpace()));
     *outputSpace_ *= func->outputSpace();
   }
 
@@ -90,6 +94,37 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionSet
 
   /// \}
 
+  /// \name Parallel evaluation
+  /// \{
+
+  /// Evaluate the member functions concurrently.
+  ///
+  /// The output row blocks of the members are disjoint so their
+  /// results need no synchronization, but every member must be safe to
+  /// evaluate concurrently with the others: functions accessing a
+  /// robot acquire their own pinocchio::DeviceData through
+  /// pinocchio::DeviceSync, so Device::numberDeviceData should be at
+  /// least \c nbThreads.
+  ///
+  /// \param nbThreads number of persistent worker threads; 0 and 1
+  ///        restore the sequential evaluation (the default). When a
+  ///        global TaskExecutor is installed the evaluation runs
+  ///        through it and \c nbThreads only enables the mode.
+  void parallelEvaluation(std::size_t nbThreads);
+  std::size_t parallelEvaluation() const;
+
+  /// \}
+
+  /// The set supports the column restricted Jacobian evaluation when
+  /// every member does.
+  bool providesJacobianOnColumns() const {
+    if (functions_.empty()) return false;
+    for (Functions_t::const_iterator _f = functions_.begin();
+         _f != functions_.end(); ++_f)
+      if (!(*_f)->providesJacobianOnColumns()) return false;
+    return true;
+  }
+
   std::ostream& print(std::ostream& os) const;
 
   /// Constructor
@@ -102,20 +137,29 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionSet
 
  protected:
   void impl_compute(LiegroupElementRef result, ConfigurationIn_t arg) const {
+    if (evaluator_ && functions_.size() > 1) {
+      implComputeParallel(result, arg);
+      return;
+    }
     size_type row = 0;
-    std::size_t i = 0;
     for (Functions_t::const_iterator _f = functions_.begin();
          _f != functions_.end(); ++_f) {
       const DifferentiableFunction& f = **_f;
-      f.impl_compute(result_[i], arg);
-      assert(hpp::pinocchio::checkNormalized(result_[i]));
-      result.vector().segment(row, f.outputSize()) = result_[i].vector();
+      // Each member writes its row block of the output vector in place,
+      // there is no per-function buffer to gather afterwards.
+      LiegroupElementRef slice(result.vector().segment(row, f.outputSize()),
+                               f.outputSpace());
+      f.impl_compute(slice, arg);
+      assert(hpp::pinocchio::checkNormalized(slice));
       row += f.outputSize();
-      ++i;
     }
     assert(hpp::pinocchio::checkNormalized(result));
   }
   void impl_jacobian(matrixOut_t jacobian, ConfigurationIn_t arg) const {
+    if (evaluator_ && functions_.size() > 1) {
+      implJacobianParallel(jacobian, arg);
+      return;
+    }
     size_type row = 0;
     for (Functions_t::const_iterator _f = functions_.begin();
          _f != functions_.end(); ++_f) {
@@ -124,6 +168,39 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionSet
       row += f.outputDerivativeSize();
     }
   }
+  void impl_jacobianOnColumns(matrixOut_t jacobian, vectorIn_t arg,
+                              const segments_t& cols) const {
+    size_type row = 0;
+    for (Functions_t::const_iterator _f = functions_.begin();
+         _f != functions_.end(); ++_f) {
+      const DifferentiableFunction& f = **_f;
+      f.impl_jacobianOnColumns(
+          jacobian.middleRows(row, f.outputDerivativeSize()), arg, cols);
+      row += f.outputDerivativeSize();
+    }
+  }
+
+  void impl_computeValueAndJacobian(LiegroupElementRef result,
+                                    matrixOut_t jacobian,
+                                    ConfigurationIn_t arg) const {
+    if (evaluator_ && functions_.size() > 1) {
+      implComputeValueAndJacobianParallel(result, jacobian, arg);
+      return;
+    }
+    size_type row = 0, jRow = 0;
+    for (Functions_t::const_iterator _f = functions_.begin();
+         _f != functions_.end(); ++_f) {
+      const DifferentiableFunction& f = **_f;
+      LiegroupElementRef slice(result.vector().segment(row, f.outputSize()),
+                               f.outputSpace());
+      f.impl_computeValueAndJacobian(
+          slice, jacobian.middleRows(jRow, f.outputDerivativeSize()), arg);
+      assert(hpp::pinocchio::checkNormalized(slice));
+      row += f.outputSize();
+      jRow += f.outputDerivativeSize();
+    }
+    assert(hpp::pinocchio::checkNormalized(result));
+  }
 
   bool isEqual(const DifferentiableFunction& other) const {
     const DifferentiableFunctionSet& castother =
@@ -131,16 +208,23 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionSet
     if (!DifferentiableFunction::isEqual(other)) return false;
 
     if (functions_ != castother.functions_) return false;
-    if (result_.size() != castother.result_.size()) return false;
-    for (std::size_t i = 0; i < result_.size(); i++)
-      if (result_[i] != castother.result_[i]) return false;
 
     return true;
   }
 
  private:
+  void implComputeParallel(LiegroupElementRef result,
+                           ConfigurationIn_t arg) const;
+  void implJacobianParallel(matrixOut_t jacobian, ConfigurationIn_t arg) const;
+  void implComputeValueAndJacobianParallel(LiegroupElementRef result,
+                                           matrixOut_t jacobian,
+                                           ConfigurationIn_t arg) const;
+
   Functions_t functions_;
-  mutable std::vector<LiegroupElement> result_;
+  /// Executor running the members, set by parallelEvaluation: the
+  /// global TaskExecutor when one is installed, a built-in pool
+  /// otherwise.
+  mutable TaskExecutorPtr_t evaluator_;
 };  // class DifferentiableFunctionSet
 /// \}
 }  // namespace constraints
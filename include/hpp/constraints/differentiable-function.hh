@@ -62,34 +62,102 @@ namespace constraints {
 /// method \link DifferentiableFunction::jacobian jacobian \endlink.
 class HPP_CONSTRAINTS_DLLAPI DifferentiableFunction {
  public:
+  /// Closed set of builtin function kinds.
+  ///
+  /// The evaluation methods called from the solver inner loops -
+  /// \ref value, \ref jacobian, \ref valueAndJacobian and
+  /// \ref jacobianOnColumns - switch on this tag and call the
+  /// implementation of the trivial builtin functions directly, so that
+  /// their bodies are inlined instead of going through a virtual call.
+  /// Classes outside this set keep GenericKind and the virtual
+  /// dispatch.
+  enum Kind {
+    GenericKind,
+    IdentityKind,
+    AffineKind,
+    SparseAffineKind,
+    ConstantKind
+  };
+
   virtual ~DifferentiableFunction() {}
 
-  /// Evaluate the function at a given parameter.
+  /// Builtin kind of this function, see \ref Kind.
+  Kind kind() const { return kind_; }
+
+  /// Evaluate the function at a given parameter, returning the result
+  /// by value.
   ///
+  /// Convenience form that allocates a fresh LiegroupElement per call.
+  /// Keep it for cold paths; in loops, prefer \ref value with a result
+  /// owned by the caller and reused across iterations.
   /// \note parameters should be of the correct size.
   LiegroupElement operator()(vectorIn_t argument) const {
     assert(argument.size() == inputSize());
     LiegroupElement result(outputSpace_);
-    impl_compute(result, argument);
+    value(result, argument);
     return result;
   }
   /// Evaluate the function at a given parameter.
   ///
+  /// This is the primary evaluation entry point: the result is written
+  /// into a caller-owned element, so repeated evaluations allocate
+  /// nothing.
+  /// \retval result element of the output space, see \ref outputSpace.
   /// \note parameters should be of the correct size.
-  void value(LiegroupElementRef result, vectorIn_t argument) const {
-    assert(result.space()->nq() == outputSize());
-    assert(argument.size() == inputSize());
-    impl_compute(result, argument);
-  }
+  void value(LiegroupElementRef result, vectorIn_t argument) const;
   /// Computes the jacobian.
   ///
   /// \retval jacobian jacobian will be stored in this argument
   /// \param argument point at which the jacobian will be computed
-  void jacobian(matrixOut_t jacobian, vectorIn_t argument) const {
-    assert(argument.size() == inputSize());
-    assert(jacobian.rows() == outputDerivativeSize());
-    assert(jacobian.cols() == inputDerivativeSize());
-    impl_jacobian(jacobian, argument);
+  void jacobian(matrixOut_t jacobian, vectorIn_t argument) const;
+
+  /// Evaluate the function and compute its jacobian in a single call.
+  ///
+  /// Equivalent to calling \ref value and \ref jacobian successively,
+  /// but classes whose two evaluations share intermediate computations
+  /// - such as GenericTransformation, where both require the forward
+  /// kinematics - override impl_computeValueAndJacobian to compute them
+  /// only once.
+  /// \retval result value of the function
+  /// \retval jacobian jacobian of the function
+  /// \param argument point at which the function is evaluated
+  void valueAndJacobian(LiegroupElementRef result, matrixOut_t jacobian,
+                        vectorIn_t argument) const;
+
+  /// Whether \ref jacobianOnColumns is implemented.
+  ///
+  /// When true, the solvers may ask for the Jacobian restricted to a
+  /// subset of input columns instead of materializing the full width
+  /// matrix and compressing it afterwards.
+  virtual bool providesJacobianOnColumns() const { return false; }
+
+  /// Jacobian restricted to a subset of input columns.
+  ///
+  /// \retval jacobian matrix with one column per kept input derivative,
+  ///         in the order of cols. Implementations write every
+  ///         coefficient of the matrix.
+  /// \param argument point at which the function is evaluated
+  /// \param cols intervals of input derivative indices to keep, sorted
+  ///        and disjoint.
+  /// \warning only valid when \ref providesJacobianOnColumns returns
+  ///          true.
+  void jacobianOnColumns(matrixOut_t jacobian, vectorIn_t argument,
+                         const segments_t& cols) const;
+
+  /// Evaluate the function at each column of \c arguments.
+  ///
+  /// Useful for path validation, where the same function is evaluated
+  /// on hundreds of samples of a path. The default implementation loops
+  /// over \ref value; classes able to factor work across samples - such
+  /// as GenericTransformation, which then acquires its device data only
+  /// once - override impl_computeBatch.
+  /// \retval results matrix of function values, one column per sample
+  /// \param arguments matrix of configurations, one column per sample
+  void valueBatch(matrixOut_t results, matrixIn_t arguments) const {
+    assert(results.rows() == outputSize());
+    assert(arguments.rows() == inputSize());
+    assert(results.cols() == arguments.cols());
+    impl_computeBatch(results, arguments);
   }
 
   /// Returns a vector of booleans that indicates whether the corresponding
@@ -135,12 +203,22 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunction {
   ///              the configuration space is considered a vector space.
   /// \param eps refers to \f$\epsilon\f$ in
   ///            http://en.wikipedia.org/wiki/Numerical_differentiation
+  /// \param nbThreads number of threads perturbing dofs concurrently;
+  ///              0 and 1 keep the sequential loop. The dof columns are
+  ///              independent, but every evaluation of this function
+  ///              must then be safe to run concurrently with the
+  ///              others: functions accessing a robot acquire their own
+  ///              pinocchio::DeviceData through pinocchio::DeviceSync,
+  ///              so Device::numberDeviceData should be at least
+  ///              \c nbThreads. When a global TaskExecutor is
+  ///              installed the columns run through it and
+  ///              \c nbThreads only enables the mode.
   /// Evaluate the function (x.size() + 1) times but less precise the
   /// finiteDifferenceCentral
   void finiteDifferenceForward(
       matrixOut_t jacobian, vectorIn_t arg, DevicePtr_t robot = DevicePtr_t(),
-      value_type eps =
-          std::sqrt(Eigen::NumTraits<value_type>::epsilon())) const;
+      value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon()),
+      std::size_t nbThreads = 1) const;
 
   /// Approximate the jacobian using forward finite difference.
   /// \retval jacobian jacobian will be stored in this argument
@@ -149,9 +227,36 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunction {
   ///              the configuration space is considered a vector space.
   /// \param eps refers to \f$\epsilon\f$ in
   ///            http://en.wikipedia.org/wiki/Numerical_differentiation
+  /// \param nbThreads number of threads perturbing dofs concurrently,
+  ///              see \ref finiteDifferenceForward.
   /// Evaluate the function 2*x.size() times but more precise the
   /// finiteDifferenceForward
   void finiteDifferenceCentral(
+      matrixOut_t jacobian, vectorIn_t arg, DevicePtr_t robot = DevicePtr_t(),
+      value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon()),
+      std::size_t nbThreads = 1) const;
+
+  /// Approximate the jacobian using central finite difference, with
+  /// all the perturbed points evaluated in one \ref valueBatch call.
+  ///
+  /// Functions overriding impl_computeBatch - such as
+  /// GenericTransformation, which acquires its device data once for
+  /// all the samples - factor work across the perturbed points; for
+  /// the others this is equivalent to \ref finiteDifferenceCentral.
+  /// \retval jacobian jacobian will be stored in this argument
+  /// \param arg point at which the jacobian will be computed
+  /// \param robot use to add configuration and velocities. If set to NULL,
+  ///              the configuration space is considered a vector space.
+  /// \param eps refers to \f$\epsilon\f$ in
+  ///            http://en.wikipedia.org/wiki/Numerical_differentiation
+  void finiteDifferenceCentralBatch(
+      matrixOut_t jacobian, vectorIn_t arg, DevicePtr_t robot = DevicePtr_t(),
+      value_type eps =
+          std::sqrt(Eigen::NumTraits<value_type>::epsilon())) const;
+
+  /// Same as \ref finiteDifferenceCentralBatch with the forward finite
+  /// difference scheme of \ref finiteDifferenceForward.
+  void finiteDifferenceForwardBatch(
       matrixOut_t jacobian, vectorIn_t arg, DevicePtr_t robot = DevicePtr_t(),
       value_type eps =
           std::sqrt(Eigen::NumTraits<value_type>::epsilon())) const;
@@ -203,6 +308,36 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunction {
 
   virtual void impl_jacobian(matrixOut_t jacobian, vectorIn_t arg) const = 0;
 
+  /// User implementation of the batch evaluation.
+  /// The default implementation evaluates each column separately.
+  virtual void impl_computeBatch(matrixOut_t results,
+                                 matrixIn_t arguments) const {
+    LiegroupElement result(outputSpace_);
+    for (size_type j = 0; j < arguments.cols(); ++j) {
+      impl_compute(result, arguments.col(j));
+      results.col(j) = result.vector();
+    }
+  }
+
+  /// User implementation of the column restricted Jacobian. Only
+  /// called when providesJacobianOnColumns returns true.
+  virtual void impl_jacobianOnColumns(matrixOut_t /*jacobian*/,
+                                      vectorIn_t /*argument*/,
+                                      const segments_t& /*cols*/) const {
+    assert(false && "providesJacobianOnColumns returned true but "
+                    "impl_jacobianOnColumns is not implemented");
+  }
+
+  /// User implementation of the fused evaluation.
+  /// The default implementation falls back to separate calls to
+  /// impl_compute and impl_jacobian.
+  virtual void impl_computeValueAndJacobian(LiegroupElementRef result,
+                                            matrixOut_t jacobian,
+                                            vectorIn_t argument) const {
+    impl_compute(result, argument);
+    impl_jacobian(jacobian, argument);
+  }
+
   virtual bool isEqual(const DifferentiableFunction& other) const {
     if (name_ != other.name_) return false;
     if (inputSize_ != other.inputSize_) return false;
@@ -228,6 +363,11 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunction {
   /// \sa activeDerivativeParameters
   ArrayXb activeDerivativeParameters_;
 
+  /// Initialized to GenericKind by this class. The builtin function
+  /// classes set their own tag in their constructors.
+  /// \sa Kind
+  Kind kind_;
+
  private:
   std::string name_;
   /// Context of creation of function
@@ -236,7 +376,7 @@ class HPP_CONSTRAINTS_DLLAPI DifferentiableFunction {
   friend class DifferentiableFunctionSet;
 
  protected:
-  DifferentiableFunction() {}
+  DifferentiableFunction() : kind_(GenericKind) {}
 
  private:
   HPP_SERIALIZABLE();
@@ -245,6 +385,34 @@ inline std::ostream& operator<<(std::ostream& os,
                                 const DifferentiableFunction& f) {
   return f.print(os);
 }
+
+/// Content addressed registry of differentiable functions
+///
+/// Serialized constraints typically reference the same few functions,
+/// but pointer identity only survives within one archive: after loading
+/// a roadmap, every edge owns its own copy of the same
+/// GenericTransformation. Passing each loaded function through
+/// \ref dedupe returns a single shared instance per function content
+/// (in the sense of DifferentiableFunction::operator==), so equal
+/// functions are shared again and evaluation caches keyed on function
+/// pointers work across constraints.
+///
+/// The registry keeps weak references only and does not extend the
+/// lifetime of the functions it returns. It is used by the
+/// deserialization of Implicit and by the interning create methods of
+/// GenericTransformation and Implicit.
+class HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionRegistry {
+ public:
+  /// Return the registered function equal to f
+  ///
+  /// Registers f and returns it when no equal function is known.
+  /// Thread safe. Expired entries are pruned as they are encountered.
+  static DifferentiableFunctionPtr_t dedupe(
+      const DifferentiableFunctionPtr_t& f);
+
+  /// Drop every registered function
+  static void clear();
+};  // class DifferentiableFunctionRegistry
 /// \}
 }  // namespace constraints
 }  // namespace hpp
@@ -75,6 +75,21 @@ class HPP_CONSTRAINTS_DLLAPI DistanceBetweenBodies
 
   virtual ~DistanceBetweenBodies() {}
 
+  /// Set the tolerance of the temporal-coherence cache.
+  ///
+  /// When positive, the narrow-phase distance query is skipped as long
+  /// as a conservative bound on the displacement of the two bodies
+  /// since the last query stays below this tolerance. The cached value
+  /// and witness points are then reused; the returned distance may
+  /// differ from the exact one by at most the tolerance. Set to zero
+  /// (the default) to disable the cache.
+  void cacheTolerance(const value_type& tolerance) {
+    assert(tolerance >= 0);
+    cacheTolerance_ = tolerance;
+  }
+  /// Get the tolerance of the temporal-coherence cache.
+  const value_type& cacheTolerance() const { return cacheTolerance_; }
+
  protected:
   /// Protected constructor
   ///
@@ -115,6 +130,10 @@ class HPP_CONSTRAINTS_DLLAPI DistanceBetweenBodies
  private:
   typedef ::pinocchio::GeometryData GeometryData;
 
+  /// Conservative bound on the displacement of both bodies since the
+  /// last narrow-phase query, used by the temporal-coherence cache.
+  value_type displacementBound() const;
+
   DevicePtr_t robot_;
   JointPtr_t joint1_;
   JointPtr_t joint2_;
@@ -122,6 +141,13 @@ class HPP_CONSTRAINTS_DLLAPI DistanceBetweenBodies
   mutable std::size_t minIndex_;
   mutable Configuration_t latestArgument_;
   mutable LiegroupElement latestResult_;
+  value_type cacheTolerance_;
+  /// Bounds on the distance from each joint origin to any point of its
+  /// body, used by displacementBound.
+  value_type radius1_, radius2_;
+  /// Joint placements at the last narrow-phase query.
+  mutable Transform3f queryM1_, queryM2_;
+  mutable bool queryValid_;
 };  // class DistanceBetweenBodies
 }  // namespace constraints
 }  // namespace hpp
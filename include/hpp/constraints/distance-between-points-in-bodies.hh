@@ -31,6 +31,8 @@
 #ifndef HPP_CONSTRAINTS_DISTANCE_BETWEEN_POINTS_IN_BODIES_HH
 #define HPP_CONSTRAINTS_DISTANCE_BETWEEN_POINTS_IN_BODIES_HH
 
+#include <vector>
+
 #include <hpp/constraints/differentiable-function.hh>
 #include <hpp/pinocchio/liegroup-element.hh>
 
@@ -42,8 +44,13 @@ namespace constraints {
 /// This function maps to a configuration of a robot, the distance
 ///   \li either between two points in two joints
 ///   \li or between a point in a joint and a point in the environment
+///   \li or between several pairs of points in the same two joints, in
+///       which case the value is the vector of distances.
 ///
 /// The type of distance above is determined by the method "create" called.
+///
+/// The transformed points are computed once per configuration and shared
+/// between the value and the Jacobian passes.
 class HPP_CONSTRAINTS_DLLAPI DistanceBetweenPointsInBodies
     : public DifferentiableFunction {
  public:
@@ -77,6 +84,25 @@ class HPP_CONSTRAINTS_DLLAPI DistanceBetweenPointsInBodies
                                                    const vector3_t& point1,
                                                    const vector3_t& point2);
 
+  /// Create batched instance and return shared pointer
+  ///
+  /// \param name name of the constraint,
+  /// \param robot robot that own the bodies,
+  /// \param joint1 joint that holds the first points,
+  /// \param joint2 joint that holds the second points,
+  /// \param points1 points in frame of joint 1,
+  /// \param points2 points in frame of joint 2, in the same order.
+  ///
+  /// The value is the vector of distances between corresponding points.
+  /// Both joints are transformed once per configuration, so evaluating
+  /// many point pairs on the same pair of bodies costs a single forward
+  /// kinematics sweep.
+  static DistanceBetweenPointsInBodiesPtr_t create(
+      const std::string& name, const DevicePtr_t& robot,
+      const JointPtr_t& joint1, const JointPtr_t& joint2,
+      const std::vector<vector3_t>& points1,
+      const std::vector<vector3_t>& points2);
+
   virtual ~DistanceBetweenPointsInBodies() {}
 
  protected:
@@ -104,6 +130,19 @@ class HPP_CONSTRAINTS_DLLAPI DistanceBetweenPointsInBodies
                                 const vector3_t& point1,
                                 const vector3_t& point2);
 
+  /// Protected constructor
+  ///
+  /// \param name name of the constraint,
+  /// \param robot robot that own the bodies,
+  /// \param joint1 joint that holds the first points,
+  /// \param joint2 joint that holds the second points.
+  DistanceBetweenPointsInBodies(const std::string& name,
+                                const DevicePtr_t& robot,
+                                const JointPtr_t& joint1,
+                                const JointPtr_t& joint2,
+                                const std::vector<vector3_t>& points1,
+                                const std::vector<vector3_t>& points2);
+
   virtual void impl_compute(LiegroupElementRef result,
                             ConfigurationIn_t argument) const;
   virtual void impl_jacobian(matrixOut_t jacobian, ConfigurationIn_t arg) const;
@@ -116,8 +155,9 @@ class HPP_CONSTRAINTS_DLLAPI DistanceBetweenPointsInBodies
     if (robot_ != castother.robot_) return false;
     if (joint1_ != castother.joint1_) return false;
     if (joint2_ != castother.joint2_) return false;
-    if (point1_ != castother.point1_) return false;
-    if (point2_ != castother.point2_) return false;
+    if (points1_.cols() != castother.points1_.cols()) return false;
+    if (points1_ != castother.points1_) return false;
+    if (points2_ != castother.points2_) return false;
 
     return true;
   }
@@ -126,10 +166,13 @@ class HPP_CONSTRAINTS_DLLAPI DistanceBetweenPointsInBodies
   DevicePtr_t robot_;
   JointPtr_t joint1_;
   JointPtr_t joint2_;
-  vector3_t point1_;
-  vector3_t point2_;
-  mutable vector3_t global1_;
-  mutable vector3_t global2_;
+  /// One column per point pair, expressed in the joint frames.
+  matrix_t points1_;
+  matrix_t points2_;
+  /// Transformed points, valid for latestArgument_. They are shared
+  /// between the value and the Jacobian passes.
+  mutable matrix_t global1_;
+  mutable matrix_t global2_;
   mutable Configuration_t latestArgument_;
   mutable LiegroupElement latestResult_;
 };  // class DistanceBetweenPointsInBodies
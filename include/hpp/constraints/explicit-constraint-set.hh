@@ -161,6 +161,16 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
   ///       previously added functions.
   size_type add(const ExplicitPtr_t& constraint);
 
+  /// Attempt to add a range of explicit constraints
+  ///
+  /// Equivalent to calling add on each element of the range in turn,
+  /// except that the evaluation order is re-derived only once at the
+  /// end instead of once per insertion.
+  ///
+  /// \param constraints explicit constraints
+  /// \return the number of constraints that were added.
+  size_type add(const std::vector<ExplicitPtr_t>& constraints);
+
   /// Check whether an explicit numerical constraint has been added
   /// \param numericalConstraint explicit numerical constraint
   /// \return true if the constraint is in the set.
@@ -183,7 +193,8 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
         argFunction_(Eigen::VectorXi::Constant(space->nq(), -1)),
         derFunction_(Eigen::VectorXi::Constant(space->nv(), -1)),
         errorThreshold_(Eigen::NumTraits<value_type>::epsilon()),
-        errorSize_(0)
+        errorSize_(0),
+        constantsValid_(false)
         // , Jg (nv, nv)
         ,
         arg_(space->nq()),
@@ -211,6 +222,29 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
 
   /// \}
 
+  /// \name Parallel evaluation
+  /// \{
+
+  /// Evaluate independent explicit constraints concurrently in solve.
+  ///
+  /// The evaluation order is grouped into stages: a function belongs to
+  /// the stage following the last one that computes any of its inputs,
+  /// so the functions of a stage never depend on one another. With more
+  /// than one thread, solve runs each stage on a persistent worker
+  /// pool; the per-function buffers and the disjoint output segments
+  /// make the evaluations write-independent.
+  ///
+  /// \param nbThreads number of threads evaluating the functions,
+  ///        including the calling thread. 0 or 1 restores the
+  ///        sequential evaluation. When a global TaskExecutor is
+  ///        installed the stages run through it and \c nbThreads only
+  ///        enables the mode.
+  void parallelEvaluation(std::size_t nbThreads);
+  /// Number of threads evaluating the functions, 0 when sequential.
+  std::size_t parallelEvaluation() const;
+
+  /// \}
+
   /// \name Input and outputs
   /// \{
 
@@ -407,6 +441,11 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
   ///         into a vector
   vector_t rightHandSide() const;
 
+  /// Same as above, writing the right hand sides into \c rhs instead of
+  /// returning them by value.
+  /// \retval rhs vector of size \ref rightHandSideSize.
+  void getRightHandSide(vectorOut_t rhs) const;
+
   /// Get size of the right hand side
   ///
   /// See documentation of classes Implicit and Explicit for details.
@@ -414,6 +453,29 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
 
   /// \}
 
+  /// Heap footprint of the resolution buffers, in bytes per component.
+  /// See HierarchicalIterative::MemoryUsageReport for the motivation.
+  struct MemoryUsageReport {
+    MemoryUsageReport() : functionData(0), constants(0), workspaces(0) {}
+
+    /// Argument, value and Jacobian buffers of each function.
+    std::size_t functionData;
+    /// Baked outputs of the constant functions. See bakeConstants.
+    std::size_t constants;
+    /// Solve and error workspaces.
+    std::size_t workspaces;
+
+    /// Sum of all the components.
+    std::size_t total() const {
+      return functionData + constants + workspaces;
+    }
+  };
+
+  /// Walk the per-function data and the workspaces and report their
+  /// footprint. The buffers of the functions themselves are not
+  /// counted.
+  MemoryUsageReport memoryUsage() const;
+
   std::ostream& print(std::ostream& os) const;
 
  private:
@@ -441,6 +503,27 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
   void computeJacobian(const std::size_t& i, matrixOut_t J) const;
   void computeOrder(const std::size_t& iF, std::size_t& iOrder,
                     Computed_t& computed);
+  /// Insert a constraint and update the bookkeeping, without touching
+  /// the evaluation order.
+  /// \return the index of the function if the function was added,
+  /// -1 otherwise.
+  size_type addWithoutOrder(const ExplicitPtr_t& constraint);
+  /// Append the newly inserted function iF to the evaluation order.
+  ///
+  /// When no existing function depends on the new outputs - by far the
+  /// common case since constraints are usually inserted in dependency
+  /// order - the existing order stays valid and only the dependency row
+  /// of iF is computed. Otherwise falls back on recomputeOrder.
+  void updateOrder(const std::size_t& iF);
+  /// Re-derive the whole evaluation order with computeOrder.
+  void recomputeOrder();
+  /// Re-evaluate the constant-output functions into constants_, in the
+  /// row order of constantRows_. Called lazily by solve after a right
+  /// hand side update.
+  void bakeConstants() const;
+  /// Evaluate the non-constant functions stage by stage on the worker
+  /// pool. See parallelEvaluation.
+  void solveParallel(vectorOut_t arg) const;
 
   LiegroupSpacePtr_t configSpace_;
 
@@ -456,6 +539,11 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
     mutable LiegroupElement f_value, res_qout;
     // jacobian of f
     mutable matrix_t jacobian;
+    // compiled gather of the input configuration variables
+    Eigen::BlockCopyPlan inConfPlan;
+    // the function has no input: its output only depends on the right
+    // hand side. See ExplicitConstraintSet::bakeConstants.
+    bool isConstant;
   };  // struct Data
 
   RowBlockIndices inArgs_, notOutArgs_;
@@ -467,6 +555,16 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
 
   std::vector<Data> data_;
   std::vector<std::size_t> computationOrder_;
+  /// Stage of each function and, for each stage, the non-constant
+  /// functions it contains: a function is placed right after the last
+  /// stage computing one of its inputs, so the functions of a stage are
+  /// mutually independent. See parallelEvaluation.
+  std::vector<std::size_t> levels_;
+  std::vector<std::vector<std::size_t> > stages_;
+  /// Executor running the stages, set by parallelEvaluation: the
+  /// global TaskExecutor when one is installed, a built-in pool
+  /// otherwise.
+  mutable TaskExecutorPtr_t evaluator_;
   /// For each configuration variable i, argFunction_[i] is the index in
   /// data_ of the function that computes this configuration
   /// variable.
@@ -475,6 +573,15 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
   Eigen::VectorXi argFunction_, derFunction_;
   value_type errorThreshold_;
   size_type errorSize_;
+  /// Indices in data_ of the functions with no input - typically
+  /// LockedJoint - together with their coalesced output segments and
+  /// baked output values. solve writes the baked values with a single
+  /// scatter instead of evaluating these functions one by one. See
+  /// bakeConstants.
+  std::vector<std::size_t> constantFunctions_;
+  RowBlockIndices constantRows_;
+  mutable vector_t constants_;
+  mutable bool constantsValid_;
   // mutable matrix_t Jg;
   mutable vector_t arg_, diff_, diffSmall_;
 
@@ -487,7 +594,8 @@ class HPP_CONSTRAINTS_DLLAPI ExplicitConstraintSet {
         outArgs_(),
         outDers_(),
         errorThreshold_(Eigen::NumTraits<value_type>::epsilon()),
-        errorSize_(0) {}
+        errorSize_(0),
+        constantsValid_(false) {}
   /// Initialization for serialization
   void init(const LiegroupSpacePtr_t& space) {
     configSpace_ = space;
@@ -30,6 +30,7 @@
 #define HPP_CONSTRAINTS_EXPLICIT_CONVEX_SHAPE_CONTACT_HH
 
 #include <hpp/constraints/explicit.hh>
+#include <hpp/constraints/matrix-view.hh>
 #include <tuple>
 
 namespace hpp {
@@ -120,8 +121,15 @@ class HPP_CONSTRAINTS_DLLAPI ConvexShapeContact : public Explicit {
   // Store a vector of explicit relative transforms corresponding to
   // each pair (floor surface, object surface)
   std::vector<RelativePosePtr_t> pose_;
+  // Rows of the input vector of this constraint forming the input
+  // vector of each relative pose, resolved once at construction since
+  // the shape sets are immutable.
+  std::vector<Eigen::RowBlockIndices> poseInput_;
   // Number of object surfaces
   std::size_t nObjSurf_;
+  // Preallocated evaluation scratch
+  mutable vector_t qinRelPose_;
+  mutable LiegroupElement relativePoseRhs_, outputRelPose_;
   // shared pointer to itself
   ConvexShapeContactWkPtr_t weak_;
 };  // class ConvexShapeContact
@@ -136,6 +136,10 @@ class ImplicitFunction : public DifferentiableFunction {
   Eigen::RowBlockIndices outputDerivIntervals_;
   std::vector<Eigen::MatrixBlocks<false, false> > outJacobian_;
   std::vector<Eigen::MatrixBlocks<false, false> > inJacobian_;
+  /// Compiled copies of the input and output configuration intervals,
+  /// so that each evaluation runs two tight copy loops instead of
+  /// traversing the block indices.
+  Eigen::BlockCopyPlan inConfPlan_, outConfPlan_;
   mutable vector_t qIn_;
   mutable LiegroupElement f_qIn_, qOut_;
   mutable LiegroupElement result_;
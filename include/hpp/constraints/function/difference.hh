@@ -66,6 +66,20 @@ class HPP_CONSTRAINTS_LOCAL Difference
     J.middleCols(rsd_.first, rsd_.second) *= -1;
   }
 
+  /// Evaluate each operand once for both the value and the Jacobian,
+  /// so that inner functions sharing intermediate computations between
+  /// the two - such as GenericTransformation, which runs the forward
+  /// kinematics for both - run them only once per operand.
+  void impl_computeValueAndJacobian(LiegroupElementRef y, matrixOut_t J,
+                                    vectorIn_t arg) const {
+    inner_->valueAndJacobian(l_, J.middleCols(lsd_.first, lsd_.second),
+                             arg.segment(lsa_.first, lsa_.second));
+    inner_->valueAndJacobian(r_, J.middleCols(rsd_.first, rsd_.second),
+                             arg.segment(rsa_.first, rsa_.second));
+    y.vector() = l_ - r_;
+    J.middleCols(rsd_.first, rsd_.second) *= -1;
+  }
+
   bool isEqual(const DifferentiableFunction& other) const {
     const Difference& castother = dynamic_cast<const Difference&>(other);
     if (!DifferentiableFunction::isEqual(other)) return false;
@@ -78,6 +78,8 @@ class HPP_CONSTRAINTS_DLLAPI OfParameterSubset : public DifferentiableFunction {
                     const size_type& nArgs, const size_type& nDers,
                     const segment_t& inArgs, const segment_t& inDers);
 
+  // The segments are contiguous, so the views below bind to the caller
+  // buffers without copying.
   void impl_compute(LiegroupElementRef y, vectorIn_t arg) const {
     g_->value(y, arg.segment(sa_.first, sa_.second));
   }
@@ -87,6 +89,12 @@ class HPP_CONSTRAINTS_DLLAPI OfParameterSubset : public DifferentiableFunction {
                  arg.segment(sa_.first, sa_.second));
   }
 
+  void impl_computeValueAndJacobian(LiegroupElementRef y, matrixOut_t J,
+                                    vectorIn_t arg) const {
+    g_->valueAndJacobian(y, J.middleCols(sd_.first, sd_.second),
+                         arg.segment(sa_.first, sa_.second));
+  }
+
   bool isEqual(const DifferentiableFunction& other) const {
     const OfParameterSubset& castother =
         dynamic_cast<const OfParameterSubset&>(other);
@@ -87,8 +87,10 @@ HPP_PREDEF_CLASS(DistanceBetweenBodies);
 HPP_PREDEF_CLASS(DistanceBetweenPointsInBodies);
 HPP_PREDEF_CLASS(RelativeCom);
 HPP_PREDEF_CLASS(ComBetweenFeet);
+HPP_PREDEF_CLASS(ComComputationCache);
 HPP_PREDEF_CLASS(StaticStability);
 HPP_PREDEF_CLASS(QPStaticStability);
+HPP_PREDEF_CLASS(ContactWrenchCache);
 class ConvexShape;
 typedef std::vector<ConvexShape> ConvexShapes_t;
 HPP_PREDEF_CLASS(ConvexShapeContact);
@@ -97,6 +99,7 @@ HPP_PREDEF_CLASS(ConvexShapeContactHold);
 HPP_PREDEF_CLASS(ConfigurationConstraint);
 HPP_PREDEF_CLASS(Identity);
 HPP_PREDEF_CLASS(AffineFunction);
+HPP_PREDEF_CLASS(SparseAffineFunction);
 HPP_PREDEF_CLASS(ConstantFunction);
 
 typedef pinocchio::ObjectVector_t ObjectVector_t;
@@ -121,6 +124,7 @@ typedef shared_ptr<DistanceBetweenPointsInBodies>
     DistanceBetweenPointsInBodiesPtr_t;
 typedef shared_ptr<RelativeCom> RelativeComPtr_t;
 typedef shared_ptr<ComBetweenFeet> ComBetweenFeetPtr_t;
+typedef shared_ptr<ComComputationCache> ComComputationCachePtr_t;
 /// Plane polygon represented by its vertices
 /// Used to model contact surfaces for manipulation applications
 typedef std::vector<vector3_t> Shape_t;
@@ -132,9 +136,11 @@ typedef shared_ptr<ConvexShapeContactComplement>
 typedef shared_ptr<ConvexShapeContactHold> ConvexShapeContactHoldPtr_t;
 typedef shared_ptr<StaticStability> StaticStabilityPtr_t;
 typedef shared_ptr<QPStaticStability> QPStaticStabilityPtr_t;
+typedef shared_ptr<ContactWrenchCache> ContactWrenchCachePtr_t;
 typedef shared_ptr<ConfigurationConstraint> ConfigurationConstraintPtr_t;
 typedef shared_ptr<Identity> IdentityPtr_t;
 typedef shared_ptr<AffineFunction> AffineFunctionPtr_t;
+typedef shared_ptr<SparseAffineFunction> SparseAffineFunctionPtr_t;
 typedef shared_ptr<ConstantFunction> ConstantFunctionPtr_t;
 
 template <int _Options>
@@ -186,6 +192,8 @@ typedef shared_ptr<Explicit> ExplicitPtr_t;
 typedef shared_ptr<const Explicit> ExplicitConstPtr_t;
 
 class ExplicitConstraintSet;
+class TaskExecutor;
+typedef shared_ptr<TaskExecutor> TaskExecutorPtr_t;
 namespace solver {
 class HierarchicalIterative;
 class BySubstitution;
@@ -50,6 +50,13 @@ struct GenericTransformationModel {
   bool fullPos, fullOri;
   size_type rowOri;
   const size_type cols;
+  /// Velocity dofs of the kinematic chain between the two joints.
+  /// The Jacobian evaluation only assembles and multiplies these
+  /// columns; the others are zero. Updated together with the active
+  /// derivative parameters when a joint changes.
+  Eigen::ColBlockIndices support;
+
+  size_type supportCols() const { return support.nbCols(); }
 
   inline JointConstPtr_t getJoint1() const { return JointConstPtr_t(); }
   inline void setJoint1(const JointConstPtr_t&) {}
@@ -129,6 +136,14 @@ struct GenericTransformationModel<true> : GenericTransformationModel<false> {
  *
  *  For RelativeTransformationR3xSO3, OrientationSO3, the 3 last components
  *  are replaced by a quaternion.
+ *
+ *  The create methods intern their result through
+ *  DifferentiableFunctionRegistry: creating the same constraint twice
+ *  (same name, joints, frames and mask) returns one shared instance, so
+ *  planners building thousands of identical constraints share a single
+ *  set of buffers and evaluation caches. As a consequence an instance
+ *  returned by create may be referenced elsewhere and should not be
+ *  modified after creation.
  */
 template <int _Options>
 class HPP_CONSTRAINTS_DLLAPI GenericTransformation
@@ -298,6 +313,12 @@ class HPP_CONSTRAINTS_DLLAPI GenericTransformation
   /// Get position of frame 2 in joint 2
   inline const Transform3f& frame2InJoint2() const { return m_.F2inJ2; }
 
+  /// Get the robot the function is applied to
+  inline const DevicePtr_t& robot() const { return robot_; }
+
+  /// Get which components of the error vector are computed
+  inline const std::vector<bool>& mask() const { return mask_; }
+
   /// Return pair of joints the relative pose between which
   /// modifies the function value if any
   ///
@@ -345,6 +366,15 @@ class HPP_CONSTRAINTS_DLLAPI GenericTransformation
   virtual void impl_compute(LiegroupElementRef result,
                             ConfigurationIn_t argument) const;
   virtual void impl_jacobian(matrixOut_t jacobian, ConfigurationIn_t arg) const;
+  /// Fused evaluation: the forward kinematics and the intermediate terms
+  /// shared by the value and the jacobian are computed only once.
+  virtual void impl_computeValueAndJacobian(LiegroupElementRef result,
+                                            matrixOut_t jacobian,
+                                            ConfigurationIn_t arg) const;
+  /// Batch evaluation: the device data is acquired once and the
+  /// evaluation data reused across samples.
+  virtual void impl_computeBatch(matrixOut_t results,
+                                 matrixIn_t arguments) const;
 
   bool isEqual(const DifferentiableFunction& other) const {
     const GenericTransformation& castother =
@@ -352,6 +382,12 @@ class HPP_CONSTRAINTS_DLLAPI GenericTransformation
     if (!DifferentiableFunction::isEqual(other)) return false;
     if (robot_ != castother.robot_) return false;
     if (mask_ != castother.mask_) return false;
+    if (Joint::index(joint1()) != Joint::index(castother.joint1()))
+      return false;
+    if (Joint::index(joint2()) != Joint::index(castother.joint2()))
+      return false;
+    if (!(m_.F1inJ1 == castother.m_.F1inJ1)) return false;
+    if (!(m_.F2inJ2 == castother.m_.F2inJ2)) return false;
 
     return true;
   }
@@ -367,6 +403,25 @@ class HPP_CONSTRAINTS_DLLAPI GenericTransformation
   GenericTransformation() : m_(0) {}
   HPP_SERIALIZABLE();
 };  // class GenericTransformation
+
+/// Fold an output row mask into a function when natively supported.
+///
+/// GenericTransformation takes a mask at construction and never
+/// computes the discarded rows. This function rebuilds such an
+/// instance with \c mask folded into its own, so that callers that
+/// would otherwise compute the full error and zero the inactive rows
+/// afterwards - for instance before wrapping the function in an
+/// Implicit constraint - skip the corresponding kinematics work
+/// entirely.
+///
+/// \param function the function to mask,
+/// \param mask one boolean per derivative row of \c function; inactive
+///        rows are dropped from the output of the returned function.
+/// \return the masked function, \c function itself when the mask is
+///         full, or an empty pointer when the function does not
+///         support native row masking.
+HPP_CONSTRAINTS_DLLAPI DifferentiableFunctionPtr_t applyRowMask(
+    const DifferentiableFunctionPtr_t& function, const std::vector<bool>& mask);
 /// \}
 }  // namespace constraints
 }  // namespace hpp
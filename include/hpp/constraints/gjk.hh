@@ -0,0 +1,140 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_GJK_HH
+#define HPP_CONSTRAINTS_GJK_HH
+
+#include <hpp/constraints/config.hh>
+#include <hpp/constraints/convex-shape.hh>
+#include <hpp/constraints/fwd.hh>
+
+namespace hpp {
+namespace constraints {
+/// \addtogroup constraints
+/// \{
+
+/// Distance between two convex shapes by the GJK algorithm.
+///
+/// The instance keeps the separating direction and the best support
+/// vertices of the last query, so that repeated queries on the same
+/// pair of slowly moving shapes - as between Newton iterations -
+/// converge in very few support evaluations. Support evaluations walk
+/// the circularly ordered vertices of the shape from the cached vertex
+/// instead of scanning all of them, and the support direction follows
+/// the Nesterov-accelerated scheme of Montaut et al., falling back to
+/// the vanilla iteration when acceleration stops certifying progress.
+///
+/// For best warm-start behavior, keep one instance per shape pair.
+///
+/// \note the shapes handled by this library are planar polygons, for
+/// which a penetration depth is ill defined; the distance returned on
+/// overlapping shapes is 0, with coincident witness points.
+class HPP_CONSTRAINTS_DLLAPI GJK {
+ public:
+  GJK();
+
+  /// Compute the distance between two convex shapes.
+  /// \param shape1, shape2 the shapes, with vertices in their joint
+  ///        frames,
+  /// \param M1, M2 positions of the joint frames.
+  /// \return the distance between the shapes, 0 if they intersect.
+  value_type distance(const ConvexShape& shape1, const Transform3f& M1,
+                      const ConvexShape& shape2, const Transform3f& M2);
+
+  /// Compute the distance using the current placements of the shape
+  /// joints stored in \c d. Shapes not attached to a joint are taken in
+  /// world frame.
+  value_type distance(const ConvexShape& shape1, const ConvexShape& shape2,
+                      const pinocchio::DeviceData& d);
+
+  /// Witness point on the first shape of the last query, in world frame.
+  const vector3_t& witness1() const { return w1_; }
+  /// Witness point on the second shape of the last query, in world frame.
+  const vector3_t& witness2() const { return w2_; }
+  /// Number of iterations of the last query.
+  size_type iterations() const { return iterations_; }
+
+  /// Relative tolerance on the Frank-Wolfe duality gap.
+  void tolerance(const value_type& tolerance) {
+    assert(tolerance > 0);
+    tolerance_ = tolerance;
+  }
+  const value_type& tolerance() const { return tolerance_; }
+
+  void maxIterations(const size_type& iterations) {
+    assert(iterations > 0);
+    maxIterations_ = iterations;
+  }
+  const size_type& maxIterations() const { return maxIterations_; }
+
+  /// Whether support directions use Nesterov acceleration.
+  void accelerated(bool accelerated) { accelerated_ = accelerated; }
+  bool accelerated() const { return accelerated_; }
+
+ private:
+  /// A vertex of the Minkowski difference and the support points of
+  /// each shape it stems from, in world frame.
+  struct Vertex {
+    vector3_t w, p1, p2;
+  };
+
+  void support(const ConvexShape& shape1, const Transform3f& M1,
+               const ConvexShape& shape2, const Transform3f& M2,
+               const vector3_t& direction, Vertex& vertex);
+
+  /// Project the origin onto the current simplex: write the projection
+  /// into \c v, keep only the vertices of the smallest supporting
+  /// sub-simplex with their barycentric coordinates in lambda_, and set
+  /// inside_ when the origin lies inside the simplex.
+  /// \return the squared norm of \c v.
+  value_type projectOrigin(vector3_t& v);
+  value_type projectSegment(vector3_t& v);
+  value_type projectTriangle(vector3_t& v);
+  value_type projectTetrahedron(vector3_t& v);
+
+  value_type tolerance_;
+  size_type maxIterations_, iterations_;
+  bool accelerated_;
+
+  Vertex simplex_[4];
+  value_type lambda_[4];
+  int size_;
+  bool inside_;
+
+  /// Warm-start state: separating direction and support vertex indices
+  /// of the last query.
+  vector3_t direction_;
+  bool warm_;
+  std::size_t hint1_, hint2_;
+
+  vector3_t w1_, w2_;
+};  // class GJK
+/// \}
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // HPP_CONSTRAINTS_GJK_HH
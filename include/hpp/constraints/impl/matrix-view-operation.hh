@@ -235,6 +235,49 @@ HPP_EIGEN_SPECIALIZE_ASSIGN_SELECTOR(HPP_EIGEN_LHS_TPL, HPP_EIGEN_LHS_TYPE,
 #undef HPP_EIGEN_RHS_TPL
 #undef HPP_EIGEN_RHS_TYPE
 
+/** Support for matrix products
+ *
+ *  Assigning a product to a MatrixBlockView through the generic block
+ *  copy nests the product with a temporary: the whole product is
+ *  evaluated into dense storage and then scattered block by block. The
+ *  specializations below instead evaluate each destination block as the
+ *  product of the matching rows of the left operand with the matching
+ *  columns of the right one, so no temporary is allocated and each
+ *  coefficient is written once.
+ *  \warning as with noalias, the product operands must not alias the
+ *           matrix viewed by the destination. */
+namespace internal {
+#if HPP_EIGEN_USE_EVALUATOR
+template <typename Lhs, typename Rhs, int Option,
+          HPP_EIGEN_DECLARE_TEMPLATE_ARGS_MATRIX_BLOCK_VIEW>
+struct eval_matrix_block_view_to<Product<Lhs, Rhs, Option>,
+                                 HPP_EIGEN_MATRIX_BLOCK_VIEW> {
+  typedef Product<Lhs, Rhs, Option> Src;
+  typedef HPP_EIGEN_MATRIX_BLOCK_VIEW Dst;
+  static void run(const Src& src, Dst& dst) {
+    for (typename Dst::block_iterator b(dst); b.valid(); ++b)
+      dst._block(b).noalias() = src.lhs().middleRows(b.ro(), b.rs()) *
+                                src.rhs().middleCols(b.co(), b.cs());
+  }
+};
+#else   // HPP_EIGEN_USE_EVALUATOR
+// Coefficient based products are lazy and do not allocate on the
+// generic path; only GEMM products nest a temporary.
+template <typename Lhs, typename Rhs,
+          HPP_EIGEN_DECLARE_TEMPLATE_ARGS_MATRIX_BLOCK_VIEW>
+struct eval_matrix_block_view_to<GeneralProduct<Lhs, Rhs, GemmProduct>,
+                                 HPP_EIGEN_MATRIX_BLOCK_VIEW> {
+  typedef GeneralProduct<Lhs, Rhs, GemmProduct> Src;
+  typedef HPP_EIGEN_MATRIX_BLOCK_VIEW Dst;
+  static void run(const Src& src, Dst& dst) {
+    for (typename Dst::block_iterator b(dst); b.valid(); ++b)
+      dst._block(b).noalias() = src.lhs().middleRows(b.ro(), b.rs()) *
+                                src.rhs().middleCols(b.co(), b.cs());
+  }
+};
+#endif  // HPP_EIGEN_USE_EVALUATOR
+}  // namespace internal
+
 #if !HPP_EIGEN_USE_EVALUATOR
 #undef HPP_EIGEN_EVAL_TO_BODY_NORMAL
 #undef HPP_EIGEN_EVAL_TO_BODY_TRANSPOSE
@@ -129,6 +129,12 @@ class HPP_CONSTRAINTS_DLLAPI Implicit {
   virtual ImplicitPtr_t copy() const;
   /// Create a shared pointer to a new instance.
   /// \sa constructors
+  ///
+  /// Instances are interned: creating the same constraint twice (equal
+  /// function, comparison types and mask) returns one shared instance,
+  /// and equal functions are shared through
+  /// DifferentiableFunctionRegistry. Use \ref copy to obtain a private
+  /// copy before modifying a constraint after creation.
   static ImplicitPtr_t create(const DifferentiableFunctionPtr_t& func,
                               ComparisonTypes_t comp,
                               std::vector<bool> mask = std::vector<bool>());
@@ -157,6 +163,20 @@ class HPP_CONSTRAINTS_DLLAPI Implicit {
   void rightHandSideFromConfig(ConfigurationIn_t config,
                                LiegroupElementRef rhs);
 
+  /// Computes the right hand side from a function value
+  ///
+  /// Same as \ref rightHandSideFromConfig(ConfigurationIn_t,
+  /// LiegroupElementRef), with \c value = f(config) already computed by
+  /// the caller. Lets callers managing several constraints on the same
+  /// function - see
+  /// HierarchicalIterative::rightHandSideFromConfig(ConfigurationIn_t,
+  /// const std::vector<solver::HierarchicalIterative*>&) - evaluate the
+  /// function only once.
+  /// \param value value of the function.
+  /// \retval rhs right hand side as a Lie group element.
+  void rightHandSideFromValue(LiegroupElementConstRef value,
+                              LiegroupElementRef rhs);
+
   /// Check right hand side with regard to comparison types
   /// \param rhs  right hand side,
   /// \return true if right hand side is correct
@@ -230,6 +250,22 @@ class HPP_CONSTRAINTS_DLLAPI Implicit {
   /// \param s time
   vectorIn_t rightHandSideAt(const value_type& s);
 
+  /// Precompute the right hand side trajectory
+  /// \param sMin, sMax time interval over which the right hand side
+  ///        function is sampled,
+  /// \param nbSamples number of regularly spaced samples, at least 2.
+  ///
+  /// Subsequent calls to rightHandSideAt interpolate geodesically
+  /// between the two samples enclosing the input time instead of
+  /// evaluating the right hand side function. This speeds up sweeps
+  /// over many closely spaced times, typically when projecting a
+  /// time-parameterized path. The cache is dropped when the right
+  /// hand side function is changed.
+  /// \throw std::invalid_argument if the constraint has no right hand
+  ///        side function or if nbSamples is smaller than 2.
+  void precomputeRightHandSide(const value_type& sMin, const value_type& sMax,
+                               size_type nbSamples);
+
   /// \}
 
   /// Return the ComparisonType
@@ -310,6 +346,10 @@ class HPP_CONSTRAINTS_DLLAPI Implicit {
   size_type parameterSize_;
   DifferentiableFunctionPtr_t function_;
   DifferentiableFunctionPtr_t rhsFunction_;
+  // Sampled right hand side trajectory, one sample per column. Empty
+  // when precomputeRightHandSide has not been called. Not serialized.
+  value_type rhsCacheStart_, rhsCacheStep_;
+  matrix_t rhsSamples_;
   std::vector<bool> mask_;
   segments_t activeRows_;
   Eigen::RowBlockIndices inactiveRows_;
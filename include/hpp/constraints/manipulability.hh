@@ -29,6 +29,7 @@
 #ifndef HPP_CONSTRAINTS_MANIPULABILITY_HH
 #define HPP_CONSTRAINTS_MANIPULABILITY_HH
 
+#include <Eigen/Cholesky>
 #include <hpp/constraints/config.hh>
 #include <hpp/constraints/differentiable-function.hh>
 #include <hpp/constraints/fwd.hh>
@@ -85,6 +86,8 @@ class HPP_CONSTRAINTS_DLLAPI Manipulability : public DifferentiableFunction {
   Eigen::ColBlockIndices cols_;
 
   mutable matrix_t J_, J_JT_;
+  /// Preallocated decomposition of J_JT_
+  mutable Eigen::LDLT<matrix_t> ldlt_;
 };  // class Manipulability
 /// \}
 }  // namespace constraints
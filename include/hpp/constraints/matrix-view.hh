@@ -30,6 +30,7 @@
 #define HPP_CONSTRAINTS_MATRIX_VIEW_HH
 
 #include <Eigen/Core>
+#include <algorithm>
 #include <hpp/constraints/fwd.hh>
 #include <hpp/pinocchio/util.hh>
 #include <hpp/util/indent.hh>
@@ -85,6 +86,7 @@ struct BlockIndex {
   static void add(segments_t& a, const segment_t& b);
 
   /// In place addition of segments_t to segments_t.
+  /// \note assumes b is sorted; runs in O(n+m).
   static void add(segments_t& a, const segments_t& b);
 
   /// Compute the set difference between two segments.
@@ -99,9 +101,15 @@ struct BlockIndex {
   static segments_t difference(const segment_t& a, const segments_t& b);
 
   /// Compute the set difference between two vectors of segments.
-  /// \note assume a and b are sorted
+  /// \note assume a and b are sorted; runs in O(n+m).
   static segments_t difference(const segments_t& a, const segments_t& b);
 
+  /// In place variant of
+  /// \ref difference (const segments_t&, const segments_t&): a is
+  /// replaced by a minus b.
+  /// \note assume a and b are sorted
+  static void subtract(segments_t& a, const segments_t& b);
+
   /// Split a set of segment into two sets of segments
   /// \param segments input set of segments,
   /// \param cardinal cardinal of the first set of segments,
@@ -799,6 +807,126 @@ std::ostream& operator<<(std::ostream& os,
 typedef Eigen::MatrixBlocks<false, true> RowBlockIndices;
 typedef Eigen::MatrixBlocks<true, false> ColBlockIndices;
 
+/// Precompiled gather/scatter plan for a selection of rows or columns
+///
+/// The assignment operators of MatrixBlockView walk the segment vector
+/// of a MatrixBlocks and build an Eigen block per segment every time a
+/// view is evaluated. When the same selection is replayed at every
+/// iteration of a solver, the segments can instead be compiled once
+/// into a flat list of (index in full matrix, index in condensed
+/// matrix, length) runs. Contiguous segments are merged at compilation,
+/// so replaying the plan reduces to a few large block copies - a single
+/// one when the selection is contiguous.
+class BlockCopyPlan {
+ public:
+  typedef hpp::constraints::size_type size_type;
+
+  /// Maximal set of consecutive indices selected by the plan
+  struct Run {
+    /// First index in the full matrix
+    size_type full;
+    /// First index in the condensed matrix
+    size_type condensed;
+    /// Number of consecutive indices
+    size_type length;
+  };
+
+  BlockCopyPlan() : nbIndices_(0) {}
+
+  /// Constructor by a vector of segments
+  /// \param segments selected indices
+  /// \warning segments must be sorted and non overlapping
+  explicit BlockCopyPlan(const BlockIndex::segments_t& segments) {
+    compile(segments);
+  }
+
+  /// Flatten a vector of segments into runs
+  /// \param segments selected indices
+  /// \warning segments must be sorted and non overlapping
+  void compile(const BlockIndex::segments_t& segments);
+
+  /// Number of selected indices
+  const size_type& nbIndices() const { return nbIndices_; }
+
+  /// Whether the selection is a single contiguous range
+  bool contiguous() const { return runs_.size() <= 1; }
+
+  /// Copy the selected rows of the full matrix into the condensed one
+  /// \param full matrix the rows are gathered from,
+  /// \retval condensed matrix receiving the selected rows, must have
+  ///         \ref nbIndices rows.
+  template <typename Full, typename Condensed>
+  void gatherRows(const MatrixBase<Full>& full,
+                  const MatrixBase<Condensed>& condensed) const {
+    Condensed& c = const_cast<MatrixBase<Condensed>&>(condensed).derived();
+    assert(c.rows() == nbIndices_);
+    for (std::size_t i = 0; i < runs_.size(); ++i)
+      c.middleRows(runs_[i].condensed, runs_[i].length) =
+          full.middleRows(runs_[i].full, runs_[i].length);
+  }
+
+  /// Copy the condensed matrix back into the selected rows of the full
+  /// one. Unselected rows are left untouched.
+  template <typename Condensed, typename Full>
+  void scatterRows(const MatrixBase<Condensed>& condensed,
+                   const MatrixBase<Full>& full) const {
+    Full& f = const_cast<MatrixBase<Full>&>(full).derived();
+    assert(condensed.rows() == nbIndices_);
+    for (std::size_t i = 0; i < runs_.size(); ++i)
+      f.middleRows(runs_[i].full, runs_[i].length) =
+          condensed.middleRows(runs_[i].condensed, runs_[i].length);
+  }
+
+  /// Copy the selected columns of the full matrix into the condensed one
+  template <typename Full, typename Condensed>
+  void gatherCols(const MatrixBase<Full>& full,
+                  const MatrixBase<Condensed>& condensed) const {
+    Condensed& c = const_cast<MatrixBase<Condensed>&>(condensed).derived();
+    assert(c.cols() == nbIndices_);
+    for (std::size_t i = 0; i < runs_.size(); ++i)
+      c.middleCols(runs_[i].condensed, runs_[i].length) =
+          full.middleCols(runs_[i].full, runs_[i].length);
+  }
+
+  /// Copy the condensed matrix back into the selected columns of the
+  /// full one. Unselected columns are left untouched.
+  template <typename Condensed, typename Full>
+  void scatterCols(const MatrixBase<Condensed>& condensed,
+                   const MatrixBase<Full>& full) const {
+    Full& f = const_cast<MatrixBase<Full>&>(full).derived();
+    assert(condensed.cols() == nbIndices_);
+    for (std::size_t i = 0; i < runs_.size(); ++i)
+      f.middleCols(runs_[i].full, runs_[i].length) =
+          condensed.middleCols(runs_[i].condensed, runs_[i].length);
+  }
+
+  /// Copy the rows selected by this plan and the columns selected by
+  /// \c colPlan of the full matrix into the condensed one
+  ///
+  /// The copy proceeds tile by tile, column runs outermost, so both
+  /// matrices are walked in storage order.
+  /// \param colPlan plan of the selected columns,
+  /// \param full matrix the tiles are gathered from,
+  /// \retval condensed matrix receiving the selected tiles, must have
+  ///         \ref nbIndices rows and \c colPlan.nbIndices() columns.
+  template <typename Full, typename Condensed>
+  void gather(const BlockCopyPlan& colPlan, const MatrixBase<Full>& full,
+              const MatrixBase<Condensed>& condensed) const {
+    Condensed& c = const_cast<MatrixBase<Condensed>&>(condensed).derived();
+    assert(c.rows() == nbIndices_ && c.cols() == colPlan.nbIndices_);
+    for (std::size_t j = 0; j < colPlan.runs_.size(); ++j)
+      for (std::size_t i = 0; i < runs_.size(); ++i)
+        c.block(runs_[i].condensed, colPlan.runs_[j].condensed,
+                runs_[i].length, colPlan.runs_[j].length) =
+            full.block(runs_[i].full, colPlan.runs_[j].full, runs_[i].length,
+                       colPlan.runs_[j].length);
+  }
+
+ private:
+  std::vector<Run> runs_;
+  size_type nbIndices_;
+};  // class BlockCopyPlan
+
 /// A view of an Eigen matrix.
 ///
 /// Instances of MatrixBlockView are easily built from a MatrixBlocks object.
@@ -1024,6 +1152,59 @@ class MatrixBlockView
     return true;
   }
 
+  /// Whether a coefficient of the view satisfies a predicate
+  ///
+  /// Equivalent to evaluating the view and testing
+  /// <code>(v.array() ...).any()</code>, except that the predicate
+  /// streams over the blocks of the underlying storage without
+  /// materializing a temporary.
+  template <typename Predicate>
+  EIGEN_STRONG_INLINE bool any(Predicate pred) const {
+    for (block_iterator block(*this); block.valid(); ++block) {
+      const BlockConstXprType b(_block(block));
+      for (size_type c = 0; c < b.cols(); ++c)
+        for (size_type r = 0; r < b.rows(); ++r)
+          if (pred(b(r, c))) return true;
+    }
+    return false;
+  }
+
+  /// Smallest coefficient of the view, computed block by block without
+  /// materializing a temporary.
+  EIGEN_STRONG_INLINE Scalar minCoeff() const {
+    assert(rows() > 0 && cols() > 0);
+    Scalar m(NumTraits<Scalar>::highest());
+    for (block_iterator block(*this); block.valid(); ++block)
+      m = std::min(m, Scalar(_block(block).minCoeff()));
+    return m;
+  }
+
+  /// Largest coefficient of the view, computed block by block without
+  /// materializing a temporary.
+  EIGEN_STRONG_INLINE Scalar maxCoeff() const {
+    assert(rows() > 0 && cols() > 0);
+    Scalar m(NumTraits<Scalar>::lowest());
+    for (block_iterator block(*this); block.valid(); ++block)
+      m = std::max(m, Scalar(_block(block).maxCoeff()));
+    return m;
+  }
+
+  /// Dot product of a vector view with a dense vector
+  ///
+  /// The product is accumulated segment by segment over the underlying
+  /// storage without materializing the view.
+  template <typename OtherDerived>
+  EIGEN_STRONG_INLINE Scalar dot(const MatrixBase<OtherDerived>& other) const {
+    EIGEN_STATIC_ASSERT_VECTOR_ONLY(OtherDerived)
+    assert(cols() == 1 && other.derived().size() == rows());
+    Scalar res(0);
+    for (block_iterator block(*this); block.valid(); ++block)
+      res += _block(block)
+                 .col(0)
+                 .dot(other.derived().segment(block.ro(), block.rs()));
+    return res;
+  }
+
   ArgType& m_arg;
   size_type m_nbRows;
   RowIndices_t m_rows;
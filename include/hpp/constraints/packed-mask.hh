@@ -0,0 +1,148 @@
+// Copyright (c) 2026, CNRS
+// Authors: Florent Lamiraux
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_PACKED_MASK_HH
+#define HPP_CONSTRAINTS_PACKED_MASK_HH
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <hpp/constraints/fwd.hh>
+#include <vector>
+
+namespace hpp {
+namespace constraints {
+
+/// Boolean parameter mask packed 64 flags per word.
+///
+/// DifferentiableFunction exposes its active parameters as ArrayXb,
+/// one byte per flag. The solver setup paths repeatedly intersect
+/// these masks with the free variables of the problem; packing the
+/// flags 64 per word turns the intersection into an AND over a handful
+/// of words and makes the mask eight times smaller.
+class PackedMask {
+ public:
+  typedef std::uint64_t Word_t;
+
+  PackedMask() : size_(0) {}
+
+  /// Pack a byte-per-flag mask.
+  explicit PackedMask(const ArrayXb& mask)
+      : size_(mask.size()), words_(nbWords(mask.size()), 0) {
+    for (size_type i = 0; i < size_; ++i)
+      if (mask[i]) words_[word(i)] |= bit(i);
+  }
+
+  /// Mask of size flags, set on the given intervals only.
+  PackedMask(const segments_t& segments, size_type size)
+      : size_(size), words_(nbWords(size), 0) {
+    for (std::size_t i = 0; i < segments.size(); ++i)
+      setSegment(segments[i].first, segments[i].second);
+  }
+
+  /// Number of flags.
+  size_type size() const { return size_; }
+
+  /// Clear every flag, keeping the size.
+  void reset() { std::fill(words_.begin(), words_.end(), (Word_t)0); }
+
+  /// Set one flag.
+  void set(size_type i) {
+    assert(i >= 0 && i < size_);
+    words_[word(i)] |= bit(i);
+  }
+
+  bool operator[](size_type i) const {
+    assert(i >= 0 && i < size_);
+    return (words_[word(i)] & bit(i)) != 0;
+  }
+
+  PackedMask& operator&=(const PackedMask& other) {
+    assert(size_ == other.size_);
+    for (std::size_t w = 0; w < words_.size(); ++w) words_[w] &= other.words_[w];
+    return *this;
+  }
+
+  PackedMask& operator|=(const PackedMask& other) {
+    assert(size_ == other.size_);
+    for (std::size_t w = 0; w < words_.size(); ++w) words_[w] |= other.words_[w];
+    return *this;
+  }
+
+  /// Whether any flag is set.
+  bool any() const {
+    for (std::size_t w = 0; w < words_.size(); ++w)
+      if (words_[w] != 0) return true;
+    return false;
+  }
+
+  /// Whether this and other share a set flag. Equivalent to
+  /// (*this &= other).any() without building the intersection.
+  bool intersects(const PackedMask& other) const {
+    assert(size_ == other.size_);
+    for (std::size_t w = 0; w < words_.size(); ++w)
+      if ((words_[w] & other.words_[w]) != 0) return true;
+    return false;
+  }
+
+  /// Expand back to a byte-per-flag mask.
+  ArrayXb unpack() const {
+    ArrayXb mask(size_);
+    for (size_type i = 0; i < size_; ++i) mask[i] = (*this)[i];
+    return mask;
+  }
+
+ private:
+  static std::size_t nbWords(size_type size) {
+    return (std::size_t)((size + 63) / 64);
+  }
+  static std::size_t word(size_type i) { return (std::size_t)(i >> 6); }
+  static Word_t bit(size_type i) { return (Word_t)1 << (i & 63); }
+
+  /// Set the flags of interval [first, first + length), whole words at
+  /// a time.
+  void setSegment(size_type first, size_type length) {
+    assert(first >= 0 && first + length <= size_);
+    size_type last = first + length;
+    while (first < last) {
+      const size_type lo = first & 63;
+      const size_type hi = std::min<size_type>(64, lo + (last - first));
+      Word_t bits = (hi == 64 ? ~(Word_t)0 : (((Word_t)1 << hi) - 1));
+      bits &= ~(((Word_t)1 << lo) - 1);
+      words_[word(first)] |= bits;
+      first += hi - lo;
+    }
+  }
+
+  size_type size_;
+  std::vector<Word_t> words_;
+};  // class PackedMask
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // HPP_CONSTRAINTS_PACKED_MASK_HH
@@ -59,6 +59,19 @@ class HPP_CONSTRAINTS_DLLAPI QPStaticStability : public DifferentiableFunction {
   typedef StaticStability::Contacts_t Contacts_t;
   typedef ConvexShapeContact::ForceData ForceData;
 
+  /// Backend used to solve the quadratic program.
+  enum QPBackend {
+    /// Dense active-set solver (qpOASES). Builds the n x n Hessian of
+    /// the contact forces; best for small contact sets.
+    QPOASES,
+    /// Non-negative least-squares solver working directly on the
+    /// 6 x n force matrix, so each passive-set solve costs O(n)
+    /// instead of the cubic dense solve; the passive set of the
+    /// previous evaluation warm-starts the next one. Best for large
+    /// contact sets.
+    NNLS
+  };
+
   /// Constructor
   /// \param name name of the constraint
   /// \param robot the robot the constraints is applied to,
@@ -75,6 +88,12 @@ class HPP_CONSTRAINTS_DLLAPI QPStaticStability : public DifferentiableFunction {
                     const std::vector<ForceData>& contacts,
                     const CenterOfMassComputationPtr_t& com);
 
+  /// Constructor sharing the per-contact computation
+  /// \param cache wrench expression matrix, possibly shared with other
+  ///        stability functions. See ContactWrenchCache.
+  QPStaticStability(const std::string& name,
+                    const ContactWrenchCachePtr_t& cache);
+
   static QPStaticStabilityPtr_t create(const std::string& name,
                                        const DevicePtr_t& robot,
                                        const Contacts_t& contacts,
@@ -89,8 +108,18 @@ class HPP_CONSTRAINTS_DLLAPI QPStaticStability : public DifferentiableFunction {
                                        const Contacts_t& contacts,
                                        const CenterOfMassComputationPtr_t& com);
 
+  /// Create an instance consuming a shared per-contact computation.
+  /// See ContactWrenchCache.
+  static QPStaticStabilityPtr_t create(const std::string& name,
+                                       const ContactWrenchCachePtr_t& cache);
+
   MatrixOfExpressions<>& phi() { return phi_; }
 
+  /// Select the backend solving the quadratic program.
+  /// Defaults to QPOASES.
+  void backend(QPBackend backend) { backend_ = backend; }
+  QPBackend backend() const { return backend_; }
+
  protected:
   bool isEqual(const DifferentiableFunction& other) const {
     const QPStaticStability& castother =
@@ -119,6 +148,7 @@ class HPP_CONSTRAINTS_DLLAPI QPStaticStability : public DifferentiableFunction {
   void impl_jacobian(matrixOut_t jacobian, ConfigurationIn_t argument) const;
 
   qpOASES::returnValue solveQP(vectorOut_t result) const;
+  qpOASES::returnValue solveQPNnls(vectorOut_t result) const;
 
   bool checkQPSol() const;
   bool checkStrictComplementarity() const;
@@ -138,9 +168,22 @@ class HPP_CONSTRAINTS_DLLAPI QPStaticStability : public DifferentiableFunction {
 
   mutable RowMajorMatrix_t H_;
   mutable vector_t G_;
-  mutable qpOASES::QProblemB qp_;
-  mutable MoE_t phi_;
+  /// The QP is kept alive across evaluations so that consecutive
+  /// solves hot-start from the previous active set and factorization.
+  mutable qpOASES::SQProblem qp_;
+  /// Whether qp_ holds a successfully solved problem to hot-start from.
+  mutable bool qpInitialized_;
+  /// Per-contact computation, possibly shared with other stability
+  /// functions
+  ContactWrenchCachePtr_t cache_;
+  /// Wrench expression matrix of cache_
+  MoE_t& phi_;
   mutable vector_t primal_, dual_;
+  /// Preallocated buffers of impl_jacobian.
+  mutable matrix_t JT_phi_F_, J_F_;
+  QPBackend backend_;
+  /// Passive set of the last NNLS solve, used as warm start.
+  mutable std::vector<bool> nnlsPassive_;
 };
 /// \}
 }  // namespace constraints
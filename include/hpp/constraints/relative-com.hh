@@ -125,6 +125,9 @@ class HPP_CONSTRAINTS_DLLAPI RelativeCom : public DifferentiableFunction {
   std::vector<bool> mask_;
   bool nominalCase_;
   mutable ComJacobian_t jacobian_;
+  /// Memoized access to comc_, shared with the other constraints
+  /// wrapping the same computation. Rebuilt at deserialization.
+  ComComputationCachePtr_t cache_;
 
   RelativeCom() {}
   HPP_SERIALIZABLE();
@@ -30,9 +30,308 @@
 #define HPP_CONSTRAINTS_SERIALIZATION_HH
 
 #include <boost/serialization/serialization.hpp>
+#include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/utility.hpp>
 #include <boost/serialization/vector.hpp>
+#include <cstdint>
+#include <fstream>
+#include <hpp/constraints/fwd.hh>
 #include <hpp/constraints/matrix-view.hh>
+#include <hpp/util/serialization.hh>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hpp {
+namespace constraints {
+namespace serialization {
+
+/// \addtogroup hpp_constraints_tools
+/// \{
+
+/// Format version written by \ref writeBinaryHeader
+const unsigned int binaryFormatVersion = 1;
+
+/// Tag a stream as a hpp-constraints binary archive
+///
+/// Writes a four byte magic followed by the format version, so that
+/// \ref readBinaryHeader can reject incompatible archives before boost
+/// starts parsing them.
+inline void writeBinaryHeader(std::ostream& os) {
+  os.write("hppC", 4);
+  os.write(reinterpret_cast<const char*>(&binaryFormatVersion),
+           sizeof(binaryFormatVersion));
+}
+
+/// Check the magic and format version of a binary archive
+/// \throw std::runtime_error if the stream is not a hpp-constraints
+///        binary archive or if the format version does not match.
+inline void readBinaryHeader(std::istream& is) {
+  char magic[4];
+  is.read(magic, 4);
+  if (!is.good() || magic[0] != 'h' || magic[1] != 'p' || magic[2] != 'p' ||
+      magic[3] != 'C')
+    throw std::runtime_error("not a hpp-constraints binary archive");
+  unsigned int version = 0;
+  is.read(reinterpret_cast<char*>(&version), sizeof(version));
+  if (!is.good() || version != binaryFormatVersion) {
+    std::ostringstream oss;
+    oss << "hpp-constraints binary archive version mismatch: got " << version
+        << ", expected " << binaryFormatVersion;
+    throw std::runtime_error(oss.str());
+  }
+}
+
+/// Save an object to a compact binary archive
+///
+/// Binary archives are an order of magnitude smaller and faster to
+/// parse than the text and XML ones, at the price of not being
+/// portable across platforms.
+/// \param os output stream, must be opened in binary mode,
+/// \param object object to serialize,
+/// \param name tag of the object in the archive.
+template <typename T>
+void saveBinary(std::ostream& os, const T& object, const char* name) {
+  writeBinaryHeader(os);
+  hpp::serialization::binary_oarchive oa(os);
+  oa << boost::serialization::make_nvp(name, object);
+}
+
+/// Save an object referring to a robot to a compact binary archive
+///
+/// The robot itself is not serialized: its pointer is inserted into
+/// the archive and \ref loadBinary must be given the same robot.
+template <typename T, typename DevicePtr>
+void saveBinary(std::ostream& os, const T& object, const char* name,
+                const DevicePtr& device) {
+  writeBinaryHeader(os);
+  hpp::serialization::binary_oarchive oa(os);
+  oa.insert(device->name(), device.get());
+  oa << boost::serialization::make_nvp(name, object);
+}
+
+/// Load an object from a binary archive written by \ref saveBinary
+/// \throw std::runtime_error on magic or format version mismatch.
+template <typename T>
+void loadBinary(std::istream& is, T& object, const char* name) {
+  readBinaryHeader(is);
+  hpp::serialization::binary_iarchive ia(is);
+  ia >> boost::serialization::make_nvp(name, object);
+}
+
+/// Load an object referring to a robot from a binary archive
+/// \param device the robot the object was serialized with.
+template <typename T, typename DevicePtr>
+void loadBinary(std::istream& is, T& object, const char* name,
+                const DevicePtr& device) {
+  readBinaryHeader(is);
+  hpp::serialization::binary_iarchive ia(is);
+  ia.insert(device->name(), device.get());
+  ia >> boost::serialization::make_nvp(name, object);
+}
+
+/// \cond
+namespace internal {
+/// Read-only streambuf over a range of bytes, so that the payloads of
+/// a \ref LazyArchive are parsed in place, without being copied.
+struct ConstMemoryBuf : std::streambuf {
+  ConstMemoryBuf(const char* data, std::size_t size) {
+    char* p = const_cast<char*>(data);
+    setg(p, p, p + size);
+  }
+};
+}  // namespace internal
+/// \endcond
+
+/// Save a collection of objects to an indexed binary archive
+///
+/// The archive starts with a table of payload offsets and each object
+/// is written as a self contained binary payload, so that \ref
+/// LazyArchive can open the file, read the table and deserialize the
+/// objects on demand instead of materializing all of them up front.
+/// Objects are serialized through their shared pointer: polymorphic
+/// types must be exported with BOOST_CLASS_EXPORT as usual.
+/// \param os output stream, must be opened in binary mode and be
+///        seekable (a file stream): the offset table is rewritten once
+///        the payload positions are known,
+/// \param objects collection to serialize,
+/// \param name tag of each object in its payload,
+/// \param device the robot the objects refer to, not serialized.
+template <typename T, typename DevicePtr>
+void saveBinaryCollection(std::ostream& os,
+                          const std::vector<shared_ptr<T> >& objects,
+                          const char* name, const DevicePtr& device) {
+  writeBinaryHeader(os);
+  const std::uint64_t count = objects.size();
+  os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  // Reserve the offset table; it is rewritten below, once the payload
+  // positions are known.
+  const std::ostream::pos_type indexPos = os.tellp();
+  std::vector<std::uint64_t> index(2 * objects.size(), 0);
+  if (!index.empty())
+    os.write(reinterpret_cast<const char*>(index.data()),
+             (std::streamsize)(index.size() * sizeof(std::uint64_t)));
+  for (std::size_t i = 0; i < objects.size(); ++i) {
+    const std::ostream::pos_type begin = os.tellp();
+    {
+      // One archive per payload, so that each of them can be parsed
+      // independently of the others.
+      hpp::serialization::binary_oarchive oa(os);
+      oa.insert(device->name(), device.get());
+      oa << boost::serialization::make_nvp(name, objects[i]);
+    }
+    index[2 * i] = (std::uint64_t)begin;
+    index[2 * i + 1] = (std::uint64_t)(os.tellp() - begin);
+  }
+  const std::ostream::pos_type end = os.tellp();
+  os.seekp(indexPos);
+  if (!index.empty())
+    os.write(reinterpret_cast<const char*>(index.data()),
+             (std::streamsize)(index.size() * sizeof(std::uint64_t)));
+  os.seekp(end);
+}
+
+/// On demand view of an archive written by \ref saveBinaryCollection
+///
+/// Opening the archive memory maps the file and reads the offset table
+/// only; an object is deserialized the first time \ref at asks for it
+/// and kept for the later calls. A session that touches a small part
+/// of a large collection pays the parsing cost of that part only,
+/// instead of materializing every object at startup.
+template <typename T>
+class LazyArchive {
+ public:
+  /// Map \c filename and load its index eagerly.
+  /// \throw std::runtime_error when the file cannot be opened, is not
+  ///        a hpp-constraints binary archive or its index is
+  ///        corrupted.
+  explicit LazyArchive(const std::string& filename)
+      : data_(NULL), size_(0), fd_(-1) {
+#if defined(__unix__) || defined(__APPLE__)
+    fd_ = ::open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) throw std::runtime_error("cannot open " + filename);
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+      ::close(fd_);
+      throw std::runtime_error("cannot stat " + filename);
+    }
+    size_ = (std::size_t)st.st_size;
+    void* map = ::mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (map == MAP_FAILED) {
+      ::close(fd_);
+      throw std::runtime_error("cannot map " + filename);
+    }
+    data_ = static_cast<const char*>(map);
+#else
+    // No memory mapping on this platform: read the bytes eagerly. The
+    // payloads are still parsed on demand.
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if (!ifs.good()) throw std::runtime_error("cannot open " + filename);
+    buffer_.assign(std::istreambuf_iterator<char>(ifs),
+                   std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+    try {
+      parseIndex(filename);
+    } catch (...) {
+      unmap();
+      throw;
+    }
+  }
+
+  ~LazyArchive() { unmap(); }
+
+  LazyArchive(const LazyArchive&) = delete;
+  LazyArchive& operator=(const LazyArchive&) = delete;
+
+  /// Number of objects in the archive
+  std::size_t size() const { return index_.size(); }
+
+  /// Whether object \c i has been materialized already
+  bool loaded(std::size_t i) const { return objects_[i].get() != NULL; }
+
+  /// Object \c i, deserialized on the first call and cached afterwards.
+  /// \param name tag the object was saved under,
+  /// \param device the robot the collection was serialized with.
+  template <typename DevicePtr>
+  const shared_ptr<T>& at(std::size_t i, const char* name,
+                          const DevicePtr& device) {
+    if (!objects_[i]) {
+      internal::ConstMemoryBuf buf(data_ + index_[i].first,
+                                   (std::size_t)index_[i].second);
+      std::istream is(&buf);
+      hpp::serialization::binary_iarchive ia(is);
+      ia.insert(device->name(), device.get());
+      ia >> boost::serialization::make_nvp(name, objects_[i]);
+    }
+    return objects_[i];
+  }
+
+  /// Same as above for objects that do not refer to a robot.
+  const shared_ptr<T>& at(std::size_t i, const char* name) {
+    if (!objects_[i]) {
+      internal::ConstMemoryBuf buf(data_ + index_[i].first,
+                                   (std::size_t)index_[i].second);
+      std::istream is(&buf);
+      hpp::serialization::binary_iarchive ia(is);
+      ia >> boost::serialization::make_nvp(name, objects_[i]);
+    }
+    return objects_[i];
+  }
+
+ private:
+  void parseIndex(const std::string& filename) {
+    internal::ConstMemoryBuf buf(data_, size_);
+    std::istream is(&buf);
+    readBinaryHeader(is);
+    std::uint64_t count = 0;
+    is.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!is.good()) throw std::runtime_error("truncated archive " + filename);
+    index_.resize((std::size_t)count);
+    for (std::size_t i = 0; i < index_.size(); ++i) {
+      std::uint64_t entry[2];
+      is.read(reinterpret_cast<char*>(entry), sizeof(entry));
+      if (!is.good() || entry[0] + entry[1] > size_)
+        throw std::runtime_error("corrupted index in " + filename);
+      index_[i] = std::make_pair(entry[0], entry[1]);
+    }
+    objects_.resize(index_.size());
+  }
+
+  void unmap() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (data_ != NULL) ::munmap(const_cast<char*>(data_), size_);
+    if (fd_ >= 0) ::close(fd_);
+    data_ = NULL;
+    fd_ = -1;
+#endif
+  }
+
+  const char* data_;
+  std::size_t size_;
+  int fd_;
+  std::vector<char> buffer_;
+  /// Offset and length of each payload, read at construction
+  std::vector<std::pair<std::uint64_t, std::uint64_t> > index_;
+  /// Materialized objects, NULL until the first access
+  std::vector<shared_ptr<T> > objects_;
+};
+
+/// \}
+
+}  // namespace serialization
+}  // namespace constraints
+}  // namespace hpp
 
 namespace boost {
 namespace serialization {
@@ -0,0 +1,101 @@
+// Copyright (c) 2026 CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_SOLVER_ALLOCATION_AUDIT_HH
+#define HPP_CONSTRAINTS_SOLVER_ALLOCATION_AUDIT_HH
+
+#include <hpp/constraints/config.hh>
+#include <hpp/constraints/fwd.hh>
+#include <string>
+#include <vector>
+
+namespace hpp {
+namespace constraints {
+namespace solver {
+
+/// Heap allocation accounting per solver phase.
+///
+/// The solvers are expected to stop allocating once their scratch
+/// buffers are warm; this module keeps that property under test.
+/// Attribution reuses the \ref trace zones: \ref install registers
+/// trace hooks that track the innermost open zone, and every call to
+/// \ref count charges one allocation to it. The library does not
+/// intercept allocations itself - the audit harness (typically a test
+/// binary) replaces `operator new` or the Eigen allocator and forwards
+/// to \ref count. tests/allocation-audit.cc enforces a zero-allocation
+/// budget on steady-state solves this way.
+///
+/// Zones are emitted only when the solver sources are compiled with the
+/// SOLVER_TRACE cmake option; without it the counters still work but
+/// everything lands in the "(outside solver)" bucket.
+namespace audit {
+
+/// Allocations charged to one solver phase.
+struct PhaseAllocations {
+  /// Zone name: a static phase name or a constraint function name, or
+  /// "(outside solver)" when no zone was open.
+  std::string phase;
+  /// Priority level of the zone, -1 when not tied to one level.
+  size_type level;
+  /// Number of allocations.
+  std::size_t allocations;
+  /// Total number of bytes requested.
+  std::size_t bytes;
+};
+
+/// Start attributing allocations to solver phases.
+///
+/// Saves the currently registered trace hooks and replaces them;
+/// the saved hooks keep being forwarded to, so an external profiler
+/// can stay attached. Not synchronized, like trace::hooks.
+void HPP_CONSTRAINTS_DLLAPI install();
+
+/// Restore the trace hooks saved by \ref install and stop counting.
+void HPP_CONSTRAINTS_DLLAPI uninstall();
+
+/// Reset the counters. Does not touch the hooks.
+void HPP_CONSTRAINTS_DLLAPI clear();
+
+/// Charge one allocation of \c bytes bytes to the innermost open zone.
+///
+/// Call this from the interposed allocator. No-op when the audit is
+/// not installed, and reentrancy safe: allocations made by the
+/// counters themselves are not counted.
+void HPP_CONSTRAINTS_DLLAPI count(std::size_t bytes);
+
+/// The counters accumulated since \ref install or the last \ref clear,
+/// one entry per phase.
+std::vector<PhaseAllocations> HPP_CONSTRAINTS_DLLAPI report();
+
+/// Sum of the allocation counts of \ref report, for budget checks.
+std::size_t HPP_CONSTRAINTS_DLLAPI totalAllocations();
+}  // namespace audit
+}  // namespace solver
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // HPP_CONSTRAINTS_SOLVER_ALLOCATION_AUDIT_HH
@@ -132,10 +132,25 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
     // explicit_.solve(arg);
     // iterative_.solve(arg, ls);
     // } else {
-    return impl_solve(arg, optimize, ls);
+    return impl_solve(
+        arg, optimize,
+        std::max(squaredErrorThreshold_, squaredCoarseErrorThreshold_), ls);
     // }
   }
 
+  /// Continue a resolution started by \ref solve down to
+  /// \ref errorThreshold. See
+  /// HierarchicalIterative::coarseErrorThreshold.
+  template <typename LineSearchType>
+  Status refine(vectorOut_t arg, LineSearchType ls = LineSearchType()) const {
+    return impl_solve(arg, false, squaredErrorThreshold_, ls);
+  }
+
+  /// Same as above with the default line search method.
+  inline Status refine(vectorOut_t arg) const {
+    return refine(arg, DefaultLineSearch());
+  }
+
   /// Project velocity on constraint tangent space in "from"
   ///
   /// \param from configuration,
@@ -165,12 +180,43 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
     return solve(arg, DefaultLineSearch());
   }
 
+  /// Project a sequence of configurations in order
+  ///
+  /// \param args matrix whose columns are the configurations to
+  ///        project. Each column is solved in place.
+  /// \return the status of each column.
+  ///
+  /// Consecutive columns are expected to be close to one another, as
+  /// when discretizing a path. Each sample is warm-started by applying
+  /// the correction computed for the previous sample, so that the
+  /// Newton iteration starts close to the constraint manifold and the
+  /// value and Jacobian left in the solver workspace by the previous
+  /// sample remain good initial data. If a warm-started sample fails,
+  /// it is solved again from the raw input.
+  template <typename LineSearchType>
+  std::vector<Status> solveSequence(matrixOut_t args,
+                                    LineSearchType ls = LineSearchType()) const;
+
+  inline std::vector<Status> solveSequence(matrixOut_t args) const {
+    return solveSequence(args, DefaultLineSearch());
+  }
+
   /// \name Right hand side accessors
   /// \{
 
   /// \copydoc HierarchicalIterative::rightHandSideFromConfig(ConfigurationIn_t)
   vector_t rightHandSideFromConfig(ConfigurationIn_t config);
 
+  /// \copydoc HierarchicalIterative::rightHandSideFromConfig(ConfigurationIn_t,
+  /// vectorOut_t)
+  void rightHandSideFromConfig(ConfigurationIn_t config, vectorOut_t rhs);
+
+  /// Make the batched
+  /// HierarchicalIterative::rightHandSideFromConfig(ConfigurationIn_t,
+  /// const std::vector<HierarchicalIterative*>&) callable on this
+  /// class despite the overloads above hiding it.
+  using HierarchicalIterative::rightHandSideFromConfig;
+
   /// \copydoc HierarchicalIterative::rightHandSideFromConfig(const
   /// ImplicitPtr_t&, ConfigurationIn_t)
   bool rightHandSideFromConfig(const ImplicitPtr_t& constraint,
@@ -193,9 +239,18 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
   ///       constraints (type Equality).
   vector_t rightHandSide() const;
 
+  /// \copydoc HierarchicalIterative::getRightHandSide(vectorOut_t)
+  void getRightHandSide(vectorOut_t rhs) const;
+
+  /// \copydoc HierarchicalIterative::rightHandSideView()
+  const vector_t& rightHandSideView() const;
+
   /// \copydoc HierarchicalIterative::rightHandSideSize()
   size_type rightHandSideSize() const;
 
+  /// \copydoc HierarchicalIterative::snapshot()
+  Snapshot snapshot() const;
+
   /// \}
 
   /// Return the size of the error as computed by isSatisfied
@@ -223,6 +278,32 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
     return solver::HierarchicalIterative::isSatisfied(arg, errorThreshold) &&
            explicit_.isSatisfied(arg, errorThreshold);
   }
+
+  /// Whether input vector satisfies the constraints of the solver,
+  /// evaluating the implicit constraints one by one and stopping on
+  /// the first one crossing the threshold. See
+  /// HierarchicalIterative::isSatisfiedFast.
+  bool isSatisfiedFast(vectorIn_t arg) const {
+    return solver::HierarchicalIterative::isSatisfiedFast(arg) &&
+           explicit_.isSatisfied(arg);
+  }
+
+  /// Same as \ref isSatisfiedFast(vectorIn_t) const with a given
+  /// threshold.
+  bool isSatisfiedFast(vectorIn_t arg, value_type errorThreshold) const {
+    return solver::HierarchicalIterative::isSatisfiedFast(arg,
+                                                          errorThreshold) &&
+           explicit_.isSatisfied(arg, errorThreshold);
+  }
+
+  /// Whether each column of a configuration batch satisfies the
+  /// constraints of the solver. See
+  /// HierarchicalIterative::isSatisfied(matrixIn_t, ArrayXb&) const.
+  void isSatisfied(matrixIn_t configs, ArrayXb& results) const {
+    results.resize(configs.cols());
+    for (size_type c = 0; c < configs.cols(); ++c)
+      results[c] = isSatisfiedFast(configs.col(c));
+  }
   /// Whether input vector satisfies the constraints of the solver
   /// \param arg input vector
   /// \retval error the constraint errors dispatched in a vector,
@@ -254,7 +335,7 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
     computeValue<true>(arg);
     updateJacobian(arg);
     computeDescentDirection();
-    lineSearch(*this, arg, dq_);
+    lineSearch(*this, arg, context_.dq);
     explicit_.solve(arg);
     return solver::HierarchicalIterative::isSatisfied(arg);
   }
@@ -280,6 +361,10 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
 
   virtual std::ostream& print(std::ostream& os) const;
 
+  /// Add the explicit resolution buffers to the report of
+  /// HierarchicalIterative::memoryUsage.
+  virtual MemoryUsageReport memoryUsage() const;
+
   bool integrate(vectorIn_t from, vectorIn_t velocity,
                  vectorOut_t result) const {
     bool res = solver::HierarchicalIterative::integrate(from, velocity, result);
@@ -289,12 +374,22 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
 
  protected:
   void computeActiveRowsOfJ(std::size_t iStack);
+  /// The chain rule of updateJacobian fills columns beyond the active
+  /// derivative parameters of the functions, so no column is pruned.
+  void computeActiveColsOfJ(std::size_t iStack);
+  /// The chain rule of updateJacobian reads the columns of
+  /// Data::jacobian over the explicitly constrained derivatives, which
+  /// the reduced column layout drops.
+  bool directJacobianUsable() const {
+    return explicit_.inDers().nbCols() == 0;
+  }
 
  private:
   typedef solver::HierarchicalIterative parent_t;
 
   template <typename LineSearchType>
-  Status impl_solve(vectorOut_t arg, bool optimize, LineSearchType ls) const;
+  Status impl_solve(vectorOut_t arg, bool optimize,
+                    value_type squaredThreshold, LineSearchType ls) const;
 
   ExplicitConstraintSet explicit_;
   mutable matrix_t Je_, JeExpanded_;
@@ -304,6 +399,53 @@ class HPP_CONSTRAINTS_DLLAPI BySubstitution
 };  // class BySubstitution
 /// \}
 
+// impl_solve - which backs the inline solve and refine wrappers above -
+// and solveSequence are compiled in the library for the line search
+// types of solver/hierarchical-iterative.hh, together with the line
+// search functors applied to this solver. The declarations below keep
+// translation units that include solver/impl/by-substitution.hh - only
+// needed to instantiate a custom line search type - from
+// re-instantiating them.
+extern template BySubstitution::Status BySubstitution::impl_solve(
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
+    lineSearch::Constant lineSearch) const;
+extern template BySubstitution::Status BySubstitution::impl_solve(
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
+    lineSearch::Backtracking lineSearch) const;
+extern template BySubstitution::Status BySubstitution::impl_solve(
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
+    lineSearch::FixedSequence lineSearch) const;
+extern template BySubstitution::Status BySubstitution::impl_solve(
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
+    lineSearch::ErrorNormBased lineSearch) const;
+
+extern template std::vector<BySubstitution::Status>
+BySubstitution::solveSequence(matrixOut_t args,
+                              lineSearch::Constant lineSearch) const;
+extern template std::vector<BySubstitution::Status>
+BySubstitution::solveSequence(matrixOut_t args,
+                              lineSearch::Backtracking lineSearch) const;
+extern template std::vector<BySubstitution::Status>
+BySubstitution::solveSequence(matrixOut_t args,
+                              lineSearch::FixedSequence lineSearch) const;
+extern template std::vector<BySubstitution::Status>
+BySubstitution::solveSequence(matrixOut_t args,
+                              lineSearch::ErrorNormBased lineSearch) const;
+
+namespace lineSearch {
+extern template bool Constant::operator()(const BySubstitution& solver,
+                                          vectorOut_t arg, vectorOut_t darg);
+extern template bool Backtracking::operator()(const BySubstitution& solver,
+                                              vectorOut_t arg,
+                                              vectorOut_t darg);
+extern template bool FixedSequence::operator()(const BySubstitution& solver,
+                                               vectorOut_t arg,
+                                               vectorOut_t darg);
+extern template bool ErrorNormBased::operator()(const BySubstitution& solver,
+                                                vectorOut_t arg,
+                                                vectorOut_t darg);
+}  // namespace lineSearch
+
 }  // namespace solver
 }  // namespace constraints
 }  // namespace hpp
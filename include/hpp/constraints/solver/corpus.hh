@@ -0,0 +1,245 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: Florent Lamiraux
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_SOLVER_CORPUS_HH
+#define HPP_CONSTRAINTS_SOLVER_CORPUS_HH
+
+#include <algorithm>
+#include <chrono>
+#include <hpp/constraints/config.hh>
+#include <hpp/constraints/fwd.hh>
+#include <hpp/constraints/serialization.hh>
+#include <hpp/constraints/solver/by-substitution.hh>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace hpp {
+namespace constraints {
+namespace solver {
+/// \addtogroup solvers
+/// \{
+
+/// Record/replay corpus of resolution problems.
+///
+/// A corpus captures the problems actually submitted to
+/// \ref BySubstitution on a deployment - the solver definition, the
+/// seed configuration and the right hand side - and persists them with
+/// the tagged binary format of serialization.hh. Replaying a corpus
+/// against each line-search strategy and parameter set then compares
+/// their behavior on the real workload without running the full
+/// planner.
+class HPP_CONSTRAINTS_DLLAPI Corpus {
+ public:
+  /// One captured problem.
+  struct Record {
+    /// Copy of the solver at capture time
+    shared_ptr<BySubstitution> solver;
+    /// Seed configuration given to BySubstitution::solve
+    vector_t seed;
+    /// Right hand side at capture time
+    vector_t rightHandSide;
+  };
+
+  /// Outcome of the replay of a corpus with one line-search strategy.
+  ///
+  /// The per-problem iteration counts are kept so that distributions
+  /// can be computed offline; the aggregates below cover the common
+  /// triage questions.
+  struct Statistics {
+    /// Label given to \ref replay
+    std::string lineSearch;
+    std::size_t nbProblems;
+    /// Number of problems solved with status SUCCESS
+    std::size_t nbSuccess;
+    /// Iteration count of each problem, in corpus order
+    std::vector<size_type> iterations;
+    size_type minIterations, maxIterations;
+    value_type meanIterations;
+    /// Accumulated resolution time, in seconds
+    value_type totalTime;
+
+    std::ostream& print(std::ostream& os) const;
+  };
+
+  /// Line-search parameters selected by \ref tune.
+  ///
+  /// A profile records the winning strategy with its parameters and
+  /// the iteration budget derived from the replays, together with the
+  /// statistics that made it win. Install it with \ref apply and solve
+  /// with \ref solve, so that deployments can load tuned values
+  /// instead of the one-size-fits-all defaults.
+  struct HPP_CONSTRAINTS_DLLAPI Profile {
+    /// Strategy the parameters below apply to
+    enum Strategy { FIXED_SEQUENCE, ERROR_NORM_BASED };
+
+    Profile() : strategy(FIXED_SEQUENCE), maxIterations(0) {}
+
+    Strategy strategy;
+    /// Tuned parameters, read when strategy is FIXED_SEQUENCE
+    lineSearch::FixedSequence fixedSequence;
+    /// Tuned parameters, read when strategy is ERROR_NORM_BASED
+    lineSearch::ErrorNormBased errorNormBased;
+    /// Tuned iteration budget; 0 keeps the solver value. Derived from
+    /// the iteration counts of the winning replay only when every
+    /// problem of the corpus was solved.
+    size_type maxIterations;
+    /// Replay statistics of the winning parameter set
+    Statistics statistics;
+
+    /// Install the tuned iteration budget on a solver. The line-search
+    /// parameters live in the strategy instance, so solving must go
+    /// through \ref solve (or pass the tuned instance explicitly).
+    void apply(HierarchicalIterative& solver) const;
+
+    /// Solve with the tuned strategy and parameters.
+    HierarchicalIterative::Status solve(const HierarchicalIterative& solver,
+                                        vectorOut_t arg) const;
+  };
+
+  /// Candidate grids of \ref tune. The default constructor fills
+  /// neighborhoods of the hard-coded parameter values.
+  struct TuningOptions {
+    TuningOptions();
+
+    /// Candidate values of lineSearch::FixedSequence, combined as a
+    /// full grid
+    std::vector<value_type> fixedSequenceAlpha, fixedSequenceAlphaMax,
+        fixedSequenceK;
+    /// Candidate minimum step lengths of lineSearch::ErrorNormBased;
+    /// the remaining parameters derive from them as in its constructor
+    std::vector<value_type> errorNormBasedAlphaMin;
+    /// Safety factor applied to the largest observed iteration count
+    /// when deriving Profile::maxIterations
+    value_type iterationMargin;
+  };
+
+  Corpus() {}
+
+  /// Capture a problem.
+  ///
+  /// The solver is copied, so later modifications do not alter the
+  /// record; the right hand side is taken from the solver.
+  void record(const BySubstitution& solver, vectorIn_t seed);
+
+  const std::vector<Record>& records() const { return records_; }
+
+  std::size_t size() const { return records_.size(); }
+
+  /// Persist the corpus with the tagged binary format.
+  /// \param device robot the solvers are defined on; it is not stored
+  ///        in the corpus and must be provided again at load time.
+  template <typename DevicePtr>
+  void save(std::ostream& os, const DevicePtr& device) const {
+    serialization::saveBinary(os, *this, "corpus", device);
+  }
+
+  /// Restore a corpus saved by \ref save.
+  /// \throw std::runtime_error if the stream does not hold a corpus in
+  ///        the expected format version.
+  template <typename DevicePtr>
+  void load(std::istream& is, const DevicePtr& device) {
+    serialization::loadBinary(is, *this, "corpus", device);
+  }
+
+  /// Replay every record with a line-search strategy.
+  ///
+  /// Each record is solved on a copy of its solver, so replays do not
+  /// interfere with each other. Iteration counts are read from the
+  /// solve telemetry; see HierarchicalIterative::SolveTelemetry.
+  /// \param name label reported in the statistics.
+  /// \param lineSearch strategy instance, so that non-default
+  ///        parameters can be benchmarked as well.
+  template <typename LineSearchType>
+  Statistics replay(const std::string& name,
+                    LineSearchType lineSearch = LineSearchType()) const {
+    Statistics stats;
+    stats.lineSearch = name;
+    stats.nbProblems = records_.size();
+    stats.nbSuccess = 0;
+    stats.minIterations = std::numeric_limits<size_type>::max();
+    stats.maxIterations = 0;
+    stats.meanIterations = 0;
+    stats.totalTime = 0;
+    stats.iterations.reserve(records_.size());
+    for (std::size_t i = 0; i < records_.size(); ++i) {
+      const Record& r = records_[i];
+      BySubstitution solver(*r.solver);
+      solver.rightHandSide(r.rightHandSide);
+      // One telemetry sample per iteration; sizing the ring to the
+      // iteration budget makes the sample count the iteration count.
+      solver.telemetry().capacity((std::size_t)std::max<size_type>(
+          solver.maxIterations(), 1));
+      vector_t arg(r.seed);
+      std::chrono::steady_clock::time_point start(
+          std::chrono::steady_clock::now());
+      HierarchicalIterative::Status status = solver.solve(arg, lineSearch);
+      stats.totalTime += (value_type)std::chrono::duration_cast<
+                             std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count() *
+                         1e-9;
+      const size_type iterations = (size_type)solver.telemetry().size;
+      stats.iterations.push_back(iterations);
+      stats.minIterations = std::min(stats.minIterations, iterations);
+      stats.maxIterations = std::max(stats.maxIterations, iterations);
+      stats.meanIterations += (value_type)iterations;
+      if (status == HierarchicalIterative::SUCCESS) ++stats.nbSuccess;
+    }
+    if (!records_.empty())
+      stats.meanIterations /= (value_type)records_.size();
+    else
+      stats.minIterations = 0;
+    return stats;
+  }
+
+  /// Search the line-search parameters on the captured workload.
+  ///
+  /// Replays the corpus with every parameter set of the candidate
+  /// grids and returns the one solving the most problems, ties broken
+  /// by mean iteration count then by total time. When the winning set
+  /// solves every problem, the profile also carries an iteration
+  /// budget: the largest observed count scaled by
+  /// TuningOptions::iterationMargin, so that the budget covers the
+  /// workload without paying for the default headroom.
+  /// \note replays run the solvers, so tuning is an offline operation;
+  ///       expect a cost of grid size times the corpus replay time.
+  Profile tune(const TuningOptions& options = TuningOptions()) const;
+
+ private:
+  std::vector<Record> records_;
+
+  HPP_SERIALIZABLE();
+};  // class Corpus
+/// \}
+
+}  // namespace solver
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // HPP_CONSTRAINTS_SOLVER_CORPUS_HH
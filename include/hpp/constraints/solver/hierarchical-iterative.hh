@@ -29,13 +29,20 @@
 #ifndef HPP_CONSTRAINTS_SOLVER_HIERARCHICAL_ITERATIVE_HH
 #define HPP_CONSTRAINTS_SOLVER_HIERARCHICAL_ITERATIVE_HH
 
+#include <Eigen/Cholesky>
+#include <Eigen/QR>
+#include <Eigen/SVD>
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <hpp/constraints/config.hh>
 #include <hpp/constraints/fwd.hh>
 #include <hpp/constraints/implicit-constraint-set.hh>
 #include <hpp/constraints/matrix-view.hh>
+#include <hpp/constraints/packed-mask.hh>
 #include <hpp/util/serialization-fwd.hh>
-#include <map>
+#include <string>
+#include <unordered_map>
 
 namespace hpp {
 namespace constraints {
@@ -47,6 +54,10 @@ namespace lineSearch {
 struct Constant {
   template <typename SolverType>
   bool operator()(const SolverType& solver, vectorOut_t arg, vectorOut_t darg);
+  template <typename SolverType>
+  bool operator()(const SolverType& solver,
+                  typename SolverType::SolveContext& context, vectorOut_t arg,
+                  vectorOut_t darg);
 };
 
 /// Implements the backtracking line search algorithm.
@@ -56,9 +67,15 @@ struct Backtracking {
 
   template <typename SolverType>
   bool operator()(const SolverType& solver, vectorOut_t arg, vectorOut_t darg);
+  template <typename SolverType>
+  bool operator()(const SolverType& solver,
+                  typename SolverType::SolveContext& context, vectorOut_t arg,
+                  vectorOut_t darg);
 
   template <typename SolverType>
-  inline value_type computeLocalSlope(const SolverType& solver) const;
+  inline value_type computeLocalSlope(
+      const SolverType& solver,
+      const typename SolverType::SolveContext& context) const;
 
   value_type c, tau, smallAlpha;  // 0.8 ^ 7 = 0.209, 0.8 ^ 8 = 0.1677
   mutable vector_t arg_darg, df, darg;
@@ -72,6 +89,10 @@ struct FixedSequence {
 
   template <typename SolverType>
   bool operator()(const SolverType& solver, vectorOut_t arg, vectorOut_t darg);
+  template <typename SolverType>
+  bool operator()(const SolverType& solver,
+                  typename SolverType::SolveContext& context, vectorOut_t arg,
+                  vectorOut_t darg);
 
   value_type alpha;
   value_type alphaMax, K;
@@ -88,6 +109,10 @@ struct ErrorNormBased {
 
   template <typename SolverType>
   bool operator()(const SolverType& solver, vectorOut_t arg, vectorOut_t darg);
+  template <typename SolverType>
+  bool operator()(const SolverType& solver,
+                  typename SolverType::SolveContext& context, vectorOut_t arg,
+                  vectorOut_t darg);
 
   value_type C, K, a, b;
 };
@@ -136,12 +161,30 @@ struct Bounds : Base {
   vector_t lb, ub;
 };
 /// \brief Box constraints use a Device joint limits.
+///
+/// The joint limits and the configuration-to-velocity index mapping
+/// are baked into contiguous vectors on first use, so that saturate is
+/// a single vectorized clamp-and-compare pass over the whole
+/// configuration, without any virtual joint accessor.
 struct Device : Base {
-  /// \todo write a visitor.
   bool saturate(vectorIn_t q, vectorOut_t qSat, Eigen::VectorXi& saturation);
   Device() {}
   Device(const DevicePtr_t& device) : device(device) {}
+  /// Discard the baked bounds. Must be called after changing the
+  /// device joint limits or extra configuration space bounds; the
+  /// bounds are rebuilt on the next call to saturate.
+  void invalidate() {
+    lower.resize(0);
+    upper.resize(0);
+    qToV.resize(0);
+  }
   DevicePtr_t device;
+  /// Bounds of each configuration variable, baked by saturate
+  vector_t lower, upper;
+  /// Velocity index of each configuration variable, baked by saturate
+  Eigen::VectorXi qToV;
+  /// Scratch saturation mask indexed by configuration variable
+  Eigen::ArrayXi satQ;
 };
 }  // namespace saturation
 
@@ -234,11 +277,40 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   typedef Eigen::RowBlockIndices Indices_t;
   typedef lineSearch::FixedSequence DefaultLineSearch;
 
-  enum Status { ERROR_INCREASED, MAX_ITERATION_REACHED, INFEASIBLE, SUCCESS };
+  enum Status {
+    ERROR_INCREASED,
+    MAX_ITERATION_REACHED,
+    INFEASIBLE,
+    SUCCESS,
+    /// The resolution was cancelled through SolveContext::interrupt
+    /// before reaching the threshold. See \ref solveAny.
+    INTERRUPTED
+  };
+  /// Decomposition used to compute the direction of descent.
+  /// \li JACOBI_SVD: Eigen::JacobiSVD, the most robust and the slowest,
+  /// \li BDC_SVD: Eigen::BDCSVD, faster on levels with many rows,
+  /// \li COMPLETE_ORTHOGONAL_DECOMPOSITION: rank-revealing, does not
+  ///     provide singular values so \ref sigma is not updated,
+  /// \li DAMPED_CHOLESKY: Levenberg-Marquardt style resolution of the
+  ///     damped normal equations, valid when the level is known to be
+  ///     full rank. No rank nor singular value information.
+  enum DecompositionMethod {
+    JACOBI_SVD,
+    BDC_SVD,
+    COMPLETE_ORTHOGONAL_DECOMPOSITION,
+    DAMPED_CHOLESKY
+  };
   typedef shared_ptr<saturation::Base> Saturation_t;
 
   HierarchicalIterative(const LiegroupSpacePtr_t& configSpace);
 
+  /// Copy constructor
+  ///
+  /// The clone shares the constraint objects of \c other in a
+  /// copy-on-write fashion: the deep copy of the constraints is deferred
+  /// until one of the solvers modifies them (add, merge, right hand side
+  /// setters), which makes cloning cheap when specializing a solver per
+  /// roadmap edge.
   HierarchicalIterative(const HierarchicalIterative& other);
 
   virtual ~HierarchicalIterative() {}
@@ -314,13 +386,90 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
     return solve(arg, DefaultLineSearch());
   }
 
+  /// Continue a resolution started by \ref solve down to
+  /// \ref errorThreshold.
+  ///
+  /// Only meaningful when \ref coarseErrorThreshold is set: \ref solve
+  /// then stops at the coarse threshold and refine resumes the
+  /// iteration on the same warm context - the cached evaluations and
+  /// decompositions of the coarse stage are reused - so that only the
+  /// accepted samples pay for the tight tolerance.
+  ///
+  /// \param arg the solution returned by the coarse stage, refined in
+  ///        place.
+  /// \param ls line search method used.
+  template <typename LineSearchType>
+  Status refine(vectorOut_t arg, LineSearchType ls = LineSearchType()) const;
+
+  /// Same as above with the default line search method.
+  inline Status refine(vectorOut_t arg) const {
+    return refine(arg, DefaultLineSearch());
+  }
+
+  /// Solve the system of non linear equations for a batch of initial
+  /// guesses
+  ///
+  /// \param args matrix whose columns are initial guesses; each column
+  ///        is overwritten with the corresponding solution,
+  /// \param ls line search method used.
+  /// \return for each column, the status returned by
+  ///         \ref solve (vectorOut_t, LineSearchType).
+  ///
+  /// All the seeds are projected against the same constraint stack, so
+  /// the internal workspace allocated by update() is reused across
+  /// columns instead of being set up once per call site.
+  template <typename LineSearchType>
+  std::vector<Status> solve(matrixOut_t args,
+                            LineSearchType ls = LineSearchType()) const;
+
+  /// Solve the system of non linear equations for a batch of initial
+  /// guesses
+  ///
+  /// \param args matrix whose columns are initial guesses; each column
+  ///        is overwritten with the corresponding solution.
+  ///
+  /// Use the default line search method (fixed sequence of
+  /// \f$\alpha_i\f$).
+  inline std::vector<Status> solve(matrixOut_t args) const {
+    return solve(args, DefaultLineSearch());
+  }
+
+  /// Solve from several seeds concurrently and keep the first success.
+  ///
+  /// The seeds are claimed by a small pool of threads, each running
+  /// \ref solve on its own context; on the first SUCCESS an atomic
+  /// flag cancels the remaining resolutions at their next iteration
+  /// (they return INTERRUPTED), so the latency is roughly that of the
+  /// best seed instead of the sum over the seeds tried.
+  ///
+  /// \param seeds matrix whose columns are the initial guesses; only
+  ///        the winning column is overwritten, with the solution.
+  /// \param nbThreads number of concurrent resolutions; 0 and 1 try
+  ///        the seeds sequentially, still stopping at the first
+  ///        success.
+  /// \param ls line search method, copied once per thread.
+  /// \return the index of the solved column, or -1 when no seed
+  ///         converged.
+  ///
+  /// \note this drives HierarchicalIterative::solve; on a solver with
+  ///       an explicit part (BySubstitution) use the sequential
+  ///       entries instead.
+  /// \note instantiated for the line search types of this header only.
+  template <typename LineSearchType>
+  size_type solveAny(matrixOut_t seeds, std::size_t nbThreads,
+                     LineSearchType ls = LineSearchType()) const;
+
+  /// Same as above with the default line search method.
+  inline size_type solveAny(matrixOut_t seeds, std::size_t nbThreads) const {
+    return solveAny(seeds, nbThreads, DefaultLineSearch());
+  }
+
   /// Whether input vector satisfies the constraints of the solver
   /// \param arg input vector
   /// Compares to internal error threshold.
   bool isSatisfied(vectorIn_t arg) const {
-    computeValue<false>(arg);
-    computeError();
-    return squaredNorm_ < squaredErrorThreshold_;
+    computeSquaredNorm(arg);
+    return context_.squaredNorm < squaredErrorThreshold_;
   }
 
   /// Whether input vector satisfies the constraints of the solver
@@ -328,11 +477,72 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   /// \param errorThreshold threshold to use instead of the value
   ///        stored in the solver.
   bool isSatisfied(vectorIn_t arg, value_type errorThreshold) const {
-    computeValue<false>(arg);
-    computeError();
-    return squaredNorm_ < errorThreshold * errorThreshold;
+    computeSquaredNorm(arg);
+    return context_.squaredNorm < errorThreshold * errorThreshold;
+  }
+
+  /// Whether input vector satisfies the constraints of the solver,
+  /// with early exit.
+  ///
+  /// Same answer as \ref isSatisfied(vectorIn_t) const, but the
+  /// constraints are evaluated one by one and the evaluation stops as
+  /// soon as one of them crosses the threshold, skipping the remaining
+  /// functions. Intended for pure feasibility tests such as path
+  /// validation, where most samples are clearly violated.
+  /// \warning on a negative answer the cached values of computeValue
+  ///          are left partially evaluated, so residualError must not
+  ///          be read afterwards without calling computeValue again.
+  /// \param arg input vector
+  bool isSatisfiedFast(vectorIn_t arg) const {
+    return isSatisfiedFast(arg, context_, squaredErrorThreshold_);
   }
 
+  /// Same as \ref isSatisfiedFast(vectorIn_t) const with a given
+  /// threshold.
+  bool isSatisfiedFast(vectorIn_t arg, value_type errorThreshold) const {
+    return isSatisfiedFast(arg, context_, errorThreshold * errorThreshold);
+  }
+
+  /// Same as \ref isSatisfiedFast(vectorIn_t) const on a given context.
+  bool isSatisfiedFast(vectorIn_t arg, SolveContext& context,
+                       value_type squaredErrorThreshold) const;
+
+  /// Whether each column of a configuration batch satisfies the
+  /// constraints of the solver.
+  ///
+  /// Iterates on columns so that each sample works on contiguous
+  /// storage and the solver workspace stays hot between two
+  /// consecutive samples; each sample benefits from the early exit of
+  /// \ref isSatisfiedFast. Intended for checking the samples of a path
+  /// or the nodes of a roadmap in one call.
+  /// \param configs one configuration per column
+  /// \retval results one boolean per column, resized as needed.
+  void isSatisfied(matrixIn_t configs, ArrayXb& results) const {
+    results.resize(configs.cols());
+    for (size_type c = 0; c < configs.cols(); ++c)
+      results[c] = isSatisfiedFast(configs.col(c));
+  }
+
+  /// Remember the error norm of the last configurations passed to
+  /// \ref isSatisfied.
+  ///
+  /// When \c capacity is non zero, isSatisfied keeps the squared error
+  /// norm of the \c capacity most recently asked configurations, so
+  /// that asking again about an unchanged configuration is a hash
+  /// lookup instead of a full evaluation. Intended for clients that
+  /// test the same samples against the same solver many times, such as
+  /// graph queries on a roadmap. Any right hand side modification
+  /// discards the remembered results, so the answers never go stale.
+  /// \param capacity number of configurations remembered; 0 (the
+  ///        default) disables the memoization and frees its storage.
+  /// \warning on a remembered configuration the constraints are not
+  ///          re-evaluated, so \ref residualError must not be read
+  ///          after the call without calling computeValue again.
+  void satisfactionCache(std::size_t capacity);
+
+  /// Capacity of the memoized isSatisfied results, 0 when disabled.
+  std::size_t satisfactionCache() const;
+
   /// Whether a constraint is satisfied for an input vector
   ///
   /// \param constraint, the constraint in the solver,
@@ -349,7 +559,7 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   /// If the jacobian has maximum rank r, then it corresponds to r-th
   /// greatest singular value. This value is zero when the jacobian is
   /// singular.
-  const value_type& sigma() const { return sigma_; }
+  const value_type& sigma() const { return context_.sigma; }
 
   /// \}
 
@@ -396,6 +606,24 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   /// Get error threshold
   value_type squaredErrorThreshold() const { return squaredErrorThreshold_; }
 
+  /// Set the coarse error threshold of the two stage schedule.
+  ///
+  /// When non zero, \ref solve stops as soon as the residual is below
+  /// this threshold and \ref refine continues the resolution down to
+  /// \ref errorThreshold. Useful when most samples are discarded
+  /// before the tight tolerance is needed, e.g. during roadmap
+  /// exploration; the coarse stage combines well with a cheap line
+  /// search (lineSearch::Constant) and with
+  /// \ref jacobianTransposeThreshold, which engages the decomposition
+  /// free stepping while the error is still large.
+  void coarseErrorThreshold(const value_type& threshold) {
+    squaredCoarseErrorThreshold_ = threshold * threshold;
+  }
+  /// Get the coarse error threshold. Zero when disabled.
+  value_type coarseErrorThreshold() const {
+    return sqrt(squaredCoarseErrorThreshold_);
+  }
+
   /// Get the inequality threshold
   value_type inequalityThreshold() const { return inequalityThreshold_; }
   /// set the inequality threshold
@@ -416,6 +644,94 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
 
   // Get whether the constraints are solved level by level
   bool solveLevelByLevel() const { return solveLevelByLevel_; }
+
+  /// Set the decomposition used to compute the direction of descent.
+  ///
+  /// \note Methods other than JACOBI_SVD are only used when the solver
+  ///       contains a single priority level. The hierarchical resolution
+  ///       needs the kernel basis that only the SVD provides, so stacks
+  ///       with several levels always use JACOBI_SVD.
+  void decomposition(const DecompositionMethod& method) {
+    decomposition_ = method;
+    update();
+  }
+
+  /// Get the decomposition used to compute the direction of descent.
+  const DecompositionMethod& decomposition() const { return decomposition_; }
+
+  /// Set the damping coefficient used by the DAMPED_CHOLESKY
+  /// decomposition.
+  void choleskyDamping(const value_type& damping) {
+    choleskyDamping_ = damping;
+  }
+
+  /// Get the damping coefficient used by the DAMPED_CHOLESKY
+  /// decomposition.
+  value_type choleskyDamping() const { return choleskyDamping_; }
+
+  /// Set the error norm above which the descent direction is a scaled
+  /// Jacobian-transpose step instead of a pseudo-inverse step.
+  ///
+  /// Far from the solution any descent direction makes progress, so a
+  /// decomposition per iteration is wasted work. While the error norm
+  /// is above this threshold, computeDescentDirection uses
+  /// \f$ dq = \alpha J^T e \f$ with the first-order optimal scaling
+  /// \f$ \alpha = \|J^Te\|^2 / \|JJ^Te\|^2 \f$ and computes no
+  /// decomposition at all; the pseudo-inverse path resumes once the
+  /// error falls below the threshold. Disabled when zero, the default.
+  /// \note only applies to stacks with a single priority level; the
+  ///       hierarchical resolution always uses the SVD.
+  void jacobianTransposeThreshold(const value_type& threshold) {
+    squaredJacobianTransposeThreshold_ = threshold * threshold;
+  }
+
+  /// Get the error norm above which Jacobian-transpose steps are used.
+  value_type jacobianTransposeThreshold() const {
+    return sqrt(squaredJacobianTransposeThreshold_);
+  }
+
+  /// Set the relative residual below which the decomposition of the
+  /// previous iteration is warm started.
+  ///
+  /// Between consecutive Newton iterations the reduced Jacobian changes
+  /// by a small perturbation, so its row space stays close to the right
+  /// singular subspace \f$ V \f$ of the previous decomposition. While
+  /// the relative projection residual
+  /// \f$ \|J - JVV^T\|_F / \|J\|_F \f$ is below this threshold,
+  /// computeDescentDirection decomposes the much smaller projected
+  /// matrix \f$ JV \f$ instead of \f$ J \f$; a full decomposition is
+  /// recomputed - and \f$ V \f$ refreshed - as soon as the residual
+  /// grows past it. Disabled when zero, the default.
+  /// \note only applies to the JACOBI_SVD decomposition on stacks with
+  ///       a single priority level.
+  void incrementalSvdThreshold(const value_type& threshold) {
+    squaredIncrementalSvdThreshold_ = threshold * threshold;
+    update();
+  }
+
+  /// Get the relative residual below which the previous right singular
+  /// subspace is reused.
+  value_type incrementalSvdThreshold() const {
+    return sqrt(squaredIncrementalSvdThreshold_);
+  }
+
+  /// Set the number of Newton iterations between two evaluations of the
+  /// exact constraint Jacobians.
+  ///
+  /// With a period of 1 (the default), the Jacobians are recomputed at
+  /// every iteration. With a larger period, the iterations in between
+  /// apply a Broyden rank-one update to the reduced Jacobians instead,
+  /// which avoids the expensive calls to DifferentiableFunction::jacobian
+  /// when the configuration barely moved. The exact Jacobians are also
+  /// recomputed whenever the error stops decreasing.
+  void jacobianRefreshPeriod(const size_type& period) {
+    assert(period >= 1);
+    jacobianRefreshPeriod_ = period;
+  }
+
+  /// Get the number of Newton iterations between two evaluations of the
+  /// exact constraint Jacobians.
+  size_type jacobianRefreshPeriod() const { return jacobianRefreshPeriod_; }
   /// \}
 
   /// \name Stack
@@ -447,7 +763,7 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   /// \}
 
   /// Returns the squared norm of the error vector
-  value_type residualError() const { return squaredNorm_; }
+  value_type residualError() const { return context_.squaredNorm; }
 
   /// Returns the error vector
   void residualError(vectorOut_t error) const;
@@ -473,6 +789,29 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   /// \note Only parameterizable constraints (type Equality) are set
   vector_t rightHandSideFromConfig(ConfigurationIn_t config);
 
+  /// Same as above, writing the right hand side into \c rhs instead of
+  /// returning it by value.
+  /// \param config a configuration,
+  /// \retval rhs vector of size \ref rightHandSideSize.
+  void rightHandSideFromConfig(ConfigurationIn_t config, vectorOut_t rhs);
+
+  /// Compute the right hand sides of several solvers from one
+  /// configuration.
+  ///
+  /// Equivalent to calling \ref rightHandSideFromConfig on each solver,
+  /// but each unique parameterizable function is evaluated only once
+  /// and its value distributed to every solver referencing it.
+  /// Functions are unique in the sense of pointer identity, which
+  /// \ref DifferentiableFunctionRegistry restores across deserialized
+  /// constraints. Intended for roadmap node insertion, where the
+  /// solvers of all the adjacent edges share the same Equality
+  /// constraints on the new configuration.
+  /// \param config a configuration,
+  /// \param solvers the solvers to update.
+  static void rightHandSideFromConfig(
+      ConfigurationIn_t config,
+      const std::vector<HierarchicalIterative*>& solvers);
+
   /// Compute right hand side of a constraint from a configuration
   /// \param constraint the constraint,
   /// \param config a configuration.
@@ -508,67 +847,501 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   ///       constraints (type Equality).
   vector_t rightHandSide() const;
 
+  /// Same as above, writing the right hand side into \c rhs instead of
+  /// returning it by value.
+  /// \retval rhs vector of size \ref rightHandSideSize.
+  void getRightHandSide(vectorOut_t rhs) const;
+
+  /// Read only view on the right hand side.
+  ///
+  /// The returned reference stays valid for the lifetime of the solver;
+  /// its content tracks the right hand side mutators. The vector is
+  /// gathered from the per level storage once per mutation, not per
+  /// read, so polling it is allocation and copy free - unlike \ref
+  /// rightHandSide which builds a fresh vector on every call.
+  /// \warning like \ref satisfactionCache, mutations are only tracked
+  ///          when they go through the solver accessors.
+  const vector_t& rightHandSideView() const;
+
   /// Get size of the right hand side
   /// \return sum of dimensions of parameterizable constraints
   ///         (type Equality)
   size_type rightHandSideSize() const;
 
-  /// \}
-
-  /// \name Access to internal data
-  /// You should know what you do when you call these functions
-  /// \{
+  /// Compact copy of the mutable problem parameters of a solver.
+  ///
+  /// Capturing and restoring costs O(size of the right hand side),
+  /// against a full solver copy which duplicates the constraints and
+  /// the preallocated workspace. Intended for what-if sweeps trying
+  /// alternative right hand sides - e.g. grasp poses - on the same
+  /// constraint stack.
+  struct Snapshot {
+    vector_t rightHandSide;
+    Indices_t freeVariables;
+    value_type squaredErrorThreshold, squaredCoarseErrorThreshold,
+        inequalityThreshold;
+    size_type maxIterations;
+  };
 
-  /// Compute the value of each level, and the jacobian if ComputeJac is true.
-  template <bool ComputeJac>
-  void computeValue(vectorIn_t arg) const;
-  void computeSaturation(vectorIn_t arg) const;
-  void getValue(vectorOut_t v) const;
-  void getReducedJacobian(matrixOut_t J) const;
-  /// If lastIsOptional() is true, then the last level is ignored.
-  /// \warning computeValue must have been called first.
-  void computeError() const;
+  /// Capture the mutable problem parameters: the right hand side, the
+  /// free variables, the thresholds and the maximal number of
+  /// iterations.
+  /// \warning the constraints themselves are not captured; restoring
+  ///          a snapshot on a solver whose constraints changed since
+  ///          the capture is undefined.
+  virtual Snapshot snapshot() const;
 
-  /// Accessor to the last step done
-  const vector_t& lastStep() const { return dq_; }
+  /// Restore the parameters captured by \ref snapshot.
+  void restore(const Snapshot& snapshot);
 
-  virtual bool integrate(vectorIn_t from, vectorIn_t velocity,
-                         vectorOut_t result) const;
   /// \}
 
-  virtual std::ostream& print(std::ostream& os) const;
+  /// \name Access to internal data
+  /// You should know what you do when you call these functions
+  /// \{
 
- protected:
   typedef Eigen::JacobiSVD<matrix_t> SVD_t;
+  typedef Eigen::BDCSVD<matrix_t> BDCSVD_t;
+  typedef Eigen::CompleteOrthogonalDecomposition<matrix_t> COD_t;
+  typedef Eigen::LLT<matrix_t> LLT_t;
+  typedef Eigen::Matrix<value_type, 6, Eigen::Dynamic> matrix6x_t;
+  typedef Eigen::JacobiSVD<matrix6x_t> SVD6_t;
 
   struct Data {
     /// \cond
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
     /// \endcond
+    /// The scratch matrices and vectors below are views into the arena
+    /// of the owning SolveContext, carved by
+    /// HierarchicalIterative::update so that all the levels of a solver
+    /// share a single heap block. See SolveContext::arena.
+    typedef Eigen::Map<matrix_t> MatrixMap_t;
+    typedef Eigen::Map<matrix6x_t> Matrix6xMap_t;
+    typedef Eigen::Map<vector_t> VectorMap_t;
+
+    Data();
+
     LiegroupElement output, rightHandSide;
-    vector_t error;
-    matrix_t jacobian, reducedJ;
+    VectorMap_t error;
+    MatrixMap_t jacobian, reducedJ;
+    /// Jacobian written straight into the reduced column layout when
+    /// the level function provides \ref
+    /// DifferentiableFunction::jacobianOnColumns and the solver allows
+    /// it; jacobian then keeps a zero width and the full nv wide
+    /// intermediate is never materialized.
+    mutable MatrixMap_t jacobianReduced;
+    /// Whether computeValue fills jacobianReduced instead of jacobian.
+    /// Set by HierarchicalIterative::update.
+    bool directJacobian;
 
     SVD_t svd;
+    /// Fixed-row-count decomposition, used instead of svd when the
+    /// stack has a single level whose active error dimension is exactly
+    /// 6 - the canonical pose constraint. The fixed row count lets the
+    /// SVD work on stack-allocated 6x6 blocks. Selected automatically
+    /// by HierarchicalIterative::update.
+    SVD6_t svd6;
+    mutable Matrix6xMap_t reducedJ6;
+    bool useSvd6;
+    /// Alternative decompositions, sized in
+    /// HierarchicalIterative::update according to
+    /// HierarchicalIterative::decomposition.
+    BDCSVD_t bdcSvd;
+    COD_t cod;
+    LLT_t llt;
+    mutable MatrixMap_t JJt;
+    /// Projector onto the kernel of the previous levels. Its number of
+    /// columns follows the rank met at run time, so it keeps its own
+    /// storage instead of a view into the arena.
     matrix_t PK;
 
+    /// Workspaces sized in HierarchicalIterative::update so that
+    /// computeDescentDirection does not allocate inside the Newton loop.
+    mutable MatrixMap_t JP;
+    mutable VectorMap_t reducedError;
+    mutable VectorMap_t svdRhs;
+    /// Workspace of the Jacobian-transpose step scaling. See
+    /// HierarchicalIterative::jacobianTransposeThreshold.
+    mutable VectorMap_t Jdq;
+    /// Right singular subspace of the previous iteration, the
+    /// projection of the current Jacobian onto it and the decomposition
+    /// of that projection. See
+    /// HierarchicalIterative::incrementalSvdThreshold. previousV is
+    /// sized with the rank of the decomposition that produced it, so
+    /// like PK it owns its storage.
+    mutable matrix_t previousV;
+    mutable MatrixMap_t JV;
+    mutable SVD_t svdJV;
+    mutable VectorMap_t vJV;
+    /// Error before the last step, used by the Broyden update. See
+    /// HierarchicalIterative::jacobianRefreshPeriod.
+    mutable VectorMap_t broydenError;
+
+    /// Structurally non-zero columns of reducedJ, and the compact
+    /// matrix gathering them. On a single level stack,
+    /// HierarchicalIterative::computeDescentDirection runs the
+    /// decomposition on the compact matrix so that the zero blocks of
+    /// reducedJ are never traversed.
+    Eigen::ColBlockIndices activeCols;
+    mutable MatrixMap_t reducedJcompact;
+    mutable VectorMap_t dqCompact;
+
+    /// Input slice this level actually reads and the input of the last
+    /// evaluation, used by HierarchicalIterative::computeValue to skip
+    /// levels whose inputs did not change.
+    Eigen::RowBlockIndices activeArgs;
+    mutable VectorMap_t lastArg;
+    mutable bool lastArgValid, lastJacValid;
+
     mutable size_type maxRank;
 
+#ifdef HPP_CONSTRAINTS_SOLVER_TIMINGS
+    /// Evaluation counters and accumulated durations of this level,
+    /// filled by HierarchicalIterative::computeValue and
+    /// HierarchicalIterative::computeDescentDirection. See
+    /// HierarchicalIterative::performanceReport.
+    mutable std::size_t nbValueEvaluations, nbJacobianEvaluations,
+        nbDecompositions;
+    mutable long long valueNanoseconds, decompositionNanoseconds;
+#endif
+
     ComparisonTypes_t comparison;
     std::vector<std::size_t> inequalityIndices;
+    /// Comparison types folded into coefficients: +1 on Superior rows,
+    /// -1 on Inferior rows and 0 elsewhere. Filled by
+    /// HierarchicalIterative::update so that applyComparison handles
+    /// all the rows with branch-free vector operations.
+    vector_t inequalitySign;
+    /// Scratch of applyComparison: 1 on the rows whose error is kept,
+    /// 0 on satisfied inequality rows. Empty when the level has no
+    /// inequality row.
+    mutable VectorMap_t inequalityKeep;
     Eigen::RowBlockIndices equalityIndices;
     Eigen::MatrixBlocks<false, false> activeRowsOfJ;
+    /// Gather of activeRowsOfJ compiled into run plans by
+    /// computeActiveRowsOfJ. Assembling reducedJ replays a few large
+    /// tile copies, column runs outermost so that the jacobian and
+    /// reducedJ are walked in storage order, instead of rebuilding an
+    /// Eigen block per segment pair at every evaluation.
+    Eigen::BlockCopyPlan reducedRowsPlan, reducedColsPlan;
+
+    /// Derivative parameters whose motion changes reducedJ: the union
+    /// of the active derivative parameters of the constraints kept in
+    /// activeRowsOfJ. Filled by computeActiveRowsOfJ.
+    PackedMask stepDependencies;
+    /// Whether svd - and PK when the level is not the last one - still
+    /// match reducedJ and the projector of the upstream levels.
+    /// Cleared whenever a step moves a dof of stepDependencies, so that
+    /// computeDescentDirection reuses the decomposition of levels the
+    /// iteration left untouched - typically levels already converged
+    /// when solving level by level.
+    mutable bool decompositionValid;
+
+    /// Rebind the scratch views to another arena, keeping their sizes
+    /// and relative offsets. Called by the SolveContext copy, whose
+    /// freshly copied views still point into the arena of the source.
+    void retargetScratch(value_type* base, const value_type* oldBase);
+  };
+
+  /// Convergence telemetry of \ref solve.
+  ///
+  /// One sample per Newton iteration is written into a fixed capacity
+  /// ring buffer, so that the cost in the solve loop is a few scalar
+  /// stores and the buffer never allocates once sized. The buffer can
+  /// stay on in production and be dumped offline when a solve ends with
+  /// MAX_ITERATION_REACHED.
+  struct SolveTelemetry {
+    struct Iteration {
+      /// Rank of the solve since the context was created
+      std::size_t solveId;
+      /// Rank of the iteration within its solve
+      size_type iteration;
+      /// Squared error norm at the end of the iteration
+      value_type squaredNorm;
+      /// Smallest non-zero singular value met since the last update
+      value_type sigma;
+      /// Scaling applied by the line search, measured as the ratio
+      /// between the applied and the computed step norms
+      value_type alpha;
+      /// Number of saturated degrees of freedom
+      size_type nbSaturations;
+    };
+
+    SolveTelemetry() : ring(128), head(0), size(0), solveId(0) {}
+
+    /// Resize the ring buffer and discard its content.
+    void capacity(std::size_t n) {
+      ring.assign(std::max<std::size_t>(n, 1), Iteration());
+      head = 0;
+      size = 0;
+    }
+
+    /// Overwrite the oldest sample with it.
+    void record(const Iteration& it) {
+      ring[head] = it;
+      head = (head + 1) % ring.size();
+      if (size < ring.size()) ++size;
+    }
+
+    /// Chronologically ordered copy of the buffer, oldest sample first.
+    std::vector<Iteration> dump() const {
+      std::vector<Iteration> its(size);
+      for (std::size_t i = 0; i < size; ++i)
+        its[i] = ring[(head + ring.size() - size + i) % ring.size()];
+      return its;
+    }
+
+    std::vector<Iteration> ring;
+    std::size_t head, size, solveId;
   };
 
+  /// Scratch data of the iterative resolution.
+  ///
+  /// The solver owns a default context used by
+  /// \ref solve (vectorOut_t, LineSearchType) const. To run several
+  /// resolutions concurrently on the same solver, give each thread its
+  /// own context initialized with \ref initSolveContext and use
+  /// \ref solve (vectorOut_t, SolveContext&, LineSearchType) const.
+  ///
+  /// \note the context holds a snapshot of the right hand side; it must
+  ///       be re-initialized whenever the problem definition (stack,
+  ///       free variables, right hand side) changes.
+  struct SolveContext {
+    /// \cond
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    /// \endcond
+    SolveContext() : saturationValid(false), interrupt(NULL) {}
+    /// Deep copy: the arena is copied and the scratch views of the
+    /// copied datas are retargeted to the copy, so that two contexts
+    /// never share storage.
+    SolveContext(const SolveContext& other);
+    SolveContext& operator=(const SolveContext& other);
+
+    std::vector<Data> datas;
+    /// The smallest non-zero singular value
+    value_type sigma;
+    vector_t dq, dqSmall, dqTmp;
+    Eigen::VectorXi saturation, reducedSaturation;
+    Configuration_t qSat;
+    /// Saturated set of the previous computeSaturation call. While a
+    /// dof rides its limit - the common case once a joint hits a bound
+    /// - the saturated set is stable across iterations and the reduced
+    /// mask and \ref satCols are reused instead of being regathered.
+    Eigen::VectorXi lastSaturation;
+    /// Reduced indices of the saturated dofs, rebuilt when the
+    /// saturated set changes. Column pruning only traverses these
+    /// columns instead of computing a full \f$J^T e\f$ product.
+    std::vector<size_type> satCols;
+    /// Whether lastSaturation, reducedSaturation and satCols are up to
+    /// date. Cleared by update, which changes the free variable plan
+    /// they are gathered with.
+    bool saturationValid;
+    value_type squaredNorm;
+    /// Per-iteration samples of \ref solve; see SolveTelemetry.
+    SolveTelemetry telemetry;
+    /// Single slab backing the scratch matrices and vectors of every
+    /// entry of \ref datas, sized once by HierarchicalIterative::update.
+    /// Packing them improves locality in computeDescentDirection and
+    /// replaces dozens of separate heap blocks per solver with one.
+    vector_t arena;
+    /// Scratch mask of the dofs moved by the last step, used by
+    /// invalidateStaleDecompositions. Sized once by
+    /// HierarchicalIterative::update.
+    PackedMask movedDofs;
+    /// Cooperative cancellation flag, polled once per iteration by the
+    /// solve loop; NULL (the default) disables the check. Set by
+    /// \ref solveAny to cancel the remaining seeds on first success.
+    const std::atomic<bool>* interrupt;
+  };
+
+  /// Initialize a per-thread context from the solver default one.
+  void initSolveContext(SolveContext& context) const { context = context_; }
+
+  /// Solve the system of non linear equations using the scratch data of
+  /// context instead of the solver internal one.
+  ///
+  /// This method is reentrant provided that each thread uses its own
+  /// context, line search object and vector arg.
+  template <typename LineSearchType>
+  Status solve(vectorOut_t arg, SolveContext& context,
+               LineSearchType ls = LineSearchType()) const;
+
+  /// Same as \ref refine (vectorOut_t, LineSearchType) const on a
+  /// given context.
+  template <typename LineSearchType>
+  Status refine(vectorOut_t arg, SolveContext& context,
+                LineSearchType ls = LineSearchType()) const;
+
+  /// Compute the value of each level, and the jacobian if ComputeJac is true.
+  template <bool ComputeJac>
+  void computeValue(vectorIn_t arg) const {
+    computeValue<ComputeJac>(arg, context_);
+  }
+  template <bool ComputeJac>
+  void computeValue(vectorIn_t arg, SolveContext& context) const;
+  void computeSaturation(vectorIn_t arg) const {
+    computeSaturation(arg, context_);
+  }
+  void computeSaturation(vectorIn_t arg, SolveContext& context) const;
+  void getValue(vectorOut_t v) const;
+  void getReducedJacobian(matrixOut_t J) const;
+  /// If lastIsOptional() is true, then the last level is ignored.
+  /// \warning computeValue must have been called first.
+  void computeError() const { computeError(context_); }
+  void computeError(SolveContext& context) const;
+
+  /// Accessor to the last step done
+  const vector_t& lastStep() const { return context_.dq; }
+
+  virtual bool integrate(vectorIn_t from, vectorIn_t velocity,
+                         vectorOut_t result) const {
+    return integrate(from, velocity, result, context_);
+  }
+  virtual bool integrate(vectorIn_t from, vectorIn_t velocity,
+                         vectorOut_t result, SolveContext& context) const;
+  /// \}
+
+  /// \name Performance instrumentation
+  /// \{
+
+  /// Per-constraint evaluation statistics of the default context.
+  ///
+  /// Filled by computeValue and computeDescentDirection when the
+  /// library is built with the SOLVER_TIMINGS cmake option; empty
+  /// otherwise. The functions of one priority level are evaluated
+  /// together, so constraints of the same level report identical
+  /// counters and timings.
+  struct PerformanceReport {
+    struct Entry {
+      /// Name of the constraint function
+      std::string name;
+      /// Priority level of the constraint
+      std::size_t priority;
+      /// Number of evaluations of the level values
+      std::size_t nbValueEvaluations;
+      /// Number of evaluations of the level Jacobians
+      std::size_t nbJacobianEvaluations;
+      /// Number of decompositions of the level reduced Jacobian
+      std::size_t nbDecompositions;
+      /// Accumulated evaluation time of the level, in seconds
+      value_type valueTime;
+      /// Accumulated decomposition and resolution time of the level,
+      /// in seconds
+      value_type decompositionTime;
+    };
+    std::vector<Entry> entries;
+  };
+
+  /// Aggregate the counters of the default context by constraint name.
+  /// \return one entry per constraint, or an empty report when the
+  ///         library is built without SOLVER_TIMINGS.
+  PerformanceReport performanceReport() const;
+
+  /// Reset the counters of the default context. Does nothing when the
+  /// library is built without SOLVER_TIMINGS.
+  void resetPerformanceReport() const;
+
+  /// Convergence telemetry of the default context. Use
+  /// SolveTelemetry::dump to inspect the last iterations and
+  /// SolveTelemetry::capacity to size the ring buffer.
+  SolveTelemetry& telemetry() const { return context_.telemetry; }
+
+  /// Heap footprint of the solver buffers, in bytes per component.
+  ///
+  /// Useful to track the memory cost of applications keeping many
+  /// solvers resident. The buffers of the constraint functions
+  /// themselves are not counted.
+  struct MemoryUsageReport {
+    MemoryUsageReport()
+        : arena(0),
+          datas(0),
+          decompositions(0),
+          context(0),
+          solver(0),
+          explicitSet(0) {}
+
+    /// Scratch arena of the default context. See SolveContext::arena.
+    std::size_t arena;
+    /// Level buffers kept outside the arena: outputs, right hand
+    /// sides, comparisons and the rank-dependent matrices Data::PK and
+    /// Data::previousV.
+    std::size_t datas;
+    /// Decomposition factors and workspaces of every level, estimated
+    /// from the shapes chosen by update.
+    std::size_t decompositions;
+    /// Vectors owned by the default context: descent directions,
+    /// saturation buffers and the telemetry ring.
+    std::size_t context;
+    /// Stacked reduced Jacobian and its decomposition, used by the
+    /// kernel projection.
+    std::size_t solver;
+    /// Buffers of the explicit resolution; zero here, filled by
+    /// BySubstitution. See ExplicitConstraintSet::memoryUsage.
+    std::size_t explicitSet;
+
+    /// Sum of all the components.
+    std::size_t total() const {
+      return arena + datas + decompositions + context + solver + explicitSet;
+    }
+  };
+
+  /// Walk the default context, the levels and the decompositions and
+  /// report their footprint. Decomposition sizes are derived from the
+  /// shapes sized by update, not measured, so the report is a close
+  /// estimate rather than an exact heap count.
+  virtual MemoryUsageReport memoryUsage() const;
+
+  /// \}
+
+  virtual std::ostream& print(std::ostream& os) const;
+
+ protected:
+  /// Take ownership of the constraint objects if they are still shared
+  /// with the solver this one was copied from.
+  /// Must be called before any operation that modifies the constraints.
+  void copyConstraintsOnWrite();
+
+  /// Invalidate the cached evaluations of the default context, forcing
+  /// the next computeValue call to re-evaluate every level. Must be
+  /// called whenever the error changes for a reason other than the
+  /// input, e.g. when a right hand side is modified.
+  void invalidateValueCache() const;
+
+  /// Implementation of \ref isSatisfied: compute the squared norm of
+  /// the error at arg into SolveContext::squaredNorm, going through
+  /// the memoized results of \ref satisfactionCache when enabled.
+  void computeSquaredNorm(vectorIn_t arg) const;
+
   /// Allocate datas and update sizes of the problem
   /// Should be called whenever the stack is modified.
   void update();
 
   /// Compute which rows of the jacobian of stack_[iStack]
   /// are not zero, using the activeDerivativeParameters of the functions.
-  /// The result is stored in datas_[i].activeRowsOfJ
+  /// The result is stored in context_.datas[i].activeRowsOfJ
   virtual void computeActiveRowsOfJ(std::size_t iStack);
 
+  /// Compute which columns of the reduced jacobian of stack_[iStack]
+  /// are structurally non zero, using the activeDerivativeParameters of
+  /// the functions. The result is stored in
+  /// context_.datas[i].activeCols and used by computeDescentDirection
+  /// to traverse the active blocks only.
+  virtual void computeActiveColsOfJ(std::size_t iStack);
+
+  /// Whether computeValue may ask the level functions to write their
+  /// Jacobian straight into the reduced column layout of
+  /// Data::jacobianReduced instead of the full width Data::jacobian.
+  /// Derived solvers that read columns of Data::jacobian outside the
+  /// free variables must return false.
+  virtual bool directJacobianUsable() const { return true; }
+
+  /// Carve the scratch views of context_.datas[iStack] out of buffer
+  /// and advance it, or only count when buffer is NULL. Called twice by
+  /// \ref update: once to size SolveContext::arena, once to bind the
+  /// views into it. \return the number of scalars this level needs.
+  size_type bindScratch(std::size_t iStack, size_type reducedSize,
+                        value_type*& buffer);
+
   /// Compute a SVD decomposition of each level and find the best descent
   /// direction at the first order.
   /// Linearization of the system of equations
@@ -576,48 +1349,125 @@ class HPP_CONSTRAINTS_DLLAPI HierarchicalIterative {
   /// q_{i+1} - q_{i} = J(q_i)^{+} ( rhs - v_{i} )
   /// dq = J(q_i)^{+} ( rhs - v_{i} )
   /// \warning computeValue<true> must have been called first.
-  void computeDescentDirection() const;
-  void expandDqSmall() const;
+  void computeDescentDirection() const { computeDescentDirection(context_); }
+  void computeDescentDirection(SolveContext& context) const;
+  /// Clear Data::decompositionValid of the levels whose
+  /// Data::stepDependencies intersect the dofs moved by context.dq.
+  /// Called by solve after each applied step.
+  void invalidateStaleDecompositions(SolveContext& context) const;
+  /// Implementation of \ref solve and \ref refine: iterate until the
+  /// given squared residual threshold is reached. \ref solve passes
+  /// \ref coarseErrorThreshold when it is set, \ref refine always
+  /// passes \ref errorThreshold.
+  template <typename LineSearchType>
+  Status impl_solve(vectorOut_t arg, SolveContext& context,
+                    value_type squaredThreshold, LineSearchType ls) const;
+  /// Apply a Broyden rank-one update to the reduced Jacobian of each
+  /// level, using the last step (context.dq) and the difference between
+  /// the error before the step (Data::broydenError) and the current one.
+  /// \warning computeValue<false> must have been called after the step.
+  void applyBroydenUpdate(SolveContext& context) const;
+  void expandDqSmall(SolveContext& context) const;
   void saturate(vectorOut_t arg) const;
 
+  /// Bookkeeping of a constraint, resolved once when the constraint is
+  /// added to the solver.
+  struct ConstraintIndices {
+    DifferentiableFunctionPtr_t function;
+    /// Priority level of the constraint
+    std::size_t priority;
+    /// Value rank of the constraint in its priority level
+    size_type iq;
+    /// Derivative rank of the constraint in its priority level
+    size_type iv;
+  };
+
+  /// Append a constraint to \ref constraints_ and index it by function
+  /// name, so that \ref contains runs in constant time on average.
+  void registerConstraint(const ImplicitPtr_t& constraint);
+
+  /// Retrieve the bookkeeping of a constraint function.
+  /// \return NULL when the function was never added to this solver.
+  const ConstraintIndices* findConstraintIndices(
+      const DifferentiableFunctionPtr_t& f) const;
+
   value_type squaredErrorThreshold_, inequalityThreshold_;
+  /// Coarse threshold of the two stage schedule, 0 when disabled. See
+  /// \ref coarseErrorThreshold.
+  value_type squaredCoarseErrorThreshold_;
   size_type maxIterations_;
 
+  /// One step of the integration plan of \ref integrate: either a
+  /// maximal run of vector space blocks of the configuration space,
+  /// integrated as one fused addition, or a single non Euclidean block
+  /// handled through the Lie group machinery.
+  struct IntegrationSegment {
+    /// Configuration and velocity ranges of the run
+    size_type iq, nq, iv, nv;
+    /// Rank of the block in LiegroupSpace::liegroupTypes, or
+    /// npos for vector space runs
+    std::size_t rank;
+    static const std::size_t npos = (std::size_t)-1;
+  };
+
+  /// Decompose \ref configSpace_ into \ref integrationPlan_
+  void buildIntegrationPlan();
+
   std::vector<ImplicitConstraintSet> stacks_;
   LiegroupSpacePtr_t configSpace_;
+  /// Decomposition of configSpace_ used by \ref integrate, built at
+  /// construction and on deserialization
+  std::vector<IntegrationSegment> integrationPlan_;
   size_type dimension_, reducedDimension_;
   bool lastIsOptional_;
   bool solveLevelByLevel_;
+  DecompositionMethod decomposition_;
+  value_type choleskyDamping_;
+  value_type squaredJacobianTransposeThreshold_;
+  value_type squaredIncrementalSvdThreshold_;
+  size_type jacobianRefreshPeriod_;
   /// Unknown of the set of implicit constraints
   Indices_t freeVariables_;
+  /// Compiled copy plan of freeVariables_, kept in sync by update
+  Eigen::BlockCopyPlan freeVariablesPlan_;
   Saturation_t saturate_;
   /// Members moved from core::ConfigProjector
   NumericalConstraints_t constraints_;
-  /// Value rank of constraint in its priority level
-  std::map<DifferentiableFunctionPtr_t, size_type> iq_;
-  /// Derivative rank of constraint in its priority level
-  std::map<DifferentiableFunctionPtr_t, size_type> iv_;
-  /// Priority level of constraint
-  std::map<DifferentiableFunctionPtr_t, std::size_t> priority_;
-
-  /// The smallest non-zero singular value
-  mutable value_type sigma_;
-
-  mutable vector_t dq_, dqSmall_;
+  /// Whether constraints_ is shared with the solver this one was copied
+  /// from. See copyConstraintsOnWrite.
+  bool sharedConstraints_;
+  /// Ranks and priority of each constraint, filled by \ref add
+  std::vector<ConstraintIndices> indices_;
+  /// Function name to ranks in \ref indices_. Distinct functions may
+  /// share a name; candidates are confirmed by comparing the functions.
+  std::unordered_multimap<std::string, std::size_t> functionIndex_;
+  /// Function name to ranks in \ref constraints_
+  std::unordered_multimap<std::string, std::size_t> constraintIndex_;
+
+  /// Default scratch data, used when the caller does not provide its
+  /// own SolveContext.
+  mutable SolveContext context_;
   mutable matrix_t reducedJ_;
-  mutable Eigen::VectorXi saturation_, reducedSaturation_;
-  mutable Configuration_t qSat_;
-  mutable ArrayXb tmpSat_;
-  mutable value_type squaredNorm_;
-  mutable std::vector<Data> datas_;
   mutable SVD_t svd_;
   mutable vector_t OM_;
   mutable vector_t OP_;
 
+  /// Memoized squared error norms of \ref isSatisfied, NULL when
+  /// disabled. See satisfactionCache(std::size_t).
+  class SatisfactionCache;
+  mutable shared_ptr<SatisfactionCache> satisfactionCache_;
+  /// Incremented on every right hand side modification; memoized
+  /// results of older generations are ignored.
+  mutable std::size_t rhsGeneration_;
+  /// Gathered right hand side served by \ref rightHandSideView,
+  /// refreshed on the first read after a mutation.
+  mutable vector_t rhsView_;
+  mutable bool rhsViewValid_;
+
   friend struct lineSearch::Backtracking;
 
  protected:
-  HierarchicalIterative() {}
+  HierarchicalIterative() : rhsGeneration_(0), rhsViewValid_(false) {}
 
  private:
   HPP_SERIALIZABLE_SPLIT();
@@ -627,6 +1477,86 @@ inline std::ostream& operator<<(std::ostream& os,
                                 const HierarchicalIterative& hs) {
   return hs.print(os);
 }
+
+// The solve, refine, solveAny and computeValue templates are compiled
+// in the library for the line search types of this header. The
+// declarations below keep translation units that include
+// solver/impl/hierarchical-iterative.hh - only needed to instantiate a
+// custom line search type - from re-instantiating them.
+extern template void HierarchicalIterative::computeValue<false>(
+    vectorIn_t config, SolveContext& context) const;
+extern template void HierarchicalIterative::computeValue<true>(
+    vectorIn_t config, SolveContext& context) const;
+
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, lineSearch::Constant lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, lineSearch::Backtracking lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, lineSearch::FixedSequence lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, lineSearch::ErrorNormBased lineSearch) const;
+
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Constant lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Backtracking lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::FixedSequence lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::ErrorNormBased lineSearch) const;
+
+extern template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::Constant lineSearch) const;
+extern template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::Backtracking lineSearch) const;
+extern template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::FixedSequence lineSearch) const;
+extern template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::ErrorNormBased lineSearch) const;
+
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::Constant lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::Backtracking lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::FixedSequence lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::ErrorNormBased lineSearch) const;
+
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Constant lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Backtracking lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::FixedSequence lineSearch) const;
+extern template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::ErrorNormBased lineSearch) const;
+
+extern template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::Constant lineSearch) const;
+extern template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::Backtracking lineSearch) const;
+extern template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::FixedSequence lineSearch) const;
+extern template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::ErrorNormBased lineSearch) const;
 }  // namespace solver
 }  // namespace constraints
 }  // namespace hpp
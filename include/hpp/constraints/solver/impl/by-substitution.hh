@@ -29,6 +29,8 @@
 #ifndef HPP_CONSTRAINTS_SOLVER_IMPL_BY_SUBSTITUTION_HH
 #define HPP_CONSTRAINTS_SOLVER_IMPL_BY_SUBSTITUTION_HH
 
+#include <hpp/constraints/solver/trace.hh>
+
 namespace hpp {
 namespace constraints {
 namespace solver {
@@ -37,7 +39,8 @@ typedef Eigen::NumTraits<value_type> NumTraits;
 
 template <typename LineSearchType>
 inline HierarchicalIterative::Status BySubstitution::impl_solve(
-    vectorOut_t arg, bool _optimize, LineSearchType lineSearch) const {
+    vectorOut_t arg, bool _optimize, value_type squaredThreshold,
+    LineSearchType lineSearch) const {
   bool optimize = _optimize && lastIsOptional_;
   assert(!arg.hasNaN());
 
@@ -58,17 +61,17 @@ inline HierarchicalIterative::Status BySubstitution::impl_solve(
   // Fill value and Jacobian
   computeValue<true>(arg);
   computeError();
-  if (optimize) previousCost = datas_.back().error.squaredNorm();
+  if (optimize) previousCost = context_.datas.back().error.squaredNorm();
 
-  bool errorWasBelowThr = (squaredNorm_ < squaredErrorThreshold_);
+  bool errorWasBelowThr = (context_.squaredNorm < squaredThreshold);
   vector_t initArg;
   if (errorWasBelowThr) {
     initArg = arg;
     if (!optimize) iter = std::max(maxIterations_, size_type(2)) - 2;
-    initSquaredNorm = squaredNorm_;
+    initSquaredNorm = context_.squaredNorm;
   }
 
-  bool errorIsAboveThr = (squaredNorm_ > .25 * squaredErrorThreshold_);
+  bool errorIsAboveThr = (context_.squaredNorm > .25 * squaredThreshold);
   if (errorIsAboveThr && reducedDimension_ == 0) return INFEASIBLE;
   if (optimize && !errorIsAboveThr) qopt = arg;
 
@@ -79,40 +82,52 @@ inline HierarchicalIterative::Status BySubstitution::impl_solve(
       status = MAX_ITERATION_REACHED;
       break;
     }
+    // Cooperative cancellation through SolveContext::interrupt.
+    if (context_.interrupt &&
+        context_.interrupt->load(std::memory_order_relaxed)) {
+      status = INTERRUPTED;
+      break;
+    }
     status = SUCCESS;
 
     // 2. Compute step
     // onlyLineSearch is true when we only reduced the scaling.
     if (!onlyLineSearch) {
-      previousSquaredNorm = squaredNorm_;
+      previousSquaredNorm = context_.squaredNorm;
       // Update the jacobian using the jacobian of the explicit system.
       updateJacobian(arg);
       computeSaturation(arg);
       computeDescentDirection();
     }
     // Apply scaling to avoid too large steps.
-    if (optimize) dq_ *= scaling;
-    if (dq_.squaredNorm() < dqMinSquaredNorm) {
+    if (optimize) context_.dq *= scaling;
+    if (context_.dq.squaredNorm() < dqMinSquaredNorm) {
       // We assume that the algorithm reached a local minima.
       status = INFEASIBLE;
       break;
     }
     // 3. Apply line search algorithm for the computed step
-    lineSearch(*this, arg, dq_);
+    {
+      HPP_SOLVER_TRACE_ZONE("lineSearch", -1);
+      lineSearch(*this, arg, context_.dq);
+    }
     explicit_.solve(arg);
     assert(!arg.hasNaN());
+    // Levels whose dofs the step did not move - directly or through the
+    // explicit part - keep their cached decomposition.
+    invalidateStaleDecompositions(context_);
 
     // 4. Evaluate the error at the new point.
     computeValue<true>(arg);
     computeError();
 
     --errorDecreased;
-    if (squaredNorm_ < previousSquaredNorm)
+    if (context_.squaredNorm < previousSquaredNorm)
       errorDecreased = 3;
     else
       status = ERROR_INCREASED;
 
-    errorIsAboveThr = (squaredNorm_ > .25 * squaredErrorThreshold_);
+    errorIsAboveThr = (context_.squaredNorm > .25 * squaredThreshold);
     // 5. In case of optimization,
     // - if the constraints is satisfied and the cost decreased, increase
     //   the scaling (amount of confidence in the linear approximation)
@@ -120,7 +135,7 @@ inline HierarchicalIterative::Status BySubstitution::impl_solve(
     //   and cancel this step.
     if (optimize) {
       if (!errorIsAboveThr) {
-        value_type cost = datas_.back().error.squaredNorm();
+        value_type cost = context_.datas.back().error.squaredNorm();
         if (cost < previousCost) {
           qopt = arg;
           previousCost = cost;
@@ -128,10 +143,14 @@ inline HierarchicalIterative::Status BySubstitution::impl_solve(
         }
         onlyLineSearch = false;
       } else {
-        dq_ /= scaling;
+        context_.dq /= scaling;
         scaling *= 0.5;
         if (qopt.size() > 0) arg = qopt;
         onlyLineSearch = true;
+        // The jump back to qopt is not described by dq: drop every
+        // cached decomposition.
+        for (std::size_t i = 0; i < context_.datas.size(); ++i)
+          context_.datas[i].decompositionValid = false;
       }
     }
 
@@ -139,7 +158,7 @@ inline HierarchicalIterative::Status BySubstitution::impl_solve(
   }
 
   if (!optimize && errorWasBelowThr) {
-    if (squaredNorm_ > initSquaredNorm) {
+    if (context_.squaredNorm > initSquaredNorm) {
       arg = initArg;
     }
     return SUCCESS;
@@ -151,6 +170,37 @@ inline HierarchicalIterative::Status BySubstitution::impl_solve(
   assert(!arg.hasNaN());
   return status;
 }
+template <typename LineSearchType>
+inline std::vector<HierarchicalIterative::Status> BySubstitution::solveSequence(
+    matrixOut_t args, LineSearchType lineSearch) const {
+  typedef pinocchio::LiegroupElementConstRef LgeConstRef_t;
+  std::vector<Status> statuses((std::size_t)args.cols(), INFEASIBLE);
+
+  vector_t input(args.rows());
+  vector_t correction(vector_t::Zero(configSpace()->nv()));
+  bool warmStart = false;
+  for (size_type c = 0; c < args.cols(); ++c) {
+    input = args.col(c);
+    vectorOut_t arg(args.col(c));
+    // Apply the correction of the previous sample so that the Newton
+    // iteration starts close to the constraint manifold.
+    if (warmStart) integrate(input, correction, arg);
+    statuses[(std::size_t)c] = solve(arg, lineSearch);
+    if (statuses[(std::size_t)c] != SUCCESS && warmStart) {
+      // The warm start may have moved the seed into another basin of
+      // attraction. Fall back to a cold start from the raw sample.
+      arg = input;
+      statuses[(std::size_t)c] = solve(arg, lineSearch);
+    }
+    warmStart = (statuses[(std::size_t)c] == SUCCESS);
+    if (warmStart) {
+      LgeConstRef_t in(input, configSpace());
+      LgeConstRef_t out(arg, configSpace());
+      correction = out - in;
+    }
+  }
+  return statuses;
+}
 }  // namespace solver
 }  // namespace constraints
 }  // namespace hpp
@@ -30,6 +30,7 @@
 #define HPP_CONSTRAINTS_SOLVER_IMPL_HIERARCHICAL_ITERATIVE_HH
 
 #include <hpp/constraints/config.hh>
+#include <hpp/constraints/solver/trace.hh>
 #include <hpp/constraints/svd.hh>
 #include <hpp/util/debug.hh>
 
@@ -45,13 +46,22 @@ inline bool Constant::operator()(const SolverType& solver, vectorOut_t arg,
 }
 
 template <typename SolverType>
-inline bool Backtracking::operator()(const SolverType& solver, vectorOut_t arg,
-                                     vectorOut_t u) {
+inline bool Constant::operator()(const SolverType& solver,
+                                 typename SolverType::SolveContext& context,
+                                 vectorOut_t arg, vectorOut_t darg) {
+  solver.integrate(arg, darg, arg, context);
+  return true;
+}
+
+template <typename SolverType>
+inline bool Backtracking::operator()(const SolverType& solver,
+                                     typename SolverType::SolveContext& context,
+                                     vectorOut_t arg, vectorOut_t u) {
   arg_darg.resize(arg.size());
 
-  const value_type slope = computeLocalSlope(solver);
+  const value_type slope = computeLocalSlope(solver, context);
   const value_type t = 2 * c * slope;
-  const value_type f_arg_norm2 = solver.residualError();
+  const value_type f_arg_norm2 = context.squaredNorm;
 
   if (t > 0) {
     hppDout(error, "The descent direction is not valid: " << t / c);
@@ -64,13 +74,13 @@ inline bool Backtracking::operator()(const SolverType& solver, vectorOut_t arg,
 
     while (alpha > smallAlpha) {
       darg = alpha * u;
-      solver.integrate(arg, darg, arg_darg);
-      solver.template computeValue<false>(arg_darg);
-      solver.computeError();
+      solver.integrate(arg, darg, arg_darg, context);
+      solver.template computeValue<false>(arg_darg, context);
+      solver.computeError(context);
       // Check if we are doing better than the linear approximation with coef
       // multiplied by c < 1
       // t < 0 must hold
-      const value_type f_arg_darg_norm2 = solver.residualError();
+      const value_type f_arg_darg_norm2 = context.squaredNorm;
       if (f_arg_norm2 - f_arg_darg_norm2 >= -alpha * t) {
         arg = arg_darg;
         u = darg;
@@ -86,21 +96,27 @@ inline bool Backtracking::operator()(const SolverType& solver, vectorOut_t arg,
   }
 
   u *= smallAlpha;
-  solver.integrate(arg, u, arg);
+  solver.integrate(arg, u, arg, context);
   return false;
 }
 
+template <typename SolverType>
+inline bool Backtracking::operator()(const SolverType& solver, vectorOut_t arg,
+                                     vectorOut_t u) {
+  return this->operator()(solver, solver.context_, arg, u);
+}
+
 template <typename SolverType>
 inline value_type Backtracking::computeLocalSlope(
-    const SolverType& solver) const {
+    const SolverType& solver,
+    const typename SolverType::SolveContext& context) const {
   value_type slope = 0;
   for (std::size_t i = 0; i < solver.stacks_.size(); ++i) {
-    typename SolverType::Data& d = solver.datas_[i];
+    const typename SolverType::Data& d = context.datas[i];
     const size_type nrows = d.reducedJ.rows();
     if (df.size() < nrows) df.resize(nrows);
-    df.head(nrows).noalias() = d.reducedJ * solver.dqSmall_;
-    slope +=
-        df.head(nrows).dot(d.activeRowsOfJ.keepRows().rview(d.error).eval());
+    df.head(nrows).noalias() = d.reducedJ * context.dqSmall;
+    slope += d.activeRowsOfJ.keepRows().rview(d.error).dot(df.head(nrows));
   }
   return slope;
 }
@@ -114,6 +130,16 @@ inline bool FixedSequence::operator()(const SolverType& solver, vectorOut_t arg,
   return true;
 }
 
+template <typename SolverType>
+inline bool FixedSequence::operator()(
+    const SolverType& solver, typename SolverType::SolveContext& context,
+    vectorOut_t arg, vectorOut_t darg) {
+  darg *= alpha;
+  alpha = alphaMax - K * (alphaMax - alpha);
+  solver.integrate(arg, darg, arg, context);
+  return true;
+}
+
 template <typename SolverType>
 inline bool ErrorNormBased::operator()(const SolverType& solver,
                                        vectorOut_t arg, vectorOut_t darg) {
@@ -123,12 +149,58 @@ inline bool ErrorNormBased::operator()(const SolverType& solver,
   solver.integrate(arg, darg, arg);
   return true;
 }
+
+template <typename SolverType>
+inline bool ErrorNormBased::operator()(
+    const SolverType& solver, typename SolverType::SolveContext& context,
+    vectorOut_t arg, vectorOut_t darg) {
+  const value_type r = context.squaredNorm / solver.squaredErrorThreshold();
+  const value_type alpha = C - K * std::tanh(a * r + b);
+  darg *= alpha;
+  solver.integrate(arg, darg, arg, context);
+  return true;
+}
 }  // namespace lineSearch
 
 template <typename LineSearchType>
 inline solver::HierarchicalIterative::Status
 solver::HierarchicalIterative::solve(vectorOut_t arg,
                                      LineSearchType lineSearch) const {
+  return solve(arg, context_, lineSearch);
+}
+
+template <typename LineSearchType>
+inline solver::HierarchicalIterative::Status
+solver::HierarchicalIterative::solve(vectorOut_t arg, SolveContext& context,
+                                     LineSearchType lineSearch) const {
+  // Stop at the coarse threshold when the two stage schedule is
+  // enabled; refine continues down to the tight one.
+  return impl_solve(
+      arg, context,
+      std::max(squaredErrorThreshold_, squaredCoarseErrorThreshold_),
+      lineSearch);
+}
+
+template <typename LineSearchType>
+inline solver::HierarchicalIterative::Status
+solver::HierarchicalIterative::refine(vectorOut_t arg,
+                                      LineSearchType lineSearch) const {
+  return impl_solve(arg, context_, squaredErrorThreshold_, lineSearch);
+}
+
+template <typename LineSearchType>
+inline solver::HierarchicalIterative::Status
+solver::HierarchicalIterative::refine(vectorOut_t arg, SolveContext& context,
+                                      LineSearchType lineSearch) const {
+  return impl_solve(arg, context, squaredErrorThreshold_, lineSearch);
+}
+
+template <typename LineSearchType>
+inline solver::HierarchicalIterative::Status
+solver::HierarchicalIterative::impl_solve(vectorOut_t arg,
+                                          SolveContext& context,
+                                          value_type squaredThreshold,
+                                          LineSearchType lineSearch) const {
   hppDout(info, "before projection: " << arg.transpose());
   assert(!arg.hasNaN());
 
@@ -138,40 +210,85 @@ solver::HierarchicalIterative::solve(vectorOut_t arg,
       Eigen::NumTraits<value_type>::dummy_precision();
 
   // Fill value and Jacobian
-  computeValue<true>(arg);
-  computeError();
+  computeValue<true>(arg, context);
+  computeError(context);
 
-  if (squaredNorm_ > squaredErrorThreshold_ && reducedDimension_ == 0)
+  if (context.squaredNorm > squaredThreshold && reducedDimension_ == 0)
     return INFEASIBLE;
 
   Status status;
-  while (squaredNorm_ > squaredErrorThreshold_ && errorDecreased &&
+  size_type sinceExactJacobian = 0;
+  ++context.telemetry.solveId;
+  while (context.squaredNorm > squaredThreshold && errorDecreased &&
          iter < maxIterations_) {
-    computeSaturation(arg);
-    computeDescentDirection();
-    if (dq_.squaredNorm() < dqMinSquaredNorm) {
+    // Cooperative cancellation: another seed of a multi start run
+    // already succeeded. See solveAny.
+    if (context.interrupt &&
+        context.interrupt->load(std::memory_order_relaxed)) {
+      status = INTERRUPTED;
+      break;
+    }
+    computeSaturation(arg, context);
+    computeDescentDirection(context);
+    const value_type dqSquaredNorm = context.dq.squaredNorm();
+    if (dqSquaredNorm < dqMinSquaredNorm) {
       // TODO INFEASIBLE means that we have reached a local minima.
       // The problem may still be feasible from a different starting point.
       status = INFEASIBLE;
       break;
     }
-    lineSearch(*this, arg, dq_);
+    // Quasi-Newton mode: skip the exact Jacobian evaluation and apply a
+    // Broyden rank-one update instead, unless the refresh period expired
+    // or the error stopped decreasing at the previous iteration.
+    const bool broyden =
+        (jacobianRefreshPeriod_ > 1 &&
+         sinceExactJacobian + 1 < jacobianRefreshPeriod_ && errorDecreased == 3);
+    if (broyden)
+      for (std::size_t i = 0; i < stacks_.size(); ++i) {
+        Data& d = context.datas[i];
+        d.broydenError = d.activeRowsOfJ.keepRows().rview(d.error);
+      }
+    {
+      HPP_SOLVER_TRACE_ZONE("lineSearch", -1);
+      lineSearch(*this, context, arg, context.dq);
+    }
+    // Levels whose dofs the step did not move keep their cached
+    // decomposition for the next iteration.
+    invalidateStaleDecompositions(context);
+
+    if (broyden) {
+      computeValue<false>(arg, context);
+      applyBroydenUpdate(context);
+      ++sinceExactJacobian;
+    } else {
+      computeValue<true>(arg, context);
+      sinceExactJacobian = 0;
+    }
+    computeError(context);
 
-    computeValue<true>(arg);
-    computeError();
+    // One telemetry sample per iteration: a few scalar stores into a
+    // preallocated ring buffer, cheap enough to stay on in production.
+    SolveTelemetry::Iteration sample;
+    sample.solveId = context.telemetry.solveId;
+    sample.iteration = iter;
+    sample.squaredNorm = context.squaredNorm;
+    sample.sigma = context.sigma;
+    sample.alpha = std::sqrt(context.dq.squaredNorm() / dqSquaredNorm);
+    sample.nbSaturations = (context.saturation.array() != 0).count();
+    context.telemetry.record(sample);
 
-    hppDout(info, "squareNorm = " << squaredNorm_);
+    hppDout(info, "squareNorm = " << context.squaredNorm);
     --errorDecreased;
-    if (squaredNorm_ < previousSquaredNorm)
+    if (context.squaredNorm < previousSquaredNorm)
       errorDecreased = 3;
     else
       status = ERROR_INCREASED;
-    previousSquaredNorm = squaredNorm_;
+    previousSquaredNorm = context.squaredNorm;
     ++iter;
   }
 
   hppDout(info, "number of iterations: " << iter);
-  if (squaredNorm_ > squaredErrorThreshold_) {
+  if (context.squaredNorm > squaredThreshold) {
     hppDout(info, "Projection failed.");
     return (iter >= maxIterations_) ? MAX_ITERATION_REACHED : status;
   }
@@ -179,6 +296,20 @@ solver::HierarchicalIterative::solve(vectorOut_t arg,
   assert(!arg.hasNaN());
   return SUCCESS;
 }
+
+template <typename LineSearchType>
+inline std::vector<solver::HierarchicalIterative::Status>
+solver::HierarchicalIterative::solve(matrixOut_t args,
+                                     LineSearchType lineSearch) const {
+  std::vector<Status> statuses((std::size_t)args.cols(), INFEASIBLE);
+  // Iterate on columns so that each seed works on contiguous storage and
+  // the solver workspace stays hot between two consecutive seeds.
+  for (size_type c = 0; c < args.cols(); ++c) {
+    vectorOut_t arg(args.col(c));
+    statuses[(std::size_t)c] = solve(arg, lineSearch);
+  }
+  return statuses;
+}
 }  // namespace solver
 }  // namespace constraints
 }  // namespace hpp
@@ -0,0 +1,118 @@
+// Copyright (c) 2026 CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_SOLVER_TRACE_HH
+#define HPP_CONSTRAINTS_SOLVER_TRACE_HH
+
+#include <hpp/constraints/config.hh>
+#include <hpp/constraints/fwd.hh>
+
+namespace hpp {
+namespace constraints {
+namespace solver {
+
+/// Trace points for external profilers.
+///
+/// The solver phases - value evaluation, descent direction, line
+/// search, explicit resolution - emit begin/end zone events through the
+/// callbacks registered here, so that an external tracer (Tracy,
+/// perfetto, ...) can show them on the same timeline as the rest of the
+/// application. Unlike HierarchicalIterative::performanceReport, which
+/// aggregates counters, this correlates individual solver phases with
+/// outside events.
+///
+/// The trace points are compiled in only when the library is built with
+/// the SOLVER_TRACE cmake option; the default build carries no
+/// instrumentation at all. With the option on and no hooks registered,
+/// a trace point costs one pointer load and test.
+namespace trace {
+
+/// Zone callbacks, called from the solver hot loops.
+///
+/// They must be cheap and reentrant: solvers may run concurrently (see
+/// HierarchicalIterative::solveAny) and zones nest.
+struct Hooks {
+  /// Open a zone.
+  /// \param name static phase name, or the name of the constraint
+  ///        function being evaluated,
+  /// \param level priority level of the zone, -1 when the phase is not
+  ///        tied to one level.
+  typedef void (*ZoneBegin)(const char* name, size_type level);
+  /// Close the innermost zone. Called with the arguments of the
+  /// matching ZoneBegin for tracers whose end event repeats them.
+  typedef void (*ZoneEnd)(const char* name, size_type level);
+
+  Hooks() : zoneBegin(0), zoneEnd(0) {}
+
+  ZoneBegin zoneBegin;
+  ZoneEnd zoneEnd;
+};
+
+/// Register the zone callbacks. Not synchronized: register once at
+/// startup, before any solver runs.
+void HPP_CONSTRAINTS_DLLAPI hooks(const Hooks& hooks);
+
+/// The registered zone callbacks.
+const Hooks& HPP_CONSTRAINTS_DLLAPI hooks();
+
+#ifdef HPP_CONSTRAINTS_SOLVER_TRACE
+/// Scoped zone emitted by HPP_SOLVER_TRACE_ZONE.
+class ScopedZone {
+ public:
+  ScopedZone(const char* name, size_type level)
+      : name_(name), level_(level) {
+    if (hooks().zoneBegin) hooks().zoneBegin(name_, level_);
+  }
+  ~ScopedZone() {
+    if (hooks().zoneEnd) hooks().zoneEnd(name_, level_);
+  }
+
+ private:
+  const char* name_;
+  size_type level_;
+};
+#endif  // HPP_CONSTRAINTS_SOLVER_TRACE
+}  // namespace trace
+}  // namespace solver
+}  // namespace constraints
+}  // namespace hpp
+
+/// Open a zone until the end of the enclosing scope. Compiled to
+/// nothing unless the library is built with the SOLVER_TRACE cmake
+/// option.
+#ifdef HPP_CONSTRAINTS_SOLVER_TRACE
+#define HPP_SOLVER_TRACE_CAT_(a, b) a##b
+#define HPP_SOLVER_TRACE_ZONE_(name, level, line)              \
+  ::hpp::constraints::solver::trace::ScopedZone                \
+      HPP_SOLVER_TRACE_CAT_(hppTraceZone, line)(name, level)
+#define HPP_SOLVER_TRACE_ZONE(name, level) \
+  HPP_SOLVER_TRACE_ZONE_(name, level, __LINE__)
+#else
+#define HPP_SOLVER_TRACE_ZONE(name, level) ((void)0)
+#endif
+
+#endif  // HPP_CONSTRAINTS_SOLVER_TRACE_HH
@@ -30,6 +30,7 @@
 #define HPP_CONSTRAINTS_STATIC_STABILITY_HH
 
 #include <hpp/constraints/config.hh>
+#include <hpp/constraints/convex-shape-contact.hh>
 #include <hpp/constraints/deprecated.hh>
 #include <hpp/constraints/differentiable-function.hh>
 #include <hpp/constraints/fwd.hh>
@@ -66,11 +67,23 @@ class HPP_CONSTRAINTS_DLLAPI StaticStability : public DifferentiableFunction {
                   const Contacts_t& contacts,
                   const CenterOfMassComputationPtr_t& com);
 
+  /// Constructor sharing the per-contact computation
+  /// \param cache wrench expression matrix, possibly shared with other
+  ///        stability functions; must have been built from a contact
+  ///        list. See ContactWrenchCache.
+  StaticStability(const std::string& name,
+                  const ContactWrenchCachePtr_t& cache);
+
   static StaticStabilityPtr_t create(const std::string& name,
                                      const DevicePtr_t& robot,
                                      const Contacts_t& contacts,
                                      const CenterOfMassComputationPtr_t& com);
 
+  /// Create an instance consuming a shared per-contact computation.
+  /// See ContactWrenchCache.
+  static StaticStabilityPtr_t create(const std::string& name,
+                                     const ContactWrenchCachePtr_t& cache);
+
   static StaticStabilityPtr_t create(const DevicePtr_t& robot,
                                      const Contacts_t& contacts,
                                      const CenterOfMassComputationPtr_t& com);
@@ -117,11 +130,75 @@ class HPP_CONSTRAINTS_DLLAPI StaticStability : public DifferentiableFunction {
 
   typedef MatrixOfExpressions<eigen::vector3_t, JacobianMatrix> MoE_t;
 
-  mutable MoE_t phi_;
+  /// Per-contact computation, possibly shared with other stability
+  /// functions
+  ContactWrenchCachePtr_t cache_;
+  /// Wrench expression matrix of cache_
+  MoE_t& phi_;
   mutable vector_t u_, uMinus_, v_;
   mutable matrix_t uDot_, uMinusDot_, vDot_;
   mutable vector_t lambdaDot_;
 };
+
+/// Shared per-contact computation of the stability functions
+///
+/// StaticStability and QPStaticStability build the same 2 x n matrix
+/// of contact wrench expressions - the contact normal and its center
+/// of mass lever arm - and each instance re-evaluates it per call.
+/// When the constraint and the cost are evaluated in the same solve,
+/// build one cache and hand it to both functions: the forward
+/// kinematics, the expression values, the Jacobians and the SVD are
+/// then computed once per configuration instead of once per function.
+class HPP_CONSTRAINTS_DLLAPI ContactWrenchCache {
+ public:
+  typedef MatrixOfExpressions<eigen::vector3_t, JacobianMatrix> MoE_t;
+
+  /// Build the wrench matrix of a contact list: one column per
+  /// contact.
+  static ContactWrenchCachePtr_t create(
+      const DevicePtr_t& robot, const StaticStability::Contacts_t& contacts,
+      const CenterOfMassComputationPtr_t& com);
+
+  /// Build the wrench matrix of a force data list: one column per
+  /// contact point, the normal expression shared by the points of a
+  /// contact.
+  static ContactWrenchCachePtr_t create(
+      const DevicePtr_t& robot,
+      const std::vector<ConvexShapeContact::ForceData>& contacts,
+      const CenterOfMassComputationPtr_t& com);
+
+  /// Place the robot at arg and invalidate the expressions, unless arg
+  /// is the configuration of the previous call, in which case the
+  /// cached evaluations stay valid.
+  void prepare(ConfigurationIn_t arg);
+
+  /// The matrix of wrench expressions: row 0 holds the contact
+  /// normals, row 1 the center of mass lever arms.
+  MoE_t& phi() { return phi_; }
+
+  /// Number of columns of \ref phi
+  std::size_t size() const { return nbColumns_; }
+
+  const DevicePtr_t& robot() const { return robot_; }
+  /// Contacts the matrix was built from; empty when built from force
+  /// datas.
+  const StaticStability::Contacts_t& contacts() const { return contacts_; }
+  const CenterOfMassComputationPtr_t& com() const { return com_; }
+
+ private:
+  ContactWrenchCache(const DevicePtr_t& robot,
+                     const CenterOfMassComputationPtr_t& com,
+                     std::size_t nbColumns);
+
+  DevicePtr_t robot_;
+  StaticStability::Contacts_t contacts_;
+  CenterOfMassComputationPtr_t com_;
+  MoE_t phi_;
+  std::size_t nbColumns_;
+  /// Configuration of the last \ref prepare call
+  vector_t lastArg_;
+  bool argValid_;
+};
 /// \}
 }  // namespace constraints
 }  // namespace hpp
@@ -59,22 +59,44 @@ static Eigen::Ref<const typename SVD::MatrixUType> getV2(
   return svd.matrixV().rightCols(svd.matrixV().cols() - rank);
 }
 
+/// Compute the pseudo inverse from a decomposition
+///
+/// \param svd decomposition of the matrix to invert,
+/// \retval pinvmat the pseudo inverse,
+/// \param singularValuesInv caller provided workspace receiving the
+///        inverted singular values, so that repeated calls do not
+///        allocate.
+///
+/// The utilities of this file are templated over the decomposition
+/// type: instantiating them with a fixed size matrix type - as the
+/// symbolic calculus expressions of known small dimensions do - yields
+/// allocation free code without further specialization.
 template <typename SVD>
 static void pseudoInverse(const SVD& svd,
-                          Eigen::Ref<typename SVD::MatrixType> pinvmat) {
+                          Eigen::Ref<typename SVD::MatrixType> pinvmat,
+                          typename SVD::SingularValuesType& singularValuesInv) {
   eigen_assert(
       svd.computeU() && svd.computeV() &&
       "Eigen::JacobiSVD "
       "computation flags must be at least: ComputeThinU | ComputeThinV");
 
   size_type rank = svd.rank();
-  typename SVD::SingularValuesType singularValues_inv =
-      svd.singularValues().segment(0, rank).cwiseInverse();
+  singularValuesInv.resize(svd.singularValues().size());
+  singularValuesInv.head(rank) =
+      svd.singularValues().head(rank).cwiseInverse();
 
-  pinvmat.noalias() = getV1<SVD>(svd, rank) * singularValues_inv.asDiagonal() *
+  pinvmat.noalias() = getV1<SVD>(svd, rank) *
+                      singularValuesInv.head(rank).asDiagonal() *
                       getU1<SVD>(svd, rank).adjoint();
 }
 
+template <typename SVD>
+static void pseudoInverse(const SVD& svd,
+                          Eigen::Ref<typename SVD::MatrixType> pinvmat) {
+  typename SVD::SingularValuesType singularValuesInv;
+  pseudoInverse<SVD>(svd, pinvmat, singularValuesInv);
+}
+
 template <typename SVD>
 void projectorOnSpan(const SVD& svd,
                      Eigen::Ref<typename SVD::MatrixType> projector) {
@@ -114,7 +136,7 @@ void projectorOnKernel(const SVD& svd,
   else {
     projector.noalias() =
         -getV1<SVD>(svd, rank) * getV1<SVD>(svd, rank).adjoint();
-    projector.diagonal().noalias() += vector_t::Ones(svd.matrixV().rows());
+    projector.diagonal().array() += 1;
   }
 }
 
@@ -135,7 +157,7 @@ void projectorOnKernelOfInv(const SVD& svd,
     // I - U1 * U1*
     projector.noalias() =
         -getU1<SVD>(svd, rank) * getU1<SVD>(svd, rank).adjoint();
-    projector.diagonal().noalias() += vector_t::Ones(svd.matrixU().rows());
+    projector.diagonal().array() += 1;
   }
 }
 }  // namespace constraints
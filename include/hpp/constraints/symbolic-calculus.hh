@@ -81,7 +81,24 @@
     return ptr;                                                             \
   }
 
+#define HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR1(op, InType, OutType) \
+  template <typename RhsType>                                           \
+  InlineExp<OutType<InlineExp<RhsType> > > op(                          \
+      const InType& lhs, const InlineExp<RhsType>& rhs) {               \
+    typedef OutType<InlineExp<RhsType> > Op_t;                          \
+    return InlineExp<Op_t>(Op_t(lhs, rhs));                             \
+  }
+
+#define HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR2(op, OutType)       \
+  template <typename LhsType, typename RhsType>                       \
+  InlineExp<OutType<InlineExp<LhsType>, InlineExp<RhsType> > > op(    \
+      const InlineExp<LhsType>& lhs, const InlineExp<RhsType>& rhs) { \
+    typedef OutType<InlineExp<LhsType>, InlineExp<RhsType> > Op_t;    \
+    return InlineExp<Op_t>(Op_t(lhs, rhs));                           \
+  }
+
 #include <Eigen/SVD>
+#include <hpp/constraints/com-computation-cache.hh>
 #include <hpp/constraints/fwd.hh>
 #include <hpp/constraints/macros.hh>
 #include <hpp/constraints/svd.hh>
@@ -89,6 +106,8 @@
 #include <hpp/pinocchio/center-of-mass-computation.hh>
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/liegroup-element.hh>
+#include <set>
+#include <vector>
 
 namespace hpp {
 namespace constraints {
@@ -101,6 +120,8 @@ template <typename ValueType, typename JacobianType>
 class CalculusBaseAbstract;
 template <typename T>
 class Traits;
+template <typename T>
+class InlineExp;
 
 template <typename LhsValue, typename RhsValue>
 class Expression;
@@ -148,6 +169,128 @@ struct Traits<JointTranspose> {
   typedef JointTranspose WkPtr_t;
 };
 
+/// Pointer-like handle storing an expression node by value.
+///
+/// The classic way of building an expression heap-allocates every node
+/// behind a shared_ptr, which costs an allocation and reference
+/// counting per node even for expressions that are only evaluated in
+/// place. InlineExp stores a node inline while exposing the
+/// pointer-like interface the operator classes expect through the
+/// Traits indirection, so expressions compose on the stack with value
+/// semantics: the leaves and the operator nodes live wherever the
+/// expression object lives, and only the operand cell of each operator
+/// remains heap-allocated.
+/// \code
+/// InlineExp<PointInJoint> p(PointInJoint(joint, local, ndof));
+/// InlineExp<VectorInJoint> n(VectorInJoint(joint, normal, ndof));
+/// InlineExp<ScalarProduct<InlineExp<PointInJoint>,
+///                         InlineExp<VectorInJoint> > > sp(p * n);
+/// sp->invalidate();
+/// sp->computeValue(q);
+/// \endcode
+/// Call share() to copy the node to the heap and obtain the classic
+/// shared form when the expression must outlive the current scope.
+template <typename T>
+class InlineExp {
+ public:
+  typedef T Node_t;
+
+  InlineExp() {}
+  InlineExp(const T& node) : node_(node) {}
+
+  T* operator->() { return &node_; }
+  const T* operator->() const { return &node_; }
+  T& operator*() { return node_; }
+  const T& operator*() const { return node_; }
+
+  /// Copy the node to the heap, yielding the classic shared form.
+  HPP_CONSTRAINTS_CB_REF<T> share() const {
+    return HPP_CONSTRAINTS_CB_REF<T>(new T(node_));
+  }
+
+ private:
+  T node_;
+
+ public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+template <typename T>
+struct Traits<InlineExp<T> > {
+  typedef InlineExp<T> Ptr_t;
+  typedef InlineExp<T> WkPtr_t;
+};
+
+/// Flattened evaluation order of an expression tree.
+///
+/// CalculusBaseAbstract::record appends the nodes of a tree operands
+/// first, so executing the tape in order evaluates each node exactly
+/// once with its operands already available: the recursive descent
+/// through the expression and the invalidate() cascades over the
+/// shared_ptr graph are replaced by tight loops over a contiguous
+/// array of operations dispatched through plain function pointers.
+/// Shared sub-expressions are recorded only once.
+class ExpressionTape {
+ public:
+  /// Append a node to the tape. Its operands must have been appended
+  /// before. Does nothing if the node was already recorded.
+  template <typename NodeType>
+  void append(NodeType* node) {
+    if (!recorded_.insert(node).second) return;
+    Op op;
+    op.node = node;
+    op.invalidate = &ExpressionTape::invalidateOp<NodeType>;
+    op.value = &ExpressionTape::valueOp<NodeType>;
+    op.jacobian = &ExpressionTape::jacobianOp<NodeType>;
+    ops_.push_back(op);
+  }
+  void clear() {
+    ops_.clear();
+    recorded_.clear();
+  }
+  bool empty() const { return ops_.empty(); }
+  std::size_t size() const { return ops_.size(); }
+
+  /// Clear the validity flags of every recorded node.
+  void invalidate() const {
+    for (std::size_t k = 0; k < ops_.size(); ++k)
+      ops_[k].invalidate(ops_[k].node);
+  }
+  /// Compute the value of every recorded node, operands first.
+  void computeValue(const ConfigurationIn_t arg) const {
+    for (std::size_t k = 0; k < ops_.size(); ++k)
+      ops_[k].value(ops_[k].node, arg);
+  }
+  /// Compute the value and jacobian of every recorded node, operands
+  /// first. Values are needed by the jacobians of the product nodes.
+  void computeJacobian(const ConfigurationIn_t arg) const {
+    for (std::size_t k = 0; k < ops_.size(); ++k)
+      ops_[k].jacobian(ops_[k].node, arg);
+  }
+
+ private:
+  template <typename NodeType>
+  static void invalidateOp(void* node) {
+    static_cast<NodeType*>(node)->invalidateNode();
+  }
+  template <typename NodeType>
+  static void valueOp(void* node, const ConfigurationIn_t arg) {
+    static_cast<NodeType*>(node)->evaluateValue(arg);
+  }
+  template <typename NodeType>
+  static void jacobianOp(void* node, const ConfigurationIn_t arg) {
+    static_cast<NodeType*>(node)->evaluateJacobian(arg);
+  }
+
+  struct Op {
+    void* node;
+    void (*invalidate)(void*);
+    void (*value)(void*, const ConfigurationIn_t);
+    void (*jacobian)(void*, const ConfigurationIn_t);
+  };
+  std::vector<Op> ops_;
+  std::set<const void*> recorded_;
+};  // class ExpressionTape
+
 /// Abstract class defining a basic common interface.
 ///
 /// The purpose of this class is to allow the user to define an expression
@@ -172,6 +315,8 @@ class CalculusBaseAbstract {
   virtual void computeValue(const ConfigurationIn_t arg) = 0;
   virtual void computeJacobian(const ConfigurationIn_t arg) = 0;
   virtual void invalidate() = 0;
+  /// Append the nodes of this expression to a tape, operands first.
+  virtual void record(ExpressionTape& tape) = 0;
 };
 
 /// Main abstract class.
@@ -214,6 +359,35 @@ class CalculusBase : public CalculusBaseAbstract<ValueType, JacobianType> {
     jValid_ = false;
     cValid_ = false;
   }
+  /// Append this node to a tape. Operator classes override this method
+  /// to record their operands first; leaves only record themselves.
+  virtual void record(ExpressionTape& tape) {
+    tape.append(static_cast<T*>(this));
+  }
+  /// Clear the validity flags of this node only, without cascading to
+  /// the operands. Called by ExpressionTape, which holds every node of
+  /// the expression.
+  void invalidateNode() {
+    vValid_ = false;
+    jValid_ = false;
+    cValid_ = false;
+  }
+  /// Same as computeValue, without virtual dispatch. Called by
+  /// ExpressionTape, where the operands of a node appear earlier on the
+  /// tape and are thus already computed.
+  void evaluateValue(const ConfigurationIn_t arg) {
+    if (vValid_) return;
+    static_cast<T*>(this)->impl_value(arg);
+    vValid_ = true;
+  }
+  /// Same as computeJacobian, without virtual dispatch. Also computes
+  /// the value, which the jacobians of the product nodes need.
+  void evaluateJacobian(const ConfigurationIn_t arg) {
+    evaluateValue(arg);
+    if (jValid_) return;
+    static_cast<T*>(this)->impl_jacobian(arg);
+    jValid_ = true;
+  }
   inline const CrossType& cross() const { return cross_; }
   void computeCrossValue(const ConfigurationIn_t arg) {
     if (cValid_) return;
@@ -247,6 +421,18 @@ HPP_CONSTRAINTS_CB_DEFINE_OPERATOR1(operator*, value_type, ScalarMultiply)
 HPP_CONSTRAINTS_CB_DEFINE_OPERATOR1(operator*, JointPtr_t, RotationMultiply)
 HPP_CONSTRAINTS_CB_DEFINE_OPERATOR1(operator*, JointTranspose, RotationMultiply)
 
+HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR2(operator-, Difference)
+HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR2(operator+, Sum)
+HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR2(operator*, ScalarProduct)
+HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR2(operator^, CrossProduct)
+
+HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR1(operator*, value_type,
+                                           ScalarMultiply)
+HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR1(operator*, JointPtr_t,
+                                           RotationMultiply)
+HPP_CONSTRAINTS_CB_DEFINE_INLINE_OPERATOR1(operator*, JointTranspose,
+                                           RotationMultiply)
+
 /// Base class for classes representing an operation.
 template <typename LhsValue, typename RhsValue>
 class Expression {
@@ -326,6 +512,11 @@ class CrossProduct : public CalculusBase<CrossProduct<LhsValue, RhsValue> > {
     e_->rhs_->invalidate();
     e_->lhs_->invalidate();
   }
+  void record(ExpressionTape& tape) {
+    e_->lhs_->record(tape);
+    e_->rhs_->record(tape);
+    Parent_t::record(tape);
+  }
 
  protected:
   typename Expression<LhsValue, RhsValue>::Ptr_t e_;
@@ -375,6 +566,11 @@ class ScalarProduct
     e_->rhs_->invalidate();
     e_->lhs_->invalidate();
   }
+  void record(ExpressionTape& tape) {
+    e_->lhs_->record(tape);
+    e_->rhs_->record(tape);
+    Parent_t::record(tape);
+  }
 
  protected:
   typename Expression<LhsValue, RhsValue>::Ptr_t e_;
@@ -417,6 +613,11 @@ class Difference : public CalculusBase<Difference<LhsValue, RhsValue> > {
     e_->rhs_->invalidate();
     e_->lhs_->invalidate();
   }
+  void record(ExpressionTape& tape) {
+    e_->lhs_->record(tape);
+    e_->rhs_->record(tape);
+    Parent_t::record(tape);
+  }
 
  protected:
   typename Expression<LhsValue, RhsValue>::Ptr_t e_;
@@ -457,6 +658,11 @@ class Sum : public CalculusBase<Sum<LhsValue, RhsValue> > {
     e_->rhs_->invalidate();
     e_->lhs_->invalidate();
   }
+  void record(ExpressionTape& tape) {
+    e_->lhs_->record(tape);
+    e_->rhs_->record(tape);
+    Parent_t::record(tape);
+  }
 
  protected:
   typename Expression<LhsValue, RhsValue>::Ptr_t e_;
@@ -496,6 +702,10 @@ class ScalarMultiply : public CalculusBase<ScalarMultiply<RhsValue> > {
     Parent_t::invalidate();
     e_->rhs_->invalidate();
   }
+  void record(ExpressionTape& tape) {
+    e_->rhs_->record(tape);
+    Parent_t::record(tape);
+  }
 
  protected:
   typename Expression<value_type, RhsValue>::Ptr_t e_;
@@ -560,6 +770,10 @@ class RotationMultiply : public CalculusBase<RotationMultiply<RhsValue> > {
     Parent_t::invalidate();
     e_->rhs_->invalidate();
   }
+  void record(ExpressionTape& tape) {
+    e_->rhs_->record(tape);
+    Parent_t::record(tape);
+  }
 
  protected:
   typename Expression<pinocchio::Joint, RhsValue>::Ptr_t e_;
@@ -789,9 +1003,11 @@ class PointCom : public CalculusBase<PointCom, vector3_t, ComJacobian_t> {
 
   PointCom(const Parent_t& other)
       : Parent_t(other),
-        comc_(static_cast<const PointCom&>(other).centerOfMassComputation()) {}
+        comc_(static_cast<const PointCom&>(other).centerOfMassComputation()),
+        cache_(ComComputationCache::get(comc_)) {}
 
-  PointCom(const CenterOfMassComputationPtr_t& comc) : comc_(comc) {}
+  PointCom(const CenterOfMassComputationPtr_t& comc)
+      : comc_(comc), cache_(ComComputationCache::get(comc)) {}
 
   inline const vector3_t& value() const { return comc_->com(); }
   inline const ComJacobian_t& jacobian() const { return comc_->jacobian(); }
@@ -799,11 +1015,11 @@ class PointCom : public CalculusBase<PointCom, vector3_t, ComJacobian_t> {
   const CenterOfMassComputationPtr_t& centerOfMassComputation() const {
     return comc_;
   }
-  void impl_value(const ConfigurationIn_t) {
-    comc_->compute(hpp::pinocchio::COM);
+  void impl_value(const ConfigurationIn_t arg) {
+    cache_->compute(arg, hpp::pinocchio::COM);
   }
-  void impl_jacobian(const ConfigurationIn_t) {
-    comc_->compute(hpp::pinocchio::COMPUTE_ALL);
+  void impl_jacobian(const ConfigurationIn_t arg) {
+    cache_->compute(arg, hpp::pinocchio::COMPUTE_ALL);
     // TODO: there is memory and time to be saved here as this copy is
     // not important.
     // this->jacobian_ = comc_->jacobian ();
@@ -811,6 +1027,7 @@ class PointCom : public CalculusBase<PointCom, vector3_t, ComJacobian_t> {
 
  protected:
   CenterOfMassComputationPtr_t comc_;
+  ComComputationCachePtr_t cache_;
 };
 
 class JointFrame
@@ -927,6 +1144,45 @@ class MatrixOfExpressions
     elements_[i][j] = ptr;
   }
 
+  /// Flatten the element expression trees into an evaluation tape.
+  ///
+  /// Once compiled, computeValue, computeJacobian and invalidate
+  /// iterate over the tape instead of recursing through the trees, so
+  /// the per-evaluation cost of the virtual dispatch and of the
+  /// invalidate cascades over shared sub-expressions disappears. The
+  /// expression remains usable without compiling; call compile again
+  /// after modifying the elements.
+  void compile() {
+    tape_.clear();
+    record(tape_);
+  }
+
+  void record(ExpressionTape& tape) {
+    for (std::size_t i = 0; i < nRows_; ++i)
+      for (std::size_t j = 0; j < nCols_; ++j) elements_[i][j]->record(tape);
+    Parent_t::record(tape);
+  }
+
+  void invalidateNode() {
+    Parent_t::invalidateNode();
+    piValid_ = false;
+    svdValid_ = false;
+  }
+
+  void computeValue(const ConfigurationIn_t arg) {
+    if (tape_.empty())
+      Parent_t::computeValue(arg);
+    else
+      tape_.computeValue(arg);
+  }
+
+  void computeJacobian(const ConfigurationIn_t arg) {
+    if (tape_.empty())
+      Parent_t::computeJacobian(arg);
+    else
+      tape_.computeJacobian(arg);
+  }
+
   void impl_value(const ConfigurationIn_t arg) {
     size_type r = 0, c = 0, nr = 0, nc = 0;
     for (std::size_t i = 0; i < nRows_; ++i) {
@@ -972,7 +1228,7 @@ class MatrixOfExpressions
     this->computeValue(arg);
     this->computeSVD(arg);
     pi_.resize(this->value_.cols(), this->value_.rows());
-    pseudoInverse<SVD_t>(svd_, pi_);
+    pseudoInverse<SVD_t>(svd_, pi_, svInv_);
     piValid_ = true;
   }
   void computePseudoInverseJacobian(
@@ -1049,6 +1305,12 @@ class MatrixOfExpressions
   Eigen::JacobiSVD<Value_t>& svd() { return svd_; }
 
   void invalidate() {
+    if (!tape_.empty()) {
+      // The tape holds every node of the expression, including this
+      // one; invalidateNode clears the SVD caches.
+      tape_.invalidate();
+      return;
+    }
     Parent_t::invalidate();
     for (std::size_t i = 0; i < nRows_; ++i)
       for (std::size_t j = 0; j < nCols_; ++j) elements_[i][j]->invalidate();
@@ -1063,8 +1325,13 @@ class MatrixOfExpressions
   SVD_t svd_;
   matrix_t pkInv_, pk_;
   PseudoInv_t pi_;
+  /// Workspace of pseudoInverse, kept across evaluations
+  typename SVD_t::SingularValuesType svInv_;
   PseudoInvJacobian_t pij_;
   bool piValid_, svdValid_;
+  /// Not copied by the copy constructors: a copy shares the element
+  /// expressions but must call compile itself.
+  ExpressionTape tape_;
 
  public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -43,6 +43,10 @@ namespace constraints {
 /// DifferentiableFunction \note At the moment, it is not possible to write a
 /// CalculusBaseAbstract
 ///       derived object that uses the extra config space of the robot.
+/// \note The expression is invalidated only when the argument changes, so
+///       the Jacobian pass reuses the node values computed by the value
+///       pass on the same configuration. As a consequence the wrapped
+///       expression must not be evaluated outside of this function.
 template <typename Expression>
 class HPP_CONSTRAINTS_DLLAPI SymbolicFunction : public DifferentiableFunction {
  public:
@@ -115,7 +119,7 @@ class HPP_CONSTRAINTS_DLLAPI SymbolicFunction : public DifferentiableFunction {
       robot_->currentConfiguration(argument);
       robot_->computeForwardKinematics();
     }
-    expr_->invalidate();
+    invalidateIfNeeded(argument);
     expr_->computeValue(argument);
     size_t index = 0;
     for (std::size_t i = 0; i < mask_.size(); i++) {
@@ -129,7 +133,7 @@ class HPP_CONSTRAINTS_DLLAPI SymbolicFunction : public DifferentiableFunction {
       robot_->currentConfiguration(arg);
       robot_->computeForwardKinematics();
     }
-    expr_->invalidate();
+    invalidateIfNeeded(arg);
     expr_->computeJacobian(arg);
     size_t index = 0;
 
@@ -151,6 +155,18 @@ class HPP_CONSTRAINTS_DLLAPI SymbolicFunction : public DifferentiableFunction {
 
   void init(const Ptr_t& self) { wkPtr_ = self; }
 
+  /// Invalidate the expression tree only when \c arg differs from the
+  /// latest evaluated argument. The nodes keep their value and jacobian
+  /// validity flags otherwise, so a Jacobian pass following a value
+  /// pass on the same configuration reuses all the intermediate node
+  /// values.
+  void invalidateIfNeeded(ConfigurationIn_t arg) const {
+    if ((latestArgument_.size() == arg.size()) && (latestArgument_ == arg))
+      return;
+    expr_->invalidate();
+    latestArgument_ = arg;
+  }
+
   bool isEqual(const DifferentiableFunction& other) const {
     const SymbolicFunction& castother =
         dynamic_cast<const SymbolicFunction&>(other);
@@ -168,6 +184,8 @@ class HPP_CONSTRAINTS_DLLAPI SymbolicFunction : public DifferentiableFunction {
   DevicePtr_t robot_;
   typename Traits<Expression>::Ptr_t expr_;
   std::vector<bool> mask_;
+  /// Argument for which the expression nodes hold valid caches.
+  mutable Configuration_t latestArgument_;
 };  // class SymbolicFunction
 }  // namespace constraints
 }  // namespace hpp
@@ -0,0 +1,89 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: Florent Lamiraux (florent.lamiraux@laas.fr)
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef HPP_CONSTRAINTS_TASK_EXECUTOR_HH
+#define HPP_CONSTRAINTS_TASK_EXECUTOR_HH
+
+#include <functional>
+#include <hpp/constraints/config.hh>
+#include <hpp/constraints/fwd.hh>
+#include <vector>
+
+namespace hpp {
+namespace constraints {
+/// Execution substrate of the parallel features of the library
+///
+/// The parallel evaluation modes of DifferentiableFunctionSet and
+/// ExplicitConstraintSet and the parallel finite difference Jacobians
+/// run their tasks through an instance of this interface. The built-in
+/// implementation (\ref create) owns a persistent pool of worker
+/// threads; applications that already run their own pool - a motion
+/// planner for instance - can derive from this class and install their
+/// implementation with \ref global so that a single object governs the
+/// concurrency of the whole library and no thread is oversubscribed.
+class HPP_CONSTRAINTS_DLLAPI TaskExecutor {
+ public:
+  typedef std::function<void(std::size_t)> Task;
+
+  virtual ~TaskExecutor() {}
+
+  /// Run task(i) for i in [0, nbTasks), blocking until completion
+  ///
+  /// The tasks must be safe to run concurrently; how they are
+  /// distributed over the threads is up to the implementation.
+  virtual void parallelFor(const Task& task, std::size_t nbTasks) = 0;
+
+  /// Number of threads that may run tasks concurrently
+  virtual std::size_t nbThreads() const = 0;
+
+  /// Create an executor backed by a persistent pool of worker threads
+  /// \param nbThreads number of threads running the tasks, including
+  ///        the calling thread,
+  /// \param cpus optional CPU indices the worker threads are pinned to,
+  ///        assigned round robin; the calling thread participates in
+  ///        the work but is left unpinned. Ignored on platforms without
+  ///        thread affinity support.
+  static TaskExecutorPtr_t create(std::size_t nbThreads,
+                                  const std::vector<int>& cpus =
+                                      std::vector<int>());
+
+  /// Executor shared by the parallel features of the library
+  ///
+  /// Null unless the setter below installed one; the parallel features
+  /// then size their own built-in pools from their parameters.
+  static const TaskExecutorPtr_t& global();
+  /// Install the executor shared by the parallel features
+  ///
+  /// Pass a null pointer to revert to per-feature built-in pools.
+  /// \warning not thread safe; install the executor before solving.
+  static void global(const TaskExecutorPtr_t& executor);
+};  // class TaskExecutor
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // HPP_CONSTRAINTS_TASK_EXECUTOR_HH
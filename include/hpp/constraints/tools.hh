@@ -152,6 +152,116 @@ void JlogSO3(const value_type& theta, const Eigen::MatrixBase<Derived>& log,
   }
 }
 
+/// Compute the logs of several rotation matrices at once
+///
+/// The per-rotation scalar work - trace, angle, sine - is gathered into
+/// arrays so that the transcendental calls run on whole packets through
+/// Eigen's vectorized array kernels, and the small-angle handling is
+/// branch-free. Rotations of angle close to pi fall back to the scalar
+/// logSO3, which handles this rare case with the explicit formula.
+///
+/// Passing fixed-size arguments - e.g. a 3x12 matrix and an array of
+/// size 4 - yields a fully unrolled fixed-size instantiation.
+///
+/// \param Rs n rotation matrices horizontally stacked in a 3x3n matrix,
+/// \retval thetas the n angles of rotation,
+/// \retval results the n vectors \f$\mathbf{r}\f$, one per column, such
+///         that \f$R_i=\exp [\mathbf{r}_i]_{\times}\f$.
+template <typename InDerived, typename ThetaDerived, typename OutDerived>
+inline void logSO3Batch(const Eigen::MatrixBase<InDerived>& Rs,
+                        const Eigen::ArrayBase<ThetaDerived>& thetas,
+                        Eigen::MatrixBase<OutDerived> const& results) {
+  typedef typename ThetaDerived::PlainObject ArrayN_t;
+  Eigen::MatrixBase<OutDerived>& value =
+      const_cast<Eigen::MatrixBase<OutDerived>&>(results);
+  const value_type PI = ::boost::math::constants::pi<value_type>();
+  const size_type n = thetas.size();
+  assert(Rs.rows() == 3 && Rs.cols() == 3 * n);
+  assert(results.rows() == 3 && results.cols() == n);
+
+  // Gather the strided coefficients into contiguous arrays.
+  ArrayN_t tr(n), a21(n), a02(n), a10(n);
+  for (size_type i = 0; i < n; ++i) {
+    const size_type c = 3 * i;
+    tr[i] = Rs(0, c) + Rs(1, c + 1) + Rs(2, c + 2);
+    a21[i] = Rs(2, c + 1) - Rs(1, c + 2);
+    a02[i] = Rs(0, c + 2) - Rs(2, c);
+    a10[i] = Rs(1, c) - Rs(0, c + 1);
+  }
+
+  ArrayN_t th = ((tr - 1) / 2).min(value_type(1)).max(value_type(-1)).acos();
+  // Branch-free small-angle handling: the unselected 0/0 is discarded.
+  const ArrayN_t t =
+      (th > 1e-6).select(th / th.sin(), ArrayN_t::Ones(n)) / 2;
+
+  for (size_type i = 0; i < n; ++i) {
+    if (th[i] < PI - 1e-2) {
+      value(0, i) = t[i] * a21[i];
+      value(1, i) = t[i] * a02[i];
+      value(2, i) = t[i] * a10[i];
+    } else {
+      // Rare case, see the threshold comment in logSO3.
+      value_type theta;
+      vector3_t r;
+      logSO3(matrix3_t(Rs.template middleCols<3>(3 * i)), theta, r);
+      th[i] = theta;
+      value.col(i) = r;
+    }
+  }
+  const_cast<Eigen::ArrayBase<ThetaDerived>&>(thetas) = th;
+}
+
+/// Compute the jacobians of log for several rotation matrices at once
+///
+/// Batch counterpart of JlogSO3: the coefficients common to the columns
+/// of each jacobian are computed on arrays - vectorized sin/cos,
+/// branch-free small-angle handling - before the 3x3 blocks are filled.
+///
+/// \param thetas the n angles of rotation as computed by logSO3Batch,
+/// \param logs the n log vectors, one per column,
+/// \retval Jlogs the n matrices \f$J_{log}(R_i)\f$ horizontally stacked
+///         in a 3x3n matrix.
+template <typename ThetaDerived, typename LogDerived, typename OutDerived>
+void JlogSO3Batch(const Eigen::ArrayBase<ThetaDerived>& thetas,
+                  const Eigen::MatrixBase<LogDerived>& logs,
+                  Eigen::MatrixBase<OutDerived> const& Jlogs) {
+  typedef typename ThetaDerived::PlainObject ArrayN_t;
+  Eigen::MatrixBase<OutDerived>& value =
+      const_cast<Eigen::MatrixBase<OutDerived>&>(Jlogs);
+  const size_type n = thetas.size();
+  assert(logs.rows() == 3 && logs.cols() == n);
+  assert(Jlogs.rows() == 3 && Jlogs.cols() == 3 * n);
+
+  const ArrayN_t st = thetas.sin(), ct = thetas.cos();
+  const ArrayN_t st_1mct = st / (1 - ct);
+  const ArrayN_t zero = ArrayN_t::Zero(n);
+  // Small angles get an identity jacobian: diagonal 1, no off-diagonal
+  // and rank-one terms. The unselected 0/0 are discarded.
+  const ArrayN_t diag =
+      (thetas > 1e-6).select(thetas * st_1mct / 2, ArrayN_t::Ones(n));
+  const ArrayN_t off = (thetas > 1e-6).select(0.5 * ArrayN_t::Ones(n), zero);
+  const ArrayN_t alpha = (thetas > 1e-6)
+                             .select(1 / (thetas * thetas).max(1e-12) -
+                                         st_1mct / (2 * thetas.max(1e-6)),
+                                     zero);
+
+  for (size_type i = 0; i < n; ++i) {
+    const size_type c = 3 * i;
+    const value_type l0 = logs(0, i), l1 = logs(1, i), l2 = logs(2, i);
+    value.template middleCols<3>(c).noalias() =
+        alpha[i] * logs.col(i) * logs.col(i).transpose();
+    value(0, c) += diag[i];
+    value(1, c + 1) += diag[i];
+    value(2, c + 2) += diag[i];
+    value(0, c + 1) -= off[i] * l2;
+    value(1, c) += off[i] * l2;
+    value(0, c + 2) += off[i] * l1;
+    value(2, c) -= off[i] * l1;
+    value(1, c + 2) -= off[i] * l0;
+    value(2, c + 1) += off[i] * l0;
+  }
+}
+
 /// Compute log of rigid-body transform
 ///
 /// \param M rigid body transform,
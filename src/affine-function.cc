@@ -26,6 +26,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
 // DAMAGE.
 
+#include <boost/serialization/vector.hpp>
 #include <hpp/constraints/affine-function.hh>
 #include <hpp/pinocchio/liegroup-element.hh>
 #include <hpp/util/serialization.hh>
@@ -53,6 +54,48 @@ void AffineFunction::serialize(Archive& ar, const unsigned int version) {
 
 HPP_SERIALIZATION_IMPLEMENT(AffineFunction);
 
+template <class Archive>
+void SparseAffineFunction::serialize(Archive& ar, const unsigned int version) {
+  (void)version;
+  ar& make_nvp("base", base_object<DifferentiableFunction>(*this));
+  // Archive the stored coefficients as triplets: boost does not know
+  // about Eigen sparse matrices.
+  size_type rows(J_.rows()), cols(J_.cols());
+  std::vector<size_type> rowIndices, colIndices;
+  std::vector<value_type> values;
+  if (Archive::is_saving::value) {
+    rowIndices.reserve(J_.nonZeros());
+    colIndices.reserve(J_.nonZeros());
+    values.reserve(J_.nonZeros());
+    for (size_type k = 0; k < J_.outerSize(); ++k)
+      for (SparseMatrix_t::InnerIterator it(J_, k); it; ++it) {
+        rowIndices.push_back(it.row());
+        colIndices.push_back(it.col());
+        values.push_back(it.value());
+      }
+  }
+  ar& BOOST_SERIALIZATION_NVP(rows);
+  ar& BOOST_SERIALIZATION_NVP(cols);
+  ar& BOOST_SERIALIZATION_NVP(rowIndices);
+  ar& BOOST_SERIALIZATION_NVP(colIndices);
+  ar& BOOST_SERIALIZATION_NVP(values);
+  ar& make_nvp("b_", const_cast<vector_t&>(b_));
+  if (!Archive::is_saving::value) {
+    typedef Eigen::Triplet<value_type> Triplet_t;
+    std::vector<Triplet_t> triplets;
+    triplets.reserve(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i)
+      triplets.push_back(Triplet_t((SparseMatrix_t::StorageIndex)rowIndices[i],
+                                   (SparseMatrix_t::StorageIndex)colIndices[i],
+                                   values[i]));
+    SparseMatrix_t& J(const_cast<SparseMatrix_t&>(J_));
+    J.resize(rows, cols);
+    J.setFromTriplets(triplets.begin(), triplets.end());
+  }
+}
+
+HPP_SERIALIZATION_IMPLEMENT(SparseAffineFunction);
+
 template <class Archive>
 void ConstantFunction::serialize(Archive& ar, const unsigned int version) {
   (void)version;
@@ -67,4 +110,5 @@ HPP_SERIALIZATION_IMPLEMENT(ConstantFunction);
 
 BOOST_CLASS_EXPORT(hpp::constraints::Identity)
 BOOST_CLASS_EXPORT(hpp::constraints::AffineFunction)
+BOOST_CLASS_EXPORT(hpp::constraints::SparseAffineFunction)
 BOOST_CLASS_EXPORT(hpp::constraints::ConstantFunction)
@@ -29,6 +29,7 @@
 // DAMAGE.
 
 #include <hpp/constraints/com-between-feet.hh>
+#include <hpp/constraints/com-computation-cache.hh>
 #include <hpp/pinocchio/center-of-mass-computation.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
@@ -51,10 +52,8 @@ ComBetweenFeetPtr_t ComBetweenFeet::create(
     const JointPtr_t& jointR, const vector3_t pointL, const vector3_t pointR,
     const JointPtr_t& jointRef, const vector3_t pointRef,
     std::vector<bool> mask) {
-  CenterOfMassComputationPtr_t comc = CenterOfMassComputation::create(robot);
-  comc->add(robot->rootJoint());
-  return create(name, robot, comc, jointL, jointR, pointL, pointR, jointRef,
-                pointRef, mask);
+  return create(name, robot, ComComputationCache::wholeBody(robot), jointL,
+                jointR, pointL, pointR, jointRef, pointRef, mask);
 }
 
 ComBetweenFeetPtr_t ComBetweenFeet::create(
@@ -97,64 +96,46 @@ ComBetweenFeet::ComBetweenFeet(const std::string& name,
   xmxlDotu_ = xmxl_ * u_;
   xmxrDotu_ = xmxr_ * u_;
   for (int i = 0; i < 3; i++) pointRef_[i] = pointRef[i];
+  // Flatten the expression trees of the selected output rows onto a
+  // single evaluation tape; shared nodes are recorded only once.
+  if (mask_[0]) com_->record(tape_);
+  if (mask_[1]) expr_->record(tape_);
+  if (mask_[2]) xmxlDotu_->record(tape_);
+  if (mask_[3]) xmxrDotu_->record(tape_);
 }
 
 void ComBetweenFeet::impl_compute(LiegroupElementRef result,
                                   ConfigurationIn_t argument) const {
   robot_->currentConfiguration(argument);
   robot_->computeForwardKinematics();
+  tape_.invalidate();
+  tape_.computeValue(argument);
   size_t index = 0;
-  if (mask_[0]) {
-    com_->invalidate();
-    com_->computeValue(argument);
-    result.vector()[index++] = (com_->value() - pointRef_)[2];
-  }
-  if (mask_[1]) {
-    expr_->invalidate();
-    expr_->computeValue(argument);
-    result.vector()[index++] = expr_->value()[2];
-  }
-  if (mask_[2]) {
-    xmxlDotu_->invalidate();
-    xmxlDotu_->computeValue(argument);
-    result.vector()[index++] = xmxlDotu_->value()[0];
-  }
-  if (mask_[3]) {
-    xmxrDotu_->invalidate();
-    xmxrDotu_->computeValue(argument);
-    result.vector()[index] = xmxrDotu_->value()[0];
-  }
+  if (mask_[0]) result.vector()[index++] = (com_->value() - pointRef_)[2];
+  if (mask_[1]) result.vector()[index++] = expr_->value()[2];
+  if (mask_[2]) result.vector()[index++] = xmxlDotu_->value()[0];
+  if (mask_[3]) result.vector()[index] = xmxrDotu_->value()[0];
 }
 
 void ComBetweenFeet::impl_jacobian(matrixOut_t jacobian,
                                    ConfigurationIn_t arg) const {
   robot_->currentConfiguration(arg);
   robot_->computeForwardKinematics();
+  tape_.invalidate();
+  tape_.computeJacobian(arg);
   size_t index = 0;
-  if (mask_[0]) {
-    com_->invalidate();
-    com_->computeJacobian(arg);
+  if (mask_[0])
     jacobian.row(index++).leftCols(jointRef_->jacobian().cols()) =
         com_->jacobian().row(2);
-  }
-  if (mask_[1]) {
-    expr_->invalidate();
-    expr_->computeJacobian(arg);
+  if (mask_[1])
     jacobian.row(index++).leftCols(jointRef_->jacobian().cols()) =
         expr_->jacobian().row(2);
-  }
-  if (mask_[2]) {
-    xmxlDotu_->invalidate();
-    xmxlDotu_->computeJacobian(arg);
+  if (mask_[2])
     jacobian.row(index++).leftCols(jointRef_->jacobian().cols()) =
         xmxlDotu_->jacobian();
-  }
-  if (mask_[3]) {
-    xmxrDotu_->invalidate();
-    xmxrDotu_->computeJacobian(arg);
+  if (mask_[3])
     jacobian.row(index).leftCols(jointRef_->jacobian().cols()) =
         xmxrDotu_->jacobian();
-  }
 }
 }  // namespace constraints
 }  // namespace hpp
@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2026 CNRS
+// Authors: Florent Lamiraux
+//
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <hpp/constraints/com-computation-cache.hh>
+#include <hpp/pinocchio/center-of-mass-computation.hh>
+#include <hpp/pinocchio/device.hh>
+#include <map>
+#include <mutex>
+
+namespace hpp {
+namespace constraints {
+
+namespace {
+// Both registries key on raw pointers and keep weak references only,
+// so they never extend the lifetime of a device or of a computation.
+typedef std::map<CenterOfMassComputation*, ComComputationCacheWkPtr_t>
+    CacheMap_t;
+typedef std::map<Device*, pinocchio::CenterOfMassComputationWkPtr_t>
+    WholeBodyMap_t;
+
+CacheMap_t& cacheMap() {
+  static CacheMap_t map;
+  return map;
+}
+
+WholeBodyMap_t& wholeBodyMap() {
+  static WholeBodyMap_t map;
+  return map;
+}
+
+std::mutex& registryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Expired entries appear when every constraint sharing an object has
+// been destroyed. They are pruned on the next lookup.
+template <typename Map>
+void prune(Map& map) {
+  for (typename Map::iterator it = map.begin(); it != map.end();) {
+    if (it->second.expired())
+      it = map.erase(it);
+    else
+      ++it;
+  }
+}
+}  // namespace
+
+ComComputationCachePtr_t ComComputationCache::get(
+    const CenterOfMassComputationPtr_t& comc) {
+  if (!comc) return ComComputationCachePtr_t();
+  std::lock_guard<std::mutex> lock(registryMutex());
+  CacheMap_t& map = cacheMap();
+  CacheMap_t::iterator it = map.find(comc.get());
+  if (it != map.end()) {
+    ComComputationCachePtr_t cache(it->second.lock());
+    if (cache) return cache;
+  }
+  prune(map);
+  ComComputationCachePtr_t cache(new ComComputationCache(comc));
+  map[comc.get()] = cache;
+  return cache;
+}
+
+CenterOfMassComputationPtr_t ComComputationCache::wholeBody(
+    const DevicePtr_t& robot) {
+  assert(robot);
+  std::lock_guard<std::mutex> lock(registryMutex());
+  WholeBodyMap_t& map = wholeBodyMap();
+  WholeBodyMap_t::iterator it = map.find(robot.get());
+  if (it != map.end()) {
+    CenterOfMassComputationPtr_t comc(it->second.lock());
+    if (comc) return comc;
+  }
+  prune(map);
+  CenterOfMassComputationPtr_t comc(CenterOfMassComputation::create(robot));
+  comc->add(robot->rootJoint());
+  map[robot.get()] = comc;
+  return comc;
+}
+
+void ComComputationCache::compute(ConfigurationIn_t argument,
+                                  const pinocchio::Computation_t& flag) {
+  const int mask = (int)flag;
+  const bool sameConfiguration =
+      (lastConfiguration_.size() == argument.size() &&
+       lastConfiguration_ == argument);
+  if (sameConfiguration && (computed_ & mask) == mask) return;
+  comc_->compute(flag);
+  if (sameConfiguration)
+    computed_ |= mask;
+  else {
+    lastConfiguration_ = argument;
+    computed_ = mask;
+  }
+}
+
+}  // namespace constraints
+}  // namespace hpp
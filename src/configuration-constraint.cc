@@ -32,6 +32,7 @@
 #include <hpp/pinocchio/joint-collection.hh>
 #include <hpp/pinocchio/joint.hh>
 #include <hpp/pinocchio/liegroup-element.hh>
+#include <hpp/pinocchio/liegroup.hh>
 #include <hpp/pinocchio/util.hh>
 #include <hpp/util/debug.hh>
 #include <hpp/util/indent.hh>
@@ -69,11 +70,20 @@ ConfigurationConstraint::ConfigurationConstraint(const std::string& name,
     : DifferentiableFunction(robot->configSize(), robot->numberDof(),
                              LiegroupSpace::R1(), name),
       robot_(robot),
-      weights_() {
+      weights_(),
+      restricted_(false) {
   weights(ws);
   LiegroupSpacePtr_t s(LiegroupSpace::createCopy(robot->configSpace()));
   s->mergeVectorSpaces();
   goal_ = LiegroupElement(goal, s);
+  diff_.resize(robot->numberDof());
+  diffJ_.resize(1, robot->numberDof());
+}
+
+void ConfigurationConstraint::restrictToDofs(const segments_t& dofs) {
+  activeDofs_ = Eigen::RowBlockIndices(dofs);
+  activeDofs_.updateIndices<true, true, true>();
+  restricted_ = !activeDofs_.rows().empty();
 }
 
 void ConfigurationConstraint::weights(const vector_t& ws) {
@@ -109,23 +119,48 @@ std::ostream& ConfigurationConstraint::print(std::ostream& o) const {
 void ConfigurationConstraint::impl_compute(LiegroupElementRef result,
                                            ConfigurationIn_t argument) const {
   using namespace hpp::pinocchio;
-  LiegroupElementConstRef a(argument, goal_.space());
-  result.vector()[0] = 0.5 * weights_.dot((goal_ - a).cwiseAbs2());
+  difference<DefaultLieGroupMap>(robot_, goal_.vector(), argument, diff_);
+  if (restricted_) {
+    const segments_t& dofs(activeDofs_.rows());
+    value_type squaredNorm = 0;
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+      squaredNorm +=
+          weights_.segment(dofs[i].first, dofs[i].second)
+              .dot(diff_.segment(dofs[i].first, dofs[i].second).cwiseAbs2());
+    result.vector()[0] = 0.5 * squaredNorm;
+  } else {
+    result.vector()[0] = 0.5 * weights_.dot(diff_.cwiseAbs2());
+  }
 }
 
 void ConfigurationConstraint::impl_jacobian(matrixOut_t jacobian,
                                             ConfigurationIn_t argument) const {
   using namespace hpp::pinocchio;
+  const size_type nv = robot_->numberDof();
+  difference<DefaultLieGroupMap>(robot_, goal_.vector(), argument, diff_);
+
+  if (restricted_) {
+    diffJ_ = diff_.transpose();
+    // Apply jacobian of the difference on the right.
+    goal_.space()->dDifference_dq0<pinocchio::InputTimesDerivative>(
+        argument, goal_.vector(), diffJ_);
+    jacobian.leftCols(nv).setZero();
+    const segments_t& dofs(activeDofs_.rows());
+    for (std::size_t i = 0; i < dofs.size(); ++i)
+      jacobian.middleCols(dofs[i].first, dofs[i].second) =
+          diffJ_.middleCols(dofs[i].first, dofs[i].second)
+              .cwiseProduct(
+                  weights_.segment(dofs[i].first, dofs[i].second).transpose());
+    return;
+  }
 
-  LiegroupElementConstRef a(argument, goal_.space());
-  jacobian.leftCols(robot_->numberDof()).noalias() = (goal_ - a).transpose();
+  jacobian.leftCols(nv).noalias() = diff_.transpose();
 
   // Apply jacobian of the difference on the right.
   goal_.space()->dDifference_dq0<pinocchio::InputTimesDerivative>(
-      argument, goal_.vector(), jacobian.leftCols(robot_->numberDof()));
+      argument, goal_.vector(), jacobian.leftCols(nv));
 
-  jacobian.leftCols(robot_->numberDof()).array() *=
-      weights_.array().transpose();
+  jacobian.leftCols(nv).array() *= weights_.array().transpose();
 }
 }  // namespace constraints
 }  // namespace hpp
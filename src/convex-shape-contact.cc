@@ -48,7 +48,13 @@ ConvexShapeContact::ConvexShapeContact(const std::string& name,
       relativeTransformationModel_(robot->numberDof() -
                                    robot->extraConfigSpace().dimension()),
       normalMargin_(0),
-      M_(0) {
+      M_(0),
+      pairCacheMargin_(0),
+      cachedPairValid_(false),
+      selectedObject_(0),
+      selectedFloor_(0),
+      selectedIsInside_(false),
+      selectionValid_(false) {
   relativeTransformationModel_.fullPos = true;
   relativeTransformationModel_.fullOri = true;
   relativeTransformationModel_.rowOri = 3;
@@ -101,6 +107,12 @@ void ConvexShapeContact::addFloor(const ConvexShape& t) {
   ConvexShape tt(t);
   tt.reverse();
   floorConvexShapes_.push_back(tt);
+  // Radius bound used by the broad phase of selectConvexShapes.
+  value_type r(0);
+  for (std::vector<vector3_t>::const_iterator itv(tt.Pts_.begin());
+       itv != tt.Pts_.end(); ++itv)
+    r = std::max(r, (*itv - tt.C_).norm());
+  floorRadii_.push_back(r);
 
   for (ConvexShapes_t::const_iterator o_it = objectConvexShapes_.begin();
        o_it != objectConvexShapes_.end(); ++o_it) {
@@ -170,10 +182,10 @@ void ConvexShapeContact::computeInternalValue(const ConfigurationIn_t& argument,
                                               std::size_t& ifloor) const {
   GTDataV<true, true, true, false> data(relativeTransformationModel_, robot_);
 
-  data.device.currentConfiguration(argument);
-  data.device.computeForwardKinematics();
+  data.computeForwardKinematics(argument);
 
-  isInside = selectConvexShapes(data.device.d(), iobject, ifloor);
+  isInside = selectConvexShapesStamped(argument, data.device.d(), iobject,
+                                       ifloor);
   const ConvexShape &object(objectConvexShapes_[iobject]),
       floor(floorConvexShapes_[ifloor]);
   type = contactType(object, floor);
@@ -189,14 +201,9 @@ void ConvexShapeContact::computeInternalValue(const ConfigurationIn_t& argument,
   value = data.value;
 }
 
-void ConvexShapeContact::impl_compute(LiegroupElementRef result,
-                                      ConfigurationIn_t argument) const {
-  bool isInside;
-  ContactType type;
-  vector6_t value;
-  std::size_t iobject, ifloor;
-  computeInternalValue(argument, isInside, type, value, iobject, ifloor);
-
+void ConvexShapeContact::assembleValue(bool isInside, ContactType type,
+                                       const vector6_t& value,
+                                       LiegroupElementRef result) const {
   if (isInside) {
     result.vector()[0] = value[0] + normalMargin_;
     result.vector().segment<2>(1).setZero();
@@ -219,6 +226,16 @@ void ConvexShapeContact::impl_compute(LiegroupElementRef result,
       result.vector().segment<2>(3) = value.tail<2>();
       break;
   }
+}
+
+void ConvexShapeContact::impl_compute(LiegroupElementRef result,
+                                      ConfigurationIn_t argument) const {
+  bool isInside;
+  ContactType type;
+  vector6_t value;
+  std::size_t iobject, ifloor;
+  computeInternalValue(argument, isInside, type, value, iobject, ifloor);
+  assembleValue(isInside, type, value, result);
   hppDout(info, "result = " << result);
 }
 
@@ -229,11 +246,11 @@ void ConvexShapeContact::computeInternalJacobian(
 
   GTDataJ<true, true, true, false> data(relativeTransformationModel_, robot_);
 
-  data.device.currentConfiguration(argument);
-  data.device.computeForwardKinematics();
+  data.computeForwardKinematics(argument);
 
   std::size_t ifloor, iobject;
-  isInside = selectConvexShapes(data.device.d(), iobject, ifloor);
+  isInside = selectConvexShapesStamped(argument, data.device.d(), iobject,
+                                       ifloor);
   const ConvexShape &object(objectConvexShapes_[iobject]),
       floor(floorConvexShapes_[ifloor]);
   type = contactType(object, floor);
@@ -250,13 +267,9 @@ void ConvexShapeContact::computeInternalJacobian(
   compute<true, true, true, false>::jacobian(data, jacobian, mask);
 }
 
-void ConvexShapeContact::impl_jacobian(matrixOut_t jacobian,
-                                       ConfigurationIn_t argument) const {
-  bool isInside;
-  ContactType type;
-  matrix_t tmpJac(6, robot_->numberDof());
-  computeInternalJacobian(argument, isInside, type, tmpJac);
-
+void ConvexShapeContact::assembleJacobian(bool isInside, ContactType type,
+                                          const matrix_t& tmpJac,
+                                          matrixOut_t jacobian) const {
   if (isInside) {
     jacobian.row(0) = tmpJac.row(0);
     jacobian.row(1).setZero();
@@ -280,18 +293,136 @@ void ConvexShapeContact::impl_jacobian(matrixOut_t jacobian,
   }
 }
 
+void ConvexShapeContact::impl_jacobian(matrixOut_t jacobian,
+                                       ConfigurationIn_t argument) const {
+  bool isInside;
+  ContactType type;
+  matrix_t tmpJac(6, robot_->numberDof());
+  computeInternalJacobian(argument, isInside, type, tmpJac);
+  assembleJacobian(isInside, type, tmpJac, jacobian);
+}
+
+void ConvexShapeContact::computeInternalValueAndJacobian(
+    const ConfigurationIn_t& argument, bool& isInside, ContactType& type,
+    vector6_t& value, matrix_t& jacobian, std::size_t& iobject,
+    std::size_t& ifloor) const {
+  static std::vector<bool> mask(6, true);
+
+  // One forward kinematics pass and one shape-pair selection serve
+  // both the error and its Jacobian.
+  GTDataJ<true, true, true, false> data(relativeTransformationModel_, robot_);
+
+  data.computeForwardKinematics(argument);
+
+  isInside = selectConvexShapesStamped(argument, data.device.d(), iobject,
+                                       ifloor);
+  const ConvexShape &object(objectConvexShapes_[iobject]),
+      floor(floorConvexShapes_[ifloor]);
+  type = contactType(object, floor);
+
+  relativeTransformationModel_.joint1 = floor.joint_;
+  relativeTransformationModel_.joint2 = object.joint_;
+  relativeTransformationModel_.F1inJ1 = floor.positionInJoint();
+  relativeTransformationModel_.F2inJ2 = object.positionInJoint();
+  relativeTransformationModel_.checkIsIdentity1();
+  relativeTransformationModel_.checkIsIdentity2();
+  data.cross2.setZero();
+
+  compute<true, true, true, false>::error(data);
+  value = data.value;
+  compute<true, true, true, false>::jacobian(data, jacobian, mask);
+}
+
+void ConvexShapeContact::impl_computeValueAndJacobian(
+    LiegroupElementRef result, matrixOut_t jacobian,
+    ConfigurationIn_t argument) const {
+  bool isInside;
+  ContactType type;
+  vector6_t value;
+  matrix_t tmpJac(6, robot_->numberDof());
+  std::size_t iobject, ifloor;
+  computeInternalValueAndJacobian(argument, isInside, type, value, tmpJac,
+                                  iobject, ifloor);
+  assembleValue(isInside, type, value, result);
+  assembleJacobian(isInside, type, tmpJac, jacobian);
+}
+
+bool ConvexShapeContact::selectConvexShapesStamped(
+    const ConfigurationIn_t& argument, const pinocchio::DeviceData& data,
+    std::size_t& iobject, std::size_t& ifloor) const {
+  if (selectionValid_ && selectionArg_.size() == argument.size() &&
+      selectionArg_ == argument) {
+    iobject = selectedObject_;
+    ifloor = selectedFloor_;
+    return selectedIsInside_;
+  }
+  bool isInside = selectConvexShapes(data, iobject, ifloor);
+  selectionArg_ = argument;
+  selectedObject_ = iobject;
+  selectedFloor_ = ifloor;
+  selectedIsInside_ = isInside;
+  selectionValid_ = true;
+  return isInside;
+}
+
 bool ConvexShapeContact::selectConvexShapes(const pinocchio::DeviceData& data,
                                             std::size_t& iobject,
                                             std::size_t& ifloor) const {
-  ConvexShapeData od, fd;
+  ConvexShapeData fd;
   bool isInside = false;  // Initialized only to remove compiler warning.
 
-  value_type dist, minDist = +std::numeric_limits<value_type>::infinity();
+  if (pairCacheMargin_ > 0 && cachedPairValid_) {
+    const ConvexShape& floor(floorConvexShapes_[cachedFloor_]);
+    ConvexShapeData od;
+    fd.updateToCurrentTransform(floor, data);
+    od.updateToCurrentTransform(objectConvexShapes_[cachedObject_], data);
+    value_type dp = fd.distance(floor, fd.intersection(od.center_, fd.normal_));
+    if (dp < -pairCacheMargin_) {
+      // The object center still projects inside the cached floor shape
+      // by more than the margin: keep the pair without scanning the
+      // others.
+      iobject = cachedObject_;
+      ifloor = cachedFloor_;
+      return true;
+    }
+  }
+
+  // Broad phase: for any object center C_o and floor center C_f with
+  // radius bound r_f, |C_o - C_f| - r_f is a lower bound on the
+  // selection distance. Most floors are thus discarded before their
+  // frame and edge distances are computed.
+  std::vector<ConvexShapeData> ods(objectConvexShapes_.size());
+  for (std::size_t i = 0; i < ods.size(); ++i)
+    ods[i].updateToCurrentTransform(objectConvexShapes_[i], data);
+  std::vector<value_type> lowerBounds(floorConvexShapes_.size());
+  std::size_t jFirst = 0;
   for (std::size_t j = 0; j < floorConvexShapes_.size(); ++j) {
+    const ConvexShape& floor(floorConvexShapes_[j]);
+    const vector3_t center(
+        floor.joint_ ? floor.joint_->currentTransformation(data).act(floor.C_)
+                     : floor.C_);
+    value_type lb = +std::numeric_limits<value_type>::infinity();
+    for (std::size_t i = 0; i < ods.size(); ++i)
+      lb = std::min(
+          lb, std::max(0., (ods[i].center_ - center).norm() - floorRadii_[j]));
+    lowerBounds[j] = lb * lb;
+    if (lowerBounds[j] < lowerBounds[jFirst]) jFirst = j;
+  }
+
+  value_type dist, minDist = +std::numeric_limits<value_type>::infinity();
+  for (std::size_t k = 0; k < floorConvexShapes_.size(); ++k) {
+    // Evaluate the most promising floor first so that the pruning bound
+    // is tight from the start.
+    std::size_t j;
+    if (k == 0)
+      j = jFirst;
+    else
+      j = (k - 1 < jFirst) ? k - 1 : k;
+    if (lowerBounds[j] >= minDist) continue;
     fd.updateToCurrentTransform(floorConvexShapes_[j], data);
 
-    for (std::size_t i = 0; i < objectConvexShapes_.size(); ++i) {
-      od.updateToCurrentTransform(objectConvexShapes_[i], data);
+    for (std::size_t i = 0; i < ods.size(); ++i) {
+      const ConvexShapeData& od(ods[i]);
       value_type dp = fd.distance(floorConvexShapes_[j],
                                   fd.intersection(od.center_, fd.normal_)),
                  dn = fd.normal_.dot(od.center_ - fd.center_);
@@ -308,6 +439,9 @@ bool ConvexShapeContact::selectConvexShapes(const pinocchio::DeviceData& data,
       }
     }
   }
+  cachedObject_ = iobject;
+  cachedFloor_ = ifloor;
+  cachedPairValid_ = true;
 
   return isInside;
 }
@@ -435,6 +569,33 @@ void ConvexShapeContactComplement::impl_jacobian(
   jacobian.row(2) = tmpJac.row(3);
 }
 
+void ConvexShapeContactComplement::impl_computeValueAndJacobian(
+    LiegroupElementRef result, matrixOut_t jacobian,
+    ConfigurationIn_t argument) const {
+  value_type M(sibling_->radius());
+  bool isInside;
+  ConvexShapeContact::ContactType type;
+  vector6_t value;
+  matrix_t tmpJac(6, sibling_->robot_->numberDof());
+  std::size_t iobject, ifloor;
+  sibling_->computeInternalValueAndJacobian(argument, isInside, type, value,
+                                            tmpJac, iobject, ifloor);
+  vector3_t offset;
+  offset << (value_type)(2 * ifloor) * M, (value_type)(2 * iobject) * M, 0;
+  result.vector()[2] = value[3];
+  if (isInside)
+    result.vector().head<2>() = value.segment<2>(1);
+  else
+    result.vector().head<2>().setZero();
+  result.vector() += offset;
+
+  if (isInside)
+    jacobian.topRows<2>() = tmpJac.middleRows<2>(1);
+  else
+    jacobian.topRows<2>().setZero();
+  jacobian.row(2) = tmpJac.row(3);
+}
+
 std::ostream& ConvexShapeContact::print(std::ostream& o) const {
   o << "ConvexShapeContact: " << name() << ", active dof "
     << pretty_print(BlockIndex::fromLogicalExpression(activeParameters_))
@@ -500,6 +661,17 @@ void ConvexShapeContactHold::impl_jacobian(matrixOut_t jacobian,
   complement_->impl_jacobian(jacobian.bottomRows<3>(), arg);
 }
 
+void ConvexShapeContactHold::impl_computeValueAndJacobian(
+    LiegroupElementRef result, matrixOut_t jacobian,
+    vectorIn_t argument) const {
+  LiegroupElementRef tmp1(result.vector().head<5>(), LiegroupSpace::Rn(5));
+  LiegroupElementRef tmp2(result.vector().tail<3>(), LiegroupSpace::Rn(3));
+  constraint_->impl_computeValueAndJacobian(tmp1, jacobian.topRows<5>(),
+                                            argument);
+  complement_->impl_computeValueAndJacobian(tmp2, jacobian.bottomRows<3>(),
+                                            argument);
+}
+
 bool ConvexShapeContactHold::isEqual(
     const DifferentiableFunction& other) const {
   const ConvexShapeContactHold& castother =
@@ -0,0 +1,68 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <hpp/constraints/device-sync-lease.hh>
+
+namespace hpp {
+namespace constraints {
+namespace {
+// Head of the chain of leases held by the current thread. Look-ups walk
+// the chain so that leases on different devices can be nested.
+thread_local DeviceSyncLease* leaseHead = NULL;
+}  // namespace
+
+DeviceSyncLease::DeviceSyncLease(const DevicePtr_t& device)
+    : sync_(device),
+      device_(device),
+      previous_(leaseHead),
+      lastConfigValid_(false) {
+  leaseHead = this;
+}
+
+DeviceSyncLease::~DeviceSyncLease() {
+  assert(leaseHead == this);
+  leaseHead = previous_;
+}
+
+DeviceSyncLease* DeviceSyncLease::get(const DevicePtr_t& device) {
+  for (DeviceSyncLease* lease = leaseHead; lease != NULL;
+       lease = lease->previous_)
+    if (lease->device_ == device) return lease;
+  return NULL;
+}
+
+void DeviceSyncLease::computeForwardKinematics(vectorIn_t config) {
+  if (lastConfigValid_ && lastConfig_.size() == config.size() &&
+      lastConfig_ == config)
+    return;
+  sync_.currentConfiguration(config);
+  sync_.computeForwardKinematics();
+  lastConfig_ = config;
+  lastConfigValid_ = true;
+}
+}  // namespace constraints
+}  // namespace hpp
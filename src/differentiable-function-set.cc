@@ -27,6 +27,7 @@
 // DAMAGE.
 
 #include <hpp/constraints/differentiable-function-set.hh>
+#include <hpp/constraints/task-executor.hh>
 #include <hpp/util/indent.hh>
 
 namespace hpp {
@@ -37,5 +38,91 @@ std::ostream& DifferentiableFunctionSet::print(std::ostream& os) const {
     os << iendl << i << ": " << *functions_[i];
   return os << decindent;
 }
+
+void DifferentiableFunctionSet::parallelEvaluation(std::size_t nbThreads) {
+  if (nbThreads <= 1) {
+    evaluator_.reset();
+    return;
+  }
+  // A globally installed executor takes precedence over a per-set pool,
+  // so that one object governs the concurrency of the whole library.
+  // See TaskExecutor.
+  if (TaskExecutor::global()) {
+    evaluator_ = TaskExecutor::global();
+    return;
+  }
+  if (evaluator_ && evaluator_->nbThreads() == nbThreads) return;
+  evaluator_ = TaskExecutor::create(nbThreads);
+}
+
+std::size_t DifferentiableFunctionSet::parallelEvaluation() const {
+  return evaluator_ ? evaluator_->nbThreads() : 0;
+}
+
+void DifferentiableFunctionSet::implComputeParallel(
+    LiegroupElementRef result, ConfigurationIn_t arg) const {
+  std::vector<size_type> rows(functions_.size());
+  size_type row = 0;
+  for (std::size_t i = 0; i < functions_.size(); ++i) {
+    rows[i] = row;
+    row += functions_[i]->outputSize();
+  }
+  // The row blocks are disjoint so the workers write their slice of the
+  // output vector in place, without a gather pass afterwards.
+  const std::function<void(std::size_t)> task = [this, &result, &rows,
+                                                 &arg](std::size_t i) {
+    const DifferentiableFunction& f = *functions_[i];
+    LiegroupElementRef slice(result.vector().segment(rows[i], f.outputSize()),
+                             f.outputSpace());
+    f.impl_compute(slice, arg);
+    assert(hpp::pinocchio::checkNormalized(slice));
+  };
+  evaluator_->parallelFor(task, functions_.size());
+  assert(hpp::pinocchio::checkNormalized(result));
+}
+
+void DifferentiableFunctionSet::implJacobianParallel(
+    matrixOut_t jacobian, ConfigurationIn_t arg) const {
+  std::vector<size_type> rows(functions_.size());
+  size_type row = 0;
+  for (std::size_t i = 0; i < functions_.size(); ++i) {
+    rows[i] = row;
+    row += functions_[i]->outputDerivativeSize();
+  }
+  // The row blocks are disjoint so the workers never write to the same
+  // coefficient.
+  const std::function<void(std::size_t)> task = [this, &jacobian, &rows,
+                                                 &arg](std::size_t i) {
+    const DifferentiableFunction& f = *functions_[i];
+    f.impl_jacobian(jacobian.middleRows(rows[i], f.outputDerivativeSize()),
+                    arg);
+  };
+  evaluator_->parallelFor(task, functions_.size());
+}
+
+void DifferentiableFunctionSet::implComputeValueAndJacobianParallel(
+    LiegroupElementRef result, matrixOut_t jacobian,
+    ConfigurationIn_t arg) const {
+  std::vector<size_type> rows(functions_.size()), jRows(functions_.size());
+  size_type row = 0, jRow = 0;
+  for (std::size_t i = 0; i < functions_.size(); ++i) {
+    rows[i] = row;
+    jRows[i] = jRow;
+    row += functions_[i]->outputSize();
+    jRow += functions_[i]->outputDerivativeSize();
+  }
+  const std::function<void(std::size_t)> task = [this, &result, &jacobian,
+                                                 &rows, &jRows,
+                                                 &arg](std::size_t i) {
+    const DifferentiableFunction& f = *functions_[i];
+    LiegroupElementRef slice(result.vector().segment(rows[i], f.outputSize()),
+                             f.outputSpace());
+    f.impl_computeValueAndJacobian(
+        slice, jacobian.middleRows(jRows[i], f.outputDerivativeSize()), arg);
+    assert(hpp::pinocchio::checkNormalized(slice));
+  };
+  evaluator_->parallelFor(task, functions_.size());
+  assert(hpp::pinocchio::checkNormalized(result));
+}
 }  // namespace constraints
 }  // namespace hpp
@@ -27,6 +27,7 @@
 // DAMAGE.
 
 #include <boost/serialization/string.hpp>
+#include <hpp/constraints/affine-function.hh>
 #include <hpp/constraints/differentiable-function.hh>
 #include <hpp/pinocchio/configuration.hh>
 #include <hpp/pinocchio/device.hh>
@@ -35,7 +36,11 @@
 #include <hpp/pinocchio/liegroup.hh>
 #include <hpp/pinocchio/serialization.hh>
 #include <hpp/util/serialization.hh>
+#include <mutex>
 #include <pinocchio/multibody/liegroup/liegroup.hpp>
+#include <unordered_map>
+
+#include <hpp/constraints/task-executor.hh>
 
 BOOST_CLASS_EXPORT(hpp::constraints::DifferentiableFunction)
 
@@ -189,28 +194,183 @@ void finiteDiffForward(matrixOut_t jacobian, vectorIn_t x,
             "Finite difference of \"" << f.name() << "\" has NaN values.");
   }
 }
+
+/// Parallel variants of the loops above. The dof columns are
+/// independent; each task owns its perturbed point and function value,
+/// so the only requirement is that the function supports concurrent
+/// evaluations (see the nbThreads documentation in the header).
+template <typename FiniteDiffOp, typename Function>
+void finiteDiffCentralParallel(matrixOut_t jacobian, vectorIn_t x,
+                               const FiniteDiffOp& op, const Function& f,
+                               std::size_t nbThreads) {
+  const ArrayXb& adp = f.activeDerivativeParameters();
+  TaskExecutorPtr_t executor(TaskExecutor::global());
+  if (!executor) executor = TaskExecutor::create(nbThreads);
+  const std::function<void(std::size_t)> task = [&jacobian, &x, &op, &f,
+                                                 &adp](std::size_t jj) {
+    const size_type j = (size_type)jj;
+    if (!adp[j]) {
+      jacobian.col(j).setZero();
+      return;
+    }
+    vector_t h(vector_t::Zero(jacobian.cols()));
+    h[j] = op.step(j, x);
+    vector_t x_mdx(x), x_pdx(x);
+    op.template integrate<false>(x, h, j, x_mdx);
+    op.template integrate<true>(x, h, j, x_pdx);
+    LiegroupElement f_x_mdx(f.outputSpace()), f_x_pdx(f.outputSpace());
+    f.value(f_x_mdx, x_mdx);
+    f.value(f_x_pdx, x_pdx);
+    jacobian.col(j) = ((f_x_pdx - f_x_mdx) / h[j]) / 2;
+  };
+  executor->parallelFor(task, (std::size_t)jacobian.cols());
+  if (jacobian.hasNaN()) {
+    hppDout(error, "Central finite difference: NaN");
+  }
+}
+
+template <typename FiniteDiffOp, typename Function>
+void finiteDiffForwardParallel(matrixOut_t jacobian, vectorIn_t x,
+                               const FiniteDiffOp& op, const Function& f,
+                               std::size_t nbThreads) {
+  const ArrayXb& adp = f.activeDerivativeParameters();
+  LiegroupElement f_x(f.outputSpace());
+  f.value(f_x, x);
+  TaskExecutorPtr_t executor(TaskExecutor::global());
+  if (!executor) executor = TaskExecutor::create(nbThreads);
+  const std::function<void(std::size_t)> task = [&jacobian, &x, &op, &f, &adp,
+                                                 &f_x](std::size_t jj) {
+    const size_type j = (size_type)jj;
+    if (!adp[j]) {
+      jacobian.col(j).setZero();
+      return;
+    }
+    vector_t h(vector_t::Zero(jacobian.cols()));
+    h[j] = op.step(j, x);
+    vector_t x_dx(x);
+    op.template integrate<true>(x, h, j, x_dx);
+    LiegroupElement f_x_pdx(f.outputSpace());
+    f.value(f_x_pdx, x_dx);
+    jacobian.col(j) = (f_x_pdx - f_x) / h[j];
+  };
+  executor->parallelFor(task, (std::size_t)jacobian.cols());
+  if (jacobian.hasNaN()) {
+    hppDout(warning,
+            "Finite difference of \"" << f.name() << "\" has NaN values.");
+  }
+}
+
+/// Batched variants: the perturbed points are stacked column-wise and
+/// evaluated in one valueBatch call, so functions overriding
+/// impl_computeBatch factor work across them. \c central selects the
+/// scheme; forward appends the unperturbed point as last column.
+template <bool central, typename FiniteDiffOp, typename Function>
+void finiteDiffBatch(matrixOut_t jacobian, vectorIn_t x,
+                     const FiniteDiffOp& op, const Function& f) {
+  const ArrayXb& adp = f.activeDerivativeParameters();
+  const size_type n = jacobian.cols();
+  size_type nActive = 0;
+  for (size_type j = 0; j < n; ++j)
+    if (adp[j]) ++nActive;
+  const size_type cols = central ? 2 * nActive : nActive + 1;
+  matrix_t args(x.size(), cols);
+  matrix_t results(f.outputSize(), cols);
+  vector_t h(vector_t::Zero(n)), steps(vector_t::Zero(n));
+  vector_t tmp(x);
+  size_type k = 0;
+  for (size_type j = 0; j < n; ++j) {
+    if (!adp[j]) continue;
+    h[j] = op.step(j, x);
+    steps[j] = h[j];
+    if (central) {
+      op.template integrate<false>(x, h, j, tmp);
+      args.col(k++) = tmp;
+      op.reset(x, j, tmp);
+    }
+    op.template integrate<true>(x, h, j, tmp);
+    args.col(k++) = tmp;
+    op.reset(x, j, tmp);
+    h[j] = 0;
+  }
+  if (!central) args.col(k) = x;
+  f.valueBatch(results, args);
+  k = 0;
+  for (size_type j = 0; j < n; ++j) {
+    if (!adp[j]) {
+      jacobian.col(j).setZero();
+      continue;
+    }
+    if (central) {
+      LiegroupElementConstRef f_x_mdx(results.col(k), f.outputSpace());
+      LiegroupElementConstRef f_x_pdx(results.col(k + 1), f.outputSpace());
+      jacobian.col(j) = ((f_x_pdx - f_x_mdx) / steps[j]) / 2;
+      k += 2;
+    } else {
+      LiegroupElementConstRef f_x(results.col(cols - 1), f.outputSpace());
+      LiegroupElementConstRef f_x_pdx(results.col(k), f.outputSpace());
+      jacobian.col(j) = (f_x_pdx - f_x) / steps[j];
+      ++k;
+    }
+  }
+  if (jacobian.hasNaN()) {
+    hppDout(warning,
+            "Finite difference of \"" << f.name() << "\" has NaN values.");
+  }
+}
 }  // namespace
 
-void DifferentiableFunction::finiteDifferenceForward(matrixOut_t jacobian,
-                                                     vectorIn_t x,
-                                                     DevicePtr_t robot,
-                                                     value_type eps) const {
-  if (robot)
+void DifferentiableFunction::finiteDifferenceForward(
+    matrixOut_t jacobian, vectorIn_t x, DevicePtr_t robot, value_type eps,
+    std::size_t nbThreads) const {
+  if (nbThreads > 1) {
+    if (robot)
+      finiteDiffForwardParallel(jacobian, x, FiniteDiffRobotOp(robot, eps),
+                                *this, nbThreads);
+    else
+      finiteDiffForwardParallel(jacobian, x, FiniteDiffVectorSpaceOp(eps),
+                                *this, nbThreads);
+  } else if (robot)
     finiteDiffForward(jacobian, x, FiniteDiffRobotOp(robot, eps), *this);
   else
     finiteDiffForward(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this);
 }
 
-void DifferentiableFunction::finiteDifferenceCentral(matrixOut_t jacobian,
-                                                     vectorIn_t x,
-                                                     DevicePtr_t robot,
-                                                     value_type eps) const {
-  if (robot)
+void DifferentiableFunction::finiteDifferenceCentral(
+    matrixOut_t jacobian, vectorIn_t x, DevicePtr_t robot, value_type eps,
+    std::size_t nbThreads) const {
+  if (nbThreads > 1) {
+    if (robot)
+      finiteDiffCentralParallel(jacobian, x, FiniteDiffRobotOp(robot, eps),
+                                *this, nbThreads);
+    else
+      finiteDiffCentralParallel(jacobian, x, FiniteDiffVectorSpaceOp(eps),
+                                *this, nbThreads);
+  } else if (robot)
     finiteDiffCentral(jacobian, x, FiniteDiffRobotOp(robot, eps), *this);
   else
     finiteDiffCentral(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this);
 }
 
+void DifferentiableFunction::finiteDifferenceCentralBatch(matrixOut_t jacobian,
+                                                          vectorIn_t x,
+                                                          DevicePtr_t robot,
+                                                          value_type eps) const {
+  if (robot)
+    finiteDiffBatch<true>(jacobian, x, FiniteDiffRobotOp(robot, eps), *this);
+  else
+    finiteDiffBatch<true>(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this);
+}
+
+void DifferentiableFunction::finiteDifferenceForwardBatch(matrixOut_t jacobian,
+                                                          vectorIn_t x,
+                                                          DevicePtr_t robot,
+                                                          value_type eps) const {
+  if (robot)
+    finiteDiffBatch<false>(jacobian, x, FiniteDiffRobotOp(robot, eps), *this);
+  else
+    finiteDiffBatch<false>(jacobian, x, FiniteDiffVectorSpaceOp(eps), *this);
+}
+
 bool DifferentiableFunction::operator==(
     DifferentiableFunction const& other) const {
   try {
@@ -232,6 +392,7 @@ DifferentiableFunction::DifferentiableFunction(size_type sizeInput,
       outputSpace_(LiegroupSpace::Rn(sizeOutput)),
       activeParameters_(ArrayXb::Constant(sizeInput, true)),
       activeDerivativeParameters_(ArrayXb::Constant(sizeInputDerivative, true)),
+      kind_(GenericKind),
       name_(name) {}
 
 DifferentiableFunction::DifferentiableFunction(
@@ -242,9 +403,114 @@ DifferentiableFunction::DifferentiableFunction(
       outputSpace_(outputSpace),
       activeParameters_(ArrayXb::Constant(sizeInput, true)),
       activeDerivativeParameters_(ArrayXb::Constant(sizeInputDerivative, true)),
+      kind_(GenericKind),
       name_(name),
       context_() {}
 
+void DifferentiableFunction::value(LiegroupElementRef result,
+                                   vectorIn_t argument) const {
+  assert(result.space()->nq() == outputSize());
+  assert(argument.size() == inputSize());
+  // The builtin kinds bypass the virtual dispatch so that their trivial
+  // implementations get inlined here, where the solver inner loops call.
+  switch (kind_) {
+    case IdentityKind:
+      static_cast<const Identity*>(this)->Identity::impl_compute(result,
+                                                                 argument);
+      break;
+    case AffineKind:
+      static_cast<const AffineFunction*>(this)->AffineFunction::impl_compute(
+          result, argument);
+      break;
+    case SparseAffineKind:
+      static_cast<const SparseAffineFunction*>(this)
+          ->SparseAffineFunction::impl_compute(result, argument);
+      break;
+    case ConstantKind:
+      static_cast<const ConstantFunction*>(this)
+          ->ConstantFunction::impl_compute(result, argument);
+      break;
+    default:
+      impl_compute(result, argument);
+      break;
+  }
+}
+
+void DifferentiableFunction::jacobian(matrixOut_t jacobian,
+                                      vectorIn_t argument) const {
+  assert(argument.size() == inputSize());
+  assert(jacobian.rows() == outputDerivativeSize());
+  assert(jacobian.cols() == inputDerivativeSize());
+  switch (kind_) {
+    case IdentityKind:
+      static_cast<const Identity*>(this)->Identity::impl_jacobian(jacobian,
+                                                                  argument);
+      break;
+    case AffineKind:
+      static_cast<const AffineFunction*>(this)->AffineFunction::impl_jacobian(
+          jacobian, argument);
+      break;
+    case SparseAffineKind:
+      static_cast<const SparseAffineFunction*>(this)
+          ->SparseAffineFunction::impl_jacobian(jacobian, argument);
+      break;
+    case ConstantKind:
+      static_cast<const ConstantFunction*>(this)
+          ->ConstantFunction::impl_jacobian(jacobian, argument);
+      break;
+    default:
+      impl_jacobian(jacobian, argument);
+      break;
+  }
+}
+
+void DifferentiableFunction::valueAndJacobian(LiegroupElementRef result,
+                                              matrixOut_t jacobian,
+                                              vectorIn_t argument) const {
+  assert(result.space()->nq() == outputSize());
+  assert(argument.size() == inputSize());
+  assert(jacobian.rows() == outputDerivativeSize());
+  assert(jacobian.cols() == inputDerivativeSize());
+  // None of the builtin kinds shares work between the two evaluations,
+  // so the dispatch of value and jacobian is enough.
+  if (kind_ == GenericKind) {
+    impl_computeValueAndJacobian(result, jacobian, argument);
+  } else {
+    value(result, argument);
+    this->jacobian(jacobian, argument);
+  }
+}
+
+void DifferentiableFunction::jacobianOnColumns(matrixOut_t jacobian,
+                                               vectorIn_t argument,
+                                               const segments_t& cols) const {
+  assert(providesJacobianOnColumns());
+  assert(argument.size() == inputSize());
+  assert(jacobian.rows() == outputDerivativeSize());
+  switch (kind_) {
+    case IdentityKind:
+      static_cast<const Identity*>(this)->Identity::impl_jacobianOnColumns(
+          jacobian, argument, cols);
+      break;
+    case AffineKind:
+      static_cast<const AffineFunction*>(this)
+          ->AffineFunction::impl_jacobianOnColumns(jacobian, argument, cols);
+      break;
+    case SparseAffineKind:
+      static_cast<const SparseAffineFunction*>(this)
+          ->SparseAffineFunction::impl_jacobianOnColumns(jacobian, argument,
+                                                         cols);
+      break;
+    case ConstantKind:
+      static_cast<const ConstantFunction*>(this)
+          ->ConstantFunction::impl_jacobianOnColumns(jacobian, argument, cols);
+      break;
+    default:
+      impl_jacobianOnColumns(jacobian, argument, cols);
+      break;
+  }
+}
+
 std::ostream& DifferentiableFunction::print(std::ostream& o) const {
   return o << "Differentiable function: " << name();
 }
@@ -264,5 +530,49 @@ void DifferentiableFunction::serialize(Archive& ar,
 }
 
 HPP_SERIALIZATION_IMPLEMENT(DifferentiableFunction);
+
+namespace {
+typedef std::unordered_multimap<std::string, DifferentiableFunctionWkPtr_t>
+    FunctionRegistryMap_t;
+
+FunctionRegistryMap_t& functionRegistryMap() {
+  static FunctionRegistryMap_t map;
+  return map;
+}
+
+std::mutex& functionRegistryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+}  // namespace
+
+DifferentiableFunctionPtr_t DifferentiableFunctionRegistry::dedupe(
+    const DifferentiableFunctionPtr_t& f) {
+  if (!f) return f;
+  std::lock_guard<std::mutex> lock(functionRegistryMutex());
+  FunctionRegistryMap_t& map = functionRegistryMap();
+  // Equal functions have equal names, so the name bucket contains all
+  // the candidates.
+  std::pair<FunctionRegistryMap_t::iterator, FunctionRegistryMap_t::iterator>
+      range(map.equal_range(f->name()));
+  for (FunctionRegistryMap_t::iterator it = range.first;
+       it != range.second;) {
+    DifferentiableFunctionPtr_t candidate(it->second.lock());
+    if (!candidate) {
+      it = map.erase(it);
+      continue;
+    }
+    if (candidate == f || *candidate == *f) return candidate;
+    ++it;
+  }
+  map.insert(
+      std::make_pair(f->name(), DifferentiableFunctionWkPtr_t(f)));
+  return f;
+}
+
+void DifferentiableFunctionRegistry::clear() {
+  std::lock_guard<std::mutex> lock(functionRegistryMutex());
+  functionRegistryMap().clear();
+}
 }  // namespace constraints
 }  // namespace hpp
@@ -60,6 +60,22 @@ void initGeomData(const pinocchio::GeomModel& model, pinocchio::GeomData& data,
   }
 }
 
+// Conservative bound on the distance from the joint origin to any point
+// of the body, from the local bounding volumes of its geometries.
+value_type bodyRadius(const pinocchio::GeomModel& model,
+                      const pinocchio::BodyPtr_t& body) {
+  value_type radius = 0;
+  for (size_type i = 0; i < body->nbInnerObjects(); ++i) {
+    CollisionObjectConstPtr_t obj(body->innerObjectAt(i));
+    const ::pinocchio::GeometryObject& go(
+        model.geometryObjects[obj->indexInModel()]);
+    radius = std::max(radius, go.placement.translation().norm() +
+                                  go.geometry->aabb_center.norm() +
+                                  go.geometry->aabb_radius);
+  }
+  return radius;
+}
+
 DistanceBetweenBodiesPtr_t DistanceBetweenBodies::create(
     const std::string& name, const DevicePtr_t& robot, const JointPtr_t& joint1,
     const JointPtr_t& joint2) {
@@ -88,12 +104,16 @@ DistanceBetweenBodies::DistanceBetweenBodies(const std::string& name,
       joint1_(joint1),
       joint2_(joint2),
       data_(robot->geomModel()),
-      latestResult_(outputSpace()) {
+      latestResult_(outputSpace()),
+      cacheTolerance_(0),
+      queryValid_(false) {
   pinocchio::BodyPtr_t body2(joint2_->linkedBody());
   CollisionObjects_t objects2(body2->nbInnerObjects());
   for (std::size_t j = 0; j < objects2.size(); ++j)
     objects2[j] = body2->innerObjectAt(j);
   initGeomData(robot_->geomModel(), data_, joint1_->linkedBody(), objects2);
+  radius1_ = bodyRadius(robot_->geomModel(), joint1_->linkedBody());
+  radius2_ = bodyRadius(robot_->geomModel(), body2);
 }
 
 DistanceBetweenBodies::DistanceBetweenBodies(const std::string& name,
@@ -106,8 +126,28 @@ DistanceBetweenBodies::DistanceBetweenBodies(const std::string& name,
       joint1_(joint),
       joint2_(),
       data_(robot->geomModel()),
-      latestResult_(outputSpace()) {
+      latestResult_(outputSpace()),
+      cacheTolerance_(0),
+      // The environment objects do not move.
+      radius2_(0),
+      queryValid_(false) {
   initGeomData(robot_->geomModel(), data_, joint1_->linkedBody(), objects);
+  radius1_ = bodyRadius(robot_->geomModel(), joint1_->linkedBody());
+}
+
+value_type DistanceBetweenBodies::displacementBound() const {
+  // For any body point x with |x| <= r in the joint frame,
+  // |M x - M' x| <= |dt| + |dR| r; the Frobenius norm of dR bounds its
+  // spectral norm.
+  const Transform3f& M1(joint1_->currentTransformation());
+  value_type bound = (M1.translation() - queryM1_.translation()).norm() +
+                     (M1.rotation() - queryM1_.rotation()).norm() * radius1_;
+  if (joint2_) {
+    const Transform3f& M2(joint2_->currentTransformation());
+    bound += (M2.translation() - queryM2_.translation()).norm() +
+             (M2.rotation() - queryM2_.rotation()).norm() * radius2_;
+  }
+  return bound;
 }
 
 void DistanceBetweenBodies::impl_compute(LiegroupElementRef result,
@@ -119,12 +159,24 @@ void DistanceBetweenBodies::impl_compute(LiegroupElementRef result,
   }
   robot_->currentConfiguration(argument);
   robot_->computeForwardKinematics();
+  if (cacheTolerance_ > 0 && queryValid_ &&
+      displacementBound() <= cacheTolerance_) {
+    // Temporal coherence: since the last narrow-phase query, neither
+    // body can have moved enough for the distance to drift by more than
+    // the tolerance. Keep the cached value and witness points.
+    result = latestResult_;
+    latestArgument_ = argument;
+    return;
+  }
   ::pinocchio::updateGeometryPlacements(robot_->model(), robot_->data(),
                                         robot_->geomModel(), data_);
   minIndex_ = ::pinocchio::computeDistances(robot_->geomModel(), data_);
   result.vector()[0] = data_.distanceResults[minIndex_].min_distance;
   latestArgument_ = argument;
   latestResult_ = result;
+  queryM1_ = joint1_->currentTransformation();
+  if (joint2_) queryM2_ = joint2_->currentTransformation();
+  queryValid_ = true;
 }
 
 void DistanceBetweenBodies::impl_jacobian(matrixOut_t jacobian,
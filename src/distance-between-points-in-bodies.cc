@@ -38,14 +38,10 @@
 namespace hpp {
 namespace constraints {
 
-static void cross(const vector3_t& v, eigen::matrix3_t& m) {
-  m(0, 1) = -v[2];
-  m(1, 0) = v[2];
-  m(0, 2) = v[1];
-  m(2, 0) = -v[1];
-  m(1, 2) = -v[0];
-  m(2, 1) = v[0];
-  m(0, 0) = m(1, 1) = m(2, 2) = 0;
+static matrix_t toColumns(const std::vector<vector3_t>& pts) {
+  matrix_t m(3, pts.size());
+  for (std::size_t i = 0; i < pts.size(); ++i) m.col(i) = pts[i];
+  return m;
 }
 
 DistanceBetweenPointsInBodiesPtr_t DistanceBetweenPointsInBodies::create(
@@ -67,6 +63,16 @@ DistanceBetweenPointsInBodiesPtr_t DistanceBetweenPointsInBodies::create(
   return shPtr;
 }
 
+DistanceBetweenPointsInBodiesPtr_t DistanceBetweenPointsInBodies::create(
+    const std::string& name, const DevicePtr_t& robot, const JointPtr_t& joint1,
+    const JointPtr_t& joint2, const std::vector<vector3_t>& points1,
+    const std::vector<vector3_t>& points2) {
+  DistanceBetweenPointsInBodies* ptr = new DistanceBetweenPointsInBodies(
+      name, robot, joint1, joint2, points1, points2);
+  DistanceBetweenPointsInBodiesPtr_t shPtr(ptr);
+  return shPtr;
+}
+
 DistanceBetweenPointsInBodies::DistanceBetweenPointsInBodies(
     const std::string& name, const DevicePtr_t& robot, const JointPtr_t& joint1,
     const JointPtr_t& joint2, const vector3_t& point1, const vector3_t& point2)
@@ -75,11 +81,11 @@ DistanceBetweenPointsInBodies::DistanceBetweenPointsInBodies(
       robot_(robot),
       joint1_(joint1),
       joint2_(joint2),
-      point1_(point1),
-      point2_(point2),
+      points1_(point1),
+      points2_(point2),
       latestResult_(outputSpace()) {
   assert(joint1);
-  global2_ = point2;
+  global2_ = points2_;
 }
 
 DistanceBetweenPointsInBodies::DistanceBetweenPointsInBodies(
@@ -90,11 +96,29 @@ DistanceBetweenPointsInBodies::DistanceBetweenPointsInBodies(
       robot_(robot),
       joint1_(joint1),
       joint2_(),
-      point1_(point1),
-      point2_(point2),
+      points1_(point1),
+      points2_(point2),
+      latestResult_(outputSpace()) {
+  assert(joint1);
+  global2_ = points2_;
+}
+
+DistanceBetweenPointsInBodies::DistanceBetweenPointsInBodies(
+    const std::string& name, const DevicePtr_t& robot, const JointPtr_t& joint1,
+    const JointPtr_t& joint2, const std::vector<vector3_t>& points1,
+    const std::vector<vector3_t>& points2)
+    : DifferentiableFunction(robot->configSize(), robot->numberDof(),
+                             LiegroupSpace::Rn((size_type)points1.size()),
+                             name),
+      robot_(robot),
+      joint1_(joint1),
+      joint2_(joint2),
+      points1_(toColumns(points1)),
+      points2_(toColumns(points2)),
       latestResult_(outputSpace()) {
   assert(joint1);
-  global2_ = point2;
+  assert(points1.size() == points2.size());
+  global2_ = points2_;
 }
 
 void DistanceBetweenPointsInBodies::impl_compute(
@@ -106,13 +130,17 @@ void DistanceBetweenPointsInBodies::impl_compute(
   }
   robot_->currentConfiguration(argument);
   robot_->computeForwardKinematics();
-  global1_ = joint1_->currentTransformation().act(point1_);
+  // Both joints are transformed once; all the points they carry are
+  // moved in one product.
+  const Transform3f& M1(joint1_->currentTransformation());
+  global1_.noalias() = M1.rotation() * points1_;
+  global1_.colwise() += M1.translation();
   if (joint2_) {
-    global2_ = joint2_->currentTransformation().act(point2_);
-    result.vector()[0] = (global2_ - global1_).norm();
-  } else {
-    result.vector()[0] = (global1_).norm();
+    const Transform3f& M2(joint2_->currentTransformation());
+    global2_.noalias() = M2.rotation() * points2_;
+    global2_.colwise() += M2.translation();
   }
+  result.vector() = (global2_ - global1_).colwise().norm().transpose();
 
   latestArgument_ = argument;
   latestResult_ = result;
@@ -121,42 +149,47 @@ void DistanceBetweenPointsInBodies::impl_compute(
 void DistanceBetweenPointsInBodies::impl_jacobian(matrixOut_t jacobian,
                                                   ConfigurationIn_t arg) const {
   LiegroupElement dist(outputSpace());
+  // Fills global1_ and global2_, or reuses them when arg matches the
+  // latest evaluated configuration.
   impl_compute(dist, arg);
   const JointJacobian_t& J1(joint1_->jacobian());
   const Transform3f& M1(joint1_->currentTransformation());
   const matrix3_t& R1(M1.rotation());
+  // The translation part of the joint Jacobians is shared by all the
+  // point pairs.
+  matrix_t RJ1(R1 * J1.topRows(3));
+  matrix_t RJ2;
+  if (joint2_) RJ2 = joint2_->currentTransformation().rotation() *
+                     joint2_->jacobian().topRows(3);
+
+  for (size_type i = 0; i < points1_.cols(); ++i) {
+    // P1 - P2
+    vector3_t P1_minus_P2(global1_.col(i) - global2_.col(i));
+    // P1 - t1
+    vector3_t P1_minus_t1(global1_.col(i) - M1.translation());
 
-  // P1 - P2
-  vector3_t P1_minus_P2(global1_ - global2_);
-  // P1 - t1
-  vector3_t P1_minus_t1(global1_ - M1.translation());
-
-  // FIXME Remove me
-  eigen::matrix3_t P1_minus_t1_cross;
-  cross(P1_minus_t1, P1_minus_t1_cross);
-  assert(R1.colwise().cross(P1_minus_t1).isApprox(-P1_minus_t1_cross * R1));
-
-  //        T (                              )
-  // (P1-P2)  ( J    -   [P1 - t1]  J        )
-  //          (  1 [0:3]          x  1 [3:6] )
-  matrix_t tmp1(P1_minus_P2.transpose() * R1 * J1.topRows(3) +
-                P1_minus_P2.transpose() * R1.colwise().cross(P1_minus_t1) *
-                    J1.bottomRows(3));
-  if (joint2_) {
-    const JointJacobian_t& J2(joint2_->jacobian());
-    const Transform3f& M2(joint2_->currentTransformation());
-    const matrix3_t& R2(M2.rotation());
-    // P2 - t2
-    vector3_t P2_minus_t2(global2_ - M2.translation());
     //        T (                              )
     // (P1-P2)  ( J    -   [P1 - t1]  J        )
-    //          (  2 [0:3]          x  2 [3:6] )
-    matrix_t tmp2(P1_minus_P2.transpose() * R2 * J2.topRows(3) +
-                  P1_minus_P2.transpose() * R2.colwise().cross(P2_minus_t2) *
-                      J2.bottomRows(3));
-    jacobian = (tmp1 - tmp2) / dist.vector()[0];
-  } else {
-    jacobian = tmp1 / dist.vector()[0];
+    //          (  1 [0:3]          x  1 [3:6] )
+    matrix_t tmp1(P1_minus_P2.transpose() * RJ1 +
+                  P1_minus_P2.transpose() * R1.colwise().cross(P1_minus_t1) *
+                      J1.bottomRows(3));
+    if (joint2_) {
+      const JointJacobian_t& J2(joint2_->jacobian());
+      const Transform3f& M2(joint2_->currentTransformation());
+      const matrix3_t& R2(M2.rotation());
+      // P2 - t2
+      vector3_t P2_minus_t2(global2_.col(i) - M2.translation());
+      //        T (                              )
+      // (P1-P2)  ( J    -   [P2 - t2]  J        )
+      //          (  2 [0:3]          x  2 [3:6] )
+      matrix_t tmp2(P1_minus_P2.transpose() * RJ2 +
+                    P1_minus_P2.transpose() * R2.colwise().cross(P2_minus_t2) *
+                        J2.bottomRows(3));
+      jacobian.row(i) = (tmp1 - tmp2) / dist.vector()[i];
+    } else {
+      jacobian.row(i) = tmp1 / dist.vector()[i];
+    }
   }
 }
 
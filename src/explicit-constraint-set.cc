@@ -29,6 +29,8 @@
 #include <hpp/constraints/explicit-constraint-set.hh>
 #include <hpp/constraints/explicit.hh>
 #include <hpp/constraints/matrix-view.hh>
+#include <hpp/constraints/solver/trace.hh>
+#include <hpp/constraints/task-executor.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/liegroup.hh>
 #include <hpp/pinocchio/util.hh>
@@ -58,12 +60,80 @@ ExplicitConstraintSet::activeDerivativeParameters() const {
 }
 
 bool ExplicitConstraintSet::solve(vectorOut_t arg) const {
+  HPP_SOLVER_TRACE_ZONE("ExplicitConstraintSet::solve", -1);
+  if (!constantFunctions_.empty()) {
+    // One coalesced scatter of the baked values replaces the
+    // per-function evaluation of all the constant-output functions.
+    if (!constantsValid_) bakeConstants();
+    constantRows_.lview(arg) = constants_;
+  }
+  if (evaluator_) {
+    solveParallel(arg);
+    return true;
+  }
   for (std::size_t i = 0; i < data_.size(); ++i) {
-    solveExplicitConstraint(computationOrder_[i], arg);
+    const std::size_t iF = computationOrder_[i];
+    if (data_[iF].isConstant) continue;
+    HPP_SOLVER_TRACE_ZONE(
+        data_[iF].constraint->function().name().c_str(), (size_type)i);
+    solveExplicitConstraint(iF, arg);
   }
   return true;
 }
 
+void ExplicitConstraintSet::parallelEvaluation(std::size_t nbThreads) {
+  if (nbThreads <= 1) {
+    evaluator_.reset();
+    return;
+  }
+  // A globally installed executor takes precedence over a per-set pool,
+  // so that one object governs the concurrency of the whole library.
+  // See TaskExecutor.
+  if (TaskExecutor::global()) {
+    evaluator_ = TaskExecutor::global();
+    return;
+  }
+  if (evaluator_ && evaluator_->nbThreads() == nbThreads) return;
+  evaluator_ = TaskExecutor::create(nbThreads);
+}
+
+std::size_t ExplicitConstraintSet::parallelEvaluation() const {
+  return evaluator_ ? evaluator_->nbThreads() : 0;
+}
+
+void ExplicitConstraintSet::solveParallel(vectorOut_t arg) const {
+  for (std::size_t s = 0; s < stages_.size(); ++s) {
+    const std::vector<std::size_t>& stage = stages_[s];
+    if (stage.empty()) continue;
+    if (stage.size() == 1) {
+      solveExplicitConstraint(stage[0], arg);
+      continue;
+    }
+    // The functions of a stage read inputs computed by earlier stages
+    // only and write disjoint output segments, through their own
+    // per-Data buffers, so they can run concurrently.
+    const std::function<void(std::size_t)> task = [this, &stage,
+                                                   &arg](std::size_t i) {
+      solveExplicitConstraint(stage[i], arg);
+    };
+    evaluator_->parallelFor(task, stage.size());
+  }
+}
+
+void ExplicitConstraintSet::bakeConstants() const {
+  // The segments of constantRows_ are sorted and merged, so the values
+  // are staged at their configuration indices and gathered from there.
+  vector_t scratch(configSpace_->nq());
+  for (std::size_t i = 0; i < constantFunctions_.size(); ++i) {
+    const Data& d = data_[constantFunctions_[i]];
+    d.constraint->outputValue(d.res_qout, d.qin, d.rhs_implicit);
+    Eigen::RowBlockIndices(d.constraint->outputConf()).lview(scratch) =
+        d.res_qout.vector();
+  }
+  constants_ = constantRows_.rview(scratch);
+  constantsValid_ = true;
+}
+
 bool ExplicitConstraintSet::isSatisfied(vectorIn_t arg, vectorOut_t error,
                                         value_type errorThreshold) const {
   // Recover default value
@@ -133,15 +203,36 @@ ExplicitConstraintSet::Data::Data(const ExplicitPtr_t& _constraint)
       res_qout(_constraint->explicitFunction()->outputSpace()) {
   jacobian.resize(_constraint->explicitFunction()->outputDerivativeSize(),
                   _constraint->explicitFunction()->inputDerivativeSize());
+  inConfPlan.compile(_constraint->inputConf());
+  qin.resize(inConfPlan.nbIndices());
   for (std::size_t i = 0; i < constraint->comparisonType().size(); ++i) {
     if (constraint->comparisonType()[i] == Equality) {
       equalityIndices.addRow(i, 1);
     }
   }
   equalityIndices.updateRows<true, true, true>();
+  isConstant = _constraint->inputConf().empty() &&
+               _constraint->inputVelocity().empty();
 }
 
 size_type ExplicitConstraintSet::add(const ExplicitPtr_t& constraint) {
+  const size_type idx = addWithoutOrder(constraint);
+  if (idx < 0) return idx;
+  updateOrder((std::size_t)idx);
+  return idx;
+}
+
+size_type ExplicitConstraintSet::add(
+    const std::vector<ExplicitPtr_t>& constraints) {
+  size_type added = 0;
+  for (std::size_t i = 0; i < constraints.size(); ++i)
+    if (addWithoutOrder(constraints[i]) >= 0) ++added;
+  if (added > 0) recomputeOrder();
+  return added;
+}
+
+size_type ExplicitConstraintSet::addWithoutOrder(
+    const ExplicitPtr_t& constraint) {
   assert(constraint->outputConf().size() == 1 &&
          "Only contiguous function output is supported.");
   assert(constraint->outputVelocity().size() == 1 &&
@@ -175,7 +266,7 @@ size_type ExplicitConstraintSet::add(const ExplicitPtr_t& constraint) {
     if (comp[i] != EqualToZero && comp[i] != Equality) return -1;
   // Check that no other function already computes its outputs.
   RowBlockIndices outArg(constraint->outputConf());
-  if ((outArg.rview(argFunction_).eval().array() >= 0).any()) return -1;
+  if (outArg.rview(argFunction_).any([](int f) { return f >= 0; })) return -1;
   // Check that it does not insert a loop.
   std::queue<size_type> idxArg;
   // Put all indices of inArg into idxArg
@@ -203,6 +294,12 @@ size_type ExplicitConstraintSet::add(const ExplicitPtr_t& constraint) {
       .setConstant(idx);
   data_.push_back(Data(constraint));
   errorSize_ += data_.back().rhs_implicit.space()->nv();
+  if (data_.back().isConstant) {
+    constantFunctions_.push_back((std::size_t)idx);
+    constantRows_.addRow(outIdx.first, outIdx.second);
+    constantRows_.updateIndices<true, true, true>();
+    constantsValid_ = false;
+  }
 
   // Update the free dofs
   outArgs_.addRow(outIdx.first, outIdx.second);
@@ -211,8 +308,7 @@ size_type ExplicitConstraintSet::add(const ExplicitPtr_t& constraint) {
       BlockIndex::difference(BlockIndex::segment_t(0, nq), outArgs_.indices()));
 
   BlockIndex::add(inArgs_.m_rows, inArg.rows());
-  inArgs_ =
-      RowBlockIndices(BlockIndex::difference(inArgs_.rows(), outArgs_.rows()));
+  BlockIndex::subtract(inArgs_.m_rows, outArgs_.rows());
   // should be sorted already
   inArgs_.updateIndices<false, true, true>();
 
@@ -223,20 +319,88 @@ size_type ExplicitConstraintSet::add(const ExplicitPtr_t& constraint) {
 
   BlockIndex::add(inDers_.m_cols,
                   ColBlockIndices(constraint->inputVelocity()).cols());
-  inDers_ =
-      ColBlockIndices(BlockIndex::difference(inDers_.cols(), outDers_.rows()));
+  BlockIndex::subtract(inDers_.m_cols, outDers_.rows());
   // should be sorted already
   inDers_.updateIndices<false, true, true>();
 
-  /// Computation order
+  return data_.size() - 1;
+}
+
+void ExplicitConstraintSet::updateOrder(const std::size_t& iE) {
+  // Before the first insertion inOutDependencies_ is empty.
+  if (inOutDependencies_.cols() != configSpace_->nv()) {
+    recomputeOrder();
+    return;
+  }
+  const Data& d = data_[iE];
+  // If an existing function transitively depends on one of the new
+  // outputs, it must now be evaluated after the new function: give up
+  // on the incremental update and re-derive the whole order. Since the
+  // rows of inOutDependencies_ are expressed on the free variables, a
+  // column scan on the captured variables detects this.
+  for (std::size_t i = 0; i < d.constraint->outputVelocity().size(); ++i) {
+    const BlockIndex::segment_t& segment(d.constraint->outputVelocity()[i]);
+    for (size_type j = 0; j < segment.second; ++j) {
+      if ((inOutDependencies_.col(segment.first + j).array() != 0).any()) {
+        recomputeOrder();
+        return;
+      }
+    }
+  }
+  // Otherwise the existing order remains valid and the new function
+  // goes last. Its dependency row only needs the rows of the functions
+  // computing its inputs, which are final.
+  inOutDependencies_.conservativeResize(data_.size(), Eigen::NoChange);
+  inOutDependencies_.row(iE).setZero();
+  std::size_t level = 0;
+  for (std::size_t i = 0; i < d.constraint->inputVelocity().size(); ++i) {
+    const BlockIndex::segment_t& segment(d.constraint->inputVelocity()[i]);
+    for (size_type j = 0; j < segment.second; ++j) {
+      if (derFunction_[segment.first + j] < 0) {
+        inOutDependencies_(iE, segment.first + j) += 1;
+      } else {
+        assert((std::size_t)derFunction_[segment.first + j] < iE);
+        inOutDependencies_.row(iE) +=
+            inOutDependencies_.row(derFunction_[segment.first + j]);
+        level =
+            std::max(level, levels_[derFunction_[segment.first + j]] + 1);
+      }
+    }
+  }
+  computationOrder_.push_back(iE);
+  levels_.push_back(level);
+  if (stages_.size() <= level) stages_.resize(level + 1);
+  if (!d.isConstant) stages_[level].push_back(iE);
+}
+
+void ExplicitConstraintSet::recomputeOrder() {
   std::size_t order = 0;
   computationOrder_.resize(data_.size());
-  inOutDependencies_ = Eigen::MatrixXi::Zero(data_.size(), nv);
+  inOutDependencies_ = Eigen::MatrixXi::Zero(data_.size(), configSpace_->nv());
   Computed_t computed(data_.size(), false);
   for (std::size_t i = 0; i < data_.size(); ++i)
     computeOrder(i, order, computed);
   assert(order == data_.size());
-  return data_.size() - 1;
+
+  // Re-derive the stages from the new order; a function appears after
+  // the functions computing its inputs in computationOrder_.
+  levels_.assign(data_.size(), 0);
+  stages_.clear();
+  for (std::size_t i = 0; i < data_.size(); ++i) {
+    const std::size_t iE = computationOrder_[i];
+    const Data& d = data_[iE];
+    std::size_t level = 0;
+    for (std::size_t k = 0; k < d.constraint->inputVelocity().size(); ++k) {
+      const BlockIndex::segment_t& segment(d.constraint->inputVelocity()[k]);
+      for (size_type j = 0; j < segment.second; ++j)
+        if (derFunction_[segment.first + j] >= 0)
+          level =
+              std::max(level, levels_[derFunction_[segment.first + j]] + 1);
+    }
+    levels_[iE] = level;
+    if (stages_.size() <= level) stages_.resize(level + 1);
+    if (!d.isConstant) stages_[level].push_back(iE);
+  }
 }
 
 bool ExplicitConstraintSet::contains(
@@ -256,9 +420,12 @@ void ExplicitConstraintSet::solveExplicitConstraint(const std::size_t& iF,
                                                     vectorOut_t arg) const {
   const Data& d = data_[iF];
   // Compute this function
-  d.qin = RowBlockIndices(d.constraint->inputConf()).rview(arg);
+  d.inConfPlan.gatherRows(arg, d.qin);
   d.constraint->outputValue(d.res_qout, d.qin, d.rhs_implicit);
-  RowBlockIndices(d.constraint->outputConf()).lview(arg) = d.res_qout.vector();
+  // The output is a single segment (see addWithoutOrder); scatter it
+  // directly instead of building a RowBlockIndices, which allocates.
+  const segment_t& out = d.constraint->outputConf()[0];
+  arg.segment(out.first, out.second) = d.res_qout.vector();
   assert(!arg.hasNaN());
 }
 
@@ -270,7 +437,7 @@ void ExplicitConstraintSet::jacobian(matrixOut_t jacobian,
   // Compute the function jacobians
   for (std::size_t i = 0; i < data_.size(); ++i) {
     const Data& d = data_[i];
-    d.qin = RowBlockIndices(d.constraint->inputConf()).rview(arg);
+    d.inConfPlan.gatherRows(arg, d.qin);
     // Compute Jacobian of f(qin) + rhs
     // with respect to qin.
     d.constraint->jacobianOutputValue(d.qin, d.f_value, d.rhs_implicit,
@@ -348,6 +515,7 @@ void ExplicitConstraintSet::rightHandSideFromInput(const size_type& i,
   vector_t logRhsImplicit(vector_t::Zero(d.rhs_implicit.space()->nv()));
   d.equalityIndices.lview(logRhsImplicit) = d.equalityIndices.rview(logRhs);
   d.rhs_implicit = d.rhs_implicit.space()->exp(logRhsImplicit);
+  constantsValid_ = false;
 }
 
 void ExplicitConstraintSet::rightHandSide(vectorIn_t rhs) {
@@ -370,6 +538,7 @@ void ExplicitConstraintSet::rightHandSide(vectorIn_t rhs) {
     row += d.rhs_implicit.space()->nq();
   }
   assert(row == rhs.size());
+  constantsValid_ = false;
 }
 
 bool ExplicitConstraintSet::rightHandSide(const ExplicitPtr_t& constraint,
@@ -407,6 +576,7 @@ void ExplicitConstraintSet::rightHandSide(const size_type& i, vectorIn_t rhs) {
   d.equalityIndices.lview(logRhsImplicit) =
       d.equalityIndices.rview(logRhsInput);
   d.rhs_implicit = d.rhs_implicit.space()->exp(logRhsImplicit);
+  constantsValid_ = false;
   ComparisonTypes_t ct(d.constraint->comparisonType());
   for (std::size_t i = 0; i < ct.size(); ++i) {
     assert(ct[i] == Equality ||
@@ -416,16 +586,20 @@ void ExplicitConstraintSet::rightHandSide(const size_type& i, vectorIn_t rhs) {
 
 vector_t ExplicitConstraintSet::rightHandSide() const {
   vector_t rhs(rightHandSideSize());
+  getRightHandSide(rhs);
+  return rhs;
+}
+
+void ExplicitConstraintSet::getRightHandSide(vectorOut_t rhs) const {
+  assert(rhs.size() == rightHandSideSize());
   size_type row = 0;
   for (std::size_t i = 0; i < data_.size(); ++i) {
     const Data& d = data_[i];
     const size_type nRows = d.rhs_implicit.space()->nq();
-    vector_t::SegmentReturnType seg = rhs.segment(row, nRows);
-    seg = d.rhs_implicit.vector();
+    rhs.segment(row, nRows) = d.rhs_implicit.vector();
     row += nRows;
   }
   assert(row == rhs.size());
-  return rhs;
 }
 
 size_type ExplicitConstraintSet::rightHandSideSize() const {
@@ -435,6 +609,25 @@ size_type ExplicitConstraintSet::rightHandSideSize() const {
   return rhsSize;
 }
 
+ExplicitConstraintSet::MemoryUsageReport ExplicitConstraintSet::memoryUsage()
+    const {
+  MemoryUsageReport report;
+  for (std::size_t i = 0; i < data_.size(); ++i) {
+    const Data& d = data_[i];
+    report.functionData +=
+        sizeof(value_type) *
+        (std::size_t)(d.rhs_implicit.vector().size() +
+                      d.h_value.vector().size() + d.qin.size() +
+                      d.qout.size() + d.f_value.vector().size() +
+                      d.res_qout.vector().size() + d.jacobian.size());
+  }
+  report.constants = sizeof(value_type) * (std::size_t)constants_.size();
+  report.workspaces =
+      sizeof(value_type) *
+      (std::size_t)(arg_.size() + diff_.size() + diffSmall_.size());
+  return report;
+}
+
 std::ostream& ExplicitConstraintSet::print(std::ostream& os) const {
   os << "ExplicitConstraintSet, " << data_.size() << " functions." << incendl
      << "Other args: " << notOutArgs_ << iendl << "Params: " << inArgs_
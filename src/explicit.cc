@@ -189,6 +189,8 @@ void Explicit::serialize(Archive& ar, const unsigned int version) {
   ar& boost::serialization::make_nvp(
       "base", boost::serialization::base_object<Implicit>(*this));
   ar& BOOST_SERIALIZATION_NVP(inputToOutput_);
+  if (!Archive::is_saving::value)
+    inputToOutput_ = DifferentiableFunctionRegistry::dedupe(inputToOutput_);
   ar& BOOST_SERIALIZATION_NVP(inputConf_);
   ar& BOOST_SERIALIZATION_NVP(outputConf_);
   ar& BOOST_SERIALIZATION_NVP(inputVelocity_);
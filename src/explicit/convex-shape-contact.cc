@@ -128,19 +128,13 @@ void ConvexShapeContact::outputValue(LiegroupElementRef result, vectorIn_t qin,
   ConvexShapeContactHoldPtr_t f(
       HPP_STATIC_PTR_CAST(ConvexShapeContactHold, functionPtr()));
   std::size_t ifloor, iobject;
-  LiegroupElement relativePoseRhs(LiegroupSpace::R3xSO3());
   f->complement()->computeRelativePoseRightHandSide(rhs, ifloor, iobject,
-                                                    relativePoseRhs);
-  // Extract input configuration of relative pose from qin
-  Eigen::RowBlockIndices inputIndices(inputConf());
-  vector_t q(f->inputSize());
-  q.fill(sqrt(-1));
-  inputIndices.lview(q) = qin;
-  RelativePosePtr_t relativePose(pose_[ifloor * nObjSurf_ + iobject]);
-  Eigen::RowBlockIndices relPosInputIndices(relativePose->inputConf());
-  vector_t qinRelPose = relPosInputIndices.rview(q);
-  assert(!qinRelPose.hasNaN());
-  relativePose->outputValue(result, qinRelPose, relativePoseRhs);
+                                                    relativePoseRhs_);
+  // Extract input configuration of relative pose from qin through the
+  // row blocks resolved at construction.
+  std::size_t ipose(ifloor * nObjSurf_ + iobject);
+  qinRelPose_ = poseInput_[ipose].rview(qin);
+  pose_[ipose]->outputValue(result, qinRelPose_, relativePoseRhs_);
 }
 
 void ConvexShapeContact::jacobianOutputValue(vectorIn_t qin,
@@ -151,22 +145,15 @@ void ConvexShapeContact::jacobianOutputValue(vectorIn_t qin,
   ConvexShapeContactHoldPtr_t f(
       HPP_STATIC_PTR_CAST(ConvexShapeContactHold, functionPtr()));
   std::size_t ifloor, iobject;
-  LiegroupElement relativePoseRhs(LiegroupSpace::R3xSO3());
   f->complement()->computeRelativePoseRightHandSide(rhs, ifloor, iobject,
-                                                    relativePoseRhs);
-  // Extract input configuration of relative pose from qin
-  Eigen::RowBlockIndices inputIndices(inputConf());
-  vector_t q(f->inputSize());
-  q.fill(sqrt(-1));
-  inputIndices.lview(q) = qin;
-  RelativePosePtr_t relativePose(pose_[ifloor * nObjSurf_ + iobject]);
-  Eigen::RowBlockIndices relPosInputIndices(relativePose->inputConf());
-  vector_t qinRelPose = relPosInputIndices.rview(q);
-  assert(!qinRelPose.hasNaN());
-  LiegroupElement outputRelPose(LiegroupSpace::R3xSO3());
-  relativePose->outputValue(outputRelPose, qinRelPose, relativePoseRhs);
-  relativePose->jacobianOutputValue(qinRelPose, outputRelPose, relativePoseRhs,
-                                    jacobian);
+                                                    relativePoseRhs_);
+  // Extract input configuration of relative pose from qin through the
+  // row blocks resolved at construction.
+  std::size_t ipose(ifloor * nObjSurf_ + iobject);
+  qinRelPose_ = poseInput_[ipose].rview(qin);
+  pose_[ipose]->outputValue(outputRelPose_, qinRelPose_, relativePoseRhs_);
+  pose_[ipose]->jacobianOutputValue(qinRelPose_, outputRelPose_,
+                                    relativePoseRhs_, jacobian);
 }
 
 ConvexShapeContact::ConvexShapeContact(const std::string& name,
@@ -211,6 +198,30 @@ ConvexShapeContact::ConvexShapeContact(const std::string& name,
                                std::vector<bool>(6, true)));
     }
   }
+  // The shape sets do not change after construction; resolve once, for
+  // each relative pose, which rows of the input vector of this
+  // constraint form its input vector. Evaluation then extracts them
+  // directly from qin instead of scattering qin into a full
+  // configuration at each call.
+  Eigen::RowBlockIndices inputIndices(inputConf());
+  std::vector<size_type> rankInInput(f->inputSize(), -1);
+  size_type rank = 0;
+  for (const segment_t& s : inputIndices.indices())
+    for (size_type i = 0; i < s.second; ++i) rankInInput[s.first + i] = rank++;
+  poseInput_.reserve(pose_.size());
+  for (const RelativePosePtr_t& pose : pose_) {
+    Eigen::RowBlockIndices rows;
+    for (const segment_t& s :
+         Eigen::RowBlockIndices(pose->inputConf()).indices())
+      for (size_type i = 0; i < s.second; ++i) {
+        assert(rankInInput[s.first + i] >= 0);
+        rows.addRow(rankInInput[s.first + i], 1);
+      }
+    rows.updateRows<true, true, true>();
+    poseInput_.push_back(rows);
+  }
+  relativePoseRhs_ = LiegroupElement(LiegroupSpace::R3xSO3());
+  outputRelPose_ = LiegroupElement(LiegroupSpace::R3xSO3());
 }
 void ConvexShapeContact::init(ConvexShapeContactWkPtr_t weak) {
   Explicit::init(weak);
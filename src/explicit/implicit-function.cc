@@ -187,6 +187,8 @@ ImplicitFunction::ImplicitFunction(const LiegroupSpacePtr_t& configSpace,
          configSpace->nv());
   qIn_.resize(function->inputSize());
   Jf_.resize(function->outputDerivativeSize(), function->inputDerivativeSize());
+  inConfPlan_.compile(inputConfIntervals_.rows());
+  outConfPlan_.compile(outputConfIntervals_.rows());
   assert(BlockIndex::cardinal(outputConf) == function->outputSize());
   // Sum of velocity output interval sizes equal function output
   // derivative size
@@ -209,10 +211,10 @@ void ImplicitFunction::impl_compute(LiegroupElementRef result,
   using Eigen::MatrixBlocks;
   hppDout(info, "argument=" << argument.transpose());
   // Store q_{output} in result
-  qOut_.vector() = outputConfIntervals_.rview(argument);
+  outConfPlan_.gatherRows(argument, qOut_.vector());
   hppDout(info, "qOut_=" << qOut_);
   // fill in q_{input}
-  qIn_ = inputConfIntervals_.rview(argument);
+  inConfPlan_.gatherRows(argument, qIn_);
   hppDout(info, "qIn_=" << qIn_);
   // compute  f (q_{input}) -> output_
   inputToOutput_->value(f_qIn_, qIn_);
@@ -288,6 +290,8 @@ void ImplicitFunction::serialize(Archive& ar, const unsigned int version) {
     qIn_.resize(inputToOutput_->inputSize());
     Jf_.resize(inputToOutput_->outputDerivativeSize(),
                inputToOutput_->inputDerivativeSize());
+    inConfPlan_.compile(inputConfIntervals_.rows());
+    outConfPlan_.compile(outputConfIntervals_.rows());
     // should we recompute them instead of storing them ?
     // computeJacobianBlocks ();
   }
@@ -119,7 +119,12 @@ RelativeTransformation::RelativeTransformation(
       inVel_(inVel),
       outConf_(outConf),
       outVel_(outVel),
-      F1inJ1_invF2inJ2_(frame1 * frame2.inverse()) {}
+      F1inJ1_invF2inJ2_(frame1 * frame2.inverse()) {
+  // Presize the Jacobian workspaces so that impl_jacobian never
+  // allocates.
+  tmpJac_.resize(3, robot->numberDof());
+  J2_parent_minus_J1_.resize(6, robot->numberDof());
+}
 
 void RelativeTransformation::forwardKinematics(vectorIn_t arg) const {
   qsmall_ = inConf_.rview(robot_->currentConfiguration());
@@ -160,11 +165,16 @@ void RelativeTransformation::impl_compute(LiegroupElementRef result,
 
 void RelativeTransformation::impl_jacobian(matrixOut_t jacobian,
                                            vectorIn_t arg) const {
-  LiegroupElement result(outputSpace());
+  // Fixed-size storage of the freeflyer pose instead of a dynamic
+  // LiegroupElement, and the forward kinematics scratch configuration
+  // instead of a configuration copy: this runs once per solver
+  // iteration for every grasp constraint, so it must not allocate.
+  vector7_t res;
+  LiegroupElementRef result(res, outputSpace());
   impl_compute(result, arg);
-  Configuration_t q(robot_->currentConfiguration());
-  outConf_.lview(q) = result.vector();
-  robot_->currentConfiguration(q);
+  q_ = robot_->currentConfiguration();
+  outConf_.lview(q_) = res;
+  robot_->currentConfiguration(q_);
   robot_->computeForwardKinematics();
 
   bool absolute = !joint1_;
@@ -174,16 +184,21 @@ void RelativeTransformation::impl_jacobian(matrixOut_t jacobian,
   const JointJacobian_t& J1(absolute ? Jabs : joint1_->jacobian());
   // const JointJacobian_t& J2_parent (parentJoint_->jacobian());
 
-  const matrix3_t& R1(absolute ? matrix3_t::Identity().eval()
-                               : joint1_->currentTransformation().rotation());
+  // Stack copies of the fixed-size blocks; the conditional expressions
+  // previously bound lifetime-extended temporaries.
+  matrix3_t R1;
+  vector3_t t1;
+  if (absolute) {
+    R1.setIdentity();
+    t1.setZero();
+  } else {
+    R1 = joint1_->currentTransformation().rotation();
+    t1 = joint1_->currentTransformation().translation();
+  }
   const matrix3_t& R2(joint2_->currentTransformation().rotation());
   const matrix3_t& R2_inParentFrame(
       joint2_->positionInParentFrame().rotation());
 
-  const vector3_t& t1(absolute
-                          ? vector3_t::Zero().eval()
-                          : joint1_->currentTransformation().translation());
-
   matrix3_t cross1 = ::pinocchio::skew(
                 (R1 * F1inJ1_invF2inJ2_.translation()).eval()),
             cross2;
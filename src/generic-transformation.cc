@@ -26,6 +26,7 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
 // DAMAGE.
 
+#include <algorithm>
 #include <boost/serialization/vector.hpp>
 #include <hpp/constraints/generic-transformation.hh>
 #include <hpp/constraints/macros.hh>
@@ -79,6 +80,17 @@ inline Eigen::RowBlockIndices indices(const std::vector<bool>& mask) {
       Eigen::BlockIndex::fromLogicalExpression(_mask));
 }
 
+namespace {
+// Resolve a freshly created instance to the shared one, if an equal
+// constraint was created before. See the class documentation.
+template <int _Options>
+typename GenericTransformation<_Options>::Ptr_t intern(
+    const typename GenericTransformation<_Options>::Ptr_t& f) {
+  typedef GenericTransformation<_Options> GT_t;
+  return HPP_STATIC_PTR_CAST(GT_t, DifferentiableFunctionRegistry::dedupe(f));
+}
+}  // namespace
+
 void GenericTransformationModel<true>::setJoint1(const JointConstPtr_t& j) {
   if (j && j->index() > 0)
     joint1 = j;
@@ -120,7 +132,7 @@ GenericTransformation<_Options>::create(const std::string& name,
   ptr->reference(reference);
   Ptr_t shPtr(ptr);
   ptr->init(shPtr);
-  return shPtr;
+  return intern<_Options>(shPtr);
 }
 
 template <int _Options>
@@ -137,7 +149,7 @@ GenericTransformation<_Options>::create(
   ptr->frame1InJoint1(frame1);
   ptr->frame2InJoint2(frame2);
   Ptr_t shPtr(ptr);
-  return shPtr;
+  return intern<_Options>(shPtr);
 }
 
 template <int _Options>
@@ -155,7 +167,7 @@ GenericTransformation<_Options>::create(const std::string& name,
   ptr->reference(reference);
   Ptr_t shPtr(ptr);
   ptr->init(shPtr);
-  return shPtr;
+  return intern<_Options>(shPtr);
 }
 
 template <int _Options>
@@ -174,7 +186,7 @@ GenericTransformation<_Options>::create(const std::string& name,
   ptr->frame1InJoint1(frame1);
   ptr->frame2InJoint2(frame2);
   Ptr_t shPtr(ptr);
-  return shPtr;
+  return intern<_Options>(shPtr);
 }
 
 template <int _Options>
@@ -214,6 +226,11 @@ inline void GenericTransformation<_Options>::computeActiveParams() {
 
   setActiveParameters(robot_, joint1(), joint2(), activeParameters_,
                       activeDerivativeParameters_);
+  // The Jacobian assembly only touches the columns of the kinematic
+  // chain between the two joints; derive the column support from the
+  // active derivative parameters computed by the chain traversal above.
+  m_.support = Eigen::ColBlockIndices(Eigen::BlockIndex::fromLogicalExpression(
+      activeDerivativeParameters_.head(m_.cols)));
 }
 
 template <int _Options>
@@ -223,8 +240,7 @@ void GenericTransformation<_Options>::impl_compute(
           (bool)OutputR3xSO3>
       data(m_, robot_);
 
-  data.device.currentConfiguration(argument);
-  data.device.computeForwardKinematics();
+  data.computeForwardKinematics(argument);
   compute<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
           (bool)OutputR3xSO3>::error(data);
 
@@ -235,17 +251,15 @@ void GenericTransformation<_Options>::impl_compute(
 template <int _Options>
 void GenericTransformation<_Options>::impl_jacobian(
     matrixOut_t jacobian, ConfigurationIn_t arg) const {
-  // TODO there is still a little bit a memory which is dynamically
-  // allocated in GTDataJ. At the moment, this allocation is necessary to
-  // support multithreadind. To avoid it, DeviceData should provide some
-  // a temporary buffer to pass to an Eigen::Map
+  // The temporary matrices of GTDataJ are mapped onto per-thread scratch
+  // buffers (see GTScratch in src/generic-transformation/helper.hh) so this
+  // evaluation does not allocate, even when called from several threads.
   {
     GTDataJ<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
             (bool)OutputR3xSO3>
         data(m_, robot_);
 
-    data.device.currentConfiguration(arg);
-    data.device.computeForwardKinematics();
+    data.computeForwardKinematics(arg);
     compute<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
             (bool)OutputR3xSO3>::error(data);
     compute<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
@@ -275,6 +289,45 @@ void GenericTransformation<_Options>::impl_jacobian(
 #endif
 }
 
+template <int _Options>
+void GenericTransformation<_Options>::impl_computeBatch(
+    matrixOut_t results, matrixIn_t arguments) const {
+  // The GTDataV object - and with it the DeviceSync acquisition - is
+  // created once and reused for every sample, so the loop stays inside
+  // the fixed-size evaluation machinery with hot caches.
+  GTDataV<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
+          (bool)OutputR3xSO3>
+      data(m_, robot_);
+
+  for (size_type j = 0; j < arguments.cols(); ++j) {
+    data.computeForwardKinematics(arguments.col(j));
+    compute<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
+            (bool)OutputR3xSO3>::error(data);
+    results.col(j) = Vindices_.rview(data.value);
+  }
+}
+
+template <int _Options>
+void GenericTransformation<_Options>::impl_computeValueAndJacobian(
+    LiegroupElementRef result, matrixOut_t jacobian,
+    ConfigurationIn_t arg) const {
+  // GTDataJ derives from GTDataV, so one forward kinematics pass yields
+  // both the error and its jacobian. impl_jacobian computes the error
+  // anyway - the jacobian of the log needs it - but discards it.
+  GTDataJ<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
+          (bool)OutputR3xSO3>
+      data(m_, robot_);
+
+  data.computeForwardKinematics(arg);
+  compute<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
+          (bool)OutputR3xSO3>::error(data);
+  compute<IsRelative, (bool)ComputePosition, (bool)ComputeOrientation,
+          (bool)OutputR3xSO3>::jacobian(data, jacobian, mask_);
+
+  result.vector() = Vindices_.rview(data.value);
+  assert(hpp::pinocchio::checkNormalized(result));
+}
+
 template <int _Options>
 template <class Archive>
 void GenericTransformation<_Options>::serialize(Archive& ar,
@@ -287,6 +340,63 @@ void GenericTransformation<_Options>::serialize(Archive& ar,
   ar& boost::serialization::make_nvp("mask_",
                                      const_cast<std::vector<bool>&>(mask_));
   ar& BOOST_SERIALIZATION_NVP(self_);
+  // The column support of the model is not serialized; rebuild it.
+  if (Archive::is_loading::value) computeActiveParams();
+}
+
+namespace {
+template <int _Options>
+DifferentiableFunctionPtr_t tryApplyRowMask(
+    const DifferentiableFunctionPtr_t& function,
+    const std::vector<bool>& mask) {
+  typedef GenericTransformation<_Options> GT_t;
+  typename GT_t::Ptr_t gt(HPP_DYNAMIC_PTR_CAST(GT_t, function));
+  if (!gt) return DifferentiableFunctionPtr_t();
+  // mask applies to the rows currently computed; compose it with the
+  // mask already folded into the function.
+  const std::vector<bool>& current(gt->mask());
+  std::vector<bool> composed(current.size(), false);
+  std::size_t row = 0;
+  for (std::size_t i = 0; i < current.size(); ++i)
+    if (current[i]) composed[i] = mask[row++];
+  assert(row == mask.size());
+  return GT_t::create(gt->name(), gt->robot(), gt->joint1(), gt->joint2(),
+                      gt->frame1InJoint1(), gt->frame2InJoint2(), composed);
+}
+}  // namespace
+
+DifferentiableFunctionPtr_t applyRowMask(
+    const DifferentiableFunctionPtr_t& function,
+    const std::vector<bool>& mask) {
+  assert((size_type)mask.size() == function->outputDerivativeSize());
+  if (std::find(mask.begin(), mask.end(), false) == mask.end())
+    return function;
+  DifferentiableFunctionPtr_t masked;
+  if ((masked = tryApplyRowMask<PositionBit | OrientationBit>(function, mask)))
+    return masked;
+  if ((masked = tryApplyRowMask<PositionBit>(function, mask))) return masked;
+  if ((masked = tryApplyRowMask<OrientationBit>(function, mask)))
+    return masked;
+  if ((masked = tryApplyRowMask<RelativeBit | PositionBit | OrientationBit>(
+           function, mask)))
+    return masked;
+  if ((masked = tryApplyRowMask<RelativeBit | PositionBit>(function, mask)))
+    return masked;
+  if ((masked = tryApplyRowMask<RelativeBit | OrientationBit>(function, mask)))
+    return masked;
+  if ((masked = tryApplyRowMask<OutputR3xSO3Bit | PositionBit |
+                                OrientationBit>(function, mask)))
+    return masked;
+  if ((masked =
+           tryApplyRowMask<OutputR3xSO3Bit | OrientationBit>(function, mask)))
+    return masked;
+  if ((masked = tryApplyRowMask<OutputR3xSO3Bit | RelativeBit | PositionBit |
+                                OrientationBit>(function, mask)))
+    return masked;
+  if ((masked = tryApplyRowMask<OutputR3xSO3Bit | RelativeBit |
+                                OrientationBit>(function, mask)))
+    return masked;
+  return DifferentiableFunctionPtr_t();
 }
 
 /// Force instanciation of relevant classes
@@ -29,6 +29,7 @@
 #ifndef SRC_GENERIC_TRANSFORMATION_HELPER_HH
 #define SRC_GENERIC_TRANSFORMATION_HELPER_HH
 
+#include <hpp/constraints/device-sync-lease.hh>
 #include <hpp/constraints/macros.hh>
 #include <hpp/constraints/matrix-view.hh>
 #include <hpp/constraints/tools.hh>  // for logSO3
@@ -60,13 +61,58 @@ template <>
 struct GTOriDataJ<true> {
   eigen::matrix3_t Jlog_from1;
 };
+/// Per-thread backing storage for the temporary matrices of GTDataJ.
+/// GTDataJ objects are short-lived (one per Jacobian evaluation) and are
+/// never nested, so one pair of grow-only buffers per thread is enough to
+/// make the evaluation allocation-free once the buffers reached the size
+/// of the largest robot evaluated in this thread.
+struct GTScratch {
+  matrix_t jacobian, tmpJac, tmpOut, J1sup, J2sup;
+
+  static GTScratch& get(const size_type& jacRows, const size_type& cols) {
+    static thread_local GTScratch scratch;
+    grow(scratch.jacobian, jacRows, cols);
+    grow(scratch.tmpJac, 3, cols);
+    grow(scratch.tmpOut, 3, cols);
+    grow(scratch.J1sup, 6, cols);
+    grow(scratch.J2sup, 6, cols);
+    return scratch;
+  }
+
+ private:
+  static void grow(matrix_t& buffer, const size_type& rows,
+                   const size_type& cols) {
+    if (buffer.rows() < rows || buffer.cols() < cols)
+      buffer.resize(std::max(rows, buffer.rows()),
+                    std::max(cols, buffer.cols()));
+  }
+};
 /// This class contains the data of the GenericTransformation class.
 template <bool rel>
 struct GTDataBase {
-  hpp::pinocchio::DeviceSync device;
+  // When the current thread holds a DeviceSyncLease on the device, all
+  // evaluations of the lease scope share its single DeviceData
+  // acquisition. Otherwise ownSync acquires one for the duration of this
+  // evaluation.
+  DeviceSyncLease* lease;
+  hpp::pinocchio::DeviceSync ownSync;
+  hpp::pinocchio::DeviceSync& device;
   const GenericTransformationModel<rel>& model;
   hpp::pinocchio::DeviceData& ddata() { return device.d(); }
 
+  // Set the configuration and recompute the forward kinematics. Through
+  // a lease, the computation is skipped when the shared data is already
+  // at this configuration, so a sweep over many constraints runs it
+  // once.
+  void computeForwardKinematics(vectorIn_t arg) {
+    if (lease != NULL)
+      lease->computeForwardKinematics(arg);
+    else {
+      device.currentConfiguration(arg);
+      device.computeForwardKinematics();
+    }
+  }
+
   const JointJacobian_t& J2() { return model.joint2->jacobian(ddata()); }
   const Transform3f& M2() {
     if (model.joint2)
@@ -87,7 +133,10 @@ struct GTDataBase {
   const vector3_t& t1() { return M1().translation(); }
 
   GTDataBase(const GenericTransformationModel<rel>& m, const DevicePtr_t& d)
-      : device(d), model(m) {}
+      : lease(DeviceSyncLease::get(d)),
+        ownSync(d, lease == NULL),
+        device(lease != NULL ? lease->sync() : ownSync),
+        model(m) {}
 };
 template <bool rel, bool pos, bool ori, bool ose3>
 struct GTDataV : GTDataBase<rel>, GTOriDataV<ori> {
@@ -109,22 +158,60 @@ struct GTDataJ : GTDataV<rel, pos, ori, ose3>, GTOriDataJ<ori> {
   };
   typedef Eigen::Matrix<value_type, JacobianSize, Eigen::Dynamic> JacobianType;
   typedef Eigen::Matrix<value_type, 3, Eigen::Dynamic> matrix3x_t;
-  JacobianType jacobian;
-  matrix3x_t tmpJac;
+  typedef Eigen::Map<JacobianType, Eigen::Unaligned, Eigen::OuterStride<> >
+      JacobianMap;
+  typedef Eigen::Map<matrix3x_t, Eigen::Unaligned, Eigen::OuterStride<> >
+      Matrix3xMap;
+  typedef Eigen::Map<JointJacobian_t, Eigen::Unaligned, Eigen::OuterStride<> >
+      JointJacobianMap;
+  // jacobian and tmpJac are mapped onto per-thread buffers so that the
+  // evaluation does not allocate. jacobian is mapped with zero column when
+  // the output covers full position and orientation, in which case the
+  // result is written directly into the output matrix.
+  // All the temporaries span only the columns of the kinematic chain
+  // between the two joints (model.support): J1sup and J2sup hold the
+  // support columns of the joint Jacobians, gathered by gatherSupport().
+  GTScratch& scratch;
+  JacobianMap jacobian;
+  Matrix3xMap tmpJac, tmpOut;
+  JointJacobianMap J1sup, J2sup;
   eigen::vector3_t cross1, cross2;
 
   GTDataJ(const GenericTransformationModel<rel>& m, const DevicePtr_t& d)
-      : GTDataV<rel, pos, ori, ose3>(m, d)
-  // TODO the two following matrices should be of type Eigen::Map<...>
-  // and they should point to some buffer in m.device
-  // , jacobian (buffer1, NbRows, m.cols)
-  // , tmpJac   (buffer2,      3, m.cols)
-  {
+      : GTDataV<rel, pos, ori, ose3>(m, d),
+        scratch(GTScratch::get((size_type)JacobianSize, m.supportCols())),
+        jacobian(scratch.jacobian.data(), (int)JacobianSize,
+                 (!m.fullPos || !m.fullOri) ? m.supportCols() : 0,
+                 Eigen::OuterStride<>(scratch.jacobian.rows())),
+        tmpJac(scratch.tmpJac.data(), 3, m.supportCols(),
+               Eigen::OuterStride<>(scratch.tmpJac.rows())),
+        tmpOut(scratch.tmpOut.data(), 3, m.supportCols(),
+               Eigen::OuterStride<>(scratch.tmpOut.rows())),
+        J1sup(scratch.J1sup.data(), 6, m.supportCols(),
+              Eigen::OuterStride<>(scratch.J1sup.rows())),
+        J2sup(scratch.J2sup.data(), 6, m.supportCols(),
+              Eigen::OuterStride<>(scratch.J2sup.rows())) {
     assert(!ose3 || (!ori || m.fullOri));
-    if (!m.fullPos || !m.fullOri) jacobian.resize((int)JacobianSize, m.cols);
     cross1.setZero();
     if (m.t2isZero) cross2.setZero();
   }
+
+  // Shadow the base class accessors: the expressions below only
+  // multiply the support columns.
+  const JointJacobianMap& J1() const { return J1sup; }
+  const JointJacobianMap& J2() const { return J2sup; }
+
+  // Gather the support columns of the joint Jacobians. Must be called
+  // after the forward kinematics.
+  void gatherSupport() {
+    if (this->model.joint2)
+      this->model.support.rview(this->model.joint2->jacobian(this->ddata()))
+          .evalTo(J2sup);
+    if (rel && this->model.getJoint1())
+      this->model.support
+          .rview(this->model.getJoint1()->jacobian(this->ddata()))
+          .evalTo(J1sup);
+  }
 };
 
 /// ------- Compute log --------------------------------------------------
@@ -187,11 +274,18 @@ void computeJlog(const value_type& theta, const Eigen::MatrixBase<Derived>& log,
   }
 }
 
-typedef JointJacobian_t::ConstNRowsBlockXpr<3>::Type HalfJacobian_t;
-inline HalfJacobian_t omega(const JointJacobian_t& j) {
-  return j.bottomRows<3>();
+// The argument is either a JointJacobian_t or the gathered support map
+// of GTDataJ.
+template <typename Derived>
+inline typename Derived::template ConstNRowsBlockXpr<3>::Type omega(
+    const Derived& j) {
+  return j.template bottomRows<3>();
+}
+template <typename Derived>
+inline typename Derived::template ConstNRowsBlockXpr<3>::Type trans(
+    const Derived& j) {
+  return j.template topRows<3>();
 }
-inline HalfJacobian_t trans(const JointJacobian_t& j) { return j.topRows<3>(); }
 
 static inline size_type size(std::vector<bool> mask) {
   size_type res = 0;
@@ -240,8 +334,13 @@ void assign_if(bool cond, Data& d, matrixOut_t J,
   const int& rowCache = (ori ? Data::RowOri : Data::RowPos);
   if (cond)
     d.jacobian.template middleRows<3>(rowCache).noalias() = rhs;
-  else
-    J.template middleRows<3>(startRow).leftCols(d.model.cols).noalias() = rhs;
+  else {
+    // Evaluate once into the scratch buffer, then scatter to the
+    // support columns of the output. The other columns were zeroed by
+    // compute::jacobian.
+    d.tmpOut.noalias() = rhs;
+    d.model.support.lview(J.template middleRows<3>(startRow)) = d.tmpOut;
+  }
 }
 
 /// ------- Compute jacobian ---------------------------------------------
@@ -269,7 +368,7 @@ struct binary<false, true>  // Absolute
   template <bool rel, bool ori, bool ose3>
   static inline void Jtranslation(GTDataJ<rel, true, ori, ose3>& d,
                                   matrixOut_t J) {
-    const JointJacobian_t& J2(d.J2());
+    const typename GTDataJ<rel, true, ori, ose3>::JointJacobianMap& J2(d.J2());
     const matrix3_t& R2(d.R2());
     const matrix3_t& R1inJ1(d.model.F1inJ1.rotation());
 
@@ -309,7 +408,8 @@ struct binary<true, true>  // Relative
   template <bool ori, bool ose3>
   static inline void Jtranslation(GTDataJ<true, true, ori, ose3>& d,
                                   matrixOut_t J) {
-    const JointJacobian_t& J1(d.J1());
+    const typename GTDataJ<true, true, ori, ose3>::JointJacobianMap& J1(
+        d.J1());
     const matrix3_t& R1(d.R1());
     const matrix3_t& R2(d.R2());
     const matrix3_t& R1inJ1(d.model.F1inJ1.rotation());
@@ -417,6 +517,10 @@ struct compute {
   static inline void jacobian(GTDataJ<rel, pos, ori, ose3>& d,
                               matrixOut_t jacobian,
                               const std::vector<bool>& mask) {
+    // Only the columns of the kinematic chain are assembled below.
+    jacobian.setZero();
+    d.gatherSupport();
+
     const Transform3f& M2 = d.M2();
     const vector3_t& t2inJ2(d.model.F2inJ2.translation());
     const vector3_t& t2(M2.translation());
@@ -440,14 +544,13 @@ struct compute {
       binary<false, ori>::Jorientation(d, jacobian);
     }
 
-    // Copy necessary rows.
+    // Copy necessary rows, scattering to the support columns.
     size_type index = 0;
     const size_type lPos = (pos ? 3 : 0), lOri = (ori ? 3 : 0);
     if (!d.model.fullPos) {
       for (size_type i = 0; i < lPos; ++i) {
         if (mask[i]) {
-          jacobian.row(index).leftCols(d.model.cols).noalias() =
-              d.jacobian.row(i);
+          d.model.support.lview(jacobian.row(index)) = d.jacobian.row(i);
           ++index;
         }
       }
@@ -456,13 +559,11 @@ struct compute {
     if (!d.model.fullOri) {
       for (size_type i = lPos; i < lPos + lOri; ++i) {
         if (mask[i]) {
-          jacobian.row(index).leftCols(d.model.cols).noalias() =
-              d.jacobian.row(i);
+          d.model.support.lview(jacobian.row(index)) = d.jacobian.row(i);
           ++index;
         }
       }
     }
-    jacobian.rightCols(jacobian.cols() - d.model.cols).setZero();
   }
 };
 
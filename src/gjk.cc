@@ -0,0 +1,367 @@
+// Copyright (c) 2026, CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <hpp/constraints/gjk.hh>
+#include <limits>
+
+namespace hpp {
+namespace constraints {
+namespace {
+/// Support vertex of a convex polygon in direction \c dir, expressed in
+/// the frame of the polygon. The restriction of a linear functional to
+/// the circularly ordered vertices is unimodal, so hill-climb from the
+/// vertex of the previous query instead of scanning all of them.
+std::size_t supportVertex(const std::vector<vector3_t>& pts,
+                          const vector3_t& dir, std::size_t hint) {
+  const std::size_t n = pts.size();
+  std::size_t best = (hint < n) ? hint : 0;
+  value_type bestDot = pts[best].dot(dir);
+  std::size_t steps = 0;
+  std::size_t next = (best + 1) % n;
+  value_type d = pts[next].dot(dir);
+  if (d > bestDot) {
+    while (d > bestDot && ++steps < n) {
+      best = next;
+      bestDot = d;
+      next = (best + 1) % n;
+      d = pts[next].dot(dir);
+    }
+  } else {
+    next = (best + n - 1) % n;
+    d = pts[next].dot(dir);
+    while (d > bestDot && ++steps < n) {
+      best = next;
+      bestDot = d;
+      next = (best + n - 1) % n;
+      d = pts[next].dot(dir);
+    }
+  }
+  return best;
+}
+}  // namespace
+
+GJK::GJK()
+    : tolerance_(1e-8),
+      maxIterations_(64),
+      iterations_(0),
+      accelerated_(true),
+      size_(0),
+      inside_(false),
+      warm_(false),
+      hint1_(0),
+      hint2_(0) {}
+
+void GJK::support(const ConvexShape& shape1, const Transform3f& M1,
+                  const ConvexShape& shape2, const Transform3f& M2,
+                  const vector3_t& direction, Vertex& vertex) {
+  hint1_ = supportVertex(shape1.Pts_, M1.rotation().transpose() * direction,
+                         hint1_);
+  hint2_ = supportVertex(shape2.Pts_, M2.rotation().transpose() * (-direction),
+                         hint2_);
+  vertex.p1 = M1.act(shape1.Pts_[hint1_]);
+  vertex.p2 = M2.act(shape2.Pts_[hint2_]);
+  vertex.w = vertex.p1 - vertex.p2;
+}
+
+value_type GJK::projectSegment(vector3_t& v) {
+  const vector3_t &a = simplex_[0].w, &b = simplex_[1].w;
+  const vector3_t ab = b - a;
+  const value_type den = ab.squaredNorm();
+  const value_type t = (den > 0) ? -a.dot(ab) / den : 0;
+  if (t <= 0) {
+    size_ = 1;
+    lambda_[0] = 1;
+    v = a;
+  } else if (t >= 1) {
+    simplex_[0] = simplex_[1];
+    size_ = 1;
+    lambda_[0] = 1;
+    v = b;
+  } else {
+    size_ = 2;
+    lambda_[0] = 1 - t;
+    lambda_[1] = t;
+    v = a + t * ab;
+  }
+  return v.squaredNorm();
+}
+
+value_type GJK::projectTriangle(vector3_t& v) {
+  // Voronoi region tests of Ericson, Real-Time Collision Detection,
+  // section 5.1.5, with the origin as query point.
+  const Vertex A = simplex_[0], B = simplex_[1], C = simplex_[2];
+  const vector3_t ab = B.w - A.w, ac = C.w - A.w;
+  const value_type d1 = -ab.dot(A.w), d2 = -ac.dot(A.w);
+  if (d1 <= 0 && d2 <= 0) {
+    simplex_[0] = A;
+    size_ = 1;
+    lambda_[0] = 1;
+    v = A.w;
+    return v.squaredNorm();
+  }
+  const value_type d3 = -ab.dot(B.w), d4 = -ac.dot(B.w);
+  if (d3 >= 0 && d4 <= d3) {
+    simplex_[0] = B;
+    size_ = 1;
+    lambda_[0] = 1;
+    v = B.w;
+    return v.squaredNorm();
+  }
+  const value_type vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+    const value_type t = d1 / (d1 - d3);
+    simplex_[0] = A;
+    simplex_[1] = B;
+    size_ = 2;
+    lambda_[0] = 1 - t;
+    lambda_[1] = t;
+    v = A.w + t * ab;
+    return v.squaredNorm();
+  }
+  const value_type d5 = -ab.dot(C.w), d6 = -ac.dot(C.w);
+  if (d6 >= 0 && d5 <= d6) {
+    simplex_[0] = C;
+    size_ = 1;
+    lambda_[0] = 1;
+    v = C.w;
+    return v.squaredNorm();
+  }
+  const value_type vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+    const value_type t = d2 / (d2 - d6);
+    simplex_[0] = A;
+    simplex_[1] = C;
+    size_ = 2;
+    lambda_[0] = 1 - t;
+    lambda_[1] = t;
+    v = A.w + t * ac;
+    return v.squaredNorm();
+  }
+  const value_type va = d3 * d6 - d5 * d4;
+  if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+    const value_type t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    simplex_[0] = B;
+    simplex_[1] = C;
+    size_ = 2;
+    lambda_[0] = 1 - t;
+    lambda_[1] = t;
+    v = B.w + t * (C.w - B.w);
+    return v.squaredNorm();
+  }
+  const value_type den = va + vb + vc;
+  const value_type s = vb / den, t = vc / den;
+  simplex_[0] = A;
+  simplex_[1] = B;
+  simplex_[2] = C;
+  size_ = 3;
+  lambda_[0] = 1 - s - t;
+  lambda_[1] = s;
+  lambda_[2] = t;
+  v = A.w + s * ab + t * ac;
+  return v.squaredNorm();
+}
+
+value_type GJK::projectTetrahedron(vector3_t& v) {
+  static const int faces[4][4] = {
+      {0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+  const Vertex vs[4] = {simplex_[0], simplex_[1], simplex_[2], simplex_[3]};
+  value_type bestSq = std::numeric_limits<value_type>::infinity();
+  Vertex bestSimplex[3];
+  value_type bestLambda[3];
+  int bestSize = 0;
+  vector3_t bestV;
+  bool inside = true;
+  for (int f = 0; f < 4; ++f) {
+    const Vertex &A = vs[faces[f][0]], &B = vs[faces[f][1]],
+                 &C = vs[faces[f][2]], &D = vs[faces[f][3]];
+    const vector3_t n = (B.w - A.w).cross(C.w - A.w);
+    const value_type signO = -A.w.dot(n);
+    const value_type signD = (D.w - A.w).dot(n);
+    // Skip the face when the origin lies strictly on its inner side. A
+    // degenerate face - a flat tetrahedron is common with planar shapes
+    // - is projected onto as well, so that flatness is never mistaken
+    // for containment.
+    if (signO * signD > 0) continue;
+    inside = false;
+    simplex_[0] = A;
+    simplex_[1] = B;
+    simplex_[2] = C;
+    size_ = 3;
+    vector3_t w;
+    const value_type sq = projectTriangle(w);
+    if (sq < bestSq) {
+      bestSq = sq;
+      bestV = w;
+      bestSize = size_;
+      for (int i = 0; i < bestSize; ++i) {
+        bestSimplex[i] = simplex_[i];
+        bestLambda[i] = lambda_[i];
+      }
+    }
+  }
+  if (inside) {
+    inside_ = true;
+    // Barycentric coordinates of the origin, for the witness points.
+    matrix3_t T;
+    T.col(0) = vs[1].w - vs[0].w;
+    T.col(1) = vs[2].w - vs[0].w;
+    T.col(2) = vs[3].w - vs[0].w;
+    const vector3_t x = T.colPivHouseholderQr().solve(-vs[0].w);
+    for (int i = 0; i < 4; ++i) simplex_[i] = vs[i];
+    size_ = 4;
+    lambda_[0] = 1 - x.sum();
+    lambda_[1] = x[0];
+    lambda_[2] = x[1];
+    lambda_[3] = x[2];
+    v.setZero();
+    return 0;
+  }
+  size_ = bestSize;
+  for (int i = 0; i < size_; ++i) {
+    simplex_[i] = bestSimplex[i];
+    lambda_[i] = bestLambda[i];
+  }
+  v = bestV;
+  return bestSq;
+}
+
+value_type GJK::projectOrigin(vector3_t& v) {
+  switch (size_) {
+    case 1:
+      lambda_[0] = 1;
+      v = simplex_[0].w;
+      return v.squaredNorm();
+    case 2:
+      return projectSegment(v);
+    case 3:
+      return projectTriangle(v);
+    case 4:
+      return projectTetrahedron(v);
+    default:
+      assert(false && "empty simplex");
+      return 0;
+  }
+}
+
+value_type GJK::distance(const ConvexShape& shape1, const Transform3f& M1,
+                         const ConvexShape& shape2, const Transform3f& M2) {
+  vector3_t guess;
+  if (warm_)
+    guess = direction_;
+  else
+    guess = M1.act(shape1.C_) - M2.act(shape2.C_);
+  if (guess.squaredNorm() < 1e-16) guess = vector3_t(1, 0, 0);
+
+  inside_ = false;
+  size_ = 1;
+  support(shape1, M1, shape2, M2, -guess, simplex_[0]);
+  lambda_[0] = 1;
+  vector3_t v = simplex_[0].w;
+  vector3_t vPrev = v;
+  value_type vSq = v.squaredNorm();
+  bool nesterov = accelerated_;
+  const value_type eps = tolerance_ * tolerance_;
+
+  for (iterations_ = 0; iterations_ < maxIterations_; ++iterations_) {
+    if (vSq < eps) {
+      inside_ = true;
+      break;
+    }
+    vector3_t dir = -v;
+    if (nesterov && iterations_ > 0) {
+      // Nesterov momentum on the support direction.
+      const value_type m =
+          value_type(iterations_ - 1) / value_type(iterations_ + 2);
+      dir = -(v + m * (v - vPrev));
+      if (dir.squaredNorm() < 1e-16) dir = -v;
+    }
+    Vertex s;
+    bool converged = false;
+    for (;;) {
+      support(shape1, M1, shape2, M2, dir, s);
+      // Frank-Wolfe duality gap: when below the tolerance, |v| exceeds
+      // the distance by at most tolerance * |v|.
+      const value_type gap = vSq - v.dot(s.w);
+      bool duplicate = false;
+      for (int i = 0; i < size_; ++i)
+        if ((simplex_[i].w - s.w).squaredNorm() == 0) {
+          duplicate = true;
+          break;
+        }
+      if (gap <= tolerance_ * vSq || duplicate) {
+        if (nesterov) {
+          // The accelerated direction stopped certifying progress:
+          // fall back to the vanilla iteration for good.
+          nesterov = false;
+          dir = -v;
+          continue;
+        }
+        converged = true;
+      }
+      break;
+    }
+    if (converged) break;
+    simplex_[size_] = s;
+    lambda_[size_] = 0;
+    ++size_;
+    vPrev = v;
+    vSq = projectOrigin(v);
+    if (inside_) break;
+  }
+
+  if (inside_) {
+    vSq = 0;
+    v.setZero();
+  }
+  w1_.setZero();
+  w2_.setZero();
+  for (int i = 0; i < size_; ++i) {
+    w1_ += lambda_[i] * simplex_[i].p1;
+    w2_ += lambda_[i] * simplex_[i].p2;
+  }
+  // Warm-start the next query. On intersection v is zero, so keep the
+  // previous separating direction instead.
+  direction_ = inside_ ? guess : v;
+  warm_ = true;
+  return std::sqrt(vSq);
+}
+
+value_type GJK::distance(const ConvexShape& shape1, const ConvexShape& shape2,
+                         const pinocchio::DeviceData& d) {
+  Transform3f M1, M2;
+  if (shape1.joint_)
+    M1 = shape1.joint_->currentTransformation(d);
+  else
+    M1.setIdentity();
+  if (shape2.joint_)
+    M2 = shape2.joint_->currentTransformation(d);
+  else
+    M2.setIdentity();
+  return distance(shape1, M1, shape2, M2);
+}
+}  // namespace constraints
+}  // namespace hpp
@@ -33,7 +33,9 @@
 #include <boost/serialization/weak_ptr.hpp>
 #include <hpp/constraints/differentiable-function.hh>
 #include <hpp/util/serialization.hh>
+#include <mutex>
 #include <pinocchio/serialization/eigen.hpp>
+#include <unordered_map>
 
 namespace hpp {
 namespace constraints {
@@ -97,10 +99,24 @@ void Implicit::rightHandSideFunction(const DifferentiableFunctionPtr_t& rhsF) {
   }
 
   rhsFunction_ = rhsF;
+  // The sampled trajectory, if any, belongs to the previous function.
+  rhsSamples_.resize(0, 0);
 }
 
 vectorIn_t Implicit::rightHandSideAt(const value_type& s) {
-  if (rhsFunction_) {
+  if (rhsSamples_.cols() > 0) {
+    LiegroupSpacePtr_t space(function_->outputSpace());
+    value_type x = (s - rhsCacheStart_) / rhsCacheStep_;
+    size_type i =
+        (x <= 0) ? 0 : std::min((size_type)x, rhsSamples_.cols() - 2);
+    pinocchio::LiegroupElementConstRef r0(
+        space->elementConstRef(rhsSamples_.col(i))),
+        r1(space->elementConstRef(rhsSamples_.col(i + 1)));
+    // Geodesic interpolation between the two enclosing samples. Times
+    // outside the sampled interval extrapolate along the end geodesics.
+    logOutput_ = r1 - r0;
+    output_ = r0 + (x - (value_type)i) * logOutput_;
+  } else if (rhsFunction_) {
     vector_t S(1);
     S[0] = s;
     rhsFunction_->value(output_, S);
@@ -108,6 +124,29 @@ vectorIn_t Implicit::rightHandSideAt(const value_type& s) {
   return output_.vector();
 }
 
+void Implicit::precomputeRightHandSide(const value_type& sMin,
+                                       const value_type& sMax,
+                                       size_type nbSamples) {
+  if (!rhsFunction_) {
+    HPP_THROW(std::invalid_argument,
+              "Constraint " << function_->name()
+                            << " has no right hand side function to sample.");
+  }
+  if (nbSamples < 2) {
+    HPP_THROW(std::invalid_argument,
+              "At least two samples are required. Got " << nbSamples);
+  }
+  rhsCacheStart_ = sMin;
+  rhsCacheStep_ = (sMax - sMin) / (value_type)(nbSamples - 1);
+  rhsSamples_.resize(function_->outputSpace()->nq(), nbSamples);
+  vector_t S(1);
+  for (size_type i = 0; i < nbSamples; ++i) {
+    S[0] = sMin + (value_type)i * rhsCacheStep_;
+    rhsFunction_->value(output_, S);
+    rhsSamples_.col(i) = output_.vector();
+  }
+}
+
 size_type Implicit::parameterSize() const { return parameterSize_; }
 
 size_type Implicit::rightHandSideSize() const {
@@ -133,6 +172,8 @@ Implicit::Implicit(const DifferentiableFunctionPtr_t& function,
       rhs_(vector_t::Zero(function->outputSize())),
       parameterSize_(computeParameterSize(comparison_)),
       function_(function),
+      rhsCacheStart_(0),
+      rhsCacheStep_(0),
       mask_(mask),
       activeRows_(),
       inactiveRows_(),
@@ -184,6 +225,9 @@ Implicit::Implicit(const Implicit& other)
       parameterSize_(other.parameterSize_),
       function_(other.function_),
       rhsFunction_(other.rhsFunction_),
+      rhsCacheStart_(other.rhsCacheStart_),
+      rhsCacheStep_(other.rhsCacheStep_),
+      rhsSamples_(other.rhsSamples_),
       mask_(other.mask_),
       activeRows_(other.activeRows_),
       inactiveRows_(other.inactiveRows_),
@@ -203,15 +247,51 @@ bool Implicit::isEqual(const Implicit& other, bool swapAndTest) const {
   return true;
 }
 
+namespace {
+// Content addressed registry of implicit constraints, in the style of
+// DifferentiableFunctionRegistry. The functions are deduped first, so
+// pointer identity can serve as key.
+typedef std::unordered_multimap<DifferentiableFunction*, ImplicitWkPtr_t>
+    ImplicitRegistryMap_t;
+
+ImplicitRegistryMap_t& implicitRegistryMap() {
+  static ImplicitRegistryMap_t map;
+  return map;
+}
+
+std::mutex& implicitRegistryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+}  // namespace
+
 ImplicitPtr_t Implicit::create(const DifferentiableFunctionPtr_t& function,
                                ComparisonTypes_t comp, std::vector<bool> mask) {
   if (mask.empty()) {
     mask = std::vector<bool>(function->outputSpace()->nv(), true);
   }
-  Implicit* ptr = new Implicit(function, comp, mask);
+  DifferentiableFunctionPtr_t f(
+      DifferentiableFunctionRegistry::dedupe(function));
+  std::lock_guard<std::mutex> lock(implicitRegistryMutex());
+  ImplicitRegistryMap_t& map = implicitRegistryMap();
+  std::pair<ImplicitRegistryMap_t::iterator, ImplicitRegistryMap_t::iterator>
+      range(map.equal_range(f.get()));
+  for (ImplicitRegistryMap_t::iterator it = range.first;
+       it != range.second;) {
+    ImplicitPtr_t candidate(it->second.lock());
+    if (!candidate) {
+      it = map.erase(it);
+      continue;
+    }
+    if (candidate->comparison_ == comp && candidate->mask_ == mask)
+      return candidate;
+    ++it;
+  }
+  Implicit* ptr = new Implicit(f, comp, mask);
   ImplicitPtr_t shPtr(ptr);
   ImplicitWkPtr_t wkPtr(shPtr);
   ptr->init(wkPtr);
+  map.insert(std::make_pair(f.get(), wkPtr));
   return shPtr;
 }
 
@@ -227,10 +307,16 @@ ImplicitPtr_t Implicit::copy() const { return createCopy(weak_.lock()); }
 
 void Implicit::rightHandSideFromConfig(ConfigurationIn_t config,
                                        LiegroupElementRef rhs) {
-  assert(*rhs.space() == *function_->outputSpace());
   function_->value(output_, config);
+  rightHandSideFromValue(output_, rhs);
+}
+
+void Implicit::rightHandSideFromValue(LiegroupElementConstRef value,
+                                      LiegroupElementRef rhs) {
+  assert(*rhs.space() == *function_->outputSpace());
+  assert(*value.space() == *function_->outputSpace());
   logOutput_.setZero();
-  equalityIndices_.lview(logOutput_) = equalityIndices_.rview(log(output_));
+  equalityIndices_.lview(logOutput_) = equalityIndices_.rview(log(value));
   // rhs = exp(logOutput_)
   rhs = rhs.space()->exp(logOutput_);
 }
@@ -288,6 +374,10 @@ void Implicit::serialize(Archive& ar, const unsigned int version) {
   ar& BOOST_SERIALIZATION_NVP(mask_);
   ar& BOOST_SERIALIZATION_NVP(weak_);
   if (!Archive::is_saving::value) {
+    // Share functions equal in content with previously loaded
+    // constraints. Pointer identity only survives within one archive.
+    function_ = DifferentiableFunctionRegistry::dedupe(function_);
+    rhsFunction_ = DifferentiableFunctionRegistry::dedupe(rhsFunction_);
     computeActiveRows();
     computeIndices();
   }
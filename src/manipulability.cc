@@ -36,7 +36,8 @@ Manipulability::Manipulability(DifferentiableFunctionPtr_t function,
                              function->inputDerivativeSize(), 1, name),
       function_(function),
       robot_(robot),
-      J_(function->outputDerivativeSize(), function->inputDerivativeSize()) {
+      J_(function->outputDerivativeSize(), function->inputDerivativeSize()),
+      ldlt_(function->outputDerivativeSize()) {
   activeParameters_ = function->activeParameters();
   activeDerivativeParameters_ = function->activeDerivativeParameters();
   cols_ = Eigen::BlockIndex::fromLogicalExpression(activeDerivativeParameters_);
@@ -50,50 +51,24 @@ void Manipulability::impl_compute(LiegroupElementRef res,
   function_->jacobian(J_, arg);
   value_type logAbsDeterminant;
 
-  // ------------ SVD --------------------------------------------------- //
-  J_JT_ = cols_.rview(J_);
-  Eigen::JacobiSVD<matrix_t> svd(J_JT_);
-  logAbsDeterminant = svd.singularValues()
-                          .array()
-                          .cwiseMax(std::numeric_limits<value_type>::min())
-                          .log10()
-                          .sum();
+  // Compute J * J^T, block of active columns by block of active
+  // columns so that the inactive columns are never copied.
+  typedef Eigen::ColBlockIndices::View<const matrix_t>::type MatrixView_t;
+  MatrixView_t J(cols_.rview(J_));
+  J_JT_.setZero();
+  for (MatrixView_t::block_iterator block(J); block.valid(); ++block)
+    J_JT_.noalias() += J._block(block) * J._block(block).transpose();
 
-  /*
-  // ------------ Other decomposition methods --------------------------- //
-
-  // 1. Compute J * J^T
-  if (cols_.cols().size() > 1) {
-    typedef typename Eigen::ColBlockIndices::View<const matrix_t>::type
-  MatrixView_t; MatrixView_t J (cols_.rview(J_));
-    //std::cout << J.eval() << std::endl;
-    J_JT_.setZero();
-    for (MatrixView_t::block_iterator block (J); block.valid(); ++block)
-      J_JT_.noalias() += J._block(block) * J._block(block).transpose();
-  } else {
-    const segment_t& s = cols_.cols()[0];
-    //std::cout << J_.middleCols(s.first, s.second) << std::endl;
-    J_JT_.noalias() = J_.middleCols(s.first, s.second)
-      * J_.middleCols(s.first, s.second).transpose();
-  }
-
-  // 2. Compute decomposition
-
-  // 2.1 LDLT
-  Eigen::LDLT<matrix_t> ldlt (J_JT_);
-  logAbsDeterminant = ldlt.matrixL().nestedExpression().diagonal().array()
-    .cwiseMax(std::numeric_limits<value_type>::min())
-    .log10()
-    .sum();
-  logAbsDeterminant += ldlt.vectorD().array()
-    .cwiseMax(std::numeric_limits<value_type>::min())
-    .log10()
-    .sum();
-  // 2.2 QRs (FullPiv is more robust that ColPiv)
-  //Eigen::ColPivHouseholderQR<matrix_t> qr (J_JT_);
-  Eigen::FullPivHouseholderQR<matrix_t> qr (J_JT_);
-  logAbsDeterminant = qr.logAbsDeterminant();
-  // */
+  // J * J^T is symmetric positive semi-definite, so the diagonal of
+  // its LDLT decomposition holds the squared singular values of J and
+  // the decomposition reuses the workspace allocated at construction.
+  ldlt_.compute(J_JT_);
+  logAbsDeterminant =
+      0.5 * ldlt_.vectorD()
+                .array()
+                .cwiseMax(std::numeric_limits<value_type>::min())
+                .log10()
+                .sum();
 
   // This funcion will be used as a cost function whose squared norm is to
   // be minimized.
@@ -54,19 +54,17 @@ void BlockIndex::sort(segments_t& a) {
 
 void BlockIndex::shrink(segments_t& a) {
   if (a.size() < 2) return;
-  // Find consecutive element which overlap
-  typename segments_t::iterator e2 = a.begin();
-  typename segments_t::iterator e1 = e2++;
-  internal::BlockIndexComp<false, true> lend_before_rstart;
-  while (e2 != a.end()) {
-    if (!lend_before_rstart(*e1, *e2)) {
-      e1->second = std::max(e1->second, e2->first + e2->second - e1->first);
-      e2 = a.erase(e2);
-    } else {
-      e1 = e2;
-      ++e2;
-    }
+  // Compact in place: the write index trails the read index, so that
+  // merging k segments costs O(n) instead of one tail shift per merge.
+  std::size_t w = 0;
+  for (std::size_t r = 1; r < a.size(); ++r) {
+    if (a[r].first <= a[w].first + a[w].second)
+      a[w].second =
+          std::max(a[w].second, a[r].first + a[r].second - a[w].first);
+    else
+      a[++w] = a[r];
   }
+  a.resize(w + 1);
 }
 
 bool BlockIndex::overlap(const segment_t& a, const segment_t& b) {
@@ -109,17 +107,18 @@ void BlockIndex::add(segments_t& a, const segment_t& b) {
 }
 
 void BlockIndex::add(segments_t& a, const segments_t& b) {
-  // Sorted insertion of b into a, assuming b is sorted.
+  // Sorted merge of b into a, assuming b is sorted: append then merge
+  // the two sorted runs, O(n+m) moves instead of one tail shifting
+  // insertion per element of b.
+  if (b.empty()) return;
   if (a.empty()) {
     a = b;
     return;
   }
-  segments_t::iterator _a = a.begin();
-  for (segments_t::const_iterator _b = b.begin(); _b != b.end(); ++_b) {
-    _a = std::upper_bound(_a, a.end(), *_b, internal::BlockIndexCompFull());
-    _a = a.insert(_a, *_b);
-    ++_a;
-  }
+  const std::ptrdiff_t n = (std::ptrdiff_t)a.size();
+  a.insert(a.end(), b.begin(), b.end());
+  std::inplace_merge(a.begin(), a.begin() + n, a.end(),
+                     internal::BlockIndexCompFull());
 }
 
 BlockIndex::segments_t BlockIndex::difference(const segment_t& a,
@@ -163,23 +162,62 @@ BlockIndex::segments_t BlockIndex::difference(const segments_t& a,
 
 BlockIndex::segments_t BlockIndex::difference(const segment_t& a,
                                               const segments_t& b) {
-  segments_t diff(1, a);
-  for (typename segments_t::const_iterator _b = b.begin(); _b != b.end(); ++_b)
-    diff = difference(diff, *_b);
+  segments_t diff;
+  if (a.second == 0) return diff;
+  // Single sweep: b is sorted, so each of its segments bites at most
+  // once into what remains of a.
+  size_type start = a.first;
+  const size_type aend = a.first + a.second;
+  for (typename segments_t::const_iterator _b = b.begin();
+       _b != b.end() && start < aend; ++_b) {
+    if (_b->second == 0) continue;
+    const size_type bend = _b->first + _b->second;
+    if (bend <= start) continue;
+    if (_b->first > start)
+      diff.push_back(segment_t(start, std::min(_b->first, aend) - start));
+    start = std::max(start, bend);
+  }
+  if (start < aend) diff.push_back(segment_t(start, aend - start));
   return diff;
 }
 
 BlockIndex::segments_t BlockIndex::difference(const segments_t& a,
                                               const segments_t& b) {
   segments_t diff;
+  diff.reserve(a.size() + b.size());
+  // Merge based subtraction: both lists are sorted, so the cursor into
+  // b only moves forward across the segments of a, keeping the whole
+  // difference O(n+m) instead of one scan of b per segment of a.
+  typename segments_t::const_iterator _b = b.begin();
   for (typename segments_t::const_iterator _a = a.begin(); _a != a.end();
        ++_a) {
-    segments_t d = difference(*_a, b);
-    diff.insert(diff.end(), d.begin(), d.end());
+    if (_a->second == 0) continue;
+    size_type start = _a->first;
+    const size_type aend = _a->first + _a->second;
+    // Segments of b ending before start cannot overlap this segment of
+    // a nor the following ones, whose starts are not smaller.
+    while (_b != b.end() && _b->first + _b->second <= start) ++_b;
+    // A segment of b may straddle two segments of a: scan from a local
+    // cursor so that it is seen by both.
+    for (typename segments_t::const_iterator _bb = _b;
+         _bb != b.end() && _bb->first < aend && start < aend; ++_bb) {
+      if (_bb->second == 0) continue;
+      if (_bb->first > start)
+        diff.push_back(segment_t(start, std::min(_bb->first, aend) - start));
+      start = std::max(start, _bb->first + _bb->second);
+    }
+    if (start < aend) diff.push_back(segment_t(start, aend - start));
   }
   return diff;
 }
 
+void BlockIndex::subtract(segments_t& a, const segments_t& b) {
+  // The subtraction can split segments, so a truly in-place rewrite is
+  // not possible; build into a scratch and steal its storage.
+  segments_t diff(difference(a, b));
+  a.swap(diff);
+}
+
 BlockIndex::segments_t BlockIndex::split(segments_t& segments,
                                          const size_type& cardinal) {
   assert(BlockIndex::cardinal(segments) >= cardinal);
@@ -253,4 +291,24 @@ BlockIndex::segments_t BlockIndex::extract(const segments_t& segments,
   // Avoid compilation warning
   return segments_t();
 }
+
+void BlockCopyPlan::compile(const BlockIndex::segments_t& segments) {
+  runs_.clear();
+  nbIndices_ = 0;
+  for (std::size_t i = 0; i < segments.size(); ++i) {
+    const BlockIndex::segment_t& s = segments[i];
+    if (s.second == 0) continue;
+    if (!runs_.empty() && runs_.back().full + runs_.back().length == s.first) {
+      // Contiguous in the full matrix: merge into the previous run.
+      runs_.back().length += s.second;
+    } else {
+      Run r;
+      r.full = s.first;
+      r.condensed = nbIndices_;
+      r.length = s.second;
+      runs_.push_back(r);
+    }
+    nbIndices_ += s.second;
+  }
+}
 }  // namespace Eigen
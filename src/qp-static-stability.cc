@@ -46,6 +46,18 @@ std::size_t forceDatasToNbContacts(
     nb += it->points.size();
   return nb;
 }
+
+/// Minimize \f$ |A_P z - b| \f$ over the columns of A listed in P and
+/// scatter the solution into z, zero elsewhere.
+void leastSquaresOnPassive(const matrix_t& A, const vector_t& b,
+                           const std::vector<size_type>& P, vector_t& z) {
+  z.setZero();
+  if (P.empty()) return;
+  matrix_t AP(A.rows(), (size_type)P.size());
+  for (std::size_t k = 0; k < P.size(); ++k) AP.col(k) = A.col(P[k]);
+  vector_t zP(AP.colPivHouseholderQr().solve(b));
+  for (std::size_t k = 0; k < P.size(); ++k) z[P[k]] = zP[k];
+}
 }  // namespace
 
 const Eigen::Matrix<value_type, 6, 1> QPStaticStability::Gravity =
@@ -66,12 +78,15 @@ QPStaticStability::QPStaticStability(const std::string& name,
       com_(com),
       H_(nbContacts_, nbContacts_),
       G_(nbContacts_),
-      qp_((qpOASES::int_t)nbContacts_, qpOASES::HST_SEMIDEF),
-      phi_(Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(6, nbContacts_),
-           Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(
-               6, nbContacts_ * robot->numberDof())),
+      qp_((qpOASES::int_t)nbContacts_, 0, qpOASES::HST_SEMIDEF),
+      qpInitialized_(false),
+      cache_(ContactWrenchCache::create(robot, contacts, com)),
+      phi_(cache_->phi()),
       primal_(vector_t::Zero(nbContacts_)),
-      dual_(vector_t::Zero(nbContacts_)) {
+      dual_(vector_t::Zero(nbContacts_)),
+      JT_phi_F_(nbContacts_, robot->numberDof()),
+      J_F_(6, robot->numberDof()),
+      backend_(QPOASES) {
   VectorMap_t zeros(Zeros, nbContacts_);
   zeros.setZero();
 
@@ -79,17 +94,6 @@ QPStaticStability::QPStaticStability(const std::string& name,
   qp_.setOptions(options);
 
   qp_.setPrintLevel(qpOASES::PL_NONE);
-  phi_.setSize(2, nbContacts_);
-  Traits<PointCom>::Ptr_t OG = PointCom::create(com);
-  for (std::size_t i = 0; i < contacts.size(); ++i) {
-    Traits<PointInJoint>::Ptr_t OP2 = PointInJoint::create(
-        contacts[i].joint, contacts[i].point, robot->numberDof());
-    Traits<VectorInJoint>::Ptr_t n2 = VectorInJoint::create(
-        contacts[i].joint, contacts[i].normal, robot->numberDof());
-
-    phi_(0, i) = n2;
-    phi_(1, i) = (OG - OP2) ^ n2;
-  }
 }
 
 QPStaticStability::QPStaticStability(const std::string& name,
@@ -104,12 +108,44 @@ QPStaticStability::QPStaticStability(const std::string& name,
       com_(com),
       H_(nbContacts_, nbContacts_),
       G_(nbContacts_),
-      qp_((qpOASES::int_t)nbContacts_, qpOASES::HST_SEMIDEF),
-      phi_(Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(6, nbContacts_),
-           Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(
-               6, nbContacts_ * robot->numberDof())),
+      qp_((qpOASES::int_t)nbContacts_, 0, qpOASES::HST_SEMIDEF),
+      qpInitialized_(false),
+      cache_(ContactWrenchCache::create(robot, contacts, com)),
+      phi_(cache_->phi()),
       primal_(vector_t::Zero(nbContacts_)),
-      dual_(vector_t::Zero(nbContacts_)) {
+      dual_(vector_t::Zero(nbContacts_)),
+      JT_phi_F_(nbContacts_, robot->numberDof()),
+      J_F_(6, robot->numberDof()),
+      backend_(QPOASES) {
+  VectorMap_t zeros(Zeros, nbContacts_);
+  zeros.setZero();
+
+  qpOASES::Options options;
+  qp_.setOptions(options);
+
+  qp_.setPrintLevel(qpOASES::PL_NONE);
+}
+
+QPStaticStability::QPStaticStability(const std::string& name,
+                                     const ContactWrenchCachePtr_t& cache)
+    : DifferentiableFunction(cache->robot()->configSize(),
+                             cache->robot()->numberDof(), 1, name),
+      Zeros(new qpOASES::real_t[cache->size()]),
+      nWSR(40),
+      robot_(cache->robot()),
+      nbContacts_(cache->size()),
+      com_(cache->com()),
+      H_(nbContacts_, nbContacts_),
+      G_(nbContacts_),
+      qp_((qpOASES::int_t)nbContacts_, 0, qpOASES::HST_SEMIDEF),
+      qpInitialized_(false),
+      cache_(cache),
+      phi_(cache_->phi()),
+      primal_(vector_t::Zero(nbContacts_)),
+      dual_(vector_t::Zero(nbContacts_)),
+      JT_phi_F_(nbContacts_, robot_->numberDof()),
+      J_F_(6, robot_->numberDof()),
+      backend_(QPOASES) {
   VectorMap_t zeros(Zeros, nbContacts_);
   zeros.setZero();
 
@@ -117,21 +153,6 @@ QPStaticStability::QPStaticStability(const std::string& name,
   qp_.setOptions(options);
 
   qp_.setPrintLevel(qpOASES::PL_NONE);
-  phi_.setSize(2, nbContacts_);
-  Traits<PointCom>::Ptr_t OG = PointCom::create(com);
-  std::size_t col = 0;
-  for (std::size_t i = 0; i < contacts.size(); ++i) {
-    Traits<VectorInJoint>::Ptr_t n = VectorInJoint::create(
-        contacts[i].joint, contacts[i].normal, robot->numberDof());
-    for (std::size_t j = 0; j < contacts[i].points.size(); ++j) {
-      Traits<PointInJoint>::Ptr_t OP = PointInJoint::create(
-          contacts[i].joint, contacts[i].points[j], robot->numberDof());
-
-      phi_(0, col) = n;
-      phi_(1, col) = (OG - OP) ^ n;
-      col++;
-    }
-  }
 }
 
 QPStaticStabilityPtr_t QPStaticStability::create(
@@ -155,12 +176,14 @@ QPStaticStabilityPtr_t QPStaticStability::create(
   return create("QPStaticStability", robot, contacts, com);
 }
 
+QPStaticStabilityPtr_t QPStaticStability::create(
+    const std::string& name, const ContactWrenchCachePtr_t& cache) {
+  return QPStaticStabilityPtr_t(new QPStaticStability(name, cache));
+}
+
 void QPStaticStability::impl_compute(LiegroupElementRef result,
                                      ConfigurationIn_t argument) const {
-  robot_->currentConfiguration(argument);
-  robot_->computeForwardKinematics();
-
-  phi_.invalidate();
+  cache_->prepare(argument);
   phi_.computeValue(argument);
   // phi_.computeSVD (argument);
 
@@ -175,10 +198,7 @@ void QPStaticStability::impl_compute(LiegroupElementRef result,
 
 void QPStaticStability::impl_jacobian(matrixOut_t jacobian,
                                       ConfigurationIn_t argument) const {
-  robot_->currentConfiguration(argument);
-  robot_->computeForwardKinematics();
-
-  phi_.invalidate();
+  cache_->prepare(argument);
   // phi_.computeSVD (argument);
   phi_.computeJacobian(argument);
 
@@ -196,14 +216,11 @@ void QPStaticStability::impl_jacobian(matrixOut_t jacobian,
             "Jacobian WILL be wrong.");
   }
 
-  // TODO preallocate this.
-  matrix_t JT_phi_F(nbContacts_, robot_->numberDof());
-  matrix_t J_F(6, robot_->numberDof());
-  phi_.jacobianTransposeTimes(argument, phi_.value() * primal_, JT_phi_F);
-  phi_.jacobianTimes(argument, primal_, J_F);
+  phi_.jacobianTransposeTimes(argument, phi_.value() * primal_, JT_phi_F_);
+  phi_.jacobianTimes(argument, primal_, J_F_);
 
-  jacobian = 0.5 * primal_.transpose() * JT_phi_F +
-             (0.5 * phi_.value() * primal_ + Gravity).transpose() * J_F;
+  jacobian = 0.5 * primal_.transpose() * JT_phi_F_ +
+             (0.5 * phi_.value() * primal_ + Gravity).transpose() * J_F_;
 }
 
 inline qpOASES::returnValue QPStaticStability::solveQP(
@@ -212,20 +229,119 @@ inline qpOASES::returnValue QPStaticStability::solveQP(
   // Try to find a positive solution
   using qpOASES::SUCCESSFUL_RETURN;
 
+  if (backend_ == NNLS) return solveQPNnls(result);
+
   H_ = phi_.value().transpose() * phi_.value();
   G_ = phi_.value().transpose() * Gravity;
 
   qpOASES::int_t nwsr = nWSR;
-  qp_.reset();
-  qp_.setHessianType(qpOASES::HST_SEMIDEF);
   qpOASES::returnValue ret;
-  ret = qp_.init(H_.data(), G_.data(), Zeros, 0, nwsr, 0);
+  if (qpInitialized_) {
+    // Hot start from the active set and factorization of the previous
+    // evaluation: consecutive calls during a solve differ only
+    // slightly.
+    ret = qp_.hotstart(H_.data(), G_.data(), 0, Zeros, 0, 0, 0, nwsr, 0);
+    if (ret != SUCCESSFUL_RETURN) qpInitialized_ = false;
+  }
+  if (!qpInitialized_) {
+    qp_.reset();
+    qp_.setHessianType(qpOASES::HST_SEMIDEF);
+    nwsr = nWSR;
+    ret = qp_.init(H_.data(), G_.data(), 0, Zeros, 0, 0, 0, nwsr, 0);
+    qpInitialized_ = (ret == SUCCESSFUL_RETURN);
+  }
   qp_.getPrimalSolution(primal_.data());
   qp_.getDualSolution(dual_.data());
   result[0] = 2 * qp_.getObjVal() + MinusGravity.squaredNorm();
   return ret;
 }
 
+inline qpOASES::returnValue QPStaticStability::solveQPNnls(
+    vectorOut_t result) const {
+  // The QP is the non-negative least-squares problem
+  // min |phi f + g|^2, f >= 0, solved by the Lawson-Hanson algorithm
+  // on the 6 x n matrix phi directly: each passive-set solve costs
+  // O(n) instead of the cubic dense QP solve. The passive set and
+  // primal point of the previous evaluation warm-start the iteration.
+  const matrix_t& A(phi_.value());
+  const size_type n(A.cols());
+  const vector_t b(-Gravity);
+  const value_type tol(1e-10);
+
+  std::vector<bool> passive(nnlsPassive_);
+  if ((size_type)passive.size() != n) {
+    passive.assign(n, false);
+    primal_.setZero();
+  }
+  std::vector<size_type> P;
+  for (size_type i = 0; i < n; ++i)
+    if (passive[i]) P.push_back(i);
+  vector_t& f(primal_);
+  f = f.cwiseMax(0);
+  vector_t z(n), w(n);
+
+  qpOASES::returnValue ret = qpOASES::SUCCESSFUL_RETURN;
+  size_type iter = 0;
+  const size_type maxIter(3 * n + 30);
+  bool needSolve = !P.empty();
+  for (;;) {
+    while (needSolve) {
+      if (++iter > maxIter) {
+        ret = qpOASES::RET_MAX_NWSR_REACHED;
+        break;
+      }
+      leastSquaresOnPassive(A, b, P, z);
+      value_type alpha = 1;
+      bool feasible = true;
+      for (std::size_t k = 0; k < P.size(); ++k) {
+        if (z[P[k]] <= 0) {
+          feasible = false;
+          value_type a = f[P[k]] / (f[P[k]] - z[P[k]]);
+          if (a < alpha) alpha = a;
+        }
+      }
+      if (feasible) {
+        f = z;
+        break;
+      }
+      f += alpha * (z - f);
+      // Remove from the passive set the variables that reached zero.
+      std::vector<size_type> kept;
+      for (std::size_t k = 0; k < P.size(); ++k) {
+        if (f[P[k]] > tol)
+          kept.push_back(P[k]);
+        else {
+          f[P[k]] = 0;
+          passive[P[k]] = false;
+        }
+      }
+      P.swap(kept);
+    }
+    w.noalias() = A.transpose() * (b - A * f);
+    if (ret != qpOASES::SUCCESSFUL_RETURN) break;
+    // Optimality: no zero variable has a strictly positive descent
+    // direction.
+    size_type best = -1;
+    value_type wMax = tol;
+    for (size_type i = 0; i < n; ++i)
+      if (!passive[i] && w[i] > wMax) {
+        wMax = w[i];
+        best = i;
+      }
+    if (best < 0) break;
+    passive[best] = true;
+    P.push_back(best);
+    needSolve = true;
+  }
+
+  nnlsPassive_.swap(passive);
+  // Same convention as the qpOASES backend: the dual is the gradient
+  // of the objective.
+  dual_ = -w;
+  result[0] = (b - A * f).squaredNorm();
+  return ret;
+}
+
 bool QPStaticStability::checkQPSol() const {
   return (primal_.array() >= -1e-8).all();
 }
@@ -29,6 +29,7 @@
 // DAMAGE.
 
 #include <boost/serialization/vector.hpp>
+#include <hpp/constraints/com-computation-cache.hh>
 #include <hpp/constraints/macros.hh>
 #include <hpp/constraints/relative-com.hh>
 #include <hpp/pinocchio/center-of-mass-computation.hh>
@@ -60,9 +61,8 @@ RelativeComPtr_t RelativeCom::create(const std::string& name,
                                      const JointPtr_t& joint,
                                      const vector3_t reference,
                                      std::vector<bool> mask) {
-  CenterOfMassComputationPtr_t comc = CenterOfMassComputation::create(robot);
-  comc->add(robot->rootJoint());
-  return create(name, robot, comc, joint, reference, mask);
+  return create(name, robot, ComComputationCache::wholeBody(robot), joint,
+                reference, mask);
 }
 
 RelativeComPtr_t RelativeCom::create(const DevicePtr_t& robot,
@@ -99,6 +99,7 @@ RelativeCom::RelativeCom(const DevicePtr_t& robot,
       jacobian_(3, robot->numberDof() - robot->extraConfigSpace().dimension()) {
   if (mask[0] && mask[1] && mask[2]) nominalCase_ = true;
   jacobian_.setZero();
+  cache_ = ComComputationCache::get(comc_);
 }
 
 std::ostream& RelativeCom::print(std::ostream& o) const {
@@ -113,7 +114,7 @@ void RelativeCom::impl_compute(LiegroupElementRef result,
                                ConfigurationIn_t argument) const {
   robot_->currentConfiguration(argument);
   robot_->computeForwardKinematics();
-  comc_->compute(hpp::pinocchio::COM);
+  cache_->compute(argument, hpp::pinocchio::COM);
   const Transform3f& M = joint_->currentTransformation();
   const vector3_t& x = comc_->com();
   const matrix3_t& R = M.rotation();
@@ -136,7 +137,7 @@ void RelativeCom::impl_jacobian(matrixOut_t jacobian,
                                 ConfigurationIn_t arg) const {
   robot_->currentConfiguration(arg);
   robot_->computeForwardKinematics();
-  comc_->compute(hpp::pinocchio::COMPUTE_ALL);
+  cache_->compute(arg, hpp::pinocchio::COMPUTE_ALL);
   const ComJacobian_t& Jcom = comc_->jacobian();
   const JointJacobian_t& Jjoint(joint_->jacobian());
   const Transform3f& M = joint_->currentTransformation();
@@ -179,8 +180,10 @@ void RelativeCom::serialize(Archive& ar, const unsigned int version) {
   ar& BOOST_SERIALIZATION_NVP(joint_);
   ar& BOOST_SERIALIZATION_NVP(reference_);
   ar& BOOST_SERIALIZATION_NVP(mask_);
-  if (!Archive::is_saving::value)
+  if (!Archive::is_saving::value) {
     nominalCase_ = (mask_[0] && mask_[1] && mask_[2]);
+    cache_ = ComComputationCache::get(comc_);
+  }
 }
 
 HPP_SERIALIZATION_IMPLEMENT(RelativeCom);
@@ -0,0 +1,146 @@
+// Copyright (c) 2026 CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <hpp/constraints/solver/allocation-audit.hh>
+#include <hpp/constraints/solver/trace.hh>
+#include <map>
+
+namespace hpp {
+namespace constraints {
+namespace solver {
+namespace audit {
+namespace {
+// Deepest zone nesting the counters can attribute to. The solvers nest
+// at most three zones (solve > descent direction > level); leave slack
+// for embedders that open zones of their own.
+const std::size_t maxDepth = 32;
+
+struct Zone {
+  const char* name;
+  size_type level;
+};
+
+struct State {
+  State() : installed(false), counting(false), depth(0) {}
+
+  bool installed;
+  // Reentrancy guard: the counters allocate when a phase is first seen.
+  bool counting;
+  std::size_t depth;
+  Zone stack[maxDepth];
+  trace::Hooks previous;
+  std::map<std::string, PhaseAllocations> counters;
+};
+
+// Function local static to dodge initialization order with the
+// interposed allocator, which may call count before main.
+State& state() {
+  static State instance;
+  return instance;
+}
+
+void zoneBegin(const char* name, size_type level) {
+  State& s = state();
+  if (s.depth < maxDepth) {
+    s.stack[s.depth].name = name;
+    s.stack[s.depth].level = level;
+  }
+  ++s.depth;
+  if (s.previous.zoneBegin) s.previous.zoneBegin(name, level);
+}
+
+void zoneEnd(const char* name, size_type level) {
+  State& s = state();
+  if (s.depth > 0) --s.depth;
+  if (s.previous.zoneEnd) s.previous.zoneEnd(name, level);
+}
+}  // namespace
+
+void install() {
+  State& s = state();
+  s.previous = trace::hooks();
+  trace::Hooks hooks;
+  hooks.zoneBegin = &zoneBegin;
+  hooks.zoneEnd = &zoneEnd;
+  trace::hooks(hooks);
+  s.depth = 0;
+  s.installed = true;
+}
+
+void uninstall() {
+  State& s = state();
+  s.installed = false;
+  trace::hooks(s.previous);
+  s.previous = trace::Hooks();
+}
+
+void clear() { state().counters.clear(); }
+
+void count(std::size_t bytes) {
+  State& s = state();
+  if (!s.installed || s.counting) return;
+  s.counting = true;
+  const char* name = "(outside solver)";
+  size_type level = -1;
+  if (s.depth > 0 && s.depth <= maxDepth) {
+    name = s.stack[s.depth - 1].name;
+    level = s.stack[s.depth - 1].level;
+  }
+  PhaseAllocations& c = s.counters[name];
+  if (c.phase.empty()) {
+    c.phase = name;
+    c.level = level;
+  }
+  ++c.allocations;
+  c.bytes += bytes;
+  s.counting = false;
+}
+
+std::vector<PhaseAllocations> report() {
+  State& s = state();
+  std::vector<PhaseAllocations> result;
+  result.reserve(s.counters.size());
+  for (std::map<std::string, PhaseAllocations>::const_iterator it =
+           s.counters.begin();
+       it != s.counters.end(); ++it)
+    result.push_back(it->second);
+  return result;
+}
+
+std::size_t totalAllocations() {
+  State& s = state();
+  std::size_t total = 0;
+  for (std::map<std::string, PhaseAllocations>::const_iterator it =
+           s.counters.begin();
+       it != s.counters.end(); ++it)
+    total += it->second.allocations;
+  return total;
+}
+}  // namespace audit
+}  // namespace solver
+}  // namespace constraints
+}  // namespace hpp
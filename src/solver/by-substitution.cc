@@ -29,6 +29,7 @@
 #include <boost/serialization/nvp.hpp>
 #include <hpp/constraints/active-set-differentiable-function.hh>
 #include <hpp/constraints/macros.hh>
+#include <hpp/constraints/packed-mask.hh>
 #include <hpp/constraints/solver/by-substitution.hh>
 #include <hpp/constraints/solver/impl/by-substitution.hh>
 #include <hpp/constraints/solver/impl/hierarchical-iterative.hh>
@@ -93,7 +94,8 @@ bool BySubstitution::add(const ImplicitPtr_t& nm, const std::size_t& priority) {
   if (addedAsExplicit) {
     // If added as explicit, add to the list of constraint of Hierarchical
     // iterative
-    constraints_.push_back(nm);
+    copyConstraintsOnWrite();
+    registerConstraint(nm);
     hppDout(info,
             "Numerical constraint added as explicit function: "
                 << enm->explicitFunction()->name() << "with "
@@ -138,7 +140,7 @@ segments_t BySubstitution::implicitDof() const {
 // Note that the jacobian of the implicit constraints have already
 // been computed by computeValue <true>
 // The Jacobian of the implicit constraint of priority i is stored in
-// datas_ [i].jacobian
+// context_.datas [i].jacobian
 void BySubstitution::updateJacobian(vectorIn_t arg) const {
   if (explicit_.inDers().nbCols() == 0) return;
   /*                                ------
@@ -155,7 +157,7 @@ void BySubstitution::updateJacobian(vectorIn_t arg) const {
                                                  << pretty_print(Je_));
 
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
-    Data& d = datas_[i];
+    Data& d = context_.datas[i];
     hppDnum(
         info,
         "Jacobian of stack "
@@ -164,6 +166,9 @@ void BySubstitution::updateJacobian(vectorIn_t arg) const {
             << iendl
             << pretty_print(
                    explicit_.outDers().transpose().rview(d.jacobian).eval()));
+    // computeValue leaves the reduced Jacobian of up-to-date levels
+    // untouched; re-gather it so the term below is added exactly once.
+    d.reducedJ = d.activeRowsOfJ.rview(d.jacobian);
     d.reducedJ.noalias() += Eigen::MatrixBlocksRef<>(d.activeRowsOfJ.keepRows(),
                                                      explicit_.outDers())
                                 .rview(d.jacobian)
@@ -176,7 +181,7 @@ void BySubstitution::updateJacobian(vectorIn_t arg) const {
 }
 
 void BySubstitution::computeActiveRowsOfJ(std::size_t iStack) {
-  Data& d = datas_[iStack];
+  Data& d = context_.datas[iStack];
   const ImplicitConstraintSet::Implicits_t constraints(
       stacks_[iStack].constraints());
   std::size_t row = 0;
@@ -187,22 +192,24 @@ void BySubstitution::computeActiveRowsOfJ(std::size_t iStack) {
 
   typedef Eigen::MatrixBlocks<false, false> BlockIndices;
 
-  ArrayXb adpF, adpC;
+  // Free variables as a packed mask: the first activity test of each
+  // constraint is a word-wise intersection instead of a byte-per-flag
+  // gather.
+  const PackedMask freeMask(freeVariables_.indices(), configSpace_->nv());
+
+  ArrayXb adpF, adpC, inDeps;
   BlockIndices::segments_t rows;
+  PackedMask deps(segments_t(), configSpace_->nv());
   for (std::size_t i = 0; i < constraints.size(); ++i) {
-    bool active;
+    const PackedMask adp(
+        constraints[i]->function().activeDerivativeParameters());
 
     // Test on the variable left free by the explicit solver.
-    adpF = freeVariables_
-               .rview(constraints[i]
-                          ->function()
-                          .activeDerivativeParameters()
-                          .matrix())
-               .eval()
-               .array();
-    active = adpF.any();
-    if (!active && explicitIOdep.size() > 0) {
-      // Test on the variable constrained by the explicit solver.
+    bool active = freeMask.intersects(adp);
+    bool explicitDep = false;
+    if (explicitIOdep.size() > 0) {
+      // Input dofs the constraint depends on through the variables
+      // constrained by the explicit solver.
       adpC = explicit_.outDers()
                  .rview(constraints[i]
                             ->function()
@@ -213,9 +220,21 @@ void BySubstitution::computeActiveRowsOfJ(std::size_t iStack) {
       adpF = (explicitIOdep.transpose() * adpC.cast<int>().matrix())
                  .array()
                  .cast<bool>();
-      active = adpF.any();
+      explicitDep = adpF.any();
+      active = active || explicitDep;
     }
     if (active) {  // If at least one element of adp is true
+      deps |= adp;
+      if (explicitDep) {
+        // adpF is indexed over the gathered explicit inputs; scatter it
+        // back to full derivative indexing before packing.
+        inDeps = ArrayXb::Constant(configSpace_->nv(), false);
+        size_type c = 0;
+        for (const segment_t s : explicit_.inDers().indices())
+          for (size_type j = 0; j < s.second; ++j, ++c)
+            if (adpF[c]) inDeps[s.first + j] = true;
+        deps |= PackedMask(inDeps);
+      }
       for (const segment_t s : constraints[i]->activeRows()) {
         rows.emplace_back(s.first + row, s.second);
       }
@@ -225,6 +244,18 @@ void BySubstitution::computeActiveRowsOfJ(std::size_t iStack) {
   d.activeRowsOfJ =
       Eigen::MatrixBlocks<false, false>(rows, freeVariables_.m_rows);
   d.activeRowsOfJ.updateRows<true, true, true>();
+  d.stepDependencies = deps;
+}
+
+void BySubstitution::computeActiveColsOfJ(std::size_t iStack) {
+  // The chain rule applied in updateJacobian makes columns beyond the
+  // active derivative parameters of the functions non-zero, so no
+  // column can be pruned here.
+  Data& d = context_.datas[iStack];
+  segments_t all;
+  if (freeVariables_.nbIndices() > 0)
+    all.push_back(segment_t(0, freeVariables_.nbIndices()));
+  d.activeCols = Eigen::ColBlockIndices(all);
 }
 
 void BySubstitution::projectVectorOnKernel(ConfigurationIn_t arg,
@@ -241,15 +272,15 @@ void BySubstitution::projectVectorOnKernel(ConfigurationIn_t arg,
   svd_.compute(reducedJ_);
 
   // TODO the output of explicit solver should be set to zero ?
-  dqSmall_ = freeVariables_.rview(darg);
+  context_.dqSmall = freeVariables_.rview(darg);
 
   size_type rank = svd_.rank();
-  vector_t tmp(getV1(svd_, rank).adjoint() * dqSmall_);
-  dqSmall_.noalias() -= getV1(svd_, rank) * tmp;
+  vector_t tmp(getV1(svd_, rank).adjoint() * context_.dqSmall);
+  context_.dqSmall.noalias() -= getV1(svd_, rank) * tmp;
 
   // Otherwise two uninitialized values may sum up to NaN
   result.setZero();
-  freeVariables_.lview(result) = dqSmall_;
+  freeVariables_.lview(result) = context_.dqSmall;
 }
 
 void BySubstitution::projectOnKernel(ConfigurationIn_t from,
@@ -271,7 +302,15 @@ void BySubstitution::projectOnKernel(ConfigurationIn_t from,
   assert(hpp::pinocchio::checkNormalized(M));
   Lge_t P(O + OP_);
   assert(hpp::pinocchio::checkNormalized(P));
-  saturate_->saturate(P.vector(), result, saturation_);
+  saturate_->saturate(P.vector(), result, context_.saturation);
+}
+
+BySubstitution::MemoryUsageReport BySubstitution::memoryUsage() const {
+  MemoryUsageReport report(HierarchicalIterative::memoryUsage());
+  report.explicitSet =
+      explicit_.memoryUsage().total() +
+      sizeof(value_type) * (std::size_t)(Je_.size() + JeExpanded_.size());
+  return report;
 }
 
 std::ostream& BySubstitution::print(std::ostream& os) const {
@@ -281,12 +320,18 @@ std::ostream& BySubstitution::print(std::ostream& os) const {
   return os;
 }
 
-vector_t BySubstitution::rightHandSideFromConfig(ConfigurationIn_t config) {
+void BySubstitution::rightHandSideFromConfig(ConfigurationIn_t config,
+                                             vectorOut_t rhs) {
   const size_type top = parent_t::rightHandSideSize();
   const size_type bot = explicit_.rightHandSideSize();
-  vector_t rhs(top + bot);
-  rhs.head(top) = parent_t::rightHandSideFromConfig(config);
+  assert(rhs.size() == top + bot);
+  parent_t::rightHandSideFromConfig(config, rhs.head(top));
   rhs.tail(bot) = explicit_.rightHandSideFromInput(config);
+}
+
+vector_t BySubstitution::rightHandSideFromConfig(ConfigurationIn_t config) {
+  vector_t rhs(rightHandSideSize());
+  rightHandSideFromConfig(config, rhs);
   return rhs;
 }
 
@@ -324,16 +369,39 @@ void BySubstitution::rightHandSide(vectorIn_t rhs) {
   const size_type top = parent_t::rightHandSideSize();
   const size_type bot = explicit_.rightHandSideSize();
   parent_t::rightHandSide(rhs.head(top));
-  explicit_.rightHandSide(rhs.head(bot));
+  explicit_.rightHandSide(rhs.tail(bot));
+}
+
+BySubstitution::Snapshot BySubstitution::snapshot() const {
+  Snapshot s(parent_t::snapshot());
+  // Replace the implicit only right hand side with the full one,
+  // explicit part included.
+  s.rightHandSide = rightHandSide();
+  return s;
 }
 
 vector_t BySubstitution::rightHandSide() const {
+  vector_t rhs(rightHandSideSize());
+  getRightHandSide(rhs);
+  return rhs;
+}
+
+void BySubstitution::getRightHandSide(vectorOut_t rhs) const {
   const size_type top = parent_t::rightHandSideSize();
   const size_type bot = explicit_.rightHandSideSize();
-  vector_t rhs(top + bot);
-  rhs.head(top) = parent_t::rightHandSide();
-  rhs.tail(bot) = explicit_.rightHandSide();
-  return rhs;
+  assert(rhs.size() == top + bot);
+  parent_t::getRightHandSide(rhs.head(top));
+  explicit_.getRightHandSide(rhs.tail(bot));
+}
+
+const vector_t& BySubstitution::rightHandSideView() const {
+  if (!rhsViewValid_) {
+    // No-op when the structure did not change since the last gather.
+    rhsView_.resize(rightHandSideSize());
+    getRightHandSide(rhsView_);
+    rhsViewValid_ = true;
+  }
+  return rhsView_;
 }
 
 size_type BySubstitution::rightHandSideSize() const {
@@ -375,14 +443,26 @@ void BySubstitution::save(Archive& ar, const unsigned int version) const {
 HPP_SERIALIZATION_SPLIT_IMPLEMENT(BySubstitution);
 
 template BySubstitution::Status BySubstitution::impl_solve(
-    vectorOut_t arg, bool optimize, lineSearch::Constant lineSearch) const;
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
+    lineSearch::Constant lineSearch) const;
 template BySubstitution::Status BySubstitution::impl_solve(
-    vectorOut_t arg, bool optimize, lineSearch::Backtracking lineSearch) const;
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
+    lineSearch::Backtracking lineSearch) const;
 template BySubstitution::Status BySubstitution::impl_solve(
-    vectorOut_t arg, bool optimize, lineSearch::FixedSequence lineSearch) const;
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
+    lineSearch::FixedSequence lineSearch) const;
 template BySubstitution::Status BySubstitution::impl_solve(
-    vectorOut_t arg, bool optimize,
+    vectorOut_t arg, bool optimize, value_type squaredThreshold,
     lineSearch::ErrorNormBased lineSearch) const;
+
+template std::vector<BySubstitution::Status> BySubstitution::solveSequence(
+    matrixOut_t args, lineSearch::Constant lineSearch) const;
+template std::vector<BySubstitution::Status> BySubstitution::solveSequence(
+    matrixOut_t args, lineSearch::Backtracking lineSearch) const;
+template std::vector<BySubstitution::Status> BySubstitution::solveSequence(
+    matrixOut_t args, lineSearch::FixedSequence lineSearch) const;
+template std::vector<BySubstitution::Status> BySubstitution::solveSequence(
+    matrixOut_t args, lineSearch::ErrorNormBased lineSearch) const;
 }  // namespace solver
 }  // namespace constraints
 }  // namespace hpp
@@ -0,0 +1,158 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: Florent Lamiraux
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
+#include <cmath>
+#include <hpp/constraints/solver/corpus.hh>
+#include <hpp/util/serialization.hh>
+#include <pinocchio/serialization/eigen.hpp>
+#include <sstream>
+
+namespace boost {
+namespace serialization {
+template <class Archive>
+void serialize(Archive& ar, hpp::constraints::solver::Corpus::Record& record,
+               const unsigned int version) {
+  (void)version;
+  ar& make_nvp("solver", record.solver);
+  ar& make_nvp("seed", record.seed);
+  ar& make_nvp("rightHandSide", record.rightHandSide);
+}
+}  // namespace serialization
+}  // namespace boost
+
+namespace hpp {
+namespace constraints {
+namespace solver {
+void Corpus::record(const BySubstitution& solver, vectorIn_t seed) {
+  Record r;
+  r.solver = shared_ptr<BySubstitution>(new BySubstitution(solver));
+  r.seed = seed;
+  r.rightHandSide = solver.rightHandSide();
+  records_.push_back(r);
+}
+
+std::ostream& Corpus::Statistics::print(std::ostream& os) const {
+  os << "line search " << lineSearch << ": " << nbSuccess << "/" << nbProblems
+     << " solved, iterations [" << minIterations << ", " << maxIterations
+     << "] mean " << meanIterations << ", total time " << totalTime << "s";
+  return os;
+}
+
+void Corpus::Profile::apply(HierarchicalIterative& solver) const {
+  if (maxIterations > 0) solver.maxIterations(maxIterations);
+}
+
+HierarchicalIterative::Status Corpus::Profile::solve(
+    const HierarchicalIterative& solver, vectorOut_t arg) const {
+  switch (strategy) {
+    case FIXED_SEQUENCE:
+      return solver.solve(arg, fixedSequence);
+    case ERROR_NORM_BASED:
+    default:
+      return solver.solve(arg, errorNormBased);
+  }
+}
+
+Corpus::TuningOptions::TuningOptions() : iterationMargin(1.25) {
+  // Neighborhoods of the hard-coded defaults (.2, .95, .8) and of the
+  // usual alphaMin = 0.2.
+  fixedSequenceAlpha = {0.1, 0.2, 0.3};
+  fixedSequenceAlphaMax = {0.9, 0.95, 1.0};
+  fixedSequenceK = {0.7, 0.8, 0.9};
+  errorNormBasedAlphaMin = {0.1, 0.2, 0.3, 0.4};
+}
+
+namespace {
+/// Ordering of the replays of \ref Corpus::tune: more problems solved
+/// first, ties broken by mean iteration count, then by total time.
+bool betterReplay(const Corpus::Statistics& a, const Corpus::Statistics& b) {
+  if (a.nbSuccess != b.nbSuccess) return a.nbSuccess > b.nbSuccess;
+  if (a.meanIterations != b.meanIterations)
+    return a.meanIterations < b.meanIterations;
+  return a.totalTime < b.totalTime;
+}
+}  // namespace
+
+Corpus::Profile Corpus::tune(const TuningOptions& options) const {
+  Profile best;
+  bool first = true;
+
+  for (std::size_t ia = 0; ia < options.fixedSequenceAlpha.size(); ++ia)
+    for (std::size_t im = 0; im < options.fixedSequenceAlphaMax.size(); ++im)
+      for (std::size_t ik = 0; ik < options.fixedSequenceK.size(); ++ik) {
+        lineSearch::FixedSequence ls;
+        ls.alpha = options.fixedSequenceAlpha[ia];
+        ls.alphaMax = options.fixedSequenceAlphaMax[im];
+        ls.K = options.fixedSequenceK[ik];
+        std::ostringstream name;
+        name << "FixedSequence(" << ls.alpha << ", " << ls.alphaMax << ", "
+             << ls.K << ")";
+        Statistics stats(replay(name.str(), ls));
+        if (first || betterReplay(stats, best.statistics)) {
+          best.strategy = Profile::FIXED_SEQUENCE;
+          best.fixedSequence = ls;
+          best.statistics = stats;
+          first = false;
+        }
+      }
+
+  for (std::size_t i = 0; i < options.errorNormBasedAlphaMin.size(); ++i) {
+    lineSearch::ErrorNormBased ls(options.errorNormBasedAlphaMin[i]);
+    std::ostringstream name;
+    name << "ErrorNormBased(" << options.errorNormBasedAlphaMin[i] << ")";
+    Statistics stats(replay(name.str(), ls));
+    if (first || betterReplay(stats, best.statistics)) {
+      best.strategy = Profile::ERROR_NORM_BASED;
+      best.errorNormBased = ls;
+      best.statistics = stats;
+      first = false;
+    }
+  }
+
+  // Derive the iteration budget from the winning replay only when it
+  // solved everything: the counts of failed problems are clipped by
+  // the current budget and say nothing about the needed one.
+  if (best.statistics.nbProblems > 0 &&
+      best.statistics.nbSuccess == best.statistics.nbProblems)
+    best.maxIterations = (size_type)std::ceil(
+        options.iterationMargin * (value_type)best.statistics.maxIterations);
+  return best;
+}
+
+template <class Archive>
+void Corpus::serialize(Archive& ar, const unsigned int version) {
+  (void)version;
+  ar& BOOST_SERIALIZATION_NVP(records_);
+}
+
+HPP_SERIALIZATION_IMPLEMENT(Corpus);
+}  // namespace solver
+}  // namespace constraints
+}  // namespace hpp
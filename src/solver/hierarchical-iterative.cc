@@ -30,8 +30,10 @@
 #include <boost/serialization/vector.hpp>
 #include <hpp/constraints/implicit.hh>
 #include <hpp/constraints/macros.hh>
+#include <hpp/constraints/packed-mask.hh>
 #include <hpp/constraints/solver/hierarchical-iterative.hh>
 #include <hpp/constraints/solver/impl/hierarchical-iterative.hh>
+#include <hpp/constraints/solver/trace.hh>
 #include <hpp/constraints/svd.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint-collection.hh>
@@ -42,43 +44,134 @@
 #include <hpp/util/serialization.hh>
 #include <hpp/util/timer.hh>
 #include <limits>
+#include <list>
+#include <map>
 #include <pinocchio/multibody/model.hpp>
 #include <pinocchio/serialization/eigen.hpp>
+#include <thread>
 
 // #define SVD_THRESHOLD Eigen::NumTraits<value_type>::dummy_precision()
 #define SVD_THRESHOLD 1e-8
 
+// Per-level evaluation counters and timers, compiled to nothing unless
+// the SOLVER_TIMINGS cmake option is on. See
+// HierarchicalIterative::performanceReport.
+#ifdef HPP_CONSTRAINTS_SOLVER_TIMINGS
+#include <chrono>
+#define HPP_SOLVER_TIMING_NOW(t) \
+  std::chrono::steady_clock::time_point t(std::chrono::steady_clock::now())
+#define HPP_SOLVER_TIMING_ADD(t, counter)                          \
+  counter += std::chrono::duration_cast<std::chrono::nanoseconds>( \
+                 std::chrono::steady_clock::now() - (t))           \
+                 .count()
+#define HPP_SOLVER_TIMING_COUNT(counter) ++(counter)
+#else
+#define HPP_SOLVER_TIMING_NOW(t) ((void)0)
+#define HPP_SOLVER_TIMING_ADD(t, counter) ((void)0)
+#define HPP_SOLVER_TIMING_COUNT(counter) ((void)0)
+#endif
+
 namespace hpp {
 namespace constraints {
 namespace solver {
 namespace {
-template <bool Superior, bool ComputeJac, typename Derived>
-void compare(value_type& val, const Eigen::MatrixBase<Derived>& jac,
-             const value_type& thr) {
-  if ((Superior && val < thr) || (!Superior && -thr < val)) {
-    if (Superior)
-      val -= thr;
-    else
-      val += thr;
-  } else {
-    val = 0;
-    if (ComputeJac)
-      const_cast<Eigen::MatrixBase<Derived>&>(jac).derived().setZero();
-  }
+// Branch-free handling of the inequality rows over a whole error
+// vector. sign is +1 on Superior rows, -1 on Inferior rows and 0
+// elsewhere (see Data::inequalitySign); an inequality row is satisfied
+// when sign * value >= threshold, in which case its error - and its
+// Jacobian row when ComputeJac - is zeroed, otherwise the threshold is
+// folded into the error.
+void applyComparisonOnValue(vectorIn_t sign, vectorOut_t value,
+                            const value_type& thr) {
+  value.array() = ((sign.array() == 0) || (sign.array() * value.array() < thr))
+                      .cast<value_type>() *
+                  (value.array() - thr * sign.array());
 }
 
 template <bool ComputeJac>
-void applyComparison(const ComparisonTypes_t comparison,
-                     const std::vector<std::size_t>& indices, vector_t& value,
-                     matrix_t& jacobian, const value_type& thr) {
-  for (std::size_t i = 0; i < indices.size(); ++i) {
-    const std::size_t j = indices[i];
-    if (comparison[j] == Superior) {
-      compare<true, ComputeJac>(value[j], jacobian.row(j), thr);
-    } else if (comparison[j] == Inferior) {
-      compare<false, ComputeJac>(value[j], jacobian.row(j), thr);
-    }
+void applyComparison(const vector_t& sign, vectorOut_t keep, vectorOut_t value,
+                     matrixOut_t jacobian, const value_type& thr) {
+  if (ComputeJac) {
+    // Materialize the row selection so that the Jacobian masking below
+    // broadcasts a plain vector instead of re-evaluating an expression.
+    keep.array() = ((sign.array() == 0) ||
+                    (sign.array() * value.array() < thr))
+                       .cast<value_type>();
+    jacobian.array().colwise() *= keep.array();
+  }
+  applyComparisonOnValue(sign, value, thr);
+}
+
+// Tell whether one block of a configuration space integrates as a
+// plain addition. See HierarchicalIterative::buildIntegrationPlan.
+struct IsVectorSpaceVisitor : public boost::static_visitor<bool> {
+  template <int N, bool rot>
+  bool operator()(
+      const hpp::pinocchio::liegroup::VectorSpaceOperation<N, rot>&) const {
+    return true;
+  }
+  template <typename LgT>
+  bool operator()(const LgT&) const {
+    return false;
+  }
+};
+
+// Integrate one non Euclidean block of the configuration space.
+struct IntegrateBlockVisitor : public boost::static_visitor<> {
+  IntegrateBlockVisitor(vectorIn_t q, vectorIn_t v, vectorOut_t result)
+      : q_(q), v_(v), result_(result) {}
+  template <typename LgT>
+  void operator()(const LgT& lg) {
+    lg.integrate(q_, v_, result_);
   }
+  vectorIn_t q_, v_;
+  vectorOut_t result_;
+};
+
+// Equivalent to out = svd.solve (in), except that the intermediate
+// products are written into the preallocated workspace rhs so that no
+// heap allocation occurs. rhs must be at least as long as the rank.
+template <typename SVD>
+void svdSolveInPlace(const SVD& svd, vectorOut_t rhs, vectorIn_t in,
+                     vectorOut_t out) {
+  const size_type rank = svd.rank();
+  rhs.head(rank).noalias() = svd.matrixU().leftCols(rank).adjoint() * in;
+  rhs.head(rank).array() /= svd.singularValues().head(rank).array();
+  out.noalias() = svd.matrixV().leftCols(rank) * rhs.head(rank);
+}
+
+// Carve a view of the given size out of buffer and advance it, or only
+// count when buffer is NULL. See HierarchicalIterative::bindScratch.
+template <typename MapType>
+size_type carve(MapType& map, value_type*& buffer, size_type rows,
+                size_type cols) {
+  if (buffer) {
+    new (&map) MapType(buffer, rows, cols);
+    buffer += rows * cols;
+  }
+  return rows * cols;
+}
+
+size_type carve(Eigen::Map<vector_t>& map, value_type*& buffer,
+                size_type size) {
+  if (buffer) {
+    new (&map) Eigen::Map<vector_t>(buffer, size);
+    buffer += size;
+  }
+  return size;
+}
+
+// Rebind a view into another arena, keeping its size and offset.
+template <typename MapType>
+void retarget(MapType& map, value_type* base, const value_type* oldBase) {
+  if (map.data() == NULL) return;
+  new (&map) MapType(base + (map.data() - oldBase), map.rows(), map.cols());
+}
+
+void retarget(Eigen::Map<vector_t>& map, value_type* base,
+              const value_type* oldBase) {
+  if (map.data() == NULL) return;
+  new (&map) Eigen::Map<vector_t>(base + (map.data() - oldBase), map.size());
 }
 }  // namespace
 
@@ -145,137 +238,369 @@ bool Bounds::saturate(vectorIn_t q, vectorOut_t qSat,
 }
 
 bool Device::saturate(vectorIn_t q, vectorOut_t qSat, Eigen::VectorXi& sat) {
-  bool ret = false;
-  const pinocchio::Model& m = device->model();
-
-  for (std::size_t i = 1; i < m.joints.size(); ++i) {
-    const size_type nq = m.joints[i].nq();
-    const size_type nv = m.joints[i].nv();
-    const size_type idx_q = m.joints[i].idx_q();
-    const size_type idx_v = m.joints[i].idx_v();
-    for (size_type j = 0; j < nq; ++j) {
-      const size_type iq = idx_q + j;
-      const size_type iv = idx_v + std::min(j, nv - 1);
-      if (clamp(m.lowerPositionLimit[iq], m.upperPositionLimit[iq], q[iq],
-                qSat[iq], sat[iv]))
-        ret = true;
+  // Bake the bounds and the configuration-to-velocity index mapping
+  // into contiguous vectors, so that the clamp below runs over the
+  // whole configuration without any virtual joint accessor.
+  if (lower.size() != q.size()) {
+    const pinocchio::Model& m = device->model();
+    const hpp::pinocchio::ExtraConfigSpace& ecs = device->extraConfigSpace();
+    const size_type d = ecs.dimension();
+    lower.resize(m.nq + d);
+    upper.resize(m.nq + d);
+    qToV.resize(m.nq + d);
+    lower.head(m.nq) = m.lowerPositionLimit;
+    upper.head(m.nq) = m.upperPositionLimit;
+    for (std::size_t i = 1; i < m.joints.size(); ++i) {
+      const size_type nq = m.joints[i].nq();
+      const size_type nv = m.joints[i].nv();
+      const size_type idx_q = m.joints[i].idx_q();
+      const size_type idx_v = m.joints[i].idx_v();
+      for (size_type j = 0; j < nq; ++j)
+        qToV[idx_q + j] = (int)(idx_v + std::min(j, nv - 1));
+    }
+    for (size_type k = 0; k < d; ++k) {
+      lower[m.nq + k] = ecs.lower(k);
+      upper[m.nq + k] = ecs.upper(k);
+      qToV[m.nq + k] = (int)(m.nv + k);
     }
   }
 
-  const hpp::pinocchio::ExtraConfigSpace& ecs = device->extraConfigSpace();
-  const size_type& d = ecs.dimension();
-
-  for (size_type k = 0; k < d; ++k) {
-    const size_type iq = m.nq + k;
-    const size_type iv = m.nv + k;
-    if (clamp(ecs.lower(k), ecs.upper(k), q[iq], qSat[iq], sat[iv])) ret = true;
-  }
-  return ret;
+  assert(q.size() == lower.size());
+  qSat = q.cwiseMax(lower).cwiseMin(upper);
+  // -1 on a lower bound hit, 1 on an upper bound hit; the lower bound
+  // wins when the two limits are equal, as in the scalar clamp.
+  satQ = (q.array() >= upper.array()).cast<int>() -
+         (q.array() <= lower.array()).cast<int>() *
+             (1 + (q.array() >= upper.array()).cast<int>());
+  // Scatter to velocity indexing; on joints with more configuration
+  // than velocity variables the last configuration variable wins, as
+  // in the former per-joint loop.
+  for (size_type i = 0; i < qToV.size(); ++i) sat[qToV[i]] = satQ[i];
+  return (satQ != 0).any();
 }
 }  // namespace saturation
 
-typedef std::pair<DifferentiableFunctionPtr_t, size_type> iqIt_t;
-typedef std::pair<DifferentiableFunctionPtr_t, std::size_t> priorityIt_t;
+HierarchicalIterative::Data::Data()
+    : error(NULL, 0),
+      jacobian(NULL, 0, 0),
+      reducedJ(NULL, 0, 0),
+      jacobianReduced(NULL, 0, 0),
+      directJacobian(false),
+      reducedJ6(NULL, 6, 0),
+      useSvd6(false),
+      JJt(NULL, 0, 0),
+      JP(NULL, 0, 0),
+      reducedError(NULL, 0),
+      svdRhs(NULL, 0),
+      Jdq(NULL, 0),
+      JV(NULL, 0, 0),
+      vJV(NULL, 0),
+      broydenError(NULL, 0),
+      reducedJcompact(NULL, 0, 0),
+      dqCompact(NULL, 0),
+      lastArg(NULL, 0),
+      lastArgValid(false),
+      lastJacValid(false),
+      maxRank(0),
+      inequalityKeep(NULL, 0),
+      decompositionValid(false) {}
+
+void HierarchicalIterative::Data::retargetScratch(value_type* base,
+                                                  const value_type* oldBase) {
+  retarget(error, base, oldBase);
+  retarget(inequalityKeep, base, oldBase);
+  retarget(jacobian, base, oldBase);
+  retarget(reducedJ, base, oldBase);
+  retarget(jacobianReduced, base, oldBase);
+  retarget(reducedJ6, base, oldBase);
+  retarget(JJt, base, oldBase);
+  retarget(JP, base, oldBase);
+  retarget(reducedError, base, oldBase);
+  retarget(svdRhs, base, oldBase);
+  retarget(Jdq, base, oldBase);
+  retarget(JV, base, oldBase);
+  retarget(vJV, base, oldBase);
+  retarget(broydenError, base, oldBase);
+  retarget(reducedJcompact, base, oldBase);
+  retarget(dqCompact, base, oldBase);
+  retarget(lastArg, base, oldBase);
+}
+
+HierarchicalIterative::SolveContext::SolveContext(const SolveContext& other) {
+  *this = other;
+}
+
+HierarchicalIterative::SolveContext& HierarchicalIterative::SolveContext::
+operator=(const SolveContext& other) {
+  // Copy-construct the datas instead of assigning them: assigning an
+  // Eigen::Map copies coefficients through the current pointer, while
+  // copy construction copies the view itself.
+  std::vector<Data>(other.datas).swap(datas);
+  sigma = other.sigma;
+  dq = other.dq;
+  dqSmall = other.dqSmall;
+  dqTmp = other.dqTmp;
+  saturation = other.saturation;
+  reducedSaturation = other.reducedSaturation;
+  qSat = other.qSat;
+  lastSaturation = other.lastSaturation;
+  satCols = other.satCols;
+  saturationValid = other.saturationValid;
+  squaredNorm = other.squaredNorm;
+  telemetry = other.telemetry;
+  arena = other.arena;
+  movedDofs = other.movedDofs;
+  interrupt = other.interrupt;
+  // The scratch views of the copied datas still point into the arena of
+  // other; retarget them to the copy.
+  for (std::size_t i = 0; i < datas.size(); ++i)
+    datas[i].retargetScratch(arena.data(), other.arena.data());
+  return *this;
+}
+
+/// Bounded memory of the squared error norms computed by isSatisfied.
+/// Entries pair a copy of the configuration with the norm computed for
+/// it and are valid only for the right hand side generation they were
+/// stored under; the least recently asked entry is evicted first.
+class HierarchicalIterative::SatisfactionCache {
+ public:
+  explicit SatisfactionCache(std::size_t capacity) : capacity_(capacity) {}
+
+  std::size_t capacity() const { return capacity_; }
+
+  /// \retval squaredNorm the remembered norm, written on a hit only.
+  /// \return whether arg was stored under the given generation. On a
+  ///         hit the entry becomes the most recently used.
+  bool find(vectorIn_t arg, std::size_t generation, value_type& squaredNorm) {
+    std::pair<Index_t::iterator, Index_t::iterator> range(
+        index_.equal_range(hash(arg)));
+    for (Index_t::iterator it = range.first; it != range.second; ++it) {
+      const Entries_t::iterator e = it->second;
+      if (e->generation == generation && e->config.size() == arg.size() &&
+          e->config == arg) {
+        entries_.splice(entries_.begin(), entries_, e);
+        squaredNorm = e->squaredNorm;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Remember the squared norm of arg, evicting the least recently
+  /// used entry when the cache is full.
+  void store(vectorIn_t arg, std::size_t generation, value_type squaredNorm) {
+    if (entries_.size() >= capacity_) {
+      Entries_t::iterator last(--entries_.end());
+      std::pair<Index_t::iterator, Index_t::iterator> range(
+          index_.equal_range(last->hash));
+      for (Index_t::iterator it = range.first; it != range.second; ++it)
+        if (it->second == last) {
+          index_.erase(it);
+          break;
+        }
+      entries_.pop_back();
+    }
+    Entry e;
+    e.hash = hash(arg);
+    e.generation = generation;
+    e.config = arg;
+    e.squaredNorm = squaredNorm;
+    entries_.push_front(e);
+    index_.insert(std::make_pair(e.hash, entries_.begin()));
+  }
+
+ private:
+  struct Entry {
+    std::size_t hash;
+    std::size_t generation;
+    vector_t config;
+    value_type squaredNorm;
+  };
+  /// Most recently used first
+  typedef std::list<Entry> Entries_t;
+  typedef std::unordered_multimap<std::size_t, Entries_t::iterator> Index_t;
+
+  /// FNV-1a combination of the coefficient hashes. Element-wise
+  /// because arg may be a non contiguous reference.
+  static std::size_t hash(vectorIn_t arg) {
+    std::hash<value_type> hasher;
+    std::size_t h = 14695981039346656037ULL;
+    for (size_type i = 0; i < arg.size(); ++i) {
+      h ^= hasher(arg[i]);
+      h *= 1099511628211ULL;
+    }
+    return h;
+  }
+
+  std::size_t capacity_;
+  Entries_t entries_;
+  Index_t index_;
+};
 
 HierarchicalIterative::HierarchicalIterative(
     const LiegroupSpacePtr_t& configSpace)
     : squaredErrorThreshold_(0),
       inequalityThreshold_(0),
+      squaredCoarseErrorThreshold_(0),
       maxIterations_(0),
       stacks_(),
       configSpace_(configSpace),
+      integrationPlan_(),
       dimension_(0),
       reducedDimension_(0),
       lastIsOptional_(false),
       solveLevelByLevel_(false),
+      decomposition_(JACOBI_SVD),
+      choleskyDamping_(1e-2),
+      squaredJacobianTransposeThreshold_(0),
+      squaredIncrementalSvdThreshold_(0),
+      jacobianRefreshPeriod_(1),
       freeVariables_(),
+      freeVariablesPlan_(),
       saturate_(new saturation::Base()),
       constraints_(),
-      iq_(),
-      iv_(),
-      priority_(),
-      sigma_(0),
-      dq_(),
-      dqSmall_(),
+      sharedConstraints_(false),
+      indices_(),
+      functionIndex_(),
+      constraintIndex_(),
+      context_(),
       reducedJ_(),
-      saturation_(configSpace->nv()),
-      reducedSaturation_(),
-      qSat_(configSpace_->nq()),
-      tmpSat_(),
-      squaredNorm_(0),
-      datas_(),
       svd_(),
       OM_(configSpace->nv()),
-      OP_(configSpace->nv()) {
+      OP_(configSpace->nv()),
+      satisfactionCache_(),
+      rhsGeneration_(0),
+      rhsViewValid_(false) {
+  context_.sigma = 0;
+  context_.squaredNorm = 0;
+  context_.saturation.resize(configSpace->nv());
+  context_.qSat.resize(configSpace_->nq());
   // Initialize freeVariables_ to all indices.
   freeVariables_.addRow(0, configSpace_->nv());
+  freeVariablesPlan_.compile(freeVariables_.indices());
+  buildIntegrationPlan();
 }
 
 HierarchicalIterative::HierarchicalIterative(const HierarchicalIterative& other)
     : squaredErrorThreshold_(other.squaredErrorThreshold_),
       inequalityThreshold_(other.inequalityThreshold_),
+      squaredCoarseErrorThreshold_(other.squaredCoarseErrorThreshold_),
       maxIterations_(other.maxIterations_),
       stacks_(other.stacks_),
       configSpace_(other.configSpace_),
+      integrationPlan_(other.integrationPlan_),
       dimension_(other.dimension_),
       reducedDimension_(other.reducedDimension_),
       lastIsOptional_(other.lastIsOptional_),
+      solveLevelByLevel_(other.solveLevelByLevel_),
+      decomposition_(other.decomposition_),
+      choleskyDamping_(other.choleskyDamping_),
+      squaredJacobianTransposeThreshold_(other.squaredJacobianTransposeThreshold_),
+      squaredIncrementalSvdThreshold_(other.squaredIncrementalSvdThreshold_),
+      jacobianRefreshPeriod_(other.jacobianRefreshPeriod_),
       freeVariables_(other.freeVariables_),
+      freeVariablesPlan_(other.freeVariablesPlan_),
       saturate_(other.saturate_),
-      constraints_(other.constraints_.size()),
-      iq_(other.iq_),
-      iv_(other.iv_),
-      priority_(other.priority_),
-      sigma_(other.sigma_),
-      dq_(other.dq_),
-      dqSmall_(other.dqSmall_),
+      constraints_(other.constraints_),
+      sharedConstraints_(true),
+      indices_(other.indices_),
+      functionIndex_(other.functionIndex_),
+      constraintIndex_(other.constraintIndex_),
+      context_(other.context_),
       reducedJ_(other.reducedJ_),
-      saturation_(other.saturation_),
-      reducedSaturation_(other.reducedSaturation_),
-      qSat_(other.qSat_),
-      tmpSat_(other.tmpSat_),
-      squaredNorm_(other.squaredNorm_),
-      datas_(other.datas_),
       svd_(other.svd_),
       OM_(other.OM_),
-      OP_(other.OP_) {
+      OP_(other.OP_),
+      satisfactionCache_(),
+      rhsGeneration_(0),
+      rhsViewValid_(false) {
+  // The memoized isSatisfied results are not shared: the copies will
+  // diverge and sharing the entries would mix their generations. Only
+  // the capacity is inherited.
+  if (other.satisfactionCache_) satisfactionCache(other.satisfactionCache());
+}
+
+void HierarchicalIterative::copyConstraintsOnWrite() {
+  if (!sharedConstraints_) return;
+  sharedConstraints_ = false;
   for (std::size_t i = 0; i < constraints_.size(); ++i)
-    constraints_[i] = other.constraints_[i]->copy();
+    constraints_[i] = constraints_[i]->copy();
+}
+
+void HierarchicalIterative::invalidateValueCache() const {
+  for (std::size_t i = 0; i < context_.datas.size(); ++i) {
+    context_.datas[i].lastArgValid = false;
+    context_.datas[i].lastJacValid = false;
+    // A right hand side change can flip the activity of inequality
+    // rows, which applyComparison folds into the Jacobian.
+    context_.datas[i].decompositionValid = false;
+  }
+  // Memoized isSatisfied results of previous generations are ignored.
+  ++rhsGeneration_;
+  rhsViewValid_ = false;
+}
+
+void HierarchicalIterative::registerConstraint(
+    const ImplicitPtr_t& constraint) {
+  constraintIndex_.insert(std::make_pair(constraint->functionPtr()->name(),
+                                         constraints_.size()));
+  constraints_.push_back(constraint);
+}
+
+const HierarchicalIterative::ConstraintIndices*
+HierarchicalIterative::findConstraintIndices(
+    const DifferentiableFunctionPtr_t& f) const {
+  typedef std::unordered_multimap<std::string, std::size_t>::const_iterator
+      It_t;
+  // Equal functions have equal names, so the name buckets contain all
+  // the candidates. Deep comparison settles name collisions.
+  std::pair<It_t, It_t> range(functionIndex_.equal_range(f->name()));
+  for (It_t it = range.first; it != range.second; ++it) {
+    const ConstraintIndices& ci = indices_[it->second];
+    if (ci.function == f || *ci.function == *f) return &ci;
+  }
+  return NULL;
 }
 
 bool HierarchicalIterative::contains(
     const ImplicitPtr_t& numericalConstraint) const {
-  return find_if(constraints_.begin(), constraints_.end(),
-                 [&numericalConstraint](const ImplicitPtr_t& arg) {
-                   return *arg == *numericalConstraint;
-                 }) != constraints_.end();
+  typedef std::unordered_multimap<std::string, std::size_t>::const_iterator
+      It_t;
+  std::pair<It_t, It_t> range(constraintIndex_.equal_range(
+      numericalConstraint->functionPtr()->name()));
+  for (It_t it = range.first; it != range.second; ++it)
+    if (*constraints_[it->second] == *numericalConstraint) return true;
+  return false;
 }
 
 bool HierarchicalIterative::add(const ImplicitPtr_t& constraint,
                                 const std::size_t& priority) {
+  copyConstraintsOnWrite();
   DifferentiableFunctionPtr_t f(constraint->functionPtr());
-  if (find_if(priority_.begin(), priority_.end(),
-              [&f](const priorityIt_t& arg) { return *arg.first == *f; }) !=
-      priority_.end()) {
+  if (findConstraintIndices(f)) {
     std::ostringstream oss;
     oss << "Contraint \"" << f->name() << "\" already in solver";
     throw std::logic_error(oss.str().c_str());
   }
-  priority_[f] = priority;
   const ComparisonTypes_t comp(constraint->comparisonType());
   assert((size_type)comp.size() == f->outputDerivativeSize());
   const std::size_t minSize = priority + 1;
   if (stacks_.size() < minSize) {
     stacks_.resize(minSize, ImplicitConstraintSet());
-    datas_.resize(minSize, Data());
+    context_.datas.resize(minSize, Data());
   }
-  Data& d = datas_[priority];
+  Data& d = context_.datas[priority];
+  ConstraintIndices ci;
+  ci.function = f;
+  ci.priority = priority;
   // Store rank in output vector value
-  iq_[f] = datas_[priority].output.space()->nq();
+  ci.iq = context_.datas[priority].output.space()->nq();
   // Store rank in output vector derivative
-  iv_[f] = datas_[priority].output.space()->nv();
+  ci.iv = context_.datas[priority].output.space()->nv();
+  functionIndex_.insert(std::make_pair(f->name(), indices_.size()));
+  indices_.push_back(ci);
   // warning adding constraint to the stack modifies behind the stage
-  // the dimension of datas_ [priority].output.space (). It should
+  // the dimension of context_.datas [priority].output.space (). It should
   // therefore be done after the previous lines.
   stacks_[priority].add(constraint);
   for (std::size_t i = 0; i < comp.size(); ++i) {
@@ -287,7 +612,7 @@ bool HierarchicalIterative::add(const ImplicitPtr_t& constraint,
     d.comparison.push_back(comp[i]);
   }
   d.equalityIndices.updateRows<true, true, true>();
-  constraints_.push_back(constraint);
+  registerConstraint(constraint);
   update();
 
   return true;
@@ -299,15 +624,12 @@ void HierarchicalIterative::merge(const HierarchicalIterative& other) {
        it != other.constraints_.end(); ++it) {
     if (!this->contains(*it)) {
       const DifferentiableFunctionPtr_t& f = (*it)->functionPtr();
-      std::map<DifferentiableFunctionPtr_t, std::size_t>::const_iterator itp(
-          std::find_if(
-              other.priority_.begin(), other.priority_.end(),
-              [&f](const priorityIt_t& arg) { return *arg.first == *f; }));
-      if (itp == other.priority_.end()) {
+      const ConstraintIndices* ci(other.findConstraintIndices(f));
+      if (ci == NULL) {
         // If priority is not set, constraint is explicit
         priority = 0;
       } else {
-        priority = itp->second;
+        priority = ci->priority;
       }
       this->add(*it, priority);
     }
@@ -341,106 +663,317 @@ ArrayXb HierarchicalIterative::activeDerivativeParameters() const {
 }
 
 void HierarchicalIterative::update() {
+  // Structural changes discard the memoized isSatisfied results.
+  ++rhsGeneration_;
+  rhsViewValid_ = false;
+  // The free variable plan may change below; the gathered saturation
+  // masks are stale.
+  context_.saturationValid = false;
+  freeVariablesPlan_.compile(freeVariables_.indices());
   // Compute reduced size
   std::size_t reducedSize = freeVariables_.nbIndices();
 
-  dimension_ = 0;
-  reducedDimension_ = 0;
+  // First pass: compute the active rows and columns of each level and
+  // the total scratch size, so that the matrices and vectors of all the
+  // levels are carved out of a single slab. See SolveContext::arena.
+  size_type arenaSize = 0;
+  value_type* counting = NULL;
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
     computeActiveRowsOfJ(i);
+    // Structurally non-zero columns of the reduced Jacobian. On a
+    // single level stack, computeDescentDirection gathers them into a
+    // compact matrix so that the decomposition skips the zero blocks.
+    computeActiveColsOfJ(i);
+    context_.datas[i].directJacobian =
+        directJacobianUsable() &&
+        stacks_[i].function().providesJacobianOnColumns();
+    arenaSize += bindScratch(i, (size_type)reducedSize, counting);
+  }
+  context_.arena.resize(arenaSize);
+  value_type* buffer = context_.arena.data();
 
+  dimension_ = 0;
+  reducedDimension_ = 0;
+  for (std::size_t i = 0; i < stacks_.size(); ++i) {
     const ImplicitConstraintSet& constraints(stacks_[i]);
 #ifndef NDEBUG
     dynamic_cast<const DifferentiableFunctionSet&>(constraints.function());
 #endif
     const DifferentiableFunctionSet& f(
         static_cast<const DifferentiableFunctionSet&>(constraints.function()));
+    Data& d = context_.datas[i];
     dimension_ += f.outputDerivativeSize();
-    reducedDimension_ += datas_[i].activeRowsOfJ.nbRows();
-    datas_[i].output = LiegroupElement(f.outputSpace());
-    datas_[i].rightHandSide = LiegroupElement(f.outputSpace());
-    datas_[i].rightHandSide.setNeutral();
-    datas_[i].error.resize(f.outputSpace()->nv());
+    reducedDimension_ += d.activeRowsOfJ.nbRows();
+    d.output = LiegroupElement(f.outputSpace());
+    d.rightHandSide = LiegroupElement(f.outputSpace());
+    d.rightHandSide.setNeutral();
+
+    // Fold the comparison types into coefficients so that
+    // applyComparison handles every row with vector operations.
+    d.inequalitySign = vector_t::Zero((size_type)d.comparison.size());
+    for (std::size_t j = 0; j < d.comparison.size(); ++j) {
+      if (d.comparison[j] == Superior)
+        d.inequalitySign[(size_type)j] = 1;
+      else if (d.comparison[j] == Inferior)
+        d.inequalitySign[(size_type)j] = -1;
+    }
 
     assert(configSpace_->nv() == f.inputDerivativeSize());
-    datas_[i].jacobian.resize(f.outputDerivativeSize(),
-                              f.inputDerivativeSize());
-    datas_[i].jacobian.setZero();
-    datas_[i].reducedJ.resize(datas_[i].activeRowsOfJ.nbRows(), reducedSize);
-
-    datas_[i].svd = SVD_t(
-        f.outputDerivativeSize(), reducedSize,
+    // Second pass of bindScratch: carve the scratch views of this level
+    // out of the arena.
+    bindScratch(i, (size_type)reducedSize, buffer);
+    d.jacobian.setZero();
+
+    const size_type descentCols =
+        (stacks_.size() == 1 ? d.activeCols.nbCols() : (size_type)reducedSize);
+
+    // Size the decomposition with the matrix it will be given in
+    // computeDescentDirection, i.e. the active rows and columns only,
+    // so that Eigen::JacobiSVD::compute does not reallocate its
+    // workspace at each iteration.
+    d.svd = SVD_t(
+        d.activeRowsOfJ.nbRows(), descentCols,
         Eigen::ComputeThinU | (i == stacks_.size() - 1 ? Eigen::ComputeThinV
                                                        : Eigen::ComputeFullV));
-    datas_[i].svd.setThreshold(SVD_THRESHOLD);
-    datas_[i].PK.resize(reducedSize, reducedSize);
+    d.svd.setThreshold(SVD_THRESHOLD);
+    // A single level whose active error dimension is exactly 6 - the
+    // canonical pose constraint of grasp planning - is decomposed with
+    // a fixed-row-count SVD working on stack-allocated 6x6 blocks.
+    d.useSvd6 = (stacks_.size() == 1 && decomposition_ == JACOBI_SVD &&
+                 d.activeRowsOfJ.nbRows() == 6);
+    if (d.useSvd6) {
+      d.svd6 = SVD6_t(6, descentCols,
+                      Eigen::ComputeThinU | Eigen::ComputeThinV);
+      d.svd6.setThreshold(SVD_THRESHOLD);
+    }
+    // Alternative decompositions are only used when the stack has one
+    // level. See documentation of decomposition(DecompositionMethod).
+    if (stacks_.size() == 1) {
+      switch (decomposition_) {
+        case BDC_SVD:
+          d.bdcSvd = BDCSVD_t(d.activeRowsOfJ.nbRows(), descentCols,
+                              Eigen::ComputeThinU | Eigen::ComputeThinV);
+          d.bdcSvd.setThreshold(SVD_THRESHOLD);
+          break;
+        case COMPLETE_ORTHOGONAL_DECOMPOSITION:
+          d.cod = COD_t(d.activeRowsOfJ.nbRows(), descentCols);
+          d.cod.setThreshold(SVD_THRESHOLD);
+          break;
+        case DAMPED_CHOLESKY:
+          d.llt = LLT_t(d.activeRowsOfJ.nbRows());
+          break;
+        case JACOBI_SVD:
+          break;
+      }
+      // Workspaces of the incremental decomposition. The right singular
+      // subspace of a previous update() is never valid anymore. See
+      // incrementalSvdThreshold.
+      d.previousV.resize(0, 0);
+      if (squaredIncrementalSvdThreshold_ > 0 &&
+          decomposition_ == JACOBI_SVD && !d.useSvd6) {
+        const size_type r =
+            std::min<size_type>(d.activeRowsOfJ.nbRows(), descentCols);
+        d.svdJV = SVD_t(d.activeRowsOfJ.nbRows(), r,
+                        Eigen::ComputeThinU | Eigen::ComputeThinV);
+        d.svdJV.setThreshold(SVD_THRESHOLD);
+      }
+    }
+    d.PK.resize(reducedSize, reducedSize);
+
+    // Input slice this level actually reads, used by computeValue to
+    // skip the re-evaluation of levels whose inputs did not change.
+    d.activeArgs = Eigen::RowBlockIndices(
+        Eigen::BlockIndex::fromLogicalExpression(f.activeParameters()));
+    d.lastArgValid = false;
+    d.lastJacValid = false;
+    d.decompositionValid = false;
+
+#ifdef HPP_CONSTRAINTS_SOLVER_TIMINGS
+    d.nbValueEvaluations = 0;
+    d.nbJacobianEvaluations = 0;
+    d.nbDecompositions = 0;
+    d.valueNanoseconds = 0;
+    d.decompositionNanoseconds = 0;
+#endif
 
-    datas_[i].maxRank = 0;
+    d.maxRank = 0;
   }
+  assert(buffer == context_.arena.data() + arenaSize);
 
-  dq_ = vector_t::Zero(configSpace_->nv());
-  dqSmall_.resize(reducedSize);
+  context_.dq = vector_t::Zero(configSpace_->nv());
+  context_.movedDofs = PackedMask(segments_t(), configSpace_->nv());
+  context_.dqSmall.resize(reducedSize);
+  context_.dqTmp.resize(reducedSize);
   reducedJ_.resize(reducedDimension_, reducedSize);
   svd_ = SVD_t(reducedDimension_, reducedSize,
                Eigen::ComputeThinU | Eigen::ComputeThinV);
 }
 
 void HierarchicalIterative::computeActiveRowsOfJ(std::size_t iStack) {
-  Data& d = datas_[iStack];
+  Data& d = context_.datas[iStack];
   const ImplicitConstraintSet::Implicits_t constraints(
       stacks_[iStack].constraints());
   std::size_t offset = 0;
 
   typedef Eigen::MatrixBlocks<false, false> BlockIndices;
   BlockIndices::segments_t rows;
+  // Free variables as a packed mask: the activity test of each
+  // constraint below is a word-wise intersection instead of a
+  // byte-per-flag gather.
+  const PackedMask freeMask(freeVariables_.indices(), configSpace_->nv());
+  PackedMask deps(segments_t(), configSpace_->nv());
   // Loop over functions of the stack
   for (std::size_t i = 0; i < constraints.size(); ++i) {
-    ArrayXb adp = freeVariables_
-                      .rview(constraints[i]
-                                 ->function()
-                                 .activeDerivativeParameters()
-                                 .matrix())
-                      .eval();
-    if (adp.any())  // If at least one element of adp is true
+    const PackedMask adp(
+        constraints[i]->function().activeDerivativeParameters());
+    if (freeMask.intersects(adp)) {  // The constraint reads a free variable
+      deps |= adp;
       for (const segment_t s : constraints[i]->activeRows()) {
         rows.emplace_back(s.first + offset, s.second);
       }
+    }
     offset += constraints[i]->function().outputDerivativeSize();
   }
   d.activeRowsOfJ =
       Eigen::MatrixBlocks<false, false>(rows, freeVariables_.m_rows);
   d.activeRowsOfJ.updateRows<true, true, true>();
+  // Compile the gather into run plans: contiguous segments merge into
+  // single tiles, so the assembly of reducedJ degenerates to one copy
+  // per maximal tile.
+  d.reducedRowsPlan.compile(d.activeRowsOfJ.rows());
+  d.reducedColsPlan.compile(d.activeRowsOfJ.cols());
+  d.stepDependencies = deps;
+}
+
+void HierarchicalIterative::computeActiveColsOfJ(std::size_t iStack) {
+  Data& d = context_.datas[iStack];
+  const DifferentiableFunction& f(stacks_[iStack].function());
+  const ArrayXb& adp = f.activeDerivativeParameters();
+  ArrayXb reducedActive(freeVariables_.nbIndices());
+  size_type col = 0;
+  const segments_t& freeSegs = freeVariables_.indices();
+  for (std::size_t k = 0; k < freeSegs.size(); ++k) {
+    reducedActive.segment(col, freeSegs[k].second) =
+        adp.segment(freeSegs[k].first, freeSegs[k].second);
+    col += freeSegs[k].second;
+  }
+  d.activeCols = Eigen::ColBlockIndices(
+      Eigen::BlockIndex::fromLogicalExpression(reducedActive));
+}
+
+size_type HierarchicalIterative::bindScratch(std::size_t iStack,
+                                             size_type reducedSize,
+                                             value_type*& buffer) {
+  Data& d = context_.datas[iStack];
+  const DifferentiableFunction& f(stacks_[iStack].function());
+  const size_type nbRows = d.activeRowsOfJ.nbRows();
+  const size_type descentCols =
+      (stacks_.size() == 1 ? d.activeCols.nbCols() : reducedSize);
+  // These conditions mirror the decomposition selection of update();
+  // buffers of the paths not taken get a zero size.
+  const bool useSvd6 =
+      (stacks_.size() == 1 && decomposition_ == JACOBI_SVD && nbRows == 6);
+  const bool useJJt =
+      (stacks_.size() == 1 && decomposition_ == DAMPED_CHOLESKY);
+  const bool useJV =
+      (stacks_.size() == 1 && squaredIncrementalSvdThreshold_ > 0 &&
+       decomposition_ == JACOBI_SVD && !useSvd6);
+  const size_type r = std::min<size_type>(nbRows, descentCols);
+
+  size_type n = 0;
+  n += carve(d.error, buffer, f.outputSpace()->nv());
+  n += carve(d.inequalityKeep, buffer,
+             d.inequalityIndices.empty() ? 0 : f.outputSpace()->nv());
+  // On a direct level the functions write straight into jacobianReduced
+  // and the full width jacobian is never materialized.
+  n += carve(d.jacobian, buffer, f.outputDerivativeSize(),
+             d.directJacobian ? 0 : f.inputDerivativeSize());
+  n += carve(d.jacobianReduced, buffer,
+             d.directJacobian ? f.outputDerivativeSize() : 0,
+             d.directJacobian ? reducedSize : 0);
+  n += carve(d.reducedJ, buffer, nbRows, reducedSize);
+  n += carve(d.reducedJcompact, buffer, nbRows, d.activeCols.nbCols());
+  n += carve(d.dqCompact, buffer, d.activeCols.nbCols());
+  n += carve(d.reducedJ6, buffer, 6, useSvd6 ? descentCols : 0);
+  n += carve(d.JJt, buffer, useJJt ? nbRows : 0, useJJt ? nbRows : 0);
+  n += carve(d.JV, buffer, useJV ? nbRows : 0, useJV ? r : 0);
+  n += carve(d.vJV, buffer, useJV ? r : 0);
+  n += carve(d.JP, buffer, nbRows, reducedSize);
+  n += carve(d.reducedError, buffer, nbRows);
+  n += carve(d.broydenError, buffer, nbRows);
+  n += carve(d.svdRhs, buffer, std::min<size_type>(nbRows, reducedSize));
+  n += carve(d.Jdq, buffer, nbRows);
+  n += carve(d.lastArg, buffer, configSpace_->nq());
+  return n;
 }
 
 vector_t HierarchicalIterative::rightHandSideFromConfig(
     ConfigurationIn_t config) {
+  vector_t rhs(rightHandSideSize());
+  rightHandSideFromConfig(config, rhs);
+  return rhs;
+}
+
+void HierarchicalIterative::rightHandSideFromConfig(ConfigurationIn_t config,
+                                                    vectorOut_t rhs) {
+  assert(rhs.size() == rightHandSideSize());
+  copyConstraintsOnWrite();
+  invalidateValueCache();
+  size_type iq = 0;
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
     ImplicitConstraintSet& ics = stacks_[i];
-    Data& d = datas_[i];
+    Data& d = context_.datas[i];
     ics.rightHandSideFromConfig(config, d.rightHandSide);
+    size_type nq = d.rightHandSide.space()->nq();
+    rhs.segment(iq, nq) = d.rightHandSide.vector();
+    iq += nq;
+  }
+  assert(iq == rhs.size());
+}
+
+void HierarchicalIterative::rightHandSideFromConfig(
+    ConfigurationIn_t config,
+    const std::vector<HierarchicalIterative*>& solvers) {
+  // Value at config of each unique parameterizable function, keyed on
+  // function identity.
+  std::map<DifferentiableFunction*, LiegroupElement> values;
+  for (std::size_t s = 0; s < solvers.size(); ++s) {
+    HierarchicalIterative& solver = *solvers[s];
+    const NumericalConstraints_t& constraints(solver.constraints());
+    for (std::size_t j = 0; j < constraints.size(); ++j) {
+      const ImplicitPtr_t& constraint(constraints[j]);
+      if (constraint->parameterSize() == 0) continue;
+      const DifferentiableFunctionPtr_t& f(constraint->functionPtr());
+      std::map<DifferentiableFunction*, LiegroupElement>::iterator it(
+          values.find(f.get()));
+      if (it == values.end()) {
+        LiegroupElement value(f->outputSpace());
+        f->value(value, config);
+        it = values.insert(std::make_pair(f.get(), value)).first;
+      }
+      LiegroupElement rhs(f->outputSpace());
+      constraint->rightHandSideFromValue(it->second, rhs);
+      // Virtual so that BySubstitution routes the right hand side of
+      // its explicit constraints to the explicit constraint set.
+      solver.rightHandSide(constraint, rhs.vector());
+    }
   }
-  return rightHandSide();
 }
 
 bool HierarchicalIterative::rightHandSideFromConfig(
     const ImplicitPtr_t& constraint, ConfigurationIn_t config) {
+  copyConstraintsOnWrite();
+  invalidateValueCache();
   const DifferentiableFunctionPtr_t& f(constraint->functionPtr());
 
-  std::map<DifferentiableFunctionPtr_t, size_type>::iterator iqi(
-      find_if(iq_.begin(), iq_.end(),
-              [&f](const iqIt_t& arg) { return *arg.first == *f; }));
-  if (iqi == iq_.end()) return false;
+  const ConstraintIndices* ci(findConstraintIndices(f));
+  if (ci == NULL) return false;
   LiegroupSpacePtr_t space(f->outputSpace());
-  size_type iq = iqi->second;
-
-  std::map<DifferentiableFunctionPtr_t, std::size_t>::iterator prioi(
-      find_if(priority_.begin(), priority_.end(),
-              [&f](const iqIt_t& arg) { return *arg.first == *f; }));
-  if (prioi == priority_.end()) return false;
-  std::size_t i = prioi->second;
+  size_type iq = ci->iq;
+  std::size_t i = ci->priority;
 
   size_type nq = space->nq();
-  Data& d = datas_[i];
+  Data& d = context_.datas[i];
   LiegroupElementRef rhs(
       space->elementRef(d.rightHandSide.vector().segment(iq, nq)));
   constraint->rightHandSideFromConfig(config, rhs);
@@ -449,24 +982,19 @@ bool HierarchicalIterative::rightHandSideFromConfig(
 
 bool HierarchicalIterative::rightHandSide(const ImplicitPtr_t& constraint,
                                           vectorIn_t rightHandSide) {
+  copyConstraintsOnWrite();
+  invalidateValueCache();
   const DifferentiableFunctionPtr_t& f(constraint->functionPtr());
   LiegroupSpacePtr_t space(f->outputSpace());
   assert(rightHandSide.size() == space->nq());
 
-  std::map<DifferentiableFunctionPtr_t, size_type>::iterator iqi(
-      find_if(iq_.begin(), iq_.end(),
-              [&f](const iqIt_t& arg) { return *arg.first == *f; }));
-  if (iqi == iq_.end()) return false;
-  size_type iq = iqi->second;
+  const ConstraintIndices* ci(findConstraintIndices(f));
+  if (ci == NULL) return false;
+  size_type iq = ci->iq;
   size_type nq = space->nq();
+  std::size_t i = ci->priority;
 
-  std::map<DifferentiableFunctionPtr_t, std::size_t>::iterator prioi(
-      find_if(priority_.begin(), priority_.end(),
-              [&f](const iqIt_t& arg) { return *arg.first == *f; }));
-  if (prioi == priority_.end()) return false;
-  std::size_t i = prioi->second;
-
-  Data& d = datas_[i];
+  Data& d = context_.datas[i];
 #ifndef NDEBUG
   size_type nv = space->nv();
   assert(d.error.size() >= nv);
@@ -483,22 +1011,14 @@ bool HierarchicalIterative::rightHandSide(const ImplicitPtr_t& constraint,
 bool HierarchicalIterative::getRightHandSide(const ImplicitPtr_t& constraint,
                                              vectorOut_t rightHandSide) const {
   const DifferentiableFunctionPtr_t& f(constraint->functionPtr());
-  std::map<DifferentiableFunctionPtr_t, std::size_t>::const_iterator itp(
-      find_if(priority_.begin(), priority_.end(),
-              [&f](const priorityIt_t& arg) { return *arg.first == *f; }));
-  if (itp == priority_.end()) {
-    return false;
-  }
-  std::map<DifferentiableFunctionPtr_t, size_type>::const_iterator itIq(
-      find_if(iq_.begin(), iq_.end(),
-              [&f](const iqIt_t& arg) { return *arg.first == *f; }));
-  if (itIq == iq_.end()) {
+  const ConstraintIndices* ci(findConstraintIndices(f));
+  if (ci == NULL) {
     return false;
   }
   LiegroupSpacePtr_t space(f->outputSpace());
-  std::size_t i = itp->second;
-  size_type iq = itIq->second;
-  Data& d = datas_[i];
+  std::size_t i = ci->priority;
+  size_type iq = ci->iq;
+  Data& d = context_.datas[i];
   assert(rightHandSide.size() == space->nq());
   assert(d.rightHandSide.space()->nq() >= iq + space->nq());
   rightHandSide = d.rightHandSide.vector().segment(iq, space->nq());
@@ -510,26 +1030,15 @@ bool HierarchicalIterative::isConstraintSatisfied(
     bool& constraintFound) const {
   const DifferentiableFunctionPtr_t& f(constraint->functionPtr());
   assert(error.size() == f->outputSpace()->nv());
-  std::map<DifferentiableFunctionPtr_t, std::size_t>::const_iterator itp(
-      find_if(priority_.begin(), priority_.end(),
-              [&f](const priorityIt_t& arg) { return *arg.first == *f; }));
-  if (itp == priority_.end()) {
+  const ConstraintIndices* ci(findConstraintIndices(f));
+  if (ci == NULL) {
     constraintFound = false;
     return false;
   }
   constraintFound = true;
-  std::map<DifferentiableFunctionPtr_t, size_type>::const_iterator itIq(
-      find_if(iq_.begin(), iq_.end(),
-              [&f](const iqIt_t& arg) { return *arg.first == *f; }));
-  assert(itIq != iq_.end());
-  std::map<DifferentiableFunctionPtr_t, size_type>::const_iterator itIv(
-      find_if(iv_.begin(), iv_.end(),
-              [&f](const iqIt_t& arg) { return *arg.first == *f; }));
-  assert(itIv != iv_.end());
-  size_type priority(itp->second);
-  Data& d = datas_[priority];
+  Data& d = context_.datas[ci->priority];
   // Evaluate constraint function
-  size_type iq = itIq->second, nq = f->outputSpace()->nq();
+  size_type iq = ci->iq, nq = f->outputSpace()->nq();
   LiegroupElementRef output(d.output.vector().segment(iq, nq),
                             f->outputSpace());
   LiegroupElementRef rhs(d.rightHandSide.vector().segment(iq, nq),
@@ -541,9 +1050,11 @@ bool HierarchicalIterative::isConstraintSatisfied(
 }
 
 void HierarchicalIterative::rightHandSide(vectorIn_t rightHandSide) {
+  copyConstraintsOnWrite();
+  invalidateValueCache();
   size_type iq = 0, iv = 0;
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
-    Data& d = datas_[i];
+    Data& d = context_.datas[i];
     LiegroupSpacePtr_t space(d.rightHandSide.space());
     size_type nq = space->nq();
     size_type nv = space->nv();
@@ -566,6 +1077,8 @@ void HierarchicalIterative::rightHandSide(vectorIn_t rightHandSide) {
 }
 
 void HierarchicalIterative::rightHandSideAt(const value_type& s) {
+  copyConstraintsOnWrite();
+  invalidateValueCache();
   for (std::size_t i = 0; i < constraints_.size(); ++i) {
     ImplicitPtr_t implicit = constraints_[i];
     // If constraint has no right hand side function set, do nothing
@@ -578,9 +1091,15 @@ void HierarchicalIterative::rightHandSideAt(const value_type& s) {
 
 vector_t HierarchicalIterative::rightHandSide() const {
   vector_t rhs(rightHandSideSize());
+  getRightHandSide(rhs);
+  return rhs;
+}
+
+void HierarchicalIterative::getRightHandSide(vectorOut_t rhs) const {
+  assert(rhs.size() == rightHandSideSize());
   size_type iq = 0;
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
-    const Data& d = datas_[i];
+    const Data& d = context_.datas[i];
     size_type nq = d.rightHandSide.space()->nq();
     // this does not take the comparison type into account.
     // It shouldn't matter as rhs should be zero when comparison type is
@@ -589,7 +1108,38 @@ vector_t HierarchicalIterative::rightHandSide() const {
     iq += nq;
   }
   assert(iq == rhs.size());
-  return rhs;
+}
+
+const vector_t& HierarchicalIterative::rightHandSideView() const {
+  if (!rhsViewValid_) {
+    // No-op when the structure did not change since the last gather.
+    rhsView_.resize(rightHandSideSize());
+    getRightHandSide(rhsView_);
+    rhsViewValid_ = true;
+  }
+  return rhsView_;
+}
+
+HierarchicalIterative::Snapshot HierarchicalIterative::snapshot() const {
+  Snapshot s;
+  s.rightHandSide = rightHandSide();
+  s.freeVariables = freeVariables_;
+  s.squaredErrorThreshold = squaredErrorThreshold_;
+  s.squaredCoarseErrorThreshold = squaredCoarseErrorThreshold_;
+  s.inequalityThreshold = inequalityThreshold_;
+  s.maxIterations = maxIterations_;
+  return s;
+}
+
+void HierarchicalIterative::restore(const Snapshot& snapshot) {
+  // Virtual so that BySubstitution restores the right hand side of its
+  // explicit constraints too.
+  rightHandSide(snapshot.rightHandSide);
+  freeVariables(snapshot.freeVariables);
+  squaredErrorThreshold_ = snapshot.squaredErrorThreshold;
+  squaredCoarseErrorThreshold_ = snapshot.squaredCoarseErrorThreshold;
+  inequalityThreshold_ = snapshot.inequalityThreshold;
+  maxIterations_ = snapshot.maxIterations;
 }
 
 size_type HierarchicalIterative::rightHandSideSize() const {
@@ -600,60 +1150,126 @@ size_type HierarchicalIterative::rightHandSideSize() const {
 }
 
 template <bool ComputeJac>
-void HierarchicalIterative::computeValue(vectorIn_t config) const {
+void HierarchicalIterative::computeValue(vectorIn_t config,
+                                         SolveContext& context) const {
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
     const ImplicitConstraintSet& constraints(stacks_[i]);
     const DifferentiableFunction& f = constraints.function();
-    Data& d = datas_[i];
-
-    f.value(d.output, config);
+    Data& d = context.datas[i];
+
+    // Skip the evaluation if no input this level reads changed since
+    // the last call. The cached output, error and Jacobian are then
+    // exactly what the evaluation below would produce.
+    bool upToDate = d.lastArgValid && (!ComputeJac || d.lastJacValid);
+    const segments_t& segs = d.activeArgs.indices();
+    for (std::size_t k = 0; upToDate && k < segs.size(); ++k)
+      upToDate = (config.segment(segs[k].first, segs[k].second) ==
+                  d.lastArg.segment(segs[k].first, segs[k].second));
+    if (upToDate) continue;
+
+    HPP_SOLVER_TRACE_ZONE(f.name().c_str(), (size_type)i);
+    const bool direct = (ComputeJac && d.directJacobian);
+
+    HPP_SOLVER_TIMING_NOW(start);
+    if (direct) {
+      // The functions of this level write their Jacobian straight into
+      // the reduced column layout. See Data::directJacobian.
+      f.value(d.output, config);
+      f.jacobianOnColumns(d.jacobianReduced, config,
+                          freeVariables_.indices());
+    } else if (ComputeJac)
+      f.valueAndJacobian(d.output, d.jacobian, config);
+    else
+      f.value(d.output, config);
+    HPP_SOLVER_TIMING_ADD(start, d.valueNanoseconds);
+    HPP_SOLVER_TIMING_COUNT(d.nbValueEvaluations);
+    if (ComputeJac) HPP_SOLVER_TIMING_COUNT(d.nbJacobianEvaluations);
     assert(hpp::pinocchio::checkNormalized(d.output));
     assert(hpp::pinocchio::checkNormalized(d.rightHandSide));
     d.error = d.output - d.rightHandSide;
     constraints.setInactiveRowsToZero(d.error);
+    // The row-wise operations below do not depend on the column layout.
+    Data::MatrixMap_t& J(direct ? d.jacobianReduced : d.jacobian);
     if (ComputeJac) {
-      f.jacobian(d.jacobian, config);
       d.output.space()->dDifference_dq1<pinocchio::DerivativeTimesInput>(
-          d.rightHandSide.vector(), d.output.vector(), d.jacobian);
+          d.rightHandSide.vector(), d.output.vector(), J);
     }
-    applyComparison<ComputeJac>(d.comparison, d.inequalityIndices, d.error,
-                                d.jacobian, inequalityThreshold_);
+    if (!d.inequalityIndices.empty())
+      applyComparison<ComputeJac>(d.inequalitySign, d.inequalityKeep, d.error,
+                                  J, inequalityThreshold_);
 
-    // Copy columns that are not reduced
-    if (ComputeJac) d.reducedJ = d.activeRowsOfJ.rview(d.jacobian);
+    // Copy columns that are not reduced, replaying the tile plans
+    // compiled by computeActiveRowsOfJ.
+    if (ComputeJac) {
+      if (direct)
+        d.reducedRowsPlan.gatherRows(d.jacobianReduced, d.reducedJ);
+      else
+        d.reducedRowsPlan.gather(d.reducedColsPlan, d.jacobian, d.reducedJ);
+      d.decompositionValid = false;
+    }
+
+    d.lastArg = config;
+    d.lastArgValid = true;
+    d.lastJacValid = ComputeJac;
   }
 }
 
 template void HierarchicalIterative::computeValue<false>(
-    vectorIn_t config) const;
+    vectorIn_t config, SolveContext& context) const;
 template void HierarchicalIterative::computeValue<true>(
-    vectorIn_t config) const;
+    vectorIn_t config, SolveContext& context) const;
 
-void HierarchicalIterative::computeSaturation(vectorIn_t config) const {
-  bool applySaturate = saturate_->saturate(config, qSat_, saturation_);
+void HierarchicalIterative::computeSaturation(vectorIn_t config,
+                                              SolveContext& context) const {
+  bool applySaturate =
+      saturate_->saturate(config, context.qSat, context.saturation);
   if (!applySaturate) return;
 
-  reducedSaturation_ = freeVariables_.rview(saturation_);
-  assert((reducedSaturation_.array() == -1 || reducedSaturation_.array() == 0 ||
-          reducedSaturation_.array() == 1)
-             .all());
+  // The saturated set is typically stable across iterations - a joint
+  // that hit its limit rides it for the rest of the solve - so the
+  // reduced mask and the saturated column list are regathered only when
+  // it changes.
+  if (!context.saturationValid ||
+      context.lastSaturation.size() != context.saturation.size() ||
+      context.lastSaturation != context.saturation) {
+    context.reducedSaturation.resize(freeVariablesPlan_.nbIndices());
+    freeVariablesPlan_.gatherRows(context.saturation,
+                                  context.reducedSaturation);
+    assert((context.reducedSaturation.array() == -1 ||
+            context.reducedSaturation.array() == 0 ||
+            context.reducedSaturation.array() == 1)
+               .all());
+    context.satCols.clear();
+    for (size_type j = 0; j < context.reducedSaturation.size(); ++j)
+      if (context.reducedSaturation[j] != 0) context.satCols.push_back(j);
+    context.lastSaturation = context.saturation;
+    context.saturationValid = true;
+  }
 
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
-    Data& d = datas_[i];
+    Data& d = context.datas[i];
 
     vector_t error = d.activeRowsOfJ.keepRows().rview(d.error);
-    tmpSat_ = (reducedSaturation_.cast<value_type>()
-                   .cwiseProduct(d.reducedJ.transpose() * error)
-                   .array() < 0);
-    for (size_type j = 0; j < tmpSat_.size(); ++j)
-      if (tmpSat_[j]) d.reducedJ.col(j).setZero();
+    // Only the saturated columns can be pruned: test them one by one
+    // instead of computing the full J^T e product.
+    for (std::size_t k = 0; k < context.satCols.size(); ++k) {
+      const size_type j = context.satCols[k];
+      if ((value_type)context.reducedSaturation[j] *
+              d.reducedJ.col(j).dot(error) <
+          0) {
+        // The column was non zero - the product above is - so zeroing
+        // it stales any cached decomposition of the level.
+        d.reducedJ.col(j).setZero();
+        d.decompositionValid = false;
+      }
+    }
   }
 }
 
 void HierarchicalIterative::getValue(vectorOut_t v) const {
   size_type row = 0;
-  for (std::size_t i = 0; i < datas_.size(); ++i) {
-    const Data& d = datas_[i];
+  for (std::size_t i = 0; i < context_.datas.size(); ++i) {
+    const Data& d = context_.datas[i];
     v.segment(row, d.output.vector().rows()) = d.output.vector();
     row += d.output.vector().rows();
   }
@@ -662,45 +1278,171 @@ void HierarchicalIterative::getValue(vectorOut_t v) const {
 
 void HierarchicalIterative::getReducedJacobian(matrixOut_t J) const {
   size_type row = 0;
-  for (std::size_t i = 0; i < datas_.size(); ++i) {
-    const Data& d = datas_[i];
+  for (std::size_t i = 0; i < context_.datas.size(); ++i) {
+    const Data& d = context_.datas[i];
     J.middleRows(row, d.reducedJ.rows()) = d.reducedJ;
     row += d.reducedJ.rows();
   }
   assert(J.rows() == row);
 }
 
-void HierarchicalIterative::computeError() const {
+void HierarchicalIterative::computeError(SolveContext& context) const {
   const std::size_t end =
       (lastIsOptional_ ? stacks_.size() - 1 : stacks_.size());
-  squaredNorm_ = 0;
+  context.squaredNorm = 0;
   for (std::size_t i = 0; i < end; ++i) {
     const ImplicitConstraintSet::Implicits_t constraints(
         stacks_[i].constraints());
-    const Data& d = datas_[i];
+    const Data& d = context.datas[i];
     size_type iv = 0;
     for (std::size_t j = 0; j < constraints.size(); ++j) {
       size_type nv(constraints[j]->function().outputDerivativeSize());
-      squaredNorm_ =
-          std::max(squaredNorm_, d.error.segment(iv, nv).squaredNorm());
+      context.squaredNorm =
+          std::max(context.squaredNorm, d.error.segment(iv, nv).squaredNorm());
+      iv += nv;
+    }
+  }
+}
+
+void HierarchicalIterative::satisfactionCache(std::size_t capacity) {
+  if (capacity == 0)
+    satisfactionCache_.reset();
+  else if (!satisfactionCache_ || satisfactionCache_->capacity() != capacity)
+    satisfactionCache_.reset(new SatisfactionCache(capacity));
+}
+
+std::size_t HierarchicalIterative::satisfactionCache() const {
+  return satisfactionCache_ ? satisfactionCache_->capacity() : 0;
+}
+
+void HierarchicalIterative::computeSquaredNorm(vectorIn_t arg) const {
+  if (satisfactionCache_ &&
+      satisfactionCache_->find(arg, rhsGeneration_, context_.squaredNorm))
+    return;
+  computeValue<false>(arg);
+  computeError();
+  if (satisfactionCache_)
+    satisfactionCache_->store(arg, rhsGeneration_, context_.squaredNorm);
+}
+
+bool HierarchicalIterative::isSatisfiedFast(
+    vectorIn_t arg, SolveContext& context,
+    value_type squaredErrorThreshold) const {
+  const std::size_t end =
+      (lastIsOptional_ ? stacks_.size() - 1 : stacks_.size());
+  for (std::size_t i = 0; i < end; ++i) {
+    const ImplicitConstraintSet::Implicits_t& constraints(
+        stacks_[i].constraints());
+    Data& d = context.datas[i];
+
+    // Reuse the cached evaluation when no input this level reads
+    // changed since the last call, as computeValue does.
+    bool upToDate = d.lastArgValid;
+    const segments_t& segs = d.activeArgs.indices();
+    for (std::size_t k = 0; upToDate && k < segs.size(); ++k)
+      upToDate = (arg.segment(segs[k].first, segs[k].second) ==
+                  d.lastArg.segment(segs[k].first, segs[k].second));
+    if (!upToDate) {
+      d.lastArgValid = false;
+      d.lastJacValid = false;
+    }
+
+    size_type iq = 0, iv = 0;
+    for (std::size_t j = 0; j < constraints.size(); ++j) {
+      const Implicit& c = *constraints[j];
+      const DifferentiableFunction& f = c.function();
+      const size_type nq = f.outputSize();
+      const size_type nv = f.outputDerivativeSize();
+      if (!upToDate) {
+        // Evaluate this constraint only and derive its error exactly
+        // as computeValue<false> does for the whole level. The level
+        // output space is the product of the constraint output spaces,
+        // so the difference factorizes per constraint.
+        LiegroupElementRef output(
+            f.outputSpace()->elementRef(d.output.vector().segment(iq, nq)));
+        f.value(output, arg);
+        d.error.segment(iv, nv) =
+            output - f.outputSpace()->elementConstRef(
+                         d.rightHandSide.vector().segment(iq, nq));
+        c.setInactiveRowsToZero(d.error.segment(iv, nv));
+        // Branch-free equivalent of applyComparison, restricted to the
+        // rows of this constraint.
+        applyComparisonOnValue(d.inequalitySign.segment(iv, nv),
+                               d.error.segment(iv, nv), inequalityThreshold_);
+      }
+      // Abort as soon as one constraint crosses the threshold; the
+      // remaining functions are not evaluated at all.
+      if (d.error.segment(iv, nv).squaredNorm() >= squaredErrorThreshold)
+        return false;
+      iq += nq;
       iv += nv;
     }
+    if (!upToDate) {
+      // The level was fully evaluated and matches what
+      // computeValue<false> would have produced: feed the cache.
+      d.lastArg = arg;
+      d.lastArgValid = true;
+    }
+  }
+  return true;
+}
+
+void HierarchicalIterative::buildIntegrationPlan() {
+  integrationPlan_.clear();
+  const std::vector<pinocchio::LiegroupType>& types(
+      configSpace_->liegroupTypes());
+  size_type iq = 0, iv = 0;
+  for (std::size_t rank = 0; rank < types.size(); ++rank) {
+    const size_type nq = configSpace_->nq(rank), nv = configSpace_->nv(rank);
+    const bool vectorSpace =
+        boost::apply_visitor(IsVectorSpaceVisitor(), types[rank]);
+    if (vectorSpace && !integrationPlan_.empty() &&
+        integrationPlan_.back().rank == IntegrationSegment::npos) {
+      // Extend the current vector space run.
+      integrationPlan_.back().nq += nq;
+      integrationPlan_.back().nv += nv;
+    } else {
+      IntegrationSegment seg;
+      seg.iq = iq;
+      seg.nq = nq;
+      seg.iv = iv;
+      seg.nv = nv;
+      seg.rank = vectorSpace ? IntegrationSegment::npos : rank;
+      integrationPlan_.push_back(seg);
+    }
+    iq += nq;
+    iv += nv;
   }
 }
 
 bool HierarchicalIterative::integrate(vectorIn_t from, vectorIn_t velocity,
-                                      vectorOut_t result) const {
-  typedef pinocchio::LiegroupElementRef LgeRef_t;
+                                      vectorOut_t result,
+                                      SolveContext& context) const {
   result = from;
-  LgeRef_t M(result, configSpace_);
-  M += velocity;
-  return saturate_->saturate(result, result, saturation_);
+  // Each vector space run of the configuration space integrates as one
+  // fused addition; only the non Euclidean blocks go through the Lie
+  // group machinery. On mostly Euclidean robots this skips the per
+  // block dispatch of the full space integration.
+  const std::vector<pinocchio::LiegroupType>& types(
+      configSpace_->liegroupTypes());
+  for (std::size_t i = 0; i < integrationPlan_.size(); ++i) {
+    const IntegrationSegment& seg = integrationPlan_[i];
+    if (seg.rank == IntegrationSegment::npos)
+      result.segment(seg.iq, seg.nq) += velocity.segment(seg.iv, seg.nv);
+    else {
+      IntegrateBlockVisitor v(from.segment(seg.iq, seg.nq),
+                              velocity.segment(seg.iv, seg.nv),
+                              result.segment(seg.iq, seg.nq));
+      boost::apply_visitor(v, types[seg.rank]);
+    }
+  }
+  return saturate_->saturate(result, result, context.saturation);
 }
 
 void HierarchicalIterative::residualError(vectorOut_t error) const {
   size_type row = 0;
-  for (std::size_t i = 0; i < datas_.size(); ++i) {
-    const Data& d = datas_[i];
+  for (std::size_t i = 0; i < context_.datas.size(); ++i) {
+    const Data& d = context_.datas[i];
     error.segment(row, d.error.size()) = d.error;
     row += d.error.size();
   }
@@ -711,33 +1453,150 @@ bool HierarchicalIterative::definesSubmanifoldOf(
   for (NumericalConstraints_t::const_iterator it(solver.constraints().begin());
        it != solver.constraints().end(); ++it) {
     const DifferentiableFunctionPtr_t& f = (*it)->functionPtr();
-    if (find_if(constraints_.begin(), constraints_.end(),
-                [&f](const ImplicitPtr_t& arg) {
-                  return arg->function() == *f;
-                }) == constraints_.end())
-      return false;
+    typedef std::unordered_multimap<std::string, std::size_t>::const_iterator
+        It_t;
+    std::pair<It_t, It_t> range(constraintIndex_.equal_range(f->name()));
+    bool found = false;
+    for (It_t itc = range.first; itc != range.second; ++itc)
+      if (constraints_[itc->second]->function() == *f) {
+        found = true;
+        break;
+      }
+    if (!found) return false;
   }
   return true;
 }
 
-void HierarchicalIterative::computeDescentDirection() const {
-  sigma_ = std::numeric_limits<value_type>::max();
+void HierarchicalIterative::invalidateStaleDecompositions(
+    SolveContext& context) const {
+  context.movedDofs.reset();
+  for (size_type i = 0; i < context.dq.size(); ++i)
+    if (context.dq[i] != 0) context.movedDofs.set(i);
+  for (std::size_t i = 0; i < context.datas.size(); ++i) {
+    Data& d = context.datas[i];
+    if (d.decompositionValid &&
+        context.movedDofs.intersects(d.stepDependencies))
+      d.decompositionValid = false;
+  }
+}
+
+void HierarchicalIterative::computeDescentDirection(
+    SolveContext& context) const {
+  HPP_SOLVER_TRACE_ZONE("computeDescentDirection", -1);
+  context.sigma = std::numeric_limits<value_type>::max();
 
   if (stacks_.empty()) {
-    dq_.setZero();
+    context.dq.setZero();
     return;
   }
-  vector_t err;
   if (stacks_.size() == 1) {  // one level only
-    Data& d = datas_[0];
-    d.svd.compute(d.reducedJ);
-    HPP_DEBUG_SVDCHECK(d.svd);
-    // TODO Eigen::JacobiSVD does a dynamic allocation here.
-    err = d.activeRowsOfJ.keepRows().rview(-d.error);
-    dqSmall_ = d.svd.solve(err);
-    d.maxRank = std::max(d.maxRank, d.svd.rank());
-    if (d.maxRank > 0)
-      sigma_ = std::min(sigma_, d.svd.singularValues()[d.maxRank - 1]);
+    Data& d = context.datas[0];
+    d.reducedError = d.activeRowsOfJ.keepRows().rview(-d.error);
+    // Gather the structurally non-zero columns so that the
+    // decomposition and the products below only traverse the active
+    // blocks of the reduced Jacobian.
+    const bool compactCols = (d.activeCols.nbCols() < d.reducedJ.cols());
+    if (compactCols) d.reducedJcompact = d.activeCols.rview(d.reducedJ);
+    const Data::MatrixMap_t& J =
+        (compactCols ? d.reducedJcompact : d.reducedJ);
+    Eigen::Ref<vector_t> dq(compactCols
+                                ? Eigen::Ref<vector_t>(d.dqCompact)
+                                : Eigen::Ref<vector_t>(context.dqSmall));
+    HPP_SOLVER_TIMING_NOW(start);
+    if (squaredJacobianTransposeThreshold_ > 0 &&
+        context.squaredNorm > squaredJacobianTransposeThreshold_) {
+      // Far from the solution: take a scaled Jacobian-transpose step
+      // instead of computing a decomposition. The scaling minimizes the
+      // linearized error norm along J^T e. See
+      // jacobianTransposeThreshold.
+      dq.noalias() = J.transpose() * d.reducedError;
+      d.Jdq.noalias() = J * dq;
+      const value_type den = d.Jdq.squaredNorm();
+      if (den > 0) dq *= dq.squaredNorm() / den;
+    } else {
+      switch (decomposition_) {
+        case JACOBI_SVD:
+          if (d.useSvd6) {
+            // Fixed-row-count path for the canonical 6-dof pose
+            // constraint; see the documentation of Data::svd6.
+            d.reducedJ6 = J;
+            d.svd6.compute(d.reducedJ6);
+            HPP_DEBUG_SVDCHECK(d.svd6);
+            svdSolveInPlace(d.svd6, d.svdRhs, d.reducedError, dq);
+            d.maxRank = std::max(d.maxRank, d.svd6.rank());
+            if (d.maxRank > 0)
+              context.sigma = std::min(context.sigma,
+                                       d.svd6.singularValues()[d.maxRank - 1]);
+            break;
+          }
+          if (squaredIncrementalSvdThreshold_ > 0 &&
+              d.previousV.rows() == J.cols()) {
+            // Warm start: the row space of J moves little between two
+            // Newton iterations, so it is mostly contained in the right
+            // singular subspace V of the previous decomposition.
+            // Decomposing the much smaller projection J V is then
+            // enough. The columns of previousV being orthonormal, the
+            // projection residual comes for free from Frobenius norms.
+            d.JV.noalias() = J * d.previousV;
+            const value_type J2 = J.squaredNorm();
+            if (J2 - d.JV.squaredNorm() <=
+                squaredIncrementalSvdThreshold_ * J2) {
+              d.svdJV.compute(d.JV);
+              HPP_DEBUG_SVDCHECK(d.svdJV);
+              svdSolveInPlace(d.svdJV, d.svdRhs, d.reducedError, d.vJV);
+              dq.noalias() = d.previousV * d.vJV;
+              d.maxRank = std::max(d.maxRank, d.svdJV.rank());
+              if (d.maxRank > 0)
+                context.sigma = std::min(
+                    context.sigma, d.svdJV.singularValues()[d.maxRank - 1]);
+              break;
+            }
+            // The subspace drifted too far: fall through to a full
+            // decomposition, which also refreshes previousV.
+          }
+          d.svd.compute(J);
+          HPP_DEBUG_SVDCHECK(d.svd);
+          svdSolveInPlace(d.svd, d.svdRhs, d.reducedError, dq);
+          d.maxRank = std::max(d.maxRank, d.svd.rank());
+          if (d.maxRank > 0)
+            context.sigma = std::min(context.sigma, d.svd.singularValues()[d.maxRank - 1]);
+          if (squaredIncrementalSvdThreshold_ > 0)
+            d.previousV = d.svd.matrixV();
+          break;
+        case BDC_SVD:
+          d.bdcSvd.compute(J);
+          svdSolveInPlace(d.bdcSvd, d.svdRhs, d.reducedError, dq);
+          d.maxRank = std::max(d.maxRank, d.bdcSvd.rank());
+          if (d.maxRank > 0)
+            context.sigma =
+                std::min(context.sigma, d.bdcSvd.singularValues()[d.maxRank - 1]);
+          break;
+        case COMPLETE_ORTHOGONAL_DECOMPOSITION:
+          d.cod.compute(J);
+          dq = d.cod.solve(d.reducedError);
+          d.maxRank = std::max(d.maxRank, d.cod.rank());
+          break;
+        case DAMPED_CHOLESKY:
+          // dq = J^T (J J^T + lambda^2 I)^{-1} err. Well defined close to
+          // singularities thanks to the damping, but provides neither rank
+          // nor singular value information.
+          d.JJt.noalias() = J * J.transpose();
+          d.JJt.diagonal().array() += choleskyDamping_ * choleskyDamping_;
+          d.llt.compute(d.JJt);
+          d.llt.solveInPlace(d.reducedError);
+          dq.noalias() = J.transpose() * d.reducedError;
+          break;
+      }
+    }
+    if (compactCols) {
+      // Scatter the compact solution back; the inactive columns get a
+      // zero velocity.
+      context.dqSmall.setZero();
+      Eigen::RowBlockIndices(d.activeCols.cols()).lview(context.dqSmall) =
+          d.dqCompact;
+    }
+    HPP_SOLVER_TIMING_ADD(start, d.decompositionNanoseconds);
+    HPP_SOLVER_TIMING_COUNT(d.nbDecompositions);
   } else {
     // dq = dQ_0 + P_0 * v_1
     // f_1(q+dq) = f_1(q) + J_1 * dQ_0 + M_1 * v_1
@@ -749,34 +1608,48 @@ void HierarchicalIterative::computeDescentDirection() const {
     // dQ_1 = dQ_0 + P_0 * M+_1 * (-f_1(q) - J_1 * dQ_1)
     //  P_1 = P_0 * K_1
     matrix_t* projector = NULL;
+    bool upstreamChanged = false;
     for (std::size_t i = 0; i < stacks_.size(); ++i) {
-      Data& d = datas_[i];
+      Data& d = context.datas[i];
 
       // TODO: handle case where this is the first element of the stack and it
       // has no functions
       if (d.reducedJ.rows() == 0) continue;
+      HPP_SOLVER_TRACE_ZONE("descentDirectionLevel", (size_type)i);
+      HPP_SOLVER_TIMING_NOW(start);
       /// projector is of size numberDof
       bool first = (i == 0);
       bool last = (i == stacks_.size() - 1);
+      // Levels whose reduced Jacobian and upstream projector did not
+      // change since their last decomposition - typically levels
+      // already converged when solving level by level - keep their svd
+      // and PK and only redo the substitution on the new error.
+      const bool refresh = upstreamChanged || !d.decompositionValid;
       if (first) {
-        err = d.activeRowsOfJ.keepRows().rview(-d.error);
+        d.reducedError = d.activeRowsOfJ.keepRows().rview(-d.error);
         // dq should be zero and projector should be identity
-        d.svd.compute(d.reducedJ);
+        if (refresh) d.svd.compute(d.reducedJ);
         HPP_DEBUG_SVDCHECK(d.svd);
-        // TODO Eigen::JacobiSVD does a dynamic allocation here.
-        dqSmall_ = d.svd.solve(err);
+        svdSolveInPlace(d.svd, d.svdRhs, d.reducedError, context.dqSmall);
       } else {
-        err = d.activeRowsOfJ.keepRows().rview(-d.error);
-        err.noalias() -= d.reducedJ * dqSmall_;
+        d.reducedError = d.activeRowsOfJ.keepRows().rview(-d.error);
+        d.reducedError.noalias() -= d.reducedJ * context.dqSmall;
 
         if (projector == NULL) {
-          d.svd.compute(d.reducedJ);
-          // TODO Eigen::JacobiSVD does a dynamic allocation here.
-          dqSmall_ += d.svd.solve(err);
+          if (refresh) d.svd.compute(d.reducedJ);
+          svdSolveInPlace(d.svd, d.svdRhs, d.reducedError, context.dqTmp);
+          context.dqSmall += context.dqTmp;
         } else {
-          d.svd.compute(d.reducedJ * *projector);
-          // TODO Eigen::JacobiSVD does a dynamic allocation here.
-          dqSmall_ += *projector * d.svd.solve(err);
+          // The kernel dimension of the previous levels may change
+          // between iterations, in which case this compute call resizes
+          // the decomposition workspace once.
+          const size_type k = projector->cols();
+          if (refresh) {
+            d.JP.leftCols(k).noalias() = d.reducedJ * *projector;
+            d.svd.compute(d.JP.leftCols(k));
+          }
+          svdSolveInPlace(d.svd, d.svdRhs, d.reducedError, context.dqTmp.head(k));
+          context.dqSmall.noalias() += *projector * context.dqTmp.head(k);
         }
         HPP_DEBUG_SVDCHECK(d.svd);
       }
@@ -784,26 +1657,158 @@ void HierarchicalIterative::computeDescentDirection() const {
       const size_type rank = d.svd.rank();
       d.maxRank = std::max(d.maxRank, rank);
       if (d.maxRank > 0)
-        sigma_ = std::min(sigma_, d.svd.singularValues()[d.maxRank - 1]);
-      if (solveLevelByLevel_ && err.squaredNorm() > squaredErrorThreshold_)
+        context.sigma = std::min(context.sigma, d.svd.singularValues()[d.maxRank - 1]);
+      HPP_SOLVER_TIMING_ADD(start, d.decompositionNanoseconds);
+      if (refresh) HPP_SOLVER_TIMING_COUNT(d.nbDecompositions);
+      // A level left through this break keeps refreshing: its PK below
+      // may not match the svd yet.
+      if (solveLevelByLevel_ &&
+          d.reducedError.squaredNorm() > squaredErrorThreshold_)
+        break;
+      if (last) {  // No need to compute projector for next step.
+        d.decompositionValid = true;
         break;
-      if (last) break;  // No need to compute projector for next step.
+      }
 
-      if (d.svd.matrixV().cols() == rank) break;  // The kernel is { 0 }
+      if (d.svd.matrixV().cols() == rank) {  // The kernel is { 0 }
+        d.decompositionValid = true;
+        break;
+      }
       /// compute projector for next step.
-      if (projector == NULL)
-        d.PK.noalias() = getV2<SVD_t>(d.svd, rank);
-      else
-        d.PK.noalias() = *projector * getV2<SVD_t>(d.svd, rank);
+      if (refresh) {
+        if (projector == NULL)
+          d.PK.noalias() = getV2<SVD_t>(d.svd, rank);
+        else
+          d.PK.noalias() = *projector * getV2<SVD_t>(d.svd, rank);
+        d.decompositionValid = true;
+        upstreamChanged = true;
+      }
       projector = &d.PK;
     }
   }
-  expandDqSmall();
+  expandDqSmall(context);
+}
+
+void HierarchicalIterative::applyBroydenUpdate(SolveContext& context) const {
+  // Step actually applied by the line search, restricted to the free
+  // variables.
+  context.dqSmall.resize(freeVariablesPlan_.nbIndices());
+  freeVariablesPlan_.gatherRows(context.dq, context.dqSmall);
+  const value_type s2 = context.dqSmall.squaredNorm();
+  if (s2 < Eigen::NumTraits<value_type>::dummy_precision()) return;
+  for (std::size_t i = 0; i < stacks_.size(); ++i) {
+    Data& d = context.datas[i];
+    if (d.reducedJ.rows() == 0) continue;
+    // J <- J + (de - J s) s^T / (s^T s) where de is the change of the
+    // error across the step and s the reduced step.
+    d.reducedError = d.activeRowsOfJ.keepRows().rview(d.error);
+    d.broydenError = d.reducedError - d.broydenError;
+    d.broydenError.noalias() -= d.reducedJ * context.dqSmall;
+    d.reducedJ.noalias() += d.broydenError * (context.dqSmall.transpose() / s2);
+  }
+}
+
+void HierarchicalIterative::expandDqSmall(SolveContext& context) const {
+  freeVariablesPlan_.scatterRows(context.dqSmall, context.dq);
+}
+
+HierarchicalIterative::PerformanceReport
+HierarchicalIterative::performanceReport() const {
+  PerformanceReport report;
+#ifdef HPP_CONSTRAINTS_SOLVER_TIMINGS
+  for (std::size_t i = 0; i < indices_.size(); ++i) {
+    const ConstraintIndices& ci = indices_[i];
+    const Data& d = context_.datas[ci.priority];
+    PerformanceReport::Entry entry;
+    entry.name = ci.function->name();
+    entry.priority = ci.priority;
+    entry.nbValueEvaluations = d.nbValueEvaluations;
+    entry.nbJacobianEvaluations = d.nbJacobianEvaluations;
+    entry.nbDecompositions = d.nbDecompositions;
+    entry.valueTime = (value_type)d.valueNanoseconds * 1e-9;
+    entry.decompositionTime = (value_type)d.decompositionNanoseconds * 1e-9;
+    report.entries.push_back(entry);
+  }
+#endif
+  return report;
+}
+
+void HierarchicalIterative::resetPerformanceReport() const {
+#ifdef HPP_CONSTRAINTS_SOLVER_TIMINGS
+  for (std::size_t i = 0; i < context_.datas.size(); ++i) {
+    Data& d = context_.datas[i];
+    d.nbValueEvaluations = 0;
+    d.nbJacobianEvaluations = 0;
+    d.nbDecompositions = 0;
+    d.valueNanoseconds = 0;
+    d.decompositionNanoseconds = 0;
+  }
+#endif
+}
+
+namespace {
+// Scalar count of a JacobiSVD sized (rows, cols): thin U, singular
+// values and the diag x diag work matrix, plus thin or full V. See
+// HierarchicalIterative::memoryUsage.
+std::size_t svdScalars(size_type rows, size_type cols, bool fullV) {
+  const std::size_t diag = (std::size_t)std::min(rows, cols);
+  return (std::size_t)rows * diag + diag * diag + diag +
+         (std::size_t)cols * (fullV ? (std::size_t)cols : diag);
 }
+}  // namespace
 
-void HierarchicalIterative::expandDqSmall() const {
-  Eigen::MatrixBlockView<vector_t, Eigen::Dynamic, 1, false, true>(
-      dq_, freeVariables_.nbIndices(), freeVariables_.indices()) = dqSmall_;
+HierarchicalIterative::MemoryUsageReport HierarchicalIterative::memoryUsage()
+    const {
+  MemoryUsageReport report;
+  report.arena = sizeof(value_type) * (std::size_t)context_.arena.size();
+  for (std::size_t i = 0; i < context_.datas.size(); ++i) {
+    const Data& d = context_.datas[i];
+    report.datas +=
+        sizeof(value_type) *
+        (std::size_t)(d.output.vector().size() +
+                      d.rightHandSide.vector().size() + d.PK.size() +
+                      d.previousV.size() + d.inequalitySign.size());
+    report.datas += d.comparison.size() * sizeof(ComparisonType) +
+                    d.inequalityIndices.size() * sizeof(std::size_t);
+
+    const bool lastLevel = (i + 1 == context_.datas.size());
+    std::size_t scalars = svdScalars(d.svd.rows(), d.svd.cols(), !lastLevel);
+    if (d.useSvd6) scalars += svdScalars(6, d.reducedJ6.cols(), false);
+    if (stacks_.size() == 1) {
+      switch (decomposition_) {
+        case BDC_SVD:
+          scalars += svdScalars(d.svd.rows(), d.svd.cols(), false);
+          break;
+        case COMPLETE_ORTHOGONAL_DECOMPOSITION:
+          // QR factors and the permutation and coefficient vectors.
+          scalars += (std::size_t)(d.svd.rows() * d.svd.cols()) +
+                     2 * (std::size_t)d.svd.cols();
+          break;
+        case DAMPED_CHOLESKY:
+          scalars += (std::size_t)(d.svd.rows() * d.svd.rows());
+          break;
+        case JACOBI_SVD:
+          if (squaredIncrementalSvdThreshold_ > 0 && !d.useSvd6)
+            scalars += svdScalars(d.svdJV.rows(), d.svdJV.cols(), false);
+          break;
+      }
+    }
+    report.decompositions += sizeof(value_type) * scalars;
+  }
+  report.context =
+      sizeof(value_type) *
+          (std::size_t)(context_.dq.size() + context_.dqSmall.size() +
+                        context_.dqTmp.size() + context_.qSat.size()) +
+      sizeof(int) * (std::size_t)(context_.saturation.size() +
+                                  context_.reducedSaturation.size() +
+                                  context_.lastSaturation.size()) +
+      sizeof(size_type) * context_.satCols.capacity() +
+      sizeof(SolveTelemetry::Iteration) * context_.telemetry.ring.size();
+  report.solver =
+      sizeof(value_type) *
+      ((std::size_t)(reducedJ_.size() + OM_.size() + OP_.size()) +
+       svdScalars(svd_.rows(), svd_.cols(), false));
+  return report;
 }
 
 std::ostream& HierarchicalIterative::print(std::ostream& os) const {
@@ -817,7 +1822,7 @@ std::ostream& HierarchicalIterative::print(std::ostream& os) const {
   for (std::size_t i = 0; i < stacks_.size(); ++i) {
     const ImplicitConstraintSet::Implicits_t constraints(
         stacks_[i].constraints());
-    const Data& d = datas_[i];
+    const Data& d = context_.datas[i];
     os << iendl << "Level " << i;
     if (lastIsOptional_ && i == end) os << " (optional)";
     os << ": Stack of " << constraints.size() << " functions" << incindent;
@@ -839,6 +1844,73 @@ std::ostream& HierarchicalIterative::print(std::ostream& os) const {
   return os << decindent;
 }
 
+template <typename LineSearchType>
+size_type HierarchicalIterative::solveAny(matrixOut_t seeds,
+                                          std::size_t nbThreads,
+                                          LineSearchType lineSearch) const {
+  const size_type nbSeeds = seeds.cols();
+  if (nbThreads <= 1 || nbSeeds <= 1) {
+    // Sequential fallback, still stopping at the first success.
+    for (size_type c = 0; c < nbSeeds; ++c) {
+      vector_t arg(seeds.col(c));
+      if (solve(arg, lineSearch) == SUCCESS) {
+        seeds.col(c) = arg;
+        return c;
+      }
+    }
+    return -1;
+  }
+
+  std::atomic<bool> found(false);
+  std::atomic<size_type> winner(-1);
+  std::atomic<size_type> nextSeed(0);
+  // Each worker claims seeds from the shared counter and solves them
+  // on its own context. The first thread to flip found writes its
+  // solution back; the others stop at their next iteration through
+  // SolveContext::interrupt and leave their columns untouched.
+  const std::function<void()> work = [this, &seeds, &lineSearch, &found,
+                                      &winner, &nextSeed, nbSeeds]() {
+    SolveContext context;
+    initSolveContext(context);
+    context.interrupt = &found;
+    vector_t arg(seeds.rows());
+    for (;;) {
+      const size_type c = nextSeed++;
+      if (c >= nbSeeds || found.load()) break;
+      arg = seeds.col(c);
+      // Fresh line search state per seed, as the sequential entries
+      // get through their by-value parameter.
+      LineSearchType ls(lineSearch);
+      if (solve(arg, context, ls) == SUCCESS && !found.exchange(true)) {
+        seeds.col(c) = arg;
+        winner = c;
+        break;
+      }
+    }
+  };
+  const std::size_t n = std::min<std::size_t>(nbThreads, (std::size_t)nbSeeds);
+  std::vector<std::thread> workers;
+  workers.reserve(n - 1);
+  // The calling thread works too, so spawn one worker less.
+  for (std::size_t i = 1; i < n; ++i) workers.push_back(std::thread(work));
+  work();
+  for (std::size_t i = 0; i < workers.size(); ++i) workers[i].join();
+  return winner.load();
+}
+
+template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::Constant lineSearch) const;
+template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::Backtracking lineSearch) const;
+template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::FixedSequence lineSearch) const;
+template size_type HierarchicalIterative::solveAny(
+    matrixOut_t seeds, std::size_t nbThreads,
+    lineSearch::ErrorNormBased lineSearch) const;
+
 template HierarchicalIterative::Status HierarchicalIterative::solve(
     vectorOut_t arg, lineSearch::Constant lineSearch) const;
 template HierarchicalIterative::Status HierarchicalIterative::solve(
@@ -848,6 +1920,54 @@ template HierarchicalIterative::Status HierarchicalIterative::solve(
 template HierarchicalIterative::Status HierarchicalIterative::solve(
     vectorOut_t arg, lineSearch::ErrorNormBased lineSearch) const;
 
+template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Constant lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Backtracking lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::FixedSequence lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::solve(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::ErrorNormBased lineSearch) const;
+
+template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::Constant lineSearch) const;
+template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::Backtracking lineSearch) const;
+template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::FixedSequence lineSearch) const;
+template std::vector<HierarchicalIterative::Status>
+HierarchicalIterative::solve(matrixOut_t args,
+                             lineSearch::ErrorNormBased lineSearch) const;
+
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::Constant lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::Backtracking lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::FixedSequence lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, lineSearch::ErrorNormBased lineSearch) const;
+
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Constant lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::Backtracking lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::FixedSequence lineSearch) const;
+template HierarchicalIterative::Status HierarchicalIterative::refine(
+    vectorOut_t arg, SolveContext& context,
+    lineSearch::ErrorNormBased lineSearch) const;
+
 template <class Archive>
 void HierarchicalIterative::load(Archive& ar, const unsigned int version) {
   (void)version;
@@ -858,12 +1978,14 @@ void HierarchicalIterative::load(Archive& ar, const unsigned int version) {
   ar& BOOST_SERIALIZATION_NVP(lastIsOptional_);
   ar& BOOST_SERIALIZATION_NVP(saturate_);
 
-  saturation_.resize(configSpace_->nq());
-  qSat_.resize(configSpace_->nq());
+  context_.saturation.resize(configSpace_->nq());
+  context_.qSat.resize(configSpace_->nq());
   OM_.resize(configSpace_->nv());
   OP_.resize(configSpace_->nv());
   // Initialize freeVariables_ to all indices.
   freeVariables_.addRow(0, configSpace_->nv());
+  freeVariablesPlan_.compile(freeVariables_.indices());
+  buildIntegrationPlan();
 
   NumericalConstraints_t constraints;
   std::vector<std::size_t> priorities;
@@ -889,13 +2011,11 @@ void HierarchicalIterative::save(Archive& ar,
   std::vector<std::size_t> priorities(constraints_.size());
   for (std::size_t i = 0; i < constraints_.size(); ++i) {
     const DifferentiableFunctionPtr_t& f = constraints_[i]->functionPtr();
-    std::map<DifferentiableFunctionPtr_t, std::size_t>::const_iterator c(
-        find_if(priority_.begin(), priority_.end(),
-                [&f](const priorityIt_t& arg) { return *arg.first == *f; }));
-    if (c == priority_.end())
+    const ConstraintIndices* ci(findConstraintIndices(f));
+    if (ci == NULL)
       priorities[i] = 0;
     else
-      priorities[i] = c->second;
+      priorities[i] = ci->priority;
   }
   ar& BOOST_SERIALIZATION_NVP(priorities);
   // TODO save the right hand side.
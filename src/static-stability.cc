@@ -44,6 +44,74 @@ const value_type StaticStability::G = 9.81;
 const Eigen::Matrix<value_type, 6, 1> StaticStability::Gravity =
     (Eigen::Matrix<value_type, 6, 1>() << 0, 0, -1, 0, 0, 0).finished();
 
+ContactWrenchCache::ContactWrenchCache(const DevicePtr_t& robot,
+                                       const CenterOfMassComputationPtr_t& com,
+                                       std::size_t nbColumns)
+    : robot_(robot),
+      com_(com),
+      phi_(Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(6, nbColumns),
+           Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(
+               6, nbColumns * robot->numberDof())),
+      nbColumns_(nbColumns),
+      argValid_(false) {
+  phi_.setSize(2, nbColumns);
+}
+
+ContactWrenchCachePtr_t ContactWrenchCache::create(
+    const DevicePtr_t& robot, const StaticStability::Contacts_t& contacts,
+    const CenterOfMassComputationPtr_t& com) {
+  ContactWrenchCachePtr_t cache(
+      new ContactWrenchCache(robot, com, contacts.size()));
+  cache->contacts_ = contacts;
+  Traits<PointCom>::Ptr_t OG = PointCom::create(com);
+  for (std::size_t i = 0; i < contacts.size(); ++i) {
+    Traits<PointInJoint>::Ptr_t OP2 = PointInJoint::create(
+        contacts[i].joint, contacts[i].point, robot->numberDof());
+    Traits<VectorInJoint>::Ptr_t n2 = VectorInJoint::create(
+        contacts[i].joint, contacts[i].normal, robot->numberDof());
+
+    cache->phi_(0, i) = n2;
+    cache->phi_(1, i) = (OG - OP2) ^ n2;
+  }
+  cache->phi_.compile();
+  return cache;
+}
+
+ContactWrenchCachePtr_t ContactWrenchCache::create(
+    const DevicePtr_t& robot,
+    const std::vector<ConvexShapeContact::ForceData>& contacts,
+    const CenterOfMassComputationPtr_t& com) {
+  std::size_t nbColumns = 0;
+  for (std::size_t i = 0; i < contacts.size(); ++i)
+    nbColumns += contacts[i].points.size();
+  ContactWrenchCachePtr_t cache(new ContactWrenchCache(robot, com, nbColumns));
+  Traits<PointCom>::Ptr_t OG = PointCom::create(com);
+  std::size_t col = 0;
+  for (std::size_t i = 0; i < contacts.size(); ++i) {
+    Traits<VectorInJoint>::Ptr_t n = VectorInJoint::create(
+        contacts[i].joint, contacts[i].normal, robot->numberDof());
+    for (std::size_t j = 0; j < contacts[i].points.size(); ++j) {
+      Traits<PointInJoint>::Ptr_t OP = PointInJoint::create(
+          contacts[i].joint, contacts[i].points[j], robot->numberDof());
+
+      cache->phi_(0, col) = n;
+      cache->phi_(1, col) = (OG - OP) ^ n;
+      ++col;
+    }
+  }
+  cache->phi_.compile();
+  return cache;
+}
+
+void ContactWrenchCache::prepare(ConfigurationIn_t arg) {
+  if (argValid_ && lastArg_.size() == arg.size() && lastArg_ == arg) return;
+  robot_->currentConfiguration(arg);
+  robot_->computeForwardKinematics();
+  phi_.invalidate();
+  lastArg_ = arg;
+  argValid_ = true;
+}
+
 StaticStability::StaticStability(const std::string& name,
                                  const DevicePtr_t& robot,
                                  const Contacts_t& contacts,
@@ -53,28 +121,36 @@ StaticStability::StaticStability(const std::string& name,
       robot_(robot),
       contacts_(contacts),
       com_(com),
-      phi_(Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(6,
-                                                              contacts.size()),
-           Eigen::Matrix<value_type, 6, Eigen::Dynamic>::Zero(
-               6, contacts.size() * robot->numberDof())),
+      cache_(ContactWrenchCache::create(robot, contacts, com)),
+      phi_(cache_->phi()),
       u_(contacts.size()),
       uMinus_(contacts.size()),
       v_(contacts.size()),
       uDot_(contacts.size(), robot->numberDof()),
       uMinusDot_(contacts.size(), robot->numberDof()),
       vDot_(contacts.size(), robot->numberDof()),
-      lambdaDot_(robot->numberDof()) {
-  phi_.setSize(2, contacts.size());
-  Traits<PointCom>::Ptr_t OG = PointCom::create(com);
-  for (std::size_t i = 0; i < contacts.size(); ++i) {
-    Traits<PointInJoint>::Ptr_t OP2 = PointInJoint::create(
-        contacts[i].joint, contacts[i].point, robot->numberDof());
-    Traits<VectorInJoint>::Ptr_t n2 = VectorInJoint::create(
-        contacts[i].joint, contacts[i].normal, robot->numberDof());
+      lambdaDot_(robot->numberDof()) {}
 
-    phi_(0, i) = n2;
-    phi_(1, i) = (OG - OP2) ^ n2;
-  }
+StaticStability::StaticStability(const std::string& name,
+                                 const ContactWrenchCachePtr_t& cache)
+    : DifferentiableFunction(cache->robot()->configSize(),
+                             cache->robot()->numberDof(), cache->size() + 6,
+                             name),
+      robot_(cache->robot()),
+      contacts_(cache->contacts()),
+      com_(cache->com()),
+      cache_(cache),
+      phi_(cache_->phi()),
+      u_(cache->size()),
+      uMinus_(cache->size()),
+      v_(cache->size()),
+      uDot_(cache->size(), cache->robot()->numberDof()),
+      uMinusDot_(cache->size(), cache->robot()->numberDof()),
+      vDot_(cache->size(), cache->robot()->numberDof()),
+      lambdaDot_(cache->robot()->numberDof()) {
+  // The error segments are indexed by the contacts, so a cache built
+  // from force datas cannot be consumed here.
+  assert(cache->contacts().size() == cache->size());
 }
 
 StaticStabilityPtr_t StaticStability::create(
@@ -83,6 +159,11 @@ StaticStabilityPtr_t StaticStability::create(
   return StaticStabilityPtr_t(new StaticStability(name, robot, contacts, com));
 }
 
+StaticStabilityPtr_t StaticStability::create(
+    const std::string& name, const ContactWrenchCachePtr_t& cache) {
+  return StaticStabilityPtr_t(new StaticStability(name, cache));
+}
+
 StaticStabilityPtr_t StaticStability::create(
     const DevicePtr_t& robot, const Contacts_t& contacts,
     const CenterOfMassComputationPtr_t& com) {
@@ -91,10 +172,7 @@ StaticStabilityPtr_t StaticStability::create(
 
 void StaticStability::impl_compute(LiegroupElementRef result,
                                    ConfigurationIn_t argument) const {
-  robot_->currentConfiguration(argument);
-  robot_->computeForwardKinematics();
-
-  phi_.invalidate();
+  cache_->prepare(argument);
 
   phi_.computeSVD(argument);
 
@@ -115,10 +193,7 @@ void StaticStability::impl_compute(LiegroupElementRef result,
 
 void StaticStability::impl_jacobian(matrixOut_t jacobian,
                                     ConfigurationIn_t argument) const {
-  robot_->currentConfiguration(argument);
-  robot_->computeForwardKinematics();
-
-  phi_.invalidate();
+  cache_->prepare(argument);
 
   phi_.computeSVD(argument);
   phi_.computeJacobian(argument);
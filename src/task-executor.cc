@@ -0,0 +1,68 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: Florent Lamiraux (florent.lamiraux@laas.fr)
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <algorithm>
+#include <hpp/constraints/task-executor.hh>
+
+#include "thread-pool.hh"
+
+namespace hpp {
+namespace constraints {
+namespace {
+/// Built-in executor: a thin adapter over the persistent worker pool.
+class PoolExecutor : public TaskExecutor {
+ public:
+  PoolExecutor(std::size_t nbThreads, const std::vector<int>& cpus)
+      : pool_(nbThreads, cpus) {}
+
+  void parallelFor(const Task& task, std::size_t nbTasks) {
+    pool_.run(task, nbTasks);
+  }
+
+  std::size_t nbThreads() const { return pool_.nbThreads(); }
+
+ private:
+  internal::ThreadPool pool_;
+};  // class PoolExecutor
+
+TaskExecutorPtr_t globalExecutor;
+}  // namespace
+
+TaskExecutorPtr_t TaskExecutor::create(std::size_t nbThreads,
+                                       const std::vector<int>& cpus) {
+  return TaskExecutorPtr_t(
+      new PoolExecutor(std::max<std::size_t>(nbThreads, 1), cpus));
+}
+
+const TaskExecutorPtr_t& TaskExecutor::global() { return globalExecutor; }
+
+void TaskExecutor::global(const TaskExecutorPtr_t& executor) {
+  globalExecutor = executor;
+}
+}  // namespace constraints
+}  // namespace hpp
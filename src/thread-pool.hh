@@ -0,0 +1,175 @@
+// Copyright (c) 2026, LAAS-CNRS
+// Authors: Florent Lamiraux (florent.lamiraux@laas.fr)
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef SRC_THREAD_POOL_HH
+#define SRC_THREAD_POOL_HH
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace hpp {
+namespace constraints {
+namespace internal {
+/// Persistent pool of worker threads running independent tasks.
+///
+/// The workers sleep between evaluations; run() wakes them, lets them
+/// pick task indices from a shared counter - the tasks have very
+/// uneven costs, so static chunking would load-balance poorly - and
+/// the calling thread participates until every task completed.
+class ThreadPool {
+ public:
+  /// \param nbThreads number of threads running the tasks, including
+  ///        the calling thread,
+  /// \param cpus optional CPU indices the workers are pinned to,
+  ///        assigned round robin; the calling thread is left unpinned.
+  ///        Ignored on platforms without thread affinity support.
+  ThreadPool(std::size_t nbThreads,
+             const std::vector<int>& cpus = std::vector<int>())
+      : task_(NULL),
+        nbTasks_(0),
+        next_(0),
+        remaining_(0),
+        generation_(0),
+        stop_(false) {
+    workers_.reserve(nbThreads - 1);
+    (void)cpus;
+    // The calling thread works too, so spawn one worker less.
+    for (std::size_t i = 1; i < nbThreads; ++i) {
+      workers_.push_back(std::thread(&ThreadPool::loop, this));
+#if defined(__linux__)
+      if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[(i - 1) % cpus.size()], &set);
+        pthread_setaffinity_np(workers_.back().native_handle(), sizeof(set),
+                               &set);
+      }
+#endif
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_.notify_all();
+    for (std::size_t i = 0; i < workers_.size(); ++i) workers_[i].join();
+  }
+
+  /// Run task(i) for i in [0, nbTasks), blocking until completion.
+  /// At most one run may be in flight at a time.
+  void run(const std::function<void(std::size_t)>& task,
+           std::size_t nbTasks) {
+    assert(nbTasks <= indexMask_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Store order matters to work(): generation first, next_ last.
+      ++generation_;
+      task_ = &task;
+      nbTasks_ = nbTasks;
+      remaining_ = nbTasks;
+      next_ = (generation_.load() & indexMask_) << indexBits_;
+    }
+    start_.notify_all();
+    work();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (remaining_ != 0) done_.wait(lock);
+  }
+
+  std::size_t nbThreads() const { return workers_.size() + 1; }
+
+ private:
+  void work() {
+    for (;;) {
+      // Tickets carry the generation of their run in the high half, so
+      // that a worker resuming with a stale out-of-range ticket from a
+      // previous run cannot match its index against the task count of
+      // the next one - the index would then be handed out twice and
+      // remaining_ decremented once too often.
+      const std::size_t ticket = next_++;
+      const std::size_t i = ticket & indexMask_;
+      const std::size_t n = nbTasks_.load();
+      // Load the generation after the count: when it matches the
+      // ticket, run() has not moved on since next_ was stamped, so n
+      // belongs to the ticket's run. A ticket stamped with a newer
+      // generation is also valid: the worker then joins that run, and
+      // its stores are visible because next_ is reset last.
+      if ((ticket >> indexBits_) != (generation_.load() & indexMask_) || i >= n)
+        break;
+      (*task_.load())(i);
+      if (--remaining_ == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.notify_all();
+      }
+    }
+  }
+
+  void loop() {
+    std::size_t generation = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_ && generation_.load() == generation) start_.wait(lock);
+        if (stop_) return;
+        generation = generation_.load();
+      }
+      work();
+    }
+  }
+
+  // Ticket layout of next_: generation in the high half, task index in
+  // the low half. The index half bounds nbTasks; the generation half
+  // only needs to tell a stalled worker's run apart from the current
+  // one.
+  static const std::size_t indexBits_ = 4 * sizeof(std::size_t);
+  static const std::size_t indexMask_ = (std::size_t(1) << indexBits_) - 1;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_, done_;
+  std::atomic<const std::function<void(std::size_t)>*> task_;
+  std::atomic<std::size_t> nbTasks_;
+  std::atomic<std::size_t> next_, remaining_;
+  std::atomic<std::size_t> generation_;
+  bool stop_;
+};  // class ThreadPool
+}  // namespace internal
+}  // namespace constraints
+}  // namespace hpp
+
+#endif  // SRC_THREAD_POOL_HH
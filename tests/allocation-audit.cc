@@ -0,0 +1,162 @@
+// Copyright (c) 2026 CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+// Steady-state allocation budget of the solvers. The solver sources
+// are recompiled with HPP_CONSTRAINTS_SOLVER_TRACE so that the audit
+// can attribute allocations to phases, and with EIGEN_RUNTIME_NO_MALLOC
+// so that Eigen aborts on the allocations operator new does not see
+// (see CMakeLists.txt). Every operator new of this binary is counted
+// through solver::audit; after a warm-up solve, another solve,
+// isSatisfied and ExplicitConstraintSet::solve must not allocate at
+// all, so that allocation regressions fail here instead of showing as
+// latency spikes in production.
+
+#define BOOST_TEST_MODULE ALLOCATION_AUDIT
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <hpp/constraints/affine-function.hh>
+#include <hpp/constraints/explicit-constraint-set.hh>
+#include <hpp/constraints/explicit.hh>
+#include <hpp/constraints/implicit.hh>
+#include <hpp/constraints/solver/allocation-audit.hh>
+#include <hpp/constraints/solver/hierarchical-iterative.hh>
+#include <hpp/pinocchio/liegroup-space.hh>
+#include <new>
+#include <sstream>
+
+using namespace hpp::constraints;
+using hpp::pinocchio::LiegroupSpace;
+namespace audit = solver::audit;
+
+// Count every heap allocation of this binary against the current
+// solver phase. Eigen allocates through std::malloc, not operator new;
+// EIGEN_RUNTIME_NO_MALLOC covers that side.
+void* operator new(std::size_t size) {
+  audit::count(size);
+  if (void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  audit::count(size);
+  if (void* p = std::malloc(size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+std::string printReport() {
+  std::ostringstream oss;
+  std::vector<audit::PhaseAllocations> report(audit::report());
+  for (std::size_t i = 0; i < report.size(); ++i)
+    oss << report[i].phase << ": " << report[i].allocations
+        << " allocations, " << report[i].bytes << " bytes\n";
+  return oss.str();
+}
+}  // namespace
+
+BOOST_AUTO_TEST_CASE(iterative_solver_budget) {
+  audit::install();
+
+  matrix_t A(2, 2);
+  A << 2, 0, 0, 1;
+  vector_t b(2);
+  b << 1, -1;
+
+  solver::HierarchicalIterative solver(LiegroupSpace::Rn(2));
+  solver.maxIterations(20);
+  solver.errorThreshold(1e-10);
+  solver.add(Implicit::create(AffineFunction::create(A, b),
+                              ComparisonTypes_t(2, EqualToZero)),
+             0);
+
+  vector_t x(2);
+  // First solve warms up the lazily sized buffers and records the
+  // warm-up allocations per phase.
+  x << 0.5, 0.5;
+  BOOST_REQUIRE_EQUAL(solver.solve(x, solver::lineSearch::Constant()),
+                      solver::HierarchicalIterative::SUCCESS);
+  BOOST_CHECK_MESSAGE(audit::totalAllocations() > 0,
+                      "the interposed operator new did not reach the audit");
+
+  x << 0.1, 0.7;
+  audit::clear();
+  Eigen::internal::set_is_malloc_allowed(false);
+  solver::HierarchicalIterative::Status status =
+      solver.solve(x, solver::lineSearch::Constant());
+  bool satisfied = solver.isSatisfied(x);
+  Eigen::internal::set_is_malloc_allowed(true);
+  std::size_t steadyState = audit::totalAllocations();
+
+  BOOST_CHECK_EQUAL(status, solver::HierarchicalIterative::SUCCESS);
+  BOOST_CHECK(satisfied);
+  BOOST_CHECK_MESSAGE(steadyState == 0,
+                      "steady-state solve performed "
+                          << steadyState << " allocations:\n"
+                          << printReport());
+  audit::uninstall();
+}
+
+BOOST_AUTO_TEST_CASE(explicit_constraint_set_budget) {
+  audit::install();
+
+  // A chain x[i+1] = 2 x[i] + 1 of explicit constraints.
+  matrix_t J(matrix_t::Ones(1, 1) * 2);
+  vector_t b(vector_t::Ones(1));
+
+  ExplicitConstraintSet set(LiegroupSpace::Rn(4));
+  for (int i = 0; i < 3; ++i) {
+    segments_t in(1, segment_t(i, 1));
+    segments_t out(1, segment_t(i + 1, 1));
+    set.add(Explicit::create(LiegroupSpace::Rn(4),
+                             AffineFunction::create(J, b), in, out, in, out));
+  }
+
+  vector_t x(4);
+  x << 1, 0, 0, 0;
+  BOOST_REQUIRE(set.solve(x));
+  BOOST_CHECK_EQUAL(x[3], 15);
+
+  x << 2, 0, 0, 0;
+  audit::clear();
+  Eigen::internal::set_is_malloc_allowed(false);
+  bool solved = set.solve(x);
+  Eigen::internal::set_is_malloc_allowed(true);
+  std::size_t steadyState = audit::totalAllocations();
+
+  BOOST_CHECK(solved);
+  BOOST_CHECK_EQUAL(x[3], 23);
+  BOOST_CHECK_MESSAGE(steadyState == 0,
+                      "steady-state solve performed "
+                          << steadyState << " allocations:\n"
+                          << printReport());
+  audit::uninstall();
+}
@@ -188,6 +188,18 @@ BOOST_AUTO_TEST_CASE(convexShapeContact) {
   //  - object surface 0 for box 2.
   q << 0, 0, 0, 0, 0, 0, 1, -.8, .6, -2, 1, 0, 0, 0;
   q_init.push_back(q);
+  // The fused evaluation matches the separate value and Jacobian
+  // computations.
+  for (std::size_t i = 0; i < q_init.size(); ++i) {
+    LiegroupElement v(f->outputSpace()), v2(f->outputSpace());
+    matrix_t J(f->outputDerivativeSize(), f->inputDerivativeSize());
+    matrix_t J2(f->outputDerivativeSize(), f->inputDerivativeSize());
+    f->value(v, q_init[i]);
+    f->jacobian(J, q_init[i]);
+    f->valueAndJacobian(v2, J2, q_init[i]);
+    BOOST_CHECK_EQUAL(v.vector(), v2.vector());
+    BOOST_CHECK_EQUAL(J, J2);
+  }
   std::vector<LiegroupElement> q1Invq2Exp;
   // Create Solver by substitution with one explicit constraint.
   const value_type epsilon(1e-7);
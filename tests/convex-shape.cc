@@ -33,8 +33,12 @@
 #include <boost/test/included/unit_test.hpp>
 #include <pinocchio/fwd.hpp>
 
+#include "hpp/constraints/gjk.hh"
+
 using hpp::constraints::ConvexShape;
 using hpp::constraints::ConvexShapeData;
+using hpp::constraints::GJK;
+using hpp::constraints::Transform3f;
 using hpp::constraints::value_type;
 using hpp::constraints::vector3_t;
 
@@ -111,4 +115,67 @@ BOOST_AUTO_TEST_CASE(distance) {
   checkDistance(t, vector3_t(3, 0, 0), 1);
   checkDistance(t, vector3_t(1, 1, 0), -1);
   checkDistance(t, vector3_t(0, 1, 0), 0);
+
+  // Pentagon: the edge count is not a multiple of the padded width of
+  // the vectorized kernels.
+  pts.clear();
+  pts.push_back(vector3_t(0, 0, 0));
+  pts.push_back(vector3_t(2, 0, 0));
+  pts.push_back(vector3_t(3, 1, 0));
+  pts.push_back(vector3_t(2, 2, 0));
+  pts.push_back(vector3_t(0, 2, 0));
+  ConvexShape pentagon(pts);
+
+  checkDistance(pentagon, vector3_t(4, 1, 0), 1);
+  checkDistance(pentagon, vector3_t(0, 3, 0), 1);
+  checkDistance(pentagon, vector3_t(1, 1, 0), -1);
+  checkDistance(pentagon, vector3_t(0, 1, 0), 0);
+  BOOST_CHECK(pentagon.isInsideLocal(vector3_t(2.5, 1, 0)));
+  BOOST_CHECK(!pentagon.isInsideLocal(vector3_t(2.8, 0.2, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(gjk) {
+  std::vector<vector3_t> pts;
+  pts.push_back(vector3_t(0, 0, 0));
+  pts.push_back(vector3_t(1, 0, 0));
+  pts.push_back(vector3_t(1, 1, 0));
+  pts.push_back(vector3_t(0, 1, 0));
+  ConvexShape square(pts);
+
+  GJK gjk;
+  Transform3f M1, M2;
+  M1.setIdentity();
+  M2.setIdentity();
+
+  // Coplanar squares separated by a gap along x.
+  M2.translation() = vector3_t(1.5, 0, 0);
+  BOOST_CHECK_SMALL(gjk.distance(square, M1, square, M2) - 0.5, 1e-7);
+  // Parallel planes, overlapping in the xy plane.
+  M2.translation() = vector3_t(0.25, 0.25, 0.7);
+  BOOST_CHECK_SMALL(gjk.distance(square, M1, square, M2) - 0.7, 1e-7);
+  // Gap both in the plane and across planes.
+  M2.translation() = vector3_t(2, 0, 1);
+  BOOST_CHECK_SMALL(gjk.distance(square, M1, square, M2) - sqrt(2.), 1e-7);
+  // Corner to corner.
+  M2.translation() = vector3_t(2, 2, 0);
+  BOOST_CHECK_SMALL(gjk.distance(square, M1, square, M2) - sqrt(2.), 1e-7);
+  // Overlapping coplanar squares.
+  M2.translation() = vector3_t(0.5, 0.5, 0);
+  BOOST_CHECK_SMALL(gjk.distance(square, M1, square, M2), 1e-7);
+
+  // Warm-started sweep: the second square slides away along x. The
+  // accelerated, warm-started instance must agree with the analytic
+  // distance and with a cold vanilla instance, and the witness points
+  // must realize the distance.
+  for (value_type x = 1.5; x < 3.; x += 0.01) {
+    M2.translation() = vector3_t(x, 0.3, 0.2);
+    const value_type expected = sqrt((x - 1) * (x - 1) + 0.04);
+    const value_type d = gjk.distance(square, M1, square, M2);
+    BOOST_CHECK_SMALL(d - expected, 1e-7);
+    BOOST_CHECK_SMALL((gjk.witness1() - gjk.witness2()).norm() - d, 1e-7);
+    GJK vanilla;
+    vanilla.accelerated(false);
+    BOOST_CHECK_SMALL(vanilla.distance(square, M1, square, M2) - expected,
+                      1e-7);
+  }
 }
@@ -285,6 +285,41 @@ BOOST_AUTO_TEST_CASE(order) {
   order_test<3>(f, s, order, inArgs, outArgs);
 }
 
+BOOST_AUTO_TEST_CASE(bulk_add) {
+  Eigen::Matrix<value_type, 1, 1> M;
+  M(0, 0) = 1;
+
+  // dof     :  0 -> 1 -> 2 -> 3
+  // function:    f0   f1   f2
+  AffineFunctionPtr_t f[] = {AffineFunction::create(M),
+                             AffineFunction::create(M),
+                             AffineFunction::create(M)};
+  segment_t s[] = {segment_t(0, 1), segment_t(1, 1), segment_t(2, 1),
+                   segment_t(3, 1)};
+
+  // Add the whole chain at once, in reverse dependency order; the
+  // evaluation order is derived once at the end.
+  std::vector<ExplicitPtr_t> constraints;
+  for (int i = 2; i >= 0; --i)
+    constraints.push_back(Explicit::create(
+        LiegroupSpace::Rn(4), f[i], segments_t(1, s[i]), segments_t(1, s[i + 1]),
+        segments_t(1, s[i]), segments_t(1, s[i + 1])));
+  ExplicitConstraintSet expression(LiegroupSpace::Rn(4));
+  BOOST_CHECK_EQUAL(expression.add(constraints), 3);
+
+  vector_t x(4);
+  x << 1, 2, 3, 4;
+  vector_t xres = x;
+  BOOST_CHECK(expression.solve(xres));
+  BOOST_CHECK_EQUAL(xres[0], x[0]);
+  for (int i = 0; i < 3; ++i)
+    BOOST_CHECK_EQUAL(xres.segment<1>(i + 1),
+                      (*f[i])(xres.segment<1>(i)).vector());
+
+  // A constraint whose outputs are already computed is not added.
+  BOOST_CHECK_EQUAL(expression.add(constraints), 0);
+}
+
 BOOST_AUTO_TEST_CASE(jacobian1) {
   matrix_t J[] = {(matrix_t(1, 1) << 1).finished(),
                   (matrix_t(1, 1) << 2).finished(),
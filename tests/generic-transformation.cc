@@ -28,6 +28,8 @@
 
 #define EIGEN_RUNTIME_NO_MALLOC
 
+#include <hpp/constraints/configuration-constraint.hh>
+#include <hpp/constraints/device-sync-lease.hh>
 #include <hpp/constraints/explicit/relative-pose.hh>
 #include <hpp/constraints/generic-transformation.hh>
 #include <hpp/constraints/solver/by-substitution.hh>
@@ -127,12 +129,29 @@ BOOST_AUTO_TEST_CASE(print) {
 
     f->value(v, q1);
     f->jacobian(J, q1);
-    // TODO this is broken at the moment because of the introduction
-    // of a multithreaded device.
-    // Eigen::internal::set_is_malloc_allowed(false);
+    // Once the device data pool and the per-thread scratch buffers of
+    // GTDataJ are warm, evaluating the function does not allocate.
+    Eigen::internal::set_is_malloc_allowed(false);
     f->value(v, q2);
     f->jacobian(J, q2);
-    // Eigen::internal::set_is_malloc_allowed(true);
+    Eigen::internal::set_is_malloc_allowed(true);
+
+    // The fused evaluation matches the separate calls.
+    LiegroupElement v2(f->outputSpace());
+    matrix_t J2(f->outputDerivativeSize(), f->inputDerivativeSize());
+    f->valueAndJacobian(v2, J2, q2);
+    BOOST_CHECK_EQUAL(v.vector(), v2.vector());
+    BOOST_CHECK_EQUAL(J, J2);
+
+    // The batch evaluation matches the per-sample calls.
+    matrix_t args(f->inputSize(), 2);
+    args.col(0) = q1;
+    args.col(1) = q2;
+    matrix_t batch(f->outputSize(), 2);
+    f->valueBatch(batch, args);
+    f->value(v2, q1);
+    BOOST_CHECK_EQUAL(batch.col(0), v2.vector());
+    BOOST_CHECK_EQUAL(batch.col(1), v.vector());
   }
 
   // Check active parameters
@@ -215,6 +234,118 @@ BOOST_AUTO_TEST_CASE(multithread) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(apply_row_mask) {
+  DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(
+      hpp::pinocchio::unittest::HumanoidSimple);
+  JointPtr_t ee1 = device->getJointByName("lleg5_joint"),
+             ee2 = device->getJointByName("rleg5_joint");
+  BOOST_REQUIRE(device);
+  BasicConfigurationShooter cs(device);
+
+  device->currentConfiguration(*cs.shoot());
+  device->computeForwardKinematics();
+  Transform3f tf1(ee1->currentTransformation());
+  Transform3f tf2(ee2->currentTransformation());
+
+  DifferentiableFunctionPtr_t full = RelativeTransformation::create(
+      "RelativeTransformation", device, ee1, ee2, tf1, tf2);
+
+  // A full mask returns the function itself.
+  std::vector<bool> fullMask(6, true);
+  BOOST_CHECK_EQUAL(applyRowMask(full, fullMask), full);
+
+  // Masked rows are never computed but the active rows match the full
+  // function.
+  std::vector<bool> mask(6, false);
+  mask[0] = mask[1] = mask[5] = true;
+  DifferentiableFunctionPtr_t masked = applyRowMask(full, mask);
+  BOOST_REQUIRE(masked);
+  BOOST_CHECK_EQUAL(masked->outputDerivativeSize(), 3);
+
+  LiegroupElement vFull(full->outputSpace()), vMasked(masked->outputSpace());
+  matrix_t jFull(6, full->inputDerivativeSize()),
+      jMasked(3, masked->inputDerivativeSize());
+  for (int i = 0; i < 10; ++i) {
+    Configuration_t q = *cs.shoot();
+    full->value(vFull, q);
+    full->jacobian(jFull, q);
+    masked->value(vMasked, q);
+    masked->jacobian(jMasked, q);
+    BOOST_CHECK_EQUAL(vMasked.vector()[0], vFull.vector()[0]);
+    BOOST_CHECK_EQUAL(vMasked.vector()[1], vFull.vector()[1]);
+    BOOST_CHECK_EQUAL(vMasked.vector()[2], vFull.vector()[5]);
+    matrix_t jSelected(3, jFull.cols());
+    jSelected.row(0) = jFull.row(0);
+    jSelected.row(1) = jFull.row(1);
+    jSelected.row(2) = jFull.row(5);
+    BOOST_CHECK_EQUAL(jMasked, jSelected);
+  }
+
+  // Masking an already masked function composes the masks.
+  std::vector<bool> subMask(3, false);
+  subMask[2] = true;
+  DifferentiableFunctionPtr_t twice = applyRowMask(masked, subMask);
+  BOOST_REQUIRE(twice);
+  BOOST_CHECK_EQUAL(twice->outputDerivativeSize(), 1);
+
+  // Functions without native row masking are not converted.
+  DifferentiableFunctionPtr_t unsupported(ConfigurationConstraint::create(
+      "Configuration", device, device->currentConfiguration()));
+  std::vector<bool> cMask(unsupported->outputDerivativeSize(), false);
+  BOOST_CHECK(!applyRowMask(unsupported, cMask));
+}
+
+BOOST_AUTO_TEST_CASE(device_sync_lease) {
+  DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(
+      hpp::pinocchio::unittest::HumanoidSimple);
+  device->numberDeviceData(4);
+  JointPtr_t ee1 = device->getJointByName("lleg5_joint"),
+             ee2 = device->getJointByName("rleg5_joint");
+  BOOST_REQUIRE(device);
+  BasicConfigurationShooter cs(device);
+
+  device->currentConfiguration(*cs.shoot());
+  device->computeForwardKinematics();
+  Transform3f tf1(ee1->currentTransformation());
+  Transform3f tf2(ee2->currentTransformation());
+
+  DifferentiableFunctionPtr_t f = RelativeTransformation::create(
+      "RelativeTransformation", device, ee1, ee2, tf1, tf2);
+
+  Configuration_t q = *cs.shoot();
+  LiegroupElement expected(f->outputSpace());
+  matrix_t Jexpected(f->outputDerivativeSize(), f->inputDerivativeSize());
+  f->value(expected, q);
+  f->jacobian(Jexpected, q);
+
+  // Evaluations within the scope of a lease share one DeviceData and
+  // give the same results as without a lease.
+  BOOST_CHECK(DeviceSyncLease::get(device) == NULL);
+  {
+    DeviceSyncLease lease(device);
+    BOOST_REQUIRE(DeviceSyncLease::get(device) != NULL);
+    LiegroupElement v(f->outputSpace());
+    matrix_t J(f->outputDerivativeSize(), f->inputDerivativeSize());
+    f->value(v, q);
+    f->jacobian(J, q);
+    BOOST_CHECK_EQUAL(expected.vector(), v.vector());
+    BOOST_CHECK_EQUAL(Jexpected, J);
+  }
+  BOOST_CHECK(DeviceSyncLease::get(device) == NULL);
+
+  // Each thread holds its own lease across several evaluations.
+  const int N = 10;
+  std::vector<LiegroupElement> vs(N, LiegroupElement(f->outputSpace()));
+#pragma omp parallel for
+  for (int j = 0; j < N; ++j) {
+    DeviceSyncLease lease(device);
+    f->value(vs[j], q);
+    f->value(vs[j], q);
+  }
+  for (int j = 0; j < N; ++j)
+    BOOST_CHECK_EQUAL(expected.vector(), vs[j].vector());
+}
+
 BOOST_AUTO_TEST_CASE(serialization) {
   DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(
       hpp::pinocchio::unittest::HumanoidSimple);
@@ -425,16 +556,32 @@ BOOST_AUTO_TEST_CASE(equality) {
       "RelativeTransformation", device, ee1, ee2, tf1, tf2));
   functions.push_back(RelativeTransformation::create(
       "othername_____________", device, ee1, ee2, tf1, tf2));
-  // functions[2] and functions[3] are meant to have the same value with
-  // different pointers
+  // functions[2] and functions[3] are created identically: the
+  // interning create resolves them to one shared instance.
 
-  BOOST_CHECK(functions[2].get() !=
-              functions[3].get());  // boost implementation for ==
+  BOOST_CHECK(functions[2].get() == functions[3].get());
   BOOST_CHECK(*functions[2] ==
               *functions[3]);  // uses operator== defined in DiffFunc
   BOOST_CHECK(*functions[0] != *functions[2]);  // a lot of things are different
   BOOST_CHECK(*functions[2] != *functions[4]);  // only the names are different
   BOOST_CHECK(*functions[0] != *functions[1]);  // only the names are equal
+
+  // Same name and mask but different joints: not merged.
+  DifferentiableFunctionPtr_t o1(Orientation::create("Orientation", device, ee1,
+                                                     tf1)),
+      o2(Orientation::create("Orientation", device, ee2, tf2));
+  BOOST_CHECK(o1.get() != o2.get());
+  BOOST_CHECK(*o1 != *o2);
+
+  // Implicit constraints over equal functions with equal comparison
+  // types and masks are interned as well.
+  ImplicitPtr_t c1(Implicit::create(functions[2], 6 * EqualToZero)),
+      c2(Implicit::create(functions[3], 6 * EqualToZero)),
+      c3(Implicit::create(functions[2], 6 * Equality));
+  BOOST_CHECK(c1.get() == c2.get());
+  BOOST_CHECK(c1.get() != c3.get());
+  // copy still provides a private instance.
+  BOOST_CHECK(c1->copy().get() != c1.get());
 }
 
 /* Create a robot with the following kinematic chain. All joints are
@@ -0,0 +1,74 @@
+// Copyright (c) 2026 CNRS
+//
+
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+// This test is compiled with EIGEN_RUNTIME_NO_MALLOC (see CMakeLists.txt)
+// and recompiles src/solver/hierarchical-iterative.cc with the same flag,
+// so that Eigen aborts if the descent direction computation allocates.
+
+#define BOOST_TEST_MODULE HIERARCHICAL_ITERATIVE_NO_MALLOC
+#include <../tests/util.hh>
+#include <boost/test/unit_test.hpp>
+#include <hpp/constraints/implicit.hh>
+#include <hpp/constraints/solver/hierarchical-iterative.hh>
+#include <hpp/pinocchio/liegroup-space.hh>
+
+using namespace hpp::constraints;
+using hpp::pinocchio::LiegroupSpace;
+
+// Expose the protected computeDescentDirection method.
+struct Solver : solver::HierarchicalIterative {
+  Solver(const LiegroupSpacePtr_t& space)
+      : solver::HierarchicalIterative(space) {}
+  void descentDirection() const { computeDescentDirection(); }
+};
+
+BOOST_AUTO_TEST_CASE(descent_direction_no_malloc) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  Quadratic::Ptr_t f(new Quadratic(A, -1));
+
+  Solver solver(LiegroupSpace::Rn(2));
+  solver.maxIterations(20);
+  solver.errorThreshold(1e-5);
+  solver.add(Implicit::create(
+                 f, ComparisonTypes_t(f->outputDerivativeSize(), Equality)),
+             0);
+
+  vector_t x(2);
+  // First solve warms up the lazily sized buffers (line search, ...).
+  x << 0.5, 0.5;
+  BOOST_REQUIRE_EQUAL(solver.solve(x),
+                      solver::HierarchicalIterative::SUCCESS);
+
+  x << 0.1, 0.7;
+  solver.computeValue<true>(x);
+  solver.computeSaturation(x);
+  Eigen::internal::set_is_malloc_allowed(false);
+  solver.descentDirection();
+  Eigen::internal::set_is_malloc_allowed(true);
+  BOOST_CHECK(solver.lastStep().squaredNorm() > 0);
+}
@@ -149,6 +149,50 @@ BOOST_AUTO_TEST_CASE(Jlog_SO3) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(logarithm_batch) {
+  // The batch kernels must match the scalar reference implementations,
+  // including on small angles and on angles close to pi.
+  const size_type N = 64;
+  matrix_t Rs(3, 3 * N), logs(3, N), Jlogs(3, 3 * N);
+  Eigen::ArrayXd thetas(N);
+  for (size_type i = 0; i < N; ++i) {
+    vector3_t r0;
+    r0[0] = -1 + 2. * rand() / RAND_MAX;
+    r0[1] = -1 + 2. * rand() / RAND_MAX;
+    r0[2] = -1 + 2. * rand() / RAND_MAX;
+    r0.normalize();
+    // Spread the angles over [0, pi], hitting both thresholds.
+    r0 *= M_PI * value_type(i) / value_type(N - 1);
+    if (i == 1) r0 *= 1e-7;
+    Rs.middleCols<3>(3 * i) = exponential(r0);
+  }
+
+  logSO3Batch(Rs, thetas, logs);
+  JlogSO3Batch(thetas, logs, Jlogs);
+
+  for (size_type i = 0; i < N; ++i) {
+    value_type theta;
+    vector3_t r;
+    logSO3(matrix3_t(Rs.middleCols<3>(3 * i)), theta, r);
+    matrix3_t Jlog;
+    JlogSO3(theta, r, Jlog);
+    BOOST_CHECK_CLOSE(thetas[i] + 1, theta + 1, 1e-10);
+    BOOST_CHECK_SMALL((logs.col(i) - r).squaredNorm(), 1e-20);
+    BOOST_CHECK_SMALL((Jlogs.middleCols<3>(3 * i) - Jlog).squaredNorm(),
+                      1e-20);
+  }
+
+  // Fixed-size instantiation.
+  Eigen::Matrix<value_type, 3, 12> R4(Rs.leftCols<12>());
+  Eigen::Matrix<value_type, 3, 4> log4;
+  Eigen::Matrix<value_type, 3, 12> Jlog4;
+  Eigen::Array<value_type, 4, 1> theta4;
+  logSO3Batch(R4, theta4, log4);
+  JlogSO3Batch(theta4, log4, Jlog4);
+  BOOST_CHECK(log4.isApprox(logs.leftCols<4>()));
+  BOOST_CHECK(Jlog4.isApprox(Jlogs.leftCols<12>()));
+}
+
 BOOST_AUTO_TEST_CASE(Jlog_SE3) {
   for (size_type i = 0; i < 100; ++i) {
     // Generate random rigid body motion
@@ -32,6 +32,7 @@
 #include <../tests/util.hh>
 #include <boost/test/unit_test.hpp>
 #include <hpp/constraints/matrix-view.hh>
+#include <hpp/constraints/packed-mask.hh>
 #include <iostream>
 
 using namespace Eigen;
@@ -73,6 +74,20 @@ BOOST_AUTO_TEST_CASE(block_index) {
   expected_v = {segment_t(4, 1), segment_t(7, 9)};
   BOOST_CHECK_EQUAL(v, expected_v);
 
+  // w = [3,7] straddles the two segments of v.
+  v = {segment_t(0, 5), segment_t(7, 9)};
+  w = {segment_t(3, 5)};
+  expected_v = {segment_t(0, 3), segment_t(8, 8)};
+  BOOST_CHECK_EQUAL(BlockIndex::difference(v, w), expected_v);
+  BlockIndex::subtract(v, w);
+  BOOST_CHECK_EQUAL(v, expected_v);
+
+  v = {a, e};
+  w = {b, f};
+  BlockIndex::add(v, w);
+  expected_v = {a, b, e, f};
+  BOOST_CHECK_EQUAL(v, expected_v);
+
   v = {b, a, c};
   expected_v = {segment_t(0, 3)};
   BlockIndex::sort(v);
@@ -330,3 +345,177 @@ BOOST_AUTO_TEST_CASE(matrix_block_view) {
   checkMatrixBlocks(blocks.keepRows(), m);
   checkMatrixBlocks(blocks.keepCols(), m);
 }
+
+BOOST_AUTO_TEST_CASE(block_copy_plan) {
+  typedef BlockIndex::segment_t segment_t;
+  typedef BlockIndex::segments_t segments_t;
+
+  MatrixXd m(10, 11);
+  for (MatrixXd::Index i = 0; i < m.rows(); ++i)
+    for (MatrixXd::Index j = 0; j < m.cols(); ++j)
+      m(i, j) = MatrixXd::Scalar(m.cols() * i + j);
+
+  segments_t segs;
+  segs.push_back(segment_t(2, 2));  // indices 2, 3
+  segs.push_back(segment_t(4, 1));  // index 4, contiguous with previous
+  segs.push_back(segment_t(6, 3));  // indices 6, 7, 8
+
+  MatrixBlocks<false, true> rows(segs);
+  BlockCopyPlan plan(segs);
+  BOOST_CHECK_EQUAL(plan.nbIndices(), rows.nbRows());
+  BOOST_CHECK(!plan.contiguous());
+
+  // Gathers match the views.
+  MatrixXd condensed(plan.nbIndices(), m.cols());
+  plan.gatherRows(m, condensed);
+  BOOST_CHECK_EQUAL(condensed, rows.rview(m).eval());
+
+  MatrixXd condensedCols(m.rows(), plan.nbIndices());
+  plan.gatherCols(m, condensedCols);
+  BOOST_CHECK_EQUAL(condensedCols,
+                    MatrixBlocks<true, false>(segs).rview(m).eval());
+
+  // Scatter writes the selected rows and leaves the others untouched.
+  MatrixXd scattered(m);
+  plan.scatterRows(2 * condensed, scattered);
+  MatrixXd expected(m);
+  rows.lview(expected) = 2 * condensed;
+  BOOST_CHECK_EQUAL(scattered, expected);
+
+  // Vectors are supported as one column matrices.
+  VectorXd v(VectorXd::LinSpaced(10, 0., 9.)), cv(plan.nbIndices());
+  plan.gatherRows(v, cv);
+  BOOST_CHECK_EQUAL(cv, rows.rview(v).eval());
+  plan.scatterRows(cv, v);
+  BOOST_CHECK_EQUAL(v, VectorXd::LinSpaced(10, 0., 9.));
+
+  // Two dimensional gathers match the combined row and column view.
+  segments_t colSegs;
+  colSegs.push_back(segment_t(1, 3));
+  colSegs.push_back(segment_t(7, 2));
+  BlockCopyPlan colPlan(colSegs);
+  MatrixXd tiles(plan.nbIndices(), colPlan.nbIndices());
+  plan.gather(colPlan, m, tiles);
+  BOOST_CHECK_EQUAL(tiles,
+                    MatrixBlocks<false, false>(segs, colSegs).rview(m).eval());
+
+  // Contiguous segments collapse into a single run.
+  BlockCopyPlan contiguous(segments_t(1, segment_t(3, 4)));
+  BOOST_CHECK(contiguous.contiguous());
+  BOOST_CHECK_EQUAL(contiguous.nbIndices(), 4);
+  BOOST_CHECK(BlockCopyPlan().contiguous());
+  BOOST_CHECK_EQUAL(BlockCopyPlan().nbIndices(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(product_to_view) {
+  typedef MatrixBlocks<false, true> RowsIndices;
+  typedef MatrixBlocks<true, false> ColsIndices;
+  typedef MatrixBlocks<false, false> MatrixBlocks_t;
+
+  RowsIndices rows(2, 2);
+  rows.addRow(6, 4);
+  // rows contains indices 2, 3, 6, 7, 8, 9
+  ColsIndices cols(3, 2);
+  cols.addCol(7, 3);
+  // cols contains indices 3, 4, 7, 8, 9
+  MatrixBlocks_t blocks(rows.rows(), cols.cols());
+
+  MatrixXd A(MatrixXd::Random(rows.nbRows(), 12)),
+      B(MatrixXd::Random(12, cols.nbCols()));
+  // The product is evaluated block-wise into the destination, without a
+  // dense temporary. Compare against an explicit evaluation.
+  MatrixXd expectedProduct(A * B);
+
+  MatrixXd J1(MatrixXd::Zero(10, 11)), J2(MatrixXd::Zero(10, 11));
+  blocks.lview(J1) = A * B;
+  blocks.lview(J2) = expectedProduct;
+  BOOST_CHECK_EQUAL(J1, J2);
+
+  // Row only and column only views.
+  MatrixXd K1(MatrixXd::Zero(10, cols.nbCols())),
+      K2(MatrixXd::Zero(10, cols.nbCols()));
+  rows.lview(K1) = A * B;
+  rows.lview(K2) = expectedProduct;
+  BOOST_CHECK_EQUAL(K1, K2);
+
+  MatrixXd L1(MatrixXd::Zero(rows.nbRows(), 11)),
+      L2(MatrixXd::Zero(rows.nbRows(), 11));
+  cols.lview(L1) = A * B;
+  cols.lview(L2) = expectedProduct;
+  BOOST_CHECK_EQUAL(L1, L2);
+}
+
+BOOST_AUTO_TEST_CASE(lazy_reductions) {
+  typedef MatrixBlocks<false, true> RowsIndices;
+
+  RowsIndices rows(2, 2);
+  rows.addRow(6, 4);
+  // rows contains indices 2, 3, 6, 7, 8, 9
+
+  // Reductions on the view match an explicit evaluation.
+  VectorXd v(VectorXd::LinSpaced(10, -5., 4.));
+  VectorXd dense(rows.rview(v).eval());
+  BOOST_CHECK_EQUAL(rows.rview(v).any([](double x) { return x > 3.; }),
+                    (dense.array() > 3.).any());
+  BOOST_CHECK_EQUAL(rows.rview(v).any([](double x) { return x > 10.; }),
+                    (dense.array() > 10.).any());
+  BOOST_CHECK_EQUAL(rows.rview(v).minCoeff(), dense.minCoeff());
+  BOOST_CHECK_EQUAL(rows.rview(v).maxCoeff(), dense.maxCoeff());
+
+  // The dot product is accumulated segment by segment over the
+  // underlying storage.
+  VectorXd w(VectorXd::Random(rows.nbRows()));
+  BOOST_CHECK_CLOSE(rows.rview(v).dot(w), dense.dot(w), 1e-10);
+
+  // Matrix views support the predicate and extremum reductions too.
+  MatrixXd m(MatrixXd::Random(10, 11));
+  MatrixXd dm(rows.rview(m).eval());
+  BOOST_CHECK_EQUAL(rows.rview(m).minCoeff(), dm.minCoeff());
+  BOOST_CHECK_EQUAL(rows.rview(m).maxCoeff(), dm.maxCoeff());
+  BOOST_CHECK_EQUAL(rows.rview(m).any([](double x) { return x > 0.5; }),
+                    (dm.array() > 0.5).any());
+}
+
+BOOST_AUTO_TEST_CASE(packed_mask) {
+  using hpp::constraints::ArrayXb;
+  using hpp::constraints::PackedMask;
+  using hpp::constraints::segments_t;
+
+  // Sizes around the 64-flag word boundary.
+  const hpp::constraints::size_type sizes[] = {1, 63, 64, 65, 130};
+  for (hpp::constraints::size_type size : sizes) {
+    ArrayXb a(size), b(size);
+    for (int k = 0; k < 10; ++k) {
+      for (hpp::constraints::size_type i = 0; i < size; ++i) {
+        a[i] = (rand() % 4 == 0);
+        b[i] = (rand() % 4 == 0);
+      }
+      PackedMask pa(a), pb(b);
+
+      // Pack / unpack round trip.
+      BOOST_CHECK((pa.unpack() == a).all());
+      BOOST_CHECK_EQUAL(pa.any(), a.any());
+      BOOST_CHECK_EQUAL(pa.intersects(pb), (a && b).any());
+
+      PackedMask pand(pa);
+      pand &= pb;
+      BOOST_CHECK((pand.unpack() == (a && b)).all());
+      PackedMask por(pa);
+      por |= pb;
+      BOOST_CHECK((por.unpack() == (a || b)).all());
+    }
+  }
+
+  // The segment constructor matches packing the expanded mask.
+  segments_t segments;
+  segments.push_back(hpp::constraints::segment_t(3, 10));
+  segments.push_back(hpp::constraints::segment_t(60, 9));
+  segments.push_back(hpp::constraints::segment_t(128, 2));
+  ArrayXb expanded(ArrayXb::Constant(130, false));
+  for (const hpp::constraints::segment_t& s : segments)
+    expanded.segment(s.first, s.second).setConstant(true);
+  PackedMask fromSegments(segments, 130);
+  BOOST_CHECK((fromSegments.unpack() == expanded).all());
+  BOOST_CHECK(fromSegments.intersects(PackedMask(expanded)));
+  BOOST_CHECK(!PackedMask(segments_t(), 130).any());
+}
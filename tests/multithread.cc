@@ -32,9 +32,14 @@
 
 #include <../tests/convex-shape-contact-function.hh>
 #include <../tests/util.hh>
+#include <hpp/constraints/affine-function.hh>
 #include <hpp/constraints/configuration-constraint.hh>
 #include <hpp/constraints/convex-shape-contact.hh>
+#include <hpp/constraints/differentiable-function-set.hh>
+#include <hpp/constraints/explicit-constraint-set.hh>
+#include <hpp/constraints/explicit.hh>
 #include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/task-executor.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/simple-device.hh>
 #include <pinocchio/fwd.hpp>
@@ -103,3 +108,136 @@ BOOST_AUTO_TEST_CASE(multithread) {
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE(parallel_function_set) {
+  DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(
+      hpp::pinocchio::unittest::HumanoidSimple);
+  device->numberDeviceData(4);
+  JointPtr_t ee1 = device->getJointByName("lleg5_joint"),
+             ee2 = device->getJointByName("rleg5_joint");
+  BOOST_REQUIRE(device);
+
+  Configuration_t q;
+  randomConfig(device, q);
+  device->currentConfiguration(q);
+  device->computeForwardKinematics();
+  Transform3f tf1(ee1->currentTransformation());
+  Transform3f tf2(ee2->currentTransformation());
+
+  DifferentiableFunctionSetPtr_t set = DifferentiableFunctionSet::create("set");
+  set->add(Orientation::create("Orientation", device, ee2, tf2));
+  set->add(Position::create("Position", device, ee2, tf2, tf1));
+  set->add(Transformation::create("Transformation", device, ee1, tf1));
+  set->add(RelativeTransformation::create("RelativeTransformation", device,
+                                          ee1, ee2, tf1, tf2));
+  set->add(createConvexShapeContact_triangles(device, ee1,
+                                              "ConvexShapeContact triangle"));
+
+  LiegroupElement vSeq(set->outputSpace()), vPar(set->outputSpace());
+  matrix_t jSeq(set->outputDerivativeSize(), set->inputDerivativeSize()),
+      jPar(set->outputDerivativeSize(), set->inputDerivativeSize());
+  for (int i = 0; i < 10; ++i) {
+    randomConfig(device, q);
+    set->parallelEvaluation(0);
+    set->value(vSeq, q);
+    set->jacobian(jSeq, q);
+    set->parallelEvaluation(4);
+    BOOST_CHECK_EQUAL(set->parallelEvaluation(), 4);
+    set->value(vPar, q);
+    set->jacobian(jPar, q);
+    BOOST_CHECK_EQUAL(vSeq.vector(), vPar.vector());
+    BOOST_CHECK_EQUAL(jSeq, jPar);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_explicit_set) {
+  using hpp::constraints::LiegroupSpace;
+  typedef hpp::constraints::BlockIndex::segment_t segment_t;
+  typedef hpp::constraints::BlockIndex::segments_t segments_t;
+
+  Eigen::Matrix<hpp::constraints::value_type, 1, 1> M;
+  M(0, 0) = 2;
+
+  // Two independent chains sharing the free dofs 0 and 3:
+  // dof: 0 -> 1 -> 2 and 3 -> 4 -> 5. The functions of a chain are
+  // order dependent, the two chains are not.
+  ExplicitConstraintSet set(LiegroupSpace::Rn(6));
+  const int chains[4][2] = {{0, 1}, {3, 4}, {1, 2}, {4, 5}};
+  std::vector<AffineFunctionPtr_t> f;
+  for (int i = 0; i < 4; ++i) {
+    f.push_back(AffineFunction::create(M));
+    segments_t in(1, segment_t(chains[i][0], 1)),
+        out(1, segment_t(chains[i][1], 1));
+    BOOST_CHECK(set.add(Explicit::create(LiegroupSpace::Rn(6), f.back(), in,
+                                         out, in, out)) >= 0);
+  }
+
+  vector_t x(6);
+  for (int i = 0; i < 10; ++i) {
+    x.setRandom();
+    vector_t xSeq = x, xPar = x;
+    set.parallelEvaluation(0);
+    BOOST_CHECK(set.solve(xSeq));
+    set.parallelEvaluation(4);
+    BOOST_CHECK_EQUAL(set.parallelEvaluation(), 4);
+    BOOST_CHECK(set.solve(xPar));
+    BOOST_CHECK_EQUAL(xSeq, xPar);
+    BOOST_CHECK_EQUAL(xSeq[1], 2 * x[0]);
+    BOOST_CHECK_EQUAL(xSeq[2], 4 * x[0]);
+    BOOST_CHECK_EQUAL(xSeq[4], 2 * x[3]);
+    BOOST_CHECK_EQUAL(xSeq[5], 4 * x[3]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_finite_difference) {
+  DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(
+      hpp::pinocchio::unittest::HumanoidSimple);
+  device->numberDeviceData(4);
+  JointPtr_t ee1 = device->getJointByName("lleg5_joint"),
+             ee2 = device->getJointByName("rleg5_joint");
+  BOOST_REQUIRE(device);
+
+  Configuration_t q;
+  randomConfig(device, q);
+  device->currentConfiguration(q);
+  device->computeForwardKinematics();
+  Transform3f tf1(ee1->currentTransformation());
+  Transform3f tf2(ee2->currentTransformation());
+
+  DifferentiableFunctionPtr_t f(RelativeTransformation::create(
+      "RelativeTransformation", device, ee1, ee2, tf1, tf2));
+
+  const value_type eps = std::sqrt(Eigen::NumTraits<value_type>::epsilon());
+  matrix_t jSeq(f->outputDerivativeSize(), f->inputDerivativeSize()),
+      jPar(f->outputDerivativeSize(), f->inputDerivativeSize()),
+      jBatch(f->outputDerivativeSize(), f->inputDerivativeSize());
+  for (int i = 0; i < 10; ++i) {
+    randomConfig(device, q);
+    jSeq.setZero();
+    jPar.setZero();
+    jBatch.setZero();
+    f->finiteDifferenceCentral(jSeq, q, device, eps);
+    f->finiteDifferenceCentral(jPar, q, device, eps, 4);
+    f->finiteDifferenceCentralBatch(jBatch, q, device, eps);
+    BOOST_CHECK((jSeq - jPar).lpNorm<Eigen::Infinity>() < 1e-10);
+    BOOST_CHECK((jSeq - jBatch).lpNorm<Eigen::Infinity>() < 1e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(task_executor) {
+  // The built-in executor runs every task exactly once.
+  TaskExecutorPtr_t executor(TaskExecutor::create(4));
+  BOOST_CHECK_EQUAL(executor->nbThreads(), 4);
+  std::vector<int> ran(100, 0);
+  executor->parallelFor([&ran](std::size_t i) { ++ran[i]; }, ran.size());
+  for (std::size_t i = 0; i < ran.size(); ++i) BOOST_CHECK_EQUAL(ran[i], 1);
+
+  // An installed global executor overrides the per-set pools.
+  TaskExecutor::global(executor);
+  DifferentiableFunctionSetPtr_t set(DifferentiableFunctionSet::create("set"));
+  set->parallelEvaluation(2);
+  BOOST_CHECK_EQUAL(set->parallelEvaluation(), executor->nbThreads());
+  TaskExecutor::global(TaskExecutorPtr_t());
+  set->parallelEvaluation(2);
+  BOOST_CHECK_EQUAL(set->parallelEvaluation(), 2);
+}
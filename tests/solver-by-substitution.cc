@@ -30,10 +30,14 @@
 #include <../tests/util.hh>
 #include <Eigen/Geometry>
 #include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <fstream>
 #include <hpp/constraints/affine-function.hh>
 #include <hpp/constraints/explicit/relative-pose.hh>
 #include <hpp/constraints/generic-transformation.hh>
+#include <hpp/constraints/serialization.hh>
 #include <hpp/constraints/solver/by-substitution.hh>
+#include <hpp/constraints/solver/corpus.hh>
 #include <hpp/pinocchio/configuration.hh>
 #include <hpp/pinocchio/device.hh>
 #include <hpp/pinocchio/joint.hh>
@@ -368,6 +372,32 @@ BOOST_AUTO_TEST_CASE(quadratic) {
   test_quadratic3<1, 4, 2, 6>();
 }
 
+BOOST_AUTO_TEST_CASE(solve_sequence) {
+  matrix_t A(matrix_t::Identity(2, 2));
+  Quadratic::Ptr_t quad(new Quadratic(A, -1));
+
+  BySubstitution solver(LiegroupSpace::Rn(2));
+  solver.maxIterations(20);
+  solver.errorThreshold(test_precision);
+  solver.add(Implicit::create(quad, ComparisonTypes_t(1, Equality)));
+
+  // Samples along a slightly perturbed arc of the unit circle, as
+  // produced by the discretization of a path.
+  const size_type N = 10;
+  matrix_t samples(2, N);
+  for (size_type i = 0; i < N; ++i) {
+    value_type t = 0.1 + 0.8 * value_type(i) / value_type(N - 1);
+    samples.col(i) << 1.05 * cos(t), 0.95 * sin(t);
+  }
+
+  std::vector<BySubstitution::Status> statuses(solver.solveSequence(samples));
+  BOOST_REQUIRE_EQUAL(statuses.size(), (std::size_t)N);
+  for (size_type i = 0; i < N; ++i) {
+    BOOST_CHECK_EQUAL(statuses[(std::size_t)i], BySubstitution::SUCCESS);
+    BOOST_CHECK_SMALL(samples.col(i).squaredNorm() - 1, test_precision);
+  }
+}
+
 void se3ToConfig(const Transform3f& oMi, vectorOut_t v) {
   assert(v.size() == 7);
   v.head<3>() = oMi.translation();
@@ -750,6 +780,22 @@ BOOST_AUTO_TEST_CASE(hybrid_solver) {
   BOOST_CHECK_EQUAL(solver.solve<FixedSequence>(qrand),
                     BySubstitution::SUCCESS);
   BOOST_CHECK_EQUAL(solver.solve<Constant>(qrand), BySubstitution::SUCCESS);
+
+  // The telemetry ring buffer recorded the iterations of the solves
+  // above, in chronological order.
+  typedef BySubstitution::SolveTelemetry SolveTelemetry;
+  std::vector<SolveTelemetry::Iteration> samples(solver.telemetry().dump());
+  BOOST_REQUIRE(!samples.empty());
+  BOOST_CHECK_EQUAL(samples.back().solveId, solver.telemetry().solveId);
+  for (std::size_t i = 1; i < samples.size(); ++i)
+    BOOST_CHECK_LE(samples[i - 1].solveId, samples[i].solveId);
+  // The last solve converged: its last sample is below the threshold.
+  BOOST_CHECK_LE(samples.back().squaredNorm,
+                 solver.squaredErrorThreshold());
+
+  // Sizing the buffer discards the recorded samples.
+  solver.telemetry().capacity(16);
+  BOOST_CHECK(solver.telemetry().dump().empty());
 }
 
 BOOST_AUTO_TEST_CASE(by_substitution_serialization) {
@@ -809,6 +855,200 @@ BOOST_AUTO_TEST_CASE(by_substitution_serialization) {
   ss_expect << solver << '\n';
   ss_result << r_solver << '\n';
   BOOST_CHECK_EQUAL(ss_expect.str(), ss_result.str());
+
+  // Binary round trip through the tagged compact format.
+  namespace cs = hpp::constraints::serialization;
+  std::stringstream bs;
+  cs::saveBinary(bs, solver, "solver", device);
+
+  // The binary archive is more compact than the XML one.
+  BOOST_CHECK_LT(bs.str().size(), ss.str().size());
+
+  BySubstitution b_solver(device->configSpace());
+  cs::loadBinary(bs, b_solver, "solver", device);
+  std::ostringstream ss_binary;
+  ss_binary << b_solver << '\n';
+  BOOST_CHECK_EQUAL(ss_expect.str(), ss_binary.str());
+
+  // Functions equal in content are shared across separate loads.
+  BOOST_REQUIRE_EQUAL(r_solver.constraints().size(),
+                      b_solver.constraints().size());
+  for (std::size_t i = 0; i < r_solver.constraints().size(); ++i)
+    BOOST_CHECK_EQUAL(r_solver.constraints()[i]->functionPtr(),
+                      b_solver.constraints()[i]->functionPtr());
+
+  // Streams without the magic or with another format version are
+  // rejected before boost parses them.
+  std::stringstream garbage;
+  garbage << "not an archive";
+  BOOST_CHECK_THROW(cs::loadBinary(garbage, b_solver, "solver", device),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(lazy_archive) {
+  namespace cs = hpp::constraints::serialization;
+
+  DevicePtr_t device(makeDevice(HumanoidSimple));
+  BOOST_REQUIRE(device);
+  JointPtr_t ee1 = device->getJointByName("rleg5_joint"),
+             ee2 = device->getJointByName("lleg5_joint");
+
+  device->computeForwardKinematics();
+  Transform3f tf1(ee1->currentTransformation());
+  Transform3f tf2(ee2->currentTransformation());
+
+  // A small collection of distinct solvers.
+  std::vector<hpp::shared_ptr<BySubstitution> > solvers;
+  for (int i = 0; i < 3; ++i) {
+    hpp::shared_ptr<BySubstitution> solver(
+        hpp::make_shared<BySubstitution>(device->configSpace()));
+    solver->maxIterations(10 + i);
+    solver->errorThreshold(1e-3);
+    solver->add(Implicit::create(
+        Orientation::create("Orientation rleg5_joint", device, ee1, tf1),
+        3 * Equality));
+    if (i > 0)
+      solver->add(Implicit::create(
+          Orientation::create("Orientation lleg5_joint", device, ee2, tf2),
+          3 * Equality));
+    solvers.push_back(solver);
+  }
+
+  const std::string filename("lazy-archive.bin");
+  {
+    std::ofstream ofs(filename.c_str(), std::ios::binary);
+    BOOST_REQUIRE(ofs.good());
+    cs::saveBinaryCollection(ofs, solvers, "solver", device);
+  }
+
+  // Opening the archive loads the index only.
+  cs::LazyArchive<BySubstitution> archive(filename);
+  BOOST_REQUIRE_EQUAL(archive.size(), solvers.size());
+  for (std::size_t i = 0; i < archive.size(); ++i)
+    BOOST_CHECK(!archive.loaded(i));
+
+  // Payloads are materialized on first access and cached; the others
+  // stay unparsed.
+  hpp::shared_ptr<BySubstitution> s1(archive.at(1, "solver", device));
+  BOOST_CHECK(archive.loaded(1));
+  BOOST_CHECK(!archive.loaded(0));
+  BOOST_CHECK(!archive.loaded(2));
+  BOOST_CHECK_EQUAL(s1, archive.at(1, "solver", device));
+
+  std::ostringstream expected, restored;
+  expected << *solvers[1] << '\n';
+  restored << *s1 << '\n';
+  BOOST_CHECK_EQUAL(expected.str(), restored.str());
+
+  for (std::size_t i = 0; i < archive.size(); ++i) {
+    std::ostringstream exp, got;
+    exp << *solvers[i] << '\n';
+    got << *archive.at(i, "solver", device) << '\n';
+    BOOST_CHECK_EQUAL(exp.str(), got.str());
+  }
+
+  // Garbage files are rejected when the index is loaded.
+  {
+    std::ofstream ofs(filename.c_str(), std::ios::binary);
+    ofs << "not an archive";
+  }
+  BOOST_CHECK_THROW(cs::LazyArchive<BySubstitution> bad(filename),
+                    std::runtime_error);
+  std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(corpus_record_replay) {
+  using hpp::constraints::solver::Corpus;
+
+  DevicePtr_t device(makeDevice(HumanoidSimple));
+  BOOST_REQUIRE(device);
+  JointPtr_t ee1 = device->getJointByName("lleg5_joint"),
+             ee2 = device->getJointByName("rleg5_joint");
+
+  Configuration_t q = device->currentConfiguration();
+  device->currentConfiguration(q);
+  device->computeForwardKinematics();
+  Transform3f tf1(ee1->currentTransformation());
+  Transform3f tf2(ee2->currentTransformation());
+
+  BySubstitution solver(device->configSpace());
+  solver.maxIterations(40);
+  solver.errorThreshold(1e-4);
+  solver.saturation(hpp::make_shared<saturation::Device>(device));
+  solver.add(Implicit::create(
+      Orientation::create("Orientation lleg5_joint", device, ee1, tf1),
+      3 * EqualToZero));
+  solver.add(Implicit::create(
+      Orientation::create("Orientation rleg5_joint", device, ee2, tf2),
+      3 * EqualToZero));
+
+  // Capture a few problems with random seeds, as a planner would.
+  Corpus corpus;
+  for (int i = 0; i < 5; ++i)
+    corpus.record(solver, ::pinocchio::randomConfiguration(device->model()));
+  BOOST_CHECK_EQUAL(corpus.size(), 5);
+
+  // Binary round trip of the corpus file.
+  std::stringstream ss;
+  corpus.save(ss, device);
+  Corpus loaded;
+  loaded.load(ss, device);
+  BOOST_REQUIRE_EQUAL(loaded.size(), corpus.size());
+  BOOST_CHECK_EQUAL(loaded.records()[0].seed, corpus.records()[0].seed);
+  BOOST_CHECK_EQUAL(loaded.records()[0].rightHandSide,
+                    corpus.records()[0].rightHandSide);
+
+  // Replay against each strategy, including a non-default parameter
+  // set, and report the distributions.
+  std::vector<Corpus::Statistics> stats;
+  stats.push_back(loaded.replay<Constant>("constant"));
+  stats.push_back(loaded.replay<Backtracking>("backtracking"));
+  stats.push_back(loaded.replay<FixedSequence>("fixed sequence"));
+  stats.push_back(loaded.replay<ErrorNormBased>("error norm based"));
+  FixedSequence slow;
+  slow.alpha = 0.1;
+  stats.push_back(loaded.replay("fixed sequence, alpha = 0.1", slow));
+
+  for (std::size_t i = 0; i < stats.size(); ++i) {
+    const Corpus::Statistics& s = stats[i];
+    std::ostringstream os;
+    s.print(os);
+    BOOST_TEST_MESSAGE(os.str());
+    BOOST_CHECK_EQUAL(s.nbProblems, loaded.size());
+    BOOST_REQUIRE_EQUAL(s.iterations.size(), loaded.size());
+    BOOST_CHECK_LE(s.nbSuccess, s.nbProblems);
+    BOOST_CHECK_LE(s.minIterations, s.maxIterations);
+    BOOST_CHECK_LE(s.maxIterations, solver.maxIterations());
+  }
+
+  // Tune the parameters on the captured workload, with a grid reduced
+  // to keep the test fast. The default parameter set belongs to the
+  // grid, so the winner cannot solve fewer problems than it.
+  Corpus::TuningOptions options;
+  options.fixedSequenceAlpha = {0.1, 0.2};
+  options.fixedSequenceAlphaMax = {0.95};
+  options.fixedSequenceK = {0.8};
+  options.errorNormBasedAlphaMin = {0.2};
+  Corpus::Profile profile = loaded.tune(options);
+  {
+    std::ostringstream os;
+    profile.statistics.print(os);
+    BOOST_TEST_MESSAGE("tuned: " + os.str());
+  }
+  BOOST_CHECK_EQUAL(profile.statistics.nbProblems, loaded.size());
+  BOOST_CHECK_GE(profile.statistics.nbSuccess, stats[2].nbSuccess);
+
+  if (profile.statistics.nbSuccess == profile.statistics.nbProblems) {
+    // The derived budget covers the observed iteration counts, and the
+    // installed profile reproduces the replay.
+    BOOST_CHECK_GE(profile.maxIterations, profile.statistics.maxIterations);
+    BySubstitution tuned(solver);
+    profile.apply(tuned);
+    BOOST_CHECK_EQUAL(tuned.maxIterations(), profile.maxIterations);
+    vector_t arg(loaded.records()[0].seed);
+    BOOST_CHECK_EQUAL(profile.solve(tuned, arg),
+                      hpp::constraints::solver::HierarchicalIterative::SUCCESS);
+  }
 }
 
 BOOST_AUTO_TEST_CASE(hybrid_solver_rhs) {
@@ -945,6 +1185,47 @@ BOOST_AUTO_TEST_CASE(rightHandSide) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(rightHandSideView) {
+  const size_type N(4);
+  matrix_t A(matrix_t::Random(N, N + 2));
+  AffineFunctionPtr_t affine(AffineFunction::create(A));
+  ImplicitPtr_t constraint(
+      Implicit::create(affine, ComparisonTypes_t(N, Equality)));
+
+  // y = z
+  segments_t in(1, segment_t(N, 1));
+  segments_t out(1, segment_t(N + 1, 1));
+  ExplicitPtr_t expl(Explicit::create(LiegroupSpace::Rn(N + 2),
+                                      AffineFunction::create(matrix_t::Ones(1, 1)),
+                                      in, out, in, out));
+
+  BySubstitution solver(LiegroupSpace::Rn(N + 2));
+  solver.maxIterations(20);
+  solver.errorThreshold(test_precision);
+  solver.add(constraint);
+  solver.add(expl);
+
+  const vector_t& view = solver.rightHandSideView();
+  BOOST_CHECK(view == solver.rightHandSide());
+  const value_type* storage = view.data();
+
+  // The view tracks the mutators and keeps its storage.
+  vector_t b(vector_t::Random(N));
+  solver.rightHandSide(constraint, b);
+  BOOST_CHECK(solver.rightHandSideView() == solver.rightHandSide());
+  BOOST_CHECK_EQUAL(solver.rightHandSideView().data(), storage);
+
+  vector_t q(vector_t::Random(N + 2));
+  solver.rightHandSideFromConfig(q);
+  BOOST_CHECK(solver.rightHandSideView() == solver.rightHandSide());
+  BOOST_CHECK_EQUAL(solver.rightHandSideView().data(), storage);
+
+  // Gather into a preallocated vector.
+  vector_t rhs(solver.rightHandSideSize());
+  solver.getRightHandSide(rhs);
+  BOOST_CHECK(rhs == solver.rightHandSideView());
+}
+
 BOOST_AUTO_TEST_CASE(rightHandSideFromConfig) {
   // Create a kinematic chain
   DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(HumanoidSimple);
@@ -1044,6 +1325,116 @@ BOOST_AUTO_TEST_CASE(rightHandSideFromConfig) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(rightHandSideFromConfigBatch) {
+  // Create a kinematic chain
+  DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(HumanoidSimple);
+  JointPtr_t root = device->rootJoint(),
+             ee1 = device->getJointByName("lleg5_joint"),
+             ee2 = device->getJointByName("rleg5_joint");
+  BOOST_REQUIRE(device);
+
+  ComparisonTypes_t comp1(EqualToZero << Equality << EqualToZero << Equality
+                                      << EqualToZero << Equality);
+  ComparisonTypes_t comp2(2 * Equality << 2 * EqualToZero << 2 * Equality);
+  // Create two relative transformation constraints shared by the solvers
+  Transform3f tf1(Transform3f::Identity());
+  vector3_t u;
+  u << 0, -.2, 0;
+  Transform3f tf2(Transform3f::Identity());
+  tf2.translation(u);
+  DifferentiableFunctionPtr_t h(
+      RelativeTransformation::create("RelativeTransformation", device, ee1, ee2,
+                                     tf1, tf2, std::vector<bool>(6, true)));
+  ImplicitPtr_t c1(Implicit::create(h, comp1));
+  u << 1.2, 0, -1;
+  tf2.translation(u);
+  ImplicitPtr_t c2(hpp::constraints::explicit_::RelativePose::create(
+      "Transformation", device, JointPtr_t(), root, tf2, tf1, comp2,
+      std::vector<bool>(6, true)));
+
+  BySubstitution solver1(device->configSpace()), solver2(device->configSpace()),
+      ref1(device->configSpace()), ref2(device->configSpace());
+  solver1.add(c1);
+  solver1.add(c2);
+  ref1.add(c1);
+  ref1.add(c2);
+  solver2.add(c1);
+  ref2.add(c1);
+
+  std::vector<hpp::constraints::solver::HierarchicalIterative*> solvers;
+  solvers.push_back(&solver1);
+  solvers.push_back(&solver2);
+  for (size_type i = 0; i < 100; ++i) {
+    Configuration_t q(device->configSize());
+    q.setRandom();
+    // Batched right hand side computation, the shared functions are
+    // evaluated once
+    BySubstitution::rightHandSideFromConfig(q, solvers);
+    // Reference solvers computed one by one
+    ref1.rightHandSideFromConfig(q);
+    ref2.rightHandSideFromConfig(q);
+    BOOST_CHECK((solver1.rightHandSide() - ref1.rightHandSide()).norm() <
+                1e-10);
+    BOOST_CHECK((solver2.rightHandSide() - ref2.rightHandSide()).norm() <
+                1e-10);
+    // The Eigen::Ref overload matches the by-value one
+    vector_t rhs(ref1.rightHandSideSize());
+    ref1.rightHandSideFromConfig(q, rhs);
+    BOOST_CHECK((rhs - ref1.rightHandSide()).norm() < 1e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(snapshot) {
+  // Create a kinematic chain
+  DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(HumanoidSimple);
+  JointPtr_t root = device->rootJoint(),
+             ee1 = device->getJointByName("lleg5_joint"),
+             ee2 = device->getJointByName("rleg5_joint");
+  BOOST_REQUIRE(device);
+
+  ComparisonTypes_t comp1(EqualToZero << Equality << EqualToZero << Equality
+                                      << EqualToZero << Equality);
+  ComparisonTypes_t comp2(2 * Equality << 2 * EqualToZero << 2 * Equality);
+  Transform3f tf1(Transform3f::Identity());
+  vector3_t u;
+  u << 0, -.2, 0;
+  Transform3f tf2(Transform3f::Identity());
+  tf2.translation(u);
+  DifferentiableFunctionPtr_t h(
+      RelativeTransformation::create("RelativeTransformation", device, ee1, ee2,
+                                     tf1, tf2, std::vector<bool>(6, true)));
+  ImplicitPtr_t c1(Implicit::create(h, comp1));
+  u << 1.2, 0, -1;
+  tf2.translation(u);
+  ImplicitPtr_t c2(hpp::constraints::explicit_::RelativePose::create(
+      "Transformation", device, JointPtr_t(), root, tf2, tf1, comp2,
+      std::vector<bool>(6, true)));
+
+  BySubstitution solver(device->configSpace());
+  solver.maxIterations(20);
+  solver.errorThreshold(test_precision);
+  solver.add(c1);
+  solver.add(c2);
+
+  Configuration_t q1(device->configSize()), q2(device->configSize());
+  q1.setRandom();
+  q2.setRandom();
+  solver.rightHandSideFromConfig(q1);
+  // Capture the problem parameters
+  BySubstitution::Snapshot s(solver.snapshot());
+  vector_t rhs1(solver.rightHandSide());
+  // Try an alternative right hand side and change the thresholds
+  solver.rightHandSideFromConfig(q2);
+  solver.errorThreshold(10 * test_precision);
+  solver.maxIterations(5);
+  BOOST_CHECK((solver.rightHandSide() - rhs1).norm() > 1e-8);
+  // Restore and compare to the captured state
+  solver.restore(s);
+  BOOST_CHECK((solver.rightHandSide() - rhs1).norm() < 1e-10);
+  BOOST_CHECK_CLOSE(solver.errorThreshold(), test_precision, 1e-10);
+  BOOST_CHECK_EQUAL(solver.maxIterations(), 20);
+}
+
 BOOST_AUTO_TEST_CASE(merge) {
   // Create a kinematic chain
   DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(HumanoidSimple);
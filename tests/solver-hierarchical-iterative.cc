@@ -151,6 +151,347 @@ BOOST_AUTO_TEST_CASE(quadratic) {
   EIGEN_VECTOR_IS_APPROX(test1.success(0, 1), VECTOR2(0., 1 / sqrt(2)));
 }
 
+BOOST_AUTO_TEST_CASE(coarse_refine) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+  test.solver.coarseErrorThreshold(1e-2);
+
+  vector_t x(VECTOR2(0.1, 0.2));
+  BOOST_CHECK_EQUAL(test.solver.solve(x, test.ls),
+                    solver::HierarchicalIterative::SUCCESS);
+  // The coarse stage only guarantees the coarse threshold.
+  BOOST_CHECK(test.solver.isSatisfied(x, 1e-2));
+  // Refine continues on the warm state down to the tight threshold.
+  BOOST_CHECK_EQUAL(test.solver.refine(x, test.ls),
+                    solver::HierarchicalIterative::SUCCESS);
+  BOOST_CHECK(test.solver.isSatisfied(x));
+}
+
+BOOST_AUTO_TEST_CASE(multi_start) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+
+  matrix_t seeds(2, 3);
+  seeds.col(0) = VECTOR2(0, 0);  // Singular point: this seed fails.
+  seeds.col(1) = VECTOR2(0.1, 0.2);
+  seeds.col(2) = VECTOR2(0.3, 0.1);
+  const matrix_t backup(seeds);
+
+  const size_type c = test.solver.solveAny(seeds, 2, test.ls);
+  BOOST_REQUIRE(c >= 1 && c <= 2);
+  BOOST_CHECK(test.solver.isSatisfied(seeds.col(c)));
+  // The losing columns are left untouched.
+  for (size_type j = 0; j < seeds.cols(); ++j)
+    if (j != c) BOOST_CHECK_EQUAL(seeds.col(j), backup.col(j));
+
+  // No seed converges from the singular point.
+  matrix_t bad(2, 1);
+  bad.col(0) = VECTOR2(0, 0);
+  BOOST_CHECK_EQUAL(test.solver.solveAny(bad, 2, test.ls), -1);
+}
+
+BOOST_AUTO_TEST_CASE(decompositions) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  const solver::HierarchicalIterative::DecompositionMethod methods[] = {
+      solver::HierarchicalIterative::JACOBI_SVD,
+      solver::HierarchicalIterative::BDC_SVD,
+      solver::HierarchicalIterative::COMPLETE_ORTHOGONAL_DECOMPOSITION,
+      solver::HierarchicalIterative::DAMPED_CHOLESKY};
+  for (const auto& method : methods) {
+    test_quadratic<> test(A);
+    test.solver.decomposition(method);
+    BOOST_CHECK_EQUAL(test.solver.decomposition(), method);
+    test.success(0.1, 0);
+    test.success(0, 0.1);
+    test.success(0.5, 0.5);
+  }
+}
+
+// f(q) = q[0] - 0.5, reads the first configuration variable only and
+// counts its evaluations.
+class CountingAffine : public DifferentiableFunction {
+ public:
+  typedef hpp::shared_ptr<CountingAffine> Ptr_t;
+  mutable int nbValue;
+
+  CountingAffine()
+      : DifferentiableFunction(2, 2, 1, "CountingAffine"), nbValue(0) {
+    activeParameters_.setConstant(false);
+    activeParameters_[0] = true;
+    activeDerivativeParameters_.setConstant(false);
+    activeDerivativeParameters_[0] = true;
+  }
+
+  void impl_compute(LiegroupElementRef y, vectorIn_t x) const {
+    ++nbValue;
+    y.vector()[0] = x[0] - 0.5;
+  }
+
+  void impl_jacobian(matrixOut_t J, vectorIn_t) const {
+    J.setZero();
+    J(0, 0) = 1;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(incremental_value) {
+  solver::HierarchicalIterative solver(LiegroupSpace::Rn(2));
+  solver.maxIterations(20);
+  solver.errorThreshold(test_precision);
+
+  CountingAffine::Ptr_t affine(new CountingAffine());
+  matrix_t A(matrix_t::Zero(2, 2));
+  A(1, 1) = 1;
+  Quadratic::Ptr_t quad(new Quadratic(A, -1));
+  solver.add(Implicit::create(affine, ComparisonTypes_t(1, EqualToZero)), 0);
+  solver.add(Implicit::create(quad, ComparisonTypes_t(1, EqualToZero)), 1);
+
+  // Only the second dof is an unknown: the input of the first level
+  // never changes during the resolution, so it must be evaluated only
+  // once.
+  solver.freeVariables(segments_t(1, segment_t(1, 1)));
+
+  vector_t x(VECTOR2(0.5, 0.3));
+  BOOST_CHECK_EQUAL(solver.solve(x, solver::lineSearch::Constant()),
+                    solver::HierarchicalIterative::SUCCESS);
+  BOOST_CHECK_SMALL(x[1] - 1, test_precision);
+  BOOST_CHECK_EQUAL(affine->nbValue, 1);
+}
+
+BOOST_AUTO_TEST_CASE(fused_satisfaction) {
+  solver::HierarchicalIterative solver(LiegroupSpace::Rn(2));
+  solver.maxIterations(20);
+  solver.errorThreshold(test_precision);
+
+  matrix_t A(matrix_t::Identity(2, 2));
+  Quadratic::Ptr_t quad(new Quadratic(A, -1));
+  CountingAffine::Ptr_t affine(new CountingAffine());
+  solver.add(Implicit::create(quad, ComparisonTypes_t(1, EqualToZero)), 0);
+  solver.add(Implicit::create(affine, ComparisonTypes_t(1, EqualToZero)), 0);
+
+  // Clearly violated sample: the first constraint crosses the
+  // threshold, so the second function is not evaluated at all.
+  vector_t x(VECTOR2(0, 0));
+  BOOST_CHECK(!solver.isSatisfiedFast(x));
+  BOOST_CHECK_EQUAL(affine->nbValue, 0);
+  // The full evaluation gives the same answer.
+  BOOST_CHECK(!solver.isSatisfied(x));
+  BOOST_CHECK_EQUAL(affine->nbValue, 1);
+
+  // Satisfied sample: every constraint is evaluated once; the fused
+  // evaluation feeds the cache, so isSatisfied reuses it.
+  x = VECTOR2(0.5, std::sqrt(0.75));
+  BOOST_CHECK(solver.isSatisfiedFast(x));
+  BOOST_CHECK(solver.isSatisfied(x));
+  BOOST_CHECK_EQUAL(affine->nbValue, 2);
+
+  // Both paths agree on random samples.
+  for (int i = 0; i < 20; ++i) {
+    x = vector_t::Random(2);
+    BOOST_CHECK_EQUAL(solver.isSatisfiedFast(x), solver.isSatisfied(x));
+  }
+
+  // The batched check gives the per-sample answers.
+  matrix_t configs(matrix_t::Random(2, 30));
+  configs.col(0) = VECTOR2(0.5, std::sqrt(0.75));
+  ArrayXb results;
+  solver.isSatisfied(configs, results);
+  BOOST_REQUIRE_EQUAL(results.size(), configs.cols());
+  BOOST_CHECK(results[0]);
+  for (size_type c = 0; c < configs.cols(); ++c)
+    BOOST_CHECK_EQUAL(results[c], solver.isSatisfied(configs.col(c)));
+}
+
+BOOST_AUTO_TEST_CASE(satisfaction_cache) {
+  solver::HierarchicalIterative solver(LiegroupSpace::Rn(2));
+  solver.maxIterations(20);
+  solver.errorThreshold(test_precision);
+
+  CountingAffine::Ptr_t affine(new CountingAffine());
+  solver.add(Implicit::create(affine, ComparisonTypes_t(1, Equality)), 0);
+  solver.satisfactionCache(4);
+  BOOST_CHECK_EQUAL(solver.satisfactionCache(), 4);
+
+  // Alternating between two configurations thrashes the single-entry
+  // evaluation cache, but with memoization each one is evaluated once
+  // and every later query is a lookup.
+  vector_t x1(VECTOR2(0.5, 0.)), x2(VECTOR2(0.2, 0.));
+  bool s1 = solver.isSatisfied(x1), s2 = solver.isSatisfied(x2);
+  BOOST_CHECK_EQUAL(affine->nbValue, 2);
+  for (int i = 0; i < 5; ++i) {
+    BOOST_CHECK_EQUAL(solver.isSatisfied(x1), s1);
+    BOOST_CHECK_EQUAL(solver.isSatisfied(x2), s2);
+  }
+  BOOST_CHECK_EQUAL(affine->nbValue, 2);
+
+  // A right hand side modification discards the memoized results.
+  vector_t rhs(1);
+  rhs[0] = x2[0] - 0.5;
+  solver.rightHandSide(rhs);
+  BOOST_CHECK(solver.isSatisfied(x2));
+  BOOST_CHECK_EQUAL(affine->nbValue, 3);
+
+  // Memoized and fresh answers agree on random samples.
+  solver::HierarchicalIterative fresh(solver);
+  fresh.satisfactionCache(0);
+  BOOST_CHECK_EQUAL(fresh.satisfactionCache(), 0);
+  for (int i = 0; i < 20; ++i) {
+    vector_t x(vector_t::Random(2));
+    BOOST_CHECK_EQUAL(solver.isSatisfied(x), fresh.isSatisfied(x));
+    BOOST_CHECK_EQUAL(solver.isSatisfied(x), fresh.isSatisfied(x));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(active_column_compaction) {
+  solver::HierarchicalIterative solver(LiegroupSpace::Rn(2));
+  solver.maxIterations(20);
+  solver.errorThreshold(test_precision);
+
+  // The constraint reads the first dof only, so the descent direction
+  // is computed on the compact one-column Jacobian.
+  CountingAffine::Ptr_t affine(new CountingAffine());
+  solver.add(Implicit::create(affine, ComparisonTypes_t(1, EqualToZero)), 0);
+
+  vector_t x(VECTOR2(0.2, 0.3));
+  BOOST_CHECK_EQUAL(solver.solve(x, solver::lineSearch::Constant()),
+                    solver::HierarchicalIterative::SUCCESS);
+  BOOST_CHECK_SMALL(x[0] - 0.5, test_precision);
+  // The structurally zero column yields a zero velocity.
+  BOOST_CHECK_EQUAL(x[1], 0.3);
+}
+
+BOOST_AUTO_TEST_CASE(quasi_newton) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+  // Recompute the exact Jacobian every third iteration only; the Broyden
+  // updates must not prevent convergence.
+  test.solver.jacobianRefreshPeriod(3);
+  BOOST_CHECK_EQUAL(test.solver.jacobianRefreshPeriod(), 3);
+  test.success(0.1, 0);
+  test.success(0, 0.1);
+  test.success(0.5, 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(jacobian_transpose_mode) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+  // Take decomposition-free Jacobian-transpose steps while the error
+  // norm is above 0.5; the pseudo-inverse must take over close to the
+  // solution and convergence must not be affected.
+  test.solver.jacobianTransposeThreshold(0.5);
+  BOOST_CHECK_EQUAL(test.solver.jacobianTransposeThreshold(), 0.5);
+  test.success(0.1, 0);
+  test.success(0, 0.1);
+  test.success(0.5, 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(incremental_svd) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+  // Reuse the right singular subspace of the previous iteration while
+  // the Jacobian perturbation stays small; convergence must not be
+  // affected.
+  test.solver.incrementalSvdThreshold(0.25);
+  BOOST_CHECK_EQUAL(test.solver.incrementalSvdThreshold(), 0.25);
+  test.success(0.1, 0);
+  test.success(0, 0.1);
+  test.success(0.5, 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(solve_context) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+
+  // A per-thread context must give the same result as the internal one,
+  // and must not touch the solver default context.
+  solver::HierarchicalIterative::SolveContext context;
+  test.solver.initSolveContext(context);
+
+  vector_t x(VECTOR2(0.5, 0.5));
+  BOOST_CHECK_EQUAL(test.solver.solve(x, context, test.ls),
+                    solver::HierarchicalIterative::SUCCESS);
+  BOOST_CHECK_SMALL(x.squaredNorm() - 1, test_precision);
+
+  vector_t y(VECTOR2(0.5, 0.5));
+  test_quadratic<> ref(A);
+  ref.solver.solve(y, ref.ls);
+  EIGEN_VECTOR_IS_APPROX(x, y);
+}
+
+BOOST_AUTO_TEST_CASE(memory_usage) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+
+  typedef solver::HierarchicalIterative::MemoryUsageReport Report_t;
+  Report_t report(test.solver.memoryUsage());
+  // The scratch arena and the decompositions are sized by update when
+  // the constraint is added.
+  BOOST_CHECK(report.arena > 0);
+  BOOST_CHECK(report.decompositions > 0);
+  BOOST_CHECK_EQUAL(report.explicitSet, 0);
+  BOOST_CHECK_EQUAL(report.total(), report.arena + report.datas +
+                                        report.decompositions +
+                                        report.context + report.solver);
+}
+
+BOOST_AUTO_TEST_CASE(batch_solve) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+
+  // Seeds stored column-wise. Each column must match the result of the
+  // single seed API.
+  matrix_t seeds(2, 4);
+  seeds.col(0) = VECTOR2(0.1, 0);
+  seeds.col(1) = VECTOR2(0, 0.1);
+  seeds.col(2) = VECTOR2(0.5, 0.5);
+  seeds.col(3) = VECTOR2(0, 0);
+  matrix_t expected(seeds);
+
+  std::vector<solver::HierarchicalIterative::Status> statuses(
+      test.solver.solve(seeds, test.ls));
+  BOOST_REQUIRE_EQUAL(statuses.size(), 4);
+  for (std::size_t c = 0; c < 3; ++c)
+    BOOST_CHECK_EQUAL(statuses[c], solver::HierarchicalIterative::SUCCESS);
+  // (0, 0) is a singular point of the quadratic function.
+  BOOST_CHECK(statuses[3] != solver::HierarchicalIterative::SUCCESS);
+
+  test_quadratic<> ref(A);
+  for (size_type c = 0; c < expected.cols(); ++c) {
+    vectorOut_t x(expected.col(c));
+    ref.solver.solve(x, ref.ls);
+    EIGEN_VECTOR_IS_APPROX(seeds.col(c), expected.col(c));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write) {
+  matrix_t A(2, 2);
+  A << 1, 0, 0, 1;
+  test_quadratic<> test(A);
+
+  solver::HierarchicalIterative clone(test.solver);
+  // The clone shares the constraint objects until one of the solvers
+  // modifies them.
+  BOOST_CHECK(clone.constraints()[0] == test.solver.constraints()[0]);
+
+  vector_t rhs(1);
+  rhs << 0.5;
+  clone.rightHandSide(rhs);
+  // The write detached the clone from the original solver.
+  BOOST_CHECK(clone.constraints()[0] != test.solver.constraints()[0]);
+  EIGEN_VECTOR_IS_NOT_APPROX(clone.rightHandSide(),
+                             test.solver.rightHandSide());
+  // The original solver is left untouched.
+  test.success(0.5, 0.5);
+}
+
 BOOST_AUTO_TEST_CASE(one_layer) {
   DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(
       hpp::pinocchio::unittest::HumanoidSimple);
@@ -201,6 +542,58 @@ BOOST_AUTO_TEST_CASE(one_layer) {
                     solver::HierarchicalIterative::SUCCESS);
 }
 
+BOOST_AUTO_TEST_CASE(device_saturation) {
+  DevicePtr_t device = hpp::pinocchio::unittest::makeDevice(
+      hpp::pinocchio::unittest::HumanoidSimple);
+  BOOST_REQUIRE(device);
+  for (int i = 0; i < 3; ++i) {
+    device->rootJoint()->lowerBound(i, -0.5);
+    device->rootJoint()->upperBound(i, 0.5);
+  }
+  const ::pinocchio::Model& model = device->model();
+
+  solver::saturation::Device saturation(device);
+  Configuration_t qSat(model.nq);
+  Eigen::VectorXi sat(model.nv);
+  for (int trial = 0; trial < 10; ++trial) {
+    // Push some variables out of bounds.
+    Configuration_t q = ::pinocchio::randomConfiguration(model);
+    q.head<3>() += Configuration_t::Random(3);
+
+    bool res = saturation.saturate(q, qSat, sat);
+
+    // Element-wise reference.
+    bool expected = false;
+    Configuration_t qSatRef(model.nq);
+    Eigen::VectorXi satRef(model.nv);
+    for (std::size_t j = 1; j < model.joints.size(); ++j) {
+      const size_type nq = model.joints[j].nq();
+      const size_type nv = model.joints[j].nv();
+      const size_type idx_q = model.joints[j].idx_q();
+      const size_type idx_v = model.joints[j].idx_v();
+      for (size_type k = 0; k < nq; ++k) {
+        const size_type iq = idx_q + k;
+        const size_type iv = idx_v + std::min(k, nv - 1);
+        if (q[iq] <= model.lowerPositionLimit[iq]) {
+          qSatRef[iq] = model.lowerPositionLimit[iq];
+          satRef[iv] = -1;
+          expected = true;
+        } else if (q[iq] >= model.upperPositionLimit[iq]) {
+          qSatRef[iq] = model.upperPositionLimit[iq];
+          satRef[iv] = 1;
+          expected = true;
+        } else {
+          qSatRef[iq] = q[iq];
+          satRef[iv] = 0;
+        }
+      }
+    }
+    BOOST_CHECK_EQUAL(res, expected);
+    BOOST_CHECK_EQUAL(qSat, qSatRef);
+    BOOST_CHECK_EQUAL(sat, satRef);
+  }
+}
+
 template <typename LineSearch = solver::lineSearch::Constant>
 struct test_affine_opt : test_base<LineSearch> {
   test_affine_opt(const matrix_t& A, const matrix_t& B)
@@ -251,6 +644,65 @@ BOOST_AUTO_TEST_CASE(affine_opt) {
   EIGEN_VECTOR_IS_APPROX(test.optimize(0.5, 0.5), VECTOR2(0.5, 0.5));
 }
 
+BOOST_AUTO_TEST_CASE(sparse_affine_function) {
+  const size_type rows = 20, cols = 30;
+  typedef SparseAffineFunction::SparseMatrix_t SparseMatrix_t;
+  typedef Eigen::Triplet<value_type> Triplet_t;
+  std::vector<Triplet_t> triplets;
+  triplets.push_back(Triplet_t(0, 0, 1.));
+  triplets.push_back(Triplet_t(3, 7, -2.));
+  triplets.push_back(Triplet_t(12, 7, 0.5));
+  triplets.push_back(Triplet_t(19, 29, 4.));
+  SparseMatrix_t J(rows, cols);
+  J.setFromTriplets(triplets.begin(), triplets.end());
+  vector_t b(vector_t::Random(rows));
+
+  SparseAffineFunctionPtr_t sparse(SparseAffineFunction::create(J, b));
+  AffineFunctionPtr_t dense(AffineFunction::create(matrix_t(J), b));
+
+  BOOST_CHECK(
+      (sparse->activeParameters() == dense->activeParameters()).all());
+
+  LiegroupElement vSparse(sparse->outputSpace()), vDense(dense->outputSpace());
+  matrix_t jSparse(rows, cols), jDense(rows, cols);
+  for (int i = 0; i < 5; ++i) {
+    vector_t x(vector_t::Random(cols));
+    sparse->value(vSparse, x);
+    dense->value(vDense, x);
+    EIGEN_VECTOR_IS_APPROX(vSparse.vector(), vDense.vector());
+    sparse->jacobian(jSparse, x);
+    dense->jacobian(jDense, x);
+    BOOST_CHECK_EQUAL(jSparse, jDense);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(jacobian_on_columns) {
+  const size_type rows = 8, cols = 12;
+  matrix_t A(matrix_t::Random(rows, cols));
+  vector_t b(vector_t::Random(rows));
+  AffineFunctionPtr_t f(AffineFunction::create(A, b));
+  BOOST_CHECK(f->providesJacobianOnColumns());
+
+  segments_t sel;
+  sel.push_back(segment_t(1, 3));
+  sel.push_back(segment_t(7, 2));
+
+  vector_t x(vector_t::Random(cols));
+  matrix_t full(rows, cols), onCols(rows, 5), expected(rows, 5);
+  f->jacobian(full, x);
+  f->jacobianOnColumns(onCols, x, sel);
+  expected << full.middleCols(1, 3), full.middleCols(7, 2);
+  BOOST_CHECK_EQUAL(onCols, expected);
+
+  typedef SparseAffineFunction::SparseMatrix_t SparseMatrix_t;
+  SparseAffineFunctionPtr_t sparse(
+      SparseAffineFunction::create(SparseMatrix_t(A.sparseView()), b));
+  BOOST_CHECK(sparse->providesJacobianOnColumns());
+  onCols.setZero();
+  sparse->jacobianOnColumns(onCols, x, sel);
+  BOOST_CHECK_EQUAL(onCols, expected);
+}
+
 // build an implicit constraint with values in SE3 and with non trivial mask
 BOOST_AUTO_TEST_CASE(mask) {
   struct Identity : public DifferentiableFunction {
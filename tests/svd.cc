@@ -109,3 +109,30 @@ BOOST_AUTO_TEST_CASE(eigen_svd_features) {
   test<true, true>();
   test<false, true>();
 }
+
+BOOST_AUTO_TEST_CASE(pseudo_inverse_workspace) {
+  const std::size_t rows = 4, cols = 6;
+  typedef Eigen::JacobiSVD<matrix_t> SVD;
+  SVD svd(rows, cols, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  svd.setThreshold(1e-6);
+  matrix_t Mpinv(cols, rows), MpinvWs(cols, rows);
+  SVD::SingularValuesType workspace;
+  for (int i = 0; i < 100; ++i) {
+    matrix_t M = matrix_t::Random(rows, cols);
+    svd.compute(M);
+    pseudoInverse<SVD>(svd, Mpinv);
+    pseudoInverse<SVD>(svd, MpinvWs, workspace);
+    BOOST_CHECK_EQUAL(Mpinv, MpinvWs);
+  }
+
+  // The utilities instantiated for a fixed size matrix type run on
+  // fixed size workspaces.
+  typedef Eigen::Matrix<value_type, 3, 3> matrix3_t;
+  typedef Eigen::JacobiSVD<matrix3_t> SVD3;
+  SVD3 svd3(3, 3, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  matrix3_t M3(matrix3_t::Random()), M3pinv;
+  SVD3::SingularValuesType workspace3;
+  svd3.compute(M3);
+  pseudoInverse<SVD3>(svd3, M3pinv, workspace3);
+  BOOST_CHECK_MESSAGE((M3 * M3pinv * M3).isApprox(M3), "M = M * M+ * M failed");
+}
@@ -439,6 +439,74 @@ BOOST_AUTO_TEST_CASE(MatrixOfExpTest) {
   delete d2;
 }
 
+BOOST_AUTO_TEST_CASE(InlineExpTest) {
+  using namespace crossProduct;
+  DataWrapper* d1 = new DataWrapper();
+  DataWrapper* d2 = new DataWrapper();
+  // The leaves and the operator node live on the stack.
+  InlineExp<PointTester> p1(PointTester(d1)), p2(PointTester(d2));
+  typedef CrossProduct<InlineExp<PointTester>, InlineExp<PointTester> > CP_t;
+  InlineExp<CP_t> cp = p1 ^ p2;
+  Value v;
+  Jacobian j;
+  vector_t unused;
+  for (size_t i = 0; i < 100; i++) {
+    Config cfg = Config::Random();
+    cp->invalidate();
+    setWrappers(cfg, d1, d2);
+    cp->computeValue(unused);
+    value(cfg, v);
+    jacobian(cfg, j);
+    BOOST_CHECK(cp->value().isApprox(v));
+    cp->computeJacobian(unused);
+    BOOST_CHECK(cp->jacobian().isApprox(j));
+  }
+  // The shared form obtained from share() evaluates the same expression.
+  Traits<CP_t>::Ptr_t shared = cp.share();
+  Config cfg = Config::Random();
+  shared->invalidate();
+  setWrappers(cfg, d1, d2);
+  shared->computeValue(unused);
+  value(cfg, v);
+  BOOST_CHECK(shared->value().isApprox(v));
+  delete d1;
+  delete d2;
+}
+
+BOOST_AUTO_TEST_CASE(MatrixOfExpCompiledTest) {
+  using namespace matrixOfExp;
+  DataWrapper* d1 = new DataWrapper();
+  DataWrapper* d2 = new DataWrapper();
+  Traits<PointTester>::Ptr_t p1 = PointTester::create(d1),
+                             p2 = PointTester::create(d2);
+  typedef MatrixOfExpressions<Value, Jacobian> MoE_t;
+  OutputValue v;
+  OutputJacobian j;
+  MoE_t moe(v, j);
+  moe.setSize(2, 2);
+  moe.set(0, 0, p1);
+  moe.set(1, 0, p1 ^ p2);
+  moe.set(0, 1, p1 - p2);
+  moe.set(1, 1, p1 + p2);
+  moe.compile();
+  // p1 and p2 are shared between the elements and must be recorded once:
+  // 2 leaves, 3 operator nodes and the matrix itself.
+  vector_t unused;
+  for (size_t i = 0; i < 100; i++) {
+    Config cfg = Config::Random();
+    moe.invalidate();
+    setWrappers(cfg, d1, d2);
+    moe.computeValue(unused);
+    value(cfg, v);
+    jacobian(cfg, j);
+    BOOST_CHECK(moe.value().isApprox(v));
+    moe.computeJacobian(unused);
+    BOOST_CHECK(moe.jacobian().isApprox(j));
+  }
+  delete d1;
+  delete d2;
+}
+
 BOOST_AUTO_TEST_CASE(FunctionExpTest) {
   typedef Eigen::Matrix<value_type, 3, 1> Config;
   AffineFunctionPtr_t func(AffineFunction::create(matrix3_t::Identity()));
@@ -260,6 +260,47 @@ BOOST_AUTO_TEST_CASE(jacobian) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(restricted_configuration_constraint) {
+  DevicePtr_t device = createRobot();
+  Configuration_t goal = device->currentConfiguration();
+  const size_type nv = device->numberDof();
+  BOOST_REQUIRE(nv >= 14);
+
+  segments_t dofs;
+  dofs.push_back(segment_t(0, 3));
+  dofs.push_back(segment_t(10, 4));
+
+  // Restricting the evaluation to a set of dofs is equivalent to
+  // zeroing the weights of the other dofs.
+  vector_t masked(vector_t::Zero(nv));
+  masked.segment<3>(0).setOnes();
+  masked.segment<4>(10).setOnes();
+  ConfigurationConstraintPtr_t full =
+      ConfigurationConstraint::create("Configuration masked", device, goal,
+                                      masked);
+  ConfigurationConstraintPtr_t restricted = ConfigurationConstraint::create(
+      "Configuration restricted", device, goal, vector_t(vector_t::Ones(nv)));
+  restricted->restrictToDofs(dofs);
+  BOOST_CHECK_EQUAL(restricted->restrictedDofs().rows().size(), 2);
+
+  LiegroupElement vFull(full->outputSpace()), vRes(restricted->outputSpace());
+  matrix_t jFull(1, nv), jRes(1, nv);
+  Configuration_t q;
+  for (int i = 0; i < 10; ++i) {
+    randomConfig(device, q);
+    full->value(vFull, q);
+    restricted->value(vRes, q);
+    BOOST_CHECK_SMALL(std::abs(vFull.vector()[0] - vRes.vector()[0]), 1e-10);
+    full->jacobian(jFull, q);
+    restricted->jacobian(jRes, q);
+    BOOST_CHECK(jFull.isApprox(jRes));
+  }
+
+  // An empty set of intervals restores the whole configuration mode.
+  restricted->restrictToDofs(segments_t());
+  BOOST_CHECK(restricted->restrictedDofs().rows().empty());
+}
+
 BOOST_AUTO_TEST_CASE(SymbolicCalculus_position) {
   DevicePtr_t device = createRobot();
   JointPtr_t ee1 = device->getJointByName("lleg5_joint"),
@@ -280,6 +321,7 @@ BOOST_AUTO_TEST_CASE(SymbolicCalculus_position) {
   Configuration_t q1, q2;
   randomConfig(device, q2);
   matrix_t jacobian = matrix_t(pos->outputSize(), device->numberDof());
+  LiegroupElement value(pos->outputSpace());
   for (int i = 0; i < 100; i++) {
     randomConfig(device, q1);
     device->currentConfiguration(q1);
@@ -289,7 +331,7 @@ BOOST_AUTO_TEST_CASE(SymbolicCalculus_position) {
     relpos_sb_ptr->invalidate();
 
     /// Position
-    LiegroupElement value = (*pos)(q1);
+    pos->value(value, q1);
     pij->computeValue(q1);
     BOOST_CHECK(pij->value().isApprox(value.vector()));
     jacobian.setZero();
@@ -297,7 +339,7 @@ BOOST_AUTO_TEST_CASE(SymbolicCalculus_position) {
     pij->computeJacobian(q1);
     BOOST_CHECK(pij->jacobian().isApprox(jacobian));
     // Relative position
-    value = (*relpos)(q1);
+    relpos->value(value, q1);
     relpos_sb_ptr->computeValue(q1);
     BOOST_CHECK(relpos_sb_ptr->value().isApprox(value.vector()));
     jacobian.setZero();
@@ -329,13 +371,14 @@ BOOST_AUTO_TEST_CASE(SymbolicCalculus_jointframe) {
   randomConfig(device, q2);
   matrix_t jacobian1 = matrix_t(trans->outputSize(), device->numberDof());
   matrix_t jacobian2 = matrix_t(trans->outputSize(), device->numberDof());
+  LiegroupElement value1(trans->outputSpace()), value2(sf->outputSpace());
   for (int i = 0; i < 100; i++) {
     randomConfig(device, q1);
     device->currentConfiguration(q1);
     device->computeForwardKinematics();
 
-    LiegroupElement value1 = (*trans)(q1);
-    LiegroupElement value2 = (*sf)(q1);
+    trans->value(value1, q1);
+    sf->value(value2, q1);
     BOOST_CHECK(value1.vector().isApprox(value2.vector()));
     jacobian1.setZero();
     jacobian2.setZero();